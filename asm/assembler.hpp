@@ -877,7 +877,34 @@ class Assembler : public AbstractAssembler  {
     REX_WR     = 0x4C,
     REX_WRB    = 0x4D,
     REX_WRX    = 0x4E,
-    REX_WRXB   = 0x4F
+    REX_WRXB   = 0x4F,
+
+    VEX_3bytes = 0xC4,
+    VEX_2bytes = 0xC5
+  };
+
+  enum VexPrefix {
+    VEX_B = 0x20,
+    VEX_X = 0x40,
+    VEX_R = 0x80,
+    VEX_W = 0x80
+  };
+
+  // The mandatory SIMD prefix of an instruction (0x66, 0xF3 or 0xF2),
+  // in the encoding of the VEX.pp field.
+  enum VexSimdPrefix {
+    VEX_SIMD_NONE = 0x0,
+    VEX_SIMD_66   = 0x1,
+    VEX_SIMD_F3   = 0x2,
+    VEX_SIMD_F2   = 0x3
+  };
+
+  // The implied leading opcode bytes, in the encoding of the VEX.mmmmm field.
+  enum VexOpcode {
+    VEX_OPCODE_NONE  = 0x0,
+    VEX_OPCODE_0F    = 0x1,
+    VEX_OPCODE_0F_38 = 0x2,
+    VEX_OPCODE_0F_3A = 0x3
   };
 
   enum WhichOperand {
@@ -926,10 +953,28 @@ private:
 
   void prefetch_prefix(Address src);
 
+  // VEX prefixes
+  void vex_prefix(bool vex_r, bool vex_b, bool vex_x, bool vex_w,
+                  int nds_enc, VexSimdPrefix pre, VexOpcode opc);
+
+  int  vex_prefix_and_encode(int dst_enc, int nds_enc, int src_enc,
+                             VexSimdPrefix pre, VexOpcode opc,
+                             bool vex_w);
+
   // Helper functions for groups of instructions
   void emit_arith_b(int op1, int op2, Register dst, int imm8);
 
   void emit_arith(int op1, int op2, Register dst, int32_t imm32);
+  // Packed SSE instructions: [pre] [REX] 0x0F [0x38] opcode ModRM
+  void emit_simd_arith(int opcode, XMMRegister dst, XMMRegister src,
+                       VexSimdPrefix pre, VexOpcode opc = VEX_OPCODE_0F);
+  // Packed AVX instructions with a non-destructive source operand
+  void emit_vex_arith(int opcode, XMMRegister dst, XMMRegister nds, XMMRegister src,
+                      VexSimdPrefix pre, VexOpcode opc = VEX_OPCODE_0F);
+  // Packed shifts by an immediate count, SSE and AVX forms
+  void emit_simd_shift(int opcode, XMMRegister xmm_ext, XMMRegister dst, int shift);
+  void emit_vex_shift(int opcode, XMMRegister xmm_ext, XMMRegister dst, XMMRegister src,
+                      int shift);
   // only 32bit??
   void emit_arith(int op1, int op2, Register dst, jobject obj);
   void emit_arith(int op1, int op2, Register dst, Register src);
@@ -1149,6 +1194,16 @@ private:
   void addss(XMMRegister dst, Address src);
   void addss(XMMRegister dst, XMMRegister src);
 
+  // AES instructions
+  void aesdec(XMMRegister dst, Address src);
+  void aesdec(XMMRegister dst, XMMRegister src);
+  void aesdeclast(XMMRegister dst, Address src);
+  void aesdeclast(XMMRegister dst, XMMRegister src);
+  void aesenc(XMMRegister dst, Address src);
+  void aesenc(XMMRegister dst, XMMRegister src);
+  void aesenclast(XMMRegister dst, Address src);
+  void aesenclast(XMMRegister dst, XMMRegister src);
+
   void andl(Register dst, int32_t imm32);
   void andl(Register dst, Address src);
   void andl(Register dst, Register src);
@@ -1647,6 +1702,9 @@ private:
   void orq(Register dst, Address src);
   void orq(Register dst, Register src);
 
+  // Carry-Less Multiplication Quadword
+  void pclmulqdq(XMMRegister dst, XMMRegister src, int mask);
+
   // SSE4.2 string instructions
   void pcmpestri(XMMRegister xmm1, XMMRegister xmm2, int imm8);
   void pcmpestri(XMMRegister xmm1, Address src, int imm8);
@@ -1679,6 +1737,10 @@ private:
   // POR - Bitwise logical OR
   void por(XMMRegister dst, XMMRegister src);
 
+  // Shuffle Bytes
+  void pshufb(XMMRegister dst, XMMRegister src);
+  void pshufb(XMMRegister dst, Address src);
+
   // Shuffle Packed Doublewords
   void pshufd(XMMRegister dst, XMMRegister src, int mode);
   void pshufd(XMMRegister dst, Address src,     int mode);
@@ -1815,6 +1877,9 @@ private:
   void xchgq(Register reg, Address adr);
   void xchgq(Register dst, Register src);
 
+  // Get Value of Extended Control Register
+  void xgetbv();
+
   void xorl(Register dst, int32_t imm32);
   void xorl(Register dst, Address src);
   void xorl(Register dst, Register src);
@@ -1830,6 +1895,65 @@ private:
   void xorps(XMMRegister dst, Address src);
   void xorps(XMMRegister dst, XMMRegister src);
 
+  // Packed arithmetic used by the C2 vectorizer.  The SSE forms are
+  // destructive (dst = dst op src); the AVX forms take a separate first
+  // source nds.  Only the 128-bit (XMM) forms are emitted.
+
+  // Add, subtract, multiply and divide packed single-precision floats
+  void addps(XMMRegister dst, XMMRegister src);
+  void subps(XMMRegister dst, XMMRegister src);
+  void mulps(XMMRegister dst, XMMRegister src);
+  void divps(XMMRegister dst, XMMRegister src);
+  void vaddps(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vsubps(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vmulps(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vdivps(XMMRegister dst, XMMRegister nds, XMMRegister src);
+
+  // Add and subtract packed bytes, words and doublewords
+  void paddb(XMMRegister dst, XMMRegister src);
+  void paddw(XMMRegister dst, XMMRegister src);
+  void paddd(XMMRegister dst, XMMRegister src);
+  void psubb(XMMRegister dst, XMMRegister src);
+  void psubw(XMMRegister dst, XMMRegister src);
+  void psubd(XMMRegister dst, XMMRegister src);
+  void vpaddb(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpaddw(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpaddd(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpsubb(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpsubw(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpsubd(XMMRegister dst, XMMRegister nds, XMMRegister src);
+
+  // Multiply packed words and doublewords, keeping the low half (pmulld is SSE4.1)
+  void pmullw(XMMRegister dst, XMMRegister src);
+  void pmulld(XMMRegister dst, XMMRegister src);
+  void vpmullw(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpmulld(XMMRegister dst, XMMRegister nds, XMMRegister src);
+
+  // Bitwise logical AND, OR and XOR
+  void pand(XMMRegister dst, XMMRegister src);
+  void vpand(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpor(XMMRegister dst, XMMRegister nds, XMMRegister src);
+  void vpxor(XMMRegister dst, XMMRegister nds, XMMRegister src);
+
+  // Shift packed words and doublewords left or logically right, by an
+  // immediate count or by the count in the low quadword of shift
+  void psllw(XMMRegister dst, int shift);
+  void pslld(XMMRegister dst, int shift);
+  void psrlw(XMMRegister dst, int shift);
+  void psrld(XMMRegister dst, int shift);
+  void psllw(XMMRegister dst, XMMRegister shift);
+  void pslld(XMMRegister dst, XMMRegister shift);
+  void psrlw(XMMRegister dst, XMMRegister shift);
+  void psrld(XMMRegister dst, XMMRegister shift);
+  void vpsllw(XMMRegister dst, XMMRegister src, int shift);
+  void vpslld(XMMRegister dst, XMMRegister src, int shift);
+  void vpsrlw(XMMRegister dst, XMMRegister src, int shift);
+  void vpsrld(XMMRegister dst, XMMRegister src, int shift);
+  void vpsllw(XMMRegister dst, XMMRegister src, XMMRegister shift);
+  void vpslld(XMMRegister dst, XMMRegister src, XMMRegister shift);
+  void vpsrlw(XMMRegister dst, XMMRegister src, XMMRegister shift);
+  void vpsrld(XMMRegister dst, XMMRegister src, XMMRegister shift);
+
   void set_byte_if_not_zero(Register dst); // sets reg to 1 if not zero, otherwise 0
 };
 
@@ -2665,6 +2789,17 @@ public:
   void xorps(XMMRegister dst, Address src)     { Assembler::xorps(dst, src); }
   void xorps(XMMRegister dst, AddressLiteral src);
 
+  // Move Unaligned Double Quadword
+  void movdqu(Address     dst, XMMRegister src) { Assembler::movdqu(dst, src); }
+  void movdqu(XMMRegister dst, Address src)     { Assembler::movdqu(dst, src); }
+  void movdqu(XMMRegister dst, XMMRegister src) { Assembler::movdqu(dst, src); }
+  void movdqu(XMMRegister dst, AddressLiteral src);
+
+  // Shuffle Bytes
+  void pshufb(XMMRegister dst, XMMRegister src) { Assembler::pshufb(dst, src); }
+  void pshufb(XMMRegister dst, Address src)     { Assembler::pshufb(dst, src); }
+  void pshufb(XMMRegister dst, AddressLiteral src);
+
   // Data
 
   void cmov32( Condition cc, Register dst, Address  src);
@@ -2760,6 +2895,17 @@ public:
                      Register to, Register value, Register count,
                      Register rtmp, XMMRegister xtmp);
 
+  // CRC32 code for java.util.zip.CRC32::update() and updateBytes() intrinsics.
+  void update_byte_crc32(Register crc, Register val, Register table);
+#ifdef _LP64
+  void kernel_crc32(Register crc, Register buf, Register len, Register table, Register tmp);
+ private:
+  void fold_128bit_crc32(XMMRegister xcrc, XMMRegister xK, XMMRegister xtmp, Register buf, int offset);
+  void fold_128bit_crc32(XMMRegister xcrc, XMMRegister xK, XMMRegister xtmp, XMMRegister xbuf);
+  void fold_8bit_crc32(Register crc, Register table, Register tmp);
+ public:
+#endif
+
 #undef VIRTUAL
 
 };
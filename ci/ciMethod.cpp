@@ -501,13 +501,16 @@ ciCallProfile ciMethod::call_profile_at_bci(int bci) {
           // we will set result._method also.
         }
         // Determine call site's morphism.
-        // The call site count is 0 with known morphism (onlt 1 or 2 receivers)
-        // or < 0 in the case of a type check failured for checkcast, aastore, instanceof.
-        // The call site count is > 0 in the case of a polymorphic virtual call.
+        // The call site count is 0 with known morphism (all the receivers
+        // fit in the profile rows) or < 0 in the case of a type check
+        // failured for checkcast, aastore, instanceof.
+        // The call site count is > 0 in the case of a polymorphic virtual
+        // call which has seen more receivers than there are rows.
+        int row_limit = (int)call->row_limit();
         if (morphism > 0 && morphism == result._limit) {
            // The morphism <= MorphismLimit.
-           if ((morphism <  ciCallProfile::MorphismLimit) ||
-               (morphism == ciCallProfile::MorphismLimit && count == 0)) {
+           if ((morphism <  row_limit) ||
+               (morphism == row_limit && count == 0)) {
 #ifdef ASSERT
              if (count > 0) {
                this->print_short_name(tty);
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/classFilePrefetcher.hpp"
+#include "classfile/classLoader.hpp"
+#include "memory/allocation.inline.hpp"
+#include "memory/resourceArea.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "utilities/hashtable.inline.hpp"
+
+// A class file read by a prefetch thread.
+class PrefetchedClassFile: public CHeapObj {
+ private:
+  char*                _name;
+  u1*                  _buffer;
+  int                  _size;
+  int                  _index;     // of the entry in the jar file
+  PrefetchedClassFile* _next;
+
+ public:
+  PrefetchedClassFile(char* name, u1* buffer, int size, int index) :
+    _name(name), _buffer(buffer), _size(size), _index(index), _next(NULL) { }
+  ~PrefetchedClassFile() {
+    FREE_C_HEAP_ARRAY(char, _name);
+    FREE_C_HEAP_ARRAY(u1, _buffer);
+  }
+
+  const char* name() const              { return _name; }
+  u1* buffer() const                    { return _buffer; }
+  int size() const                      { return _size; }
+  int index() const                     { return _index; }
+  PrefetchedClassFile* next() const     { return _next; }
+  PrefetchedClassFile** next_addr()     { return &_next; }
+  void set_next(PrefetchedClassFile* f) { _next = f; }
+};
+
+// The prefetch state of a jar file of the boot class path.  All the
+// fields but _entry and _next are protected by ClassFilePrefetch_lock;
+// _zip is only set once, and may be read without the lock.
+class PrefetchedZip: public CHeapObj {
+ public:
+  enum {
+    bucket_count = 256
+  };
+
+ private:
+  ClassPathEntry*      _entry;
+  ClassPathZipEntry* volatile _zip;    // NULL until the jar file is open
+  bool                 _is_resolving;  // a thread is opening the jar file
+  int                  _next_index;    // next entry to be claimed
+  int                  _used_index;    // highest entry taken by the loader
+  bool                 _is_exhausted;  // all the entries have been claimed
+  PrefetchedClassFile* _buckets[bucket_count];
+  PrefetchedZip*       _next;
+
+  PrefetchedClassFile** bucket_for(const char* name) {
+    int len = (int)strlen(name);
+    return &_buckets[BasicHashtable::hash_symbol(name, len) % bucket_count];
+  }
+
+ public:
+  PrefetchedZip(ClassPathEntry* entry) :
+    _entry(entry), _zip(NULL), _is_resolving(false),
+    _next_index(0), _used_index(0), _is_exhausted(false), _next(NULL) {
+    if (!entry->is_lazy()) {
+      _zip = (ClassPathZipEntry*)entry;
+    }
+    for (int i = 0; i < bucket_count; i++) {
+      _buckets[i] = NULL;
+    }
+  }
+
+  ClassPathEntry* entry() const       { return _entry; }
+  ClassPathZipEntry* zip() const      { return _zip; }
+  PrefetchedZip* next() const         { return _next; }
+  void set_next(PrefetchedZip* z)     { _next = z; }
+
+  bool is_exhausted() const           { return _is_exhausted; }
+  void set_exhausted()                { _is_exhausted = true; }
+
+  // Entries are only claimed up to ClassFilePrefetchDistance past the
+  // last class file used.  The first thread to claim an entry of a jar
+  // file which is not open yet gets index -1 and opens it instead.
+  bool claim(int* index) {
+    if (_is_exhausted || _is_resolving) {
+      return false;
+    }
+    if (_zip == NULL) {
+      _is_resolving = true;
+      *index = -1;
+      return true;
+    }
+    if (_next_index > _used_index + (int)ClassFilePrefetchDistance) {
+      return false;
+    }
+    *index = _next_index++;
+    return true;
+  }
+
+  // A jar file which cannot be opened is not prefetched.
+  void set_resolved(ClassPathZipEntry* zip) {
+    _is_resolving = false;
+    if (zip == NULL) {
+      _is_exhausted = true;
+    } else {
+      _zip = zip;
+    }
+  }
+
+  // True if the loader has moved more than the prefetch distance past
+  // the entry at index.
+  bool is_stale(int index) const {
+    return index + (int)ClassFilePrefetchDistance < _used_index;
+  }
+
+  void add(PrefetchedClassFile* f) {
+    PrefetchedClassFile** b = bucket_for(f->name());
+    f->set_next(*b);
+    *b = f;
+  }
+
+  // Unlink the class file name, if it has been prefetched.  The loader
+  // has now reached its entry, so the class files passed over by more
+  // than the prefetch distance are unlinked too and appended to *stale.
+  PrefetchedClassFile* take(const char* name, PrefetchedClassFile** stale) {
+    PrefetchedClassFile* result = NULL;
+    PrefetchedClassFile** b = bucket_for(name);
+    for (PrefetchedClassFile* prev = NULL, *f = *b; f != NULL; prev = f, f = f->next()) {
+      if (strcmp(f->name(), name) == 0) {
+        if (prev == NULL) {
+          *b = f->next();
+        } else {
+          prev->set_next(f->next());
+        }
+        result = f;
+        break;
+      }
+    }
+    if (result != NULL && result->index() > _used_index) {
+      _used_index = result->index();
+      for (int i = 0; i < bucket_count; i++) {
+        PrefetchedClassFile** p = &_buckets[i];
+        while (*p != NULL) {
+          PrefetchedClassFile* f = *p;
+          if (is_stale(f->index())) {
+            *p = f->next();
+            f->set_next(*stale);
+            *stale = f;
+          } else {
+            p = f->next_addr();
+          }
+        }
+      }
+    }
+    return result;
+  }
+};
+
+PrefetchedZip* ClassFilePrefetcher::_zips             = NULL;
+bool           ClassFilePrefetcher::_is_active        = false;
+volatile bool  ClassFilePrefetcher::_should_terminate = false;
+
+// How long a prefetch thread waits for the prefetch window to move
+// before it checks again whether the VM is shutting down.
+static const long ClassFilePrefetchWaitMillis = 1000;
+
+PerfCounter*   ClassFilePrefetcher::_perf_prefetched_bytes = NULL;
+PerfCounter*   ClassFilePrefetcher::_perf_hits             = NULL;
+PerfCounter*   ClassFilePrefetcher::_perf_discarded        = NULL;
+
+void ClassFilePrefetcher::initialize() {
+  assert(ClassFilePrefetchThreads > 0, "prefetching is off");
+  assert(!_is_active, "should only be initialized once");
+  EXCEPTION_MARK;
+
+  if (UsePerfData) {
+    NEWPERFBYTECOUNTER(_perf_prefetched_bytes, SUN_CLS, "prefetchedClassBytes");
+    NEWPERFEVENTCOUNTER(_perf_hits, SUN_CLS, "prefetchedClassHits");
+    NEWPERFEVENTCOUNTER(_perf_discarded, SUN_CLS, "prefetchedClassDiscards");
+  }
+
+  // Collect the jar files of the boot class path.  Lazy entries are opened
+  // by the prefetch threads, so that startup does not wait for them.
+  PrefetchedZip* last = NULL;
+  for (ClassPathEntry* e = ClassLoader::classpath_entry(0); e != NULL; e = e->next()) {
+    if (!e->is_jar_file()) {
+      continue;
+    }
+    PrefetchedZip* z = new PrefetchedZip(e);
+    if (last == NULL) {
+      _zips = z;
+    } else {
+      last->set_next(z);
+    }
+    last = z;
+  }
+  if (_zips == NULL) {
+    return;
+  }
+
+  _is_active = true;
+  for (uint i = 0; i < ClassFilePrefetchThreads; i++) {
+    ClassFilePrefetchThread* t = new ClassFilePrefetchThread(i);
+    if (os::create_thread(t, os::os_thread)) {
+      os::start_thread(t);
+    } else {
+      // Prefetching is only an optimization; the threads which could be
+      // created will do all the work.
+      delete t;
+      break;
+    }
+  }
+}
+
+bool ClassFilePrefetcher::claim_entry(PrefetchedZip** zip, int* index) {
+  assert_lock_strong(ClassFilePrefetch_lock);
+  for (PrefetchedZip* z = _zips; z != NULL; z = z->next()) {
+    if (z->claim(index)) {
+      *zip = z;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool ClassFilePrefetcher::is_done() {
+  assert_lock_strong(ClassFilePrefetch_lock);
+  for (PrefetchedZip* z = _zips; z != NULL; z = z->next()) {
+    if (!z->is_exhausted()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ClassFilePrefetcher::stop() {
+  MutexLockerEx ml(ClassFilePrefetch_lock, Mutex::_no_safepoint_check_flag);
+  _should_terminate = true;
+  ClassFilePrefetch_lock->notify_all();
+}
+
+void ClassFilePrefetcher::prefetch() {
+  while (true) {
+    PrefetchedZip* z = NULL;
+    int index = 0;
+    {
+      MutexLockerEx ml(ClassFilePrefetch_lock, Mutex::_no_safepoint_check_flag);
+      while (_should_terminate || !claim_entry(&z, &index)) {
+        if (_should_terminate || is_done()) {
+          return;
+        }
+        ClassFilePrefetch_lock->wait(Mutex::_no_safepoint_check_flag,
+                                     ClassFilePrefetchWaitMillis);
+      }
+    }
+
+    if (index < 0) {
+      ClassPathEntry* resolved = ((LazyClassPathEntry*)z->entry())->resolve_entry_or_null();
+      MutexLockerEx ml(ClassFilePrefetch_lock, Mutex::_no_safepoint_check_flag);
+      z->set_resolved((ClassPathZipEntry*)resolved);
+      // The entries of the jar file can now be claimed, or, if it could
+      // not be opened, all may be done.
+      ClassFilePrefetch_lock->notify_all();
+      continue;
+    }
+
+    char* name = NULL;
+    u1* buffer = NULL;
+    int size = 0;
+    bool has_entry = z->zip()->read_entry(index, &name, &buffer, &size);
+
+    MutexLockerEx ml(ClassFilePrefetch_lock, Mutex::_no_safepoint_check_flag);
+    if (!has_entry) {
+      // Past the last entry of the jar file; wake up the threads waiting
+      // for work so that they can find out whether all is done.
+      z->set_exhausted();
+      ClassFilePrefetch_lock->notify_all();
+    } else if (buffer != NULL) {
+      if (z->is_stale(index)) {
+        // The loader has already moved on.
+        FREE_C_HEAP_ARRAY(char, name);
+        FREE_C_HEAP_ARRAY(u1, buffer);
+        if (UsePerfData) {
+          _perf_discarded->inc();
+        }
+      } else {
+        z->add(new PrefetchedClassFile(name, buffer, size, index));
+        if (UsePerfData) {
+          _perf_prefetched_bytes->inc(size);
+        }
+      }
+    }
+  }
+}
+
+u1* ClassFilePrefetcher::take(ClassPathZipEntry* zip, const char* name, int size) {
+  PrefetchedZip* z = _zips;
+  while (z != NULL && z->zip() != zip) {
+    z = z->next();
+  }
+  if (z == NULL) {
+    return NULL;
+  }
+
+  PrefetchedClassFile* f = NULL;
+  PrefetchedClassFile* stale = NULL;
+  {
+    MutexLockerEx ml(ClassFilePrefetch_lock, Mutex::_no_safepoint_check_flag);
+    f = z->take(name, &stale);
+    if (f == NULL) {
+      return NULL;
+    }
+    // The prefetch window has moved.
+    ClassFilePrefetch_lock->notify_all();
+  }
+
+  while (stale != NULL) {
+    PrefetchedClassFile* next = stale->next();
+    delete stale;
+    if (UsePerfData) {
+      _perf_discarded->inc();
+    }
+    stale = next;
+  }
+
+  u1* buffer = NULL;
+  if (f->size() == size) {
+    buffer = NEW_RESOURCE_ARRAY(u1, size);
+    memcpy(buffer, f->buffer(), size);
+    if (UsePerfData) {
+      _perf_hits->inc();
+    }
+  }
+  delete f;
+  return buffer;
+}
+
+ClassFilePrefetchThread::ClassFilePrefetchThread(int id) : NamedThread() {
+  set_name("Class File Prefetch Thread#%d", id);
+}
+
+void ClassFilePrefetchThread::run() {
+  this->record_stack_base_and_size();
+  this->initialize_thread_local_storage();
+  assert(this == Thread::current(), "just checking");
+
+  ClassFilePrefetcher::prefetch();
+
+  // All the jar files have been read.
+  ThreadLocalStorage::set_thread(NULL);
+}
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_CLASSFILE_CLASSFILEPREFETCHER_HPP
+#define SHARE_VM_CLASSFILE_CLASSFILEPREFETCHER_HPP
+
+#include "memory/allocation.hpp"
+#include "runtime/perfData.hpp"
+#include "runtime/thread.hpp"
+
+class ClassPathZipEntry;
+class PrefetchedZip;
+
+// Support for reading the class files of the boot class path ahead of use.
+//
+// The jar files of the JDK are ordered by the order in which their classes
+// are loaded at startup.  With ClassFilePrefetchThreads > 0, background
+// threads walk the jar files of the boot class path in class path order,
+// inflate the class files they contain and keep them in the C heap.  When
+// the boot loader then finds a class file in one of these jar files, it
+// takes the prefetched bytes instead of inflating the entry itself.  The
+// class is still parsed, verified, linked and added to the dictionary by
+// the thread requesting it, so the prefetching has no visible effect
+// other than time.  Only the reading and inflating of the class files is
+// done ahead: parsing allocates the klass and its constant pool in the
+// permanent generation, resolves the super class and may throw, which
+// requires the requesting JavaThread and its class loader.
+//
+// The threads do not read more than ClassFilePrefetchDistance entries
+// past the last prefetched class file that was used in a jar file, and
+// class files which have been passed over by more than that distance are
+// discarded, so the memory used stays bounded if the load order differs
+// from the jar file order.
+//
+// The threads exit once all the jar files have been read, or when the VM
+// shuts down (see stop()).
+
+class ClassFilePrefetcher : AllStatic {
+  friend class ClassFilePrefetchThread;
+ private:
+  static PrefetchedZip* _zips;         // the jar files, in class path order
+  static bool           _is_active;
+  static volatile bool  _should_terminate;
+
+  // Performance counters
+  static PerfCounter*   _perf_prefetched_bytes;
+  static PerfCounter*   _perf_hits;
+  static PerfCounter*   _perf_discarded;
+
+  // Claim the next entry to be read.  Returns false if there is no entry
+  // within the prefetch distance.  Called with ClassFilePrefetch_lock held.
+  static bool claim_entry(PrefetchedZip** zip, int* index);
+  // True once all the jar files have been read.
+  static bool is_done();
+
+  // Work loop of the prefetch threads.
+  static void prefetch();
+
+ public:
+  // Start the prefetch threads.  Called by ClassLoader::initialize() once
+  // the boot class path has been set up.
+  static void initialize();
+
+  static bool is_active() { return _is_active; }
+
+  // Make the prefetch threads exit.  Called by before_exit().
+  static void stop();
+
+  // If the class file name of zip has been prefetched, remove it and
+  // return its bytes copied into the resource area; otherwise NULL.
+  // size is the size of the class file as recorded in the jar file.
+  static u1* take(ClassPathZipEntry* zip, const char* name, int size);
+};
+
+class ClassFilePrefetchThread: public NamedThread {
+ public:
+  ClassFilePrefetchThread(int id);
+  virtual void run();
+};
+
+#endif // SHARE_VM_CLASSFILE_CLASSFILEPREFETCHER_HPP
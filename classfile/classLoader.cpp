@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "classfile/classFileParser.hpp"
+#include "classfile/classFilePrefetcher.hpp"
 #include "classfile/classFileStream.hpp"
 #include "classfile/classLoader.hpp"
 #include "classfile/javaClasses.hpp"
@@ -78,6 +79,7 @@ typedef jzentry* (JNICALL *FindEntry_t)(jzfile *zip, const char *name, jint *siz
 typedef jboolean (JNICALL *ReadEntry_t)(jzfile *zip, jzentry *entry, unsigned char *buf, char *namebuf);
 typedef jboolean (JNICALL *ReadMappedEntry_t)(jzfile *zip, jzentry *entry, unsigned char **buf, char *namebuf);
 typedef jzentry* (JNICALL *GetNextEntry_t)(jzfile *zip, jint n);
+typedef void (JNICALL *FreeEntry_t)(jzfile *zip, jzentry *entry);
 
 static ZipOpen_t         ZipOpen            = NULL;
 static ZipClose_t        ZipClose           = NULL;
@@ -85,6 +87,7 @@ static FindEntry_t       FindEntry          = NULL;
 static ReadEntry_t       ReadEntry          = NULL;
 static ReadMappedEntry_t ReadMappedEntry    = NULL;
 static GetNextEntry_t    GetNextEntry       = NULL;
+static FreeEntry_t       FreeEntry          = NULL;
 static canonicalize_fn_t CanonicalizeEntry  = NULL;
 
 // Globals
@@ -257,10 +260,17 @@ ClassFileStream* ClassPathZipEntry::open_stream(const char* name) {
   // file found, get pointer to class in mmaped jar file.
   if (ReadMappedEntry == NULL ||
       !(*ReadMappedEntry)(_zip, entry, &buffer, filename)) {
-      // mmaped access not available, perhaps due to compression,
+    // mmaped access not available, perhaps due to compression,
+    // use the contents read ahead by the prefetch threads, if any.
+    buffer = NULL;
+    if (ClassFilePrefetcher::is_active()) {
+      buffer = ClassFilePrefetcher::take(this, name, filesize);
+    }
+    if (buffer == NULL) {
       // read contents into resource array
       buffer     = NEW_RESOURCE_ARRAY(u1, filesize);
       if (!(*ReadEntry)(_zip, entry, buffer, filename)) return NULL;
+    }
   }
   if (UsePerfData) {
     ClassLoader::perf_sys_classfile_bytes_read()->inc(filesize);
@@ -281,6 +291,39 @@ void ClassPathZipEntry::contents_do(void f(const char* name, void* context), voi
   }
 }
 
+bool ClassPathZipEntry::read_entry(int n, char** name, u1** buffer, int* size) {
+  jzentry* ze = (*GetNextEntry)(_zip, n);
+  if (ze == NULL) return false;
+  *name = NULL;
+  *buffer = NULL;
+  *size = 0;
+
+  // Stored entries are not worth reading ahead: they are mapped or copied.
+  size_t name_len = strlen(ze->name);
+  const char* suffix = ".class";
+  size_t suffix_len = strlen(suffix);
+  if (ze->csize != 0 && ze->size <= max_jint &&
+      name_len > suffix_len &&
+      strcmp(ze->name + name_len - suffix_len, suffix) == 0) {
+    char* filename = NEW_C_HEAP_ARRAY(char, name_len + 1);
+    u1* contents = NEW_C_HEAP_ARRAY(u1, ze->size);
+    int entry_size = (int)ze->size;
+    // ZIP_ReadEntry releases the entry when it succeeds.
+    if ((*ReadEntry)(_zip, ze, contents, filename)) {
+      *name = filename;
+      *buffer = contents;
+      *size = entry_size;
+      return true;
+    }
+    FREE_C_HEAP_ARRAY(char, filename);
+    FREE_C_HEAP_ARRAY(u1, contents);
+  }
+  if (FreeEntry != NULL) {
+    (*FreeEntry)(_zip, ze);
+  }
+  return true;
+}
+
 LazyClassPathEntry::LazyClassPathEntry(char* path, struct stat st) : ClassPathEntry() {
   _path = strdup(path);
   _st = st;
@@ -311,6 +354,34 @@ ClassPathEntry* LazyClassPathEntry::resolve_entry() {
   return (ClassPathEntry*) _resolved_entry;
 }
 
+// Resolve the entry from a thread which is not a Java thread, such as a
+// class file prefetch thread: the path is not canonicalized, which needs
+// JNI, and NULL is returned instead of throwing if the jar file cannot be
+// opened.  The error is reported when a Java thread resolves the entry.
+ClassPathEntry* LazyClassPathEntry::resolve_entry_or_null() {
+  if (_resolved_entry != NULL) {
+    return (ClassPathEntry*) _resolved_entry;
+  }
+  if (!is_jar_file()) {
+    return NULL;
+  }
+  char* error_msg = NULL;
+  jzfile* zip = (*ZipOpen)(_path, &error_msg);
+  if (zip == NULL || error_msg != NULL) {
+    return NULL;
+  }
+  ClassPathEntry* new_entry = new ClassPathZipEntry(zip, _path);
+  {
+    ThreadCritical tc;
+    if (_resolved_entry == NULL) {
+      _resolved_entry = new_entry;
+      return new_entry;
+    }
+  }
+  delete new_entry;
+  return (ClassPathEntry*) _resolved_entry;
+}
+
 ClassFileStream* LazyClassPathEntry::open_stream(const char* name) {
   if (_meta_index != NULL &&
       !_meta_index->may_contain(name)) {
@@ -615,6 +686,7 @@ void ClassLoader::load_zip_library() {
   ReadEntry    = CAST_TO_FN_PTR(ReadEntry_t, os::dll_lookup(handle, "ZIP_ReadEntry"));
   ReadMappedEntry = CAST_TO_FN_PTR(ReadMappedEntry_t, os::dll_lookup(handle, "ZIP_ReadMappedEntry"));
   GetNextEntry = CAST_TO_FN_PTR(GetNextEntry_t, os::dll_lookup(handle, "ZIP_GetNextEntry"));
+  FreeEntry    = CAST_TO_FN_PTR(FreeEntry_t, os::dll_lookup(handle, "ZIP_FreeEntry"));
 
   // ZIP_Close is not exported on Windows in JDK5.0 so don't abort if ZIP_Close is NULL
   if (ZipOpen == NULL || FindEntry == NULL || ReadEntry == NULL || GetNextEntry == NULL) {
@@ -1019,6 +1091,10 @@ void ClassLoader::initialize() {
     // set up meta index which makes boot classpath initialization lazier
     setup_meta_index();
   }
+  if (ClassFilePrefetchThreads > 0) {
+    // start reading the boot class path ahead of use
+    ClassFilePrefetcher::initialize();
+  }
 }
 
 
@@ -109,6 +109,11 @@ class ClassPathZipEntry: public ClassPathEntry {
   ~ClassPathZipEntry();
   ClassFileStream* open_stream(const char* name);
   void contents_do(void f(const char* name, void* context), void* context);
+  // Read the n-th entry of the archive into the C heap if it is a
+  // compressed class file; otherwise *buffer is set to NULL.  Returns
+  // false if there is no n-th entry.  Used by the ClassFilePrefetcher,
+  // so it may be called by threads which are not Java threads.
+  bool read_entry(int n, char** name, u1** buffer, int* size);
   // Debugging
   NOT_PRODUCT(void compile_the_world(Handle loader, TRAPS);)
   NOT_PRODUCT(void compile_the_world12(Handle loader, TRAPS);) // JDK 1.2 version
@@ -126,8 +131,11 @@ class LazyClassPathEntry: public ClassPathEntry {
   struct stat _st;
   MetaIndex* _meta_index;
   volatile ClassPathEntry* _resolved_entry;
-  ClassPathEntry* resolve_entry();
  public:
+  ClassPathEntry* resolve_entry();
+  // Resolve the entry from a thread which is not a Java thread; returns
+  // NULL if the jar file cannot be opened.
+  ClassPathEntry* resolve_entry_or_null();
   bool is_jar_file();
   const char* name()  { return _path; }
   LazyClassPathEntry(char* path, struct stat st);
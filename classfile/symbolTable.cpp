@@ -29,14 +29,124 @@
 #include "gc_interface/collectedHeap.inline.hpp"
 #include "memory/filemap.hpp"
 #include "memory/gcLocker.inline.hpp"
+#include "memory/resourceArea.hpp"
 #include "oops/oop.inline.hpp"
 #include "oops/oop.inline2.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/mutexLocker.hpp"
 #include "utilities/hashtable.inline.hpp"
 
 // --------------------------------------------------------------------------
 
+TableResizer::TableResizer(const char* name, BasicHashtable* table) :
+  _needs_resizing(false),
+  _perf_size(NULL), _perf_entries(NULL), _perf_max_chain_length(NULL),
+  _perf_resizes(NULL), _perf_resize_time(NULL) {
+
+  if (UsePerfData) {
+    EXCEPTION_MARK;
+    ResourceMark rm;
+
+    char* cname = PerfDataManager::counter_name(name, "size");
+    _perf_size = PerfDataManager::create_variable(SUN_RT, cname,
+                                                  PerfData::U_None, CHECK);
+
+    cname = PerfDataManager::counter_name(name, "entries");
+    _perf_entries = PerfDataManager::create_variable(SUN_RT, cname,
+                                                     PerfData::U_None, CHECK);
+
+    cname = PerfDataManager::counter_name(name, "maxChainLength");
+    _perf_max_chain_length = PerfDataManager::create_variable(SUN_RT, cname,
+                                                              PerfData::U_None,
+                                                              CHECK);
+
+    cname = PerfDataManager::counter_name(name, "resizes");
+    _perf_resizes = PerfDataManager::create_counter(SUN_RT, cname,
+                                                    PerfData::U_Events, CHECK);
+
+    cname = PerfDataManager::counter_name(name, "resizeTime");
+    _perf_resize_time = PerfDataManager::create_counter(SUN_RT, cname,
+                                                        PerfData::U_Ticks, CHECK);
+
+    _perf_size->set_value(table->table_size());
+    _perf_entries->set_value(table->number_of_entries());
+  }
+}
+
+bool TableResizer::can_resize() {
+  // The shared archive records the size of the tables and links the
+  // shared entries into their buckets.
+  return ResizeSymbolTables && !UseSharedSpaces && !DumpSharedSpaces;
+}
+
+void TableResizer::check_load(BasicHashtable* table) {
+  if (!_needs_resizing &&
+      table->table_size() < max_table_size &&
+      (size_t)table->number_of_entries() > SymbolTableMaxLoad * (size_t)table->table_size() &&
+      can_resize()) {
+    _needs_resizing = true;
+  }
+}
+
+void TableResizer::resize_if_needed(BasicHashtable* table) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  if (!_needs_resizing) {
+    return;
+  }
+  _needs_resizing = false;
+
+  // Grow by doubling until the load is back under the limit.  Odd sizes
+  // keep the low bits of the hash from dominating the bucket index.
+  int old_size = table->table_size();
+  int new_size = old_size;
+  do {
+    new_size = MIN2(new_size * 2 + 1, (int)max_table_size);
+  } while (new_size < max_table_size &&
+           (size_t)table->number_of_entries() > SymbolTableMaxLoad * (size_t)new_size);
+
+  jlong start = os::elapsed_counter();
+  table->resize(new_size);
+  int max_chain_length = table->max_chain_length();
+  jlong ticks = os::elapsed_counter() - start;
+
+  if (UsePerfData) {
+    _perf_resizes->inc();
+    _perf_resize_time->inc(ticks);
+  }
+  update_counters(table, max_chain_length);
+
+  if (PrintGCDetails && Verbose) {
+    gclog_or_tty->print_cr("[Resized table from %d to %d buckets, "
+                           "%d entries, longest chain %d, %3.7f secs]",
+                           old_size, new_size, table->number_of_entries(),
+                           max_chain_length,
+                           (double)ticks / os::elapsed_frequency());
+  }
+}
+
+void TableResizer::update_max_chain_length(volatile jint* dest, int length) {
+  jint cur = *dest;
+  while (length > cur) {
+    jint prev = Atomic::cmpxchg((jint)length, dest, cur);
+    if (prev == cur) {
+      return;
+    }
+    cur = prev;
+  }
+}
+
+void TableResizer::update_counters(BasicHashtable* table, int max_chain_length) {
+  if (UsePerfData) {
+    _perf_size->set_value(table->table_size());
+    _perf_entries->set_value(table->number_of_entries());
+    _perf_max_chain_length->set_value(max_chain_length);
+  }
+}
+
+// --------------------------------------------------------------------------
+
 SymbolTable* SymbolTable::_the_table = NULL;
+TableResizer* SymbolTable::_resizer = NULL;
 
 Symbol* SymbolTable::allocate_symbol(const u1* name, int len, TRAPS) {
   // Don't allow symbols to be created which cannot fit in a Symbol*.
@@ -82,44 +192,132 @@ void SymbolTable::symbols_do(SymbolClosure *cl) {
 int SymbolTable::symbols_removed = 0;
 int SymbolTable::symbols_counted = 0;
 
-// Remove unreferenced symbols from the symbol table
-// This is done late during GC.  This doesn't use the hash table unlink because
-// it assumes that the literals are oops.
-void SymbolTable::unlink() {
-  int removed = 0;
-  int total = 0;
-  size_t memory_total = 0;
-  for (int i = 0; i < the_table()->table_size(); ++i) {
+volatile jint SymbolTable::_parallel_claimed_idx       = 0;
+volatile jint SymbolTable::_parallel_max_chain_length  = 0;
+volatile jint SymbolTable::_parallel_removed           = 0;
+volatile jint SymbolTable::_parallel_total             = 0;
+volatile jint SymbolTable::_parallel_memory_total      = 0;
+int           SymbolTable::_incremental_idx            = 0;
+int           SymbolTable::_incremental_max_chain_length = 0;
+
+// Remove the unreferenced symbols of the buckets [start, end).  This
+// doesn't use the hash table unlink because it assumes that the literals
+// are oops.  Returns the length of the longest chain left.
+int SymbolTable::buckets_unlink(int start, int end, int* removed,
+                                int* total, size_t* memory_total) {
+  BasicHashtableEntry* free_first = NULL;
+  BasicHashtableEntry* free_last = NULL;
+  int max_chain_length = 0;
+  for (int i = start; i < end; ++i) {
+    int chain_length = 0;
     for (HashtableEntry<Symbol*>** p = the_table()->bucket_addr(i); *p != NULL; ) {
       HashtableEntry<Symbol*>* entry = *p;
       if (entry->is_shared()) {
         break;
       }
       Symbol* s = entry->literal();
-      memory_total += s->object_size();
-      total++;
+      *memory_total += s->object_size();
+      (*total)++;
       assert(s != NULL, "just checking");
       // If reference count is zero, remove.
       if (s->refcount() == 0) {
         delete s;
-        removed++;
+        (*removed)++;
         *p = entry->next();
-        the_table()->free_entry(entry);
+        entry->set_next(free_first);
+        free_first = entry;
+        if (free_last == NULL) {
+          free_last = entry;
+        }
       } else {
+        chain_length++;
         p = entry->next_addr();
       }
     }
+    max_chain_length = MAX2(max_chain_length, chain_length);
   }
-  symbols_removed += removed;
-  symbols_counted += total;
+  if (free_first != NULL) {
+    the_table()->bulk_free_entries(free_first, free_last, *removed);
+  }
+  return max_chain_length;
+}
+
+void SymbolTable::clear_parallel_claimed_index() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  _parallel_claimed_idx = 0;
+  _parallel_max_chain_length = 0;
+  _parallel_removed = 0;
+  _parallel_total = 0;
+  _parallel_memory_total = 0;
+}
+
+void SymbolTable::possibly_parallel_unlink() {
+  const int limit = the_table()->table_size();
+  while (true) {
+    // Grab next set of buckets to scan
+    int start = Atomic::add(ClaimChunkSize, &_parallel_claimed_idx) - ClaimChunkSize;
+    if (start >= limit) {
+      // End of table
+      break;
+    }
+    int end = MIN2(limit, start + ClaimChunkSize);
+    int removed = 0;
+    int total = 0;
+    size_t memory_total = 0;
+    int max_chain_length = buckets_unlink(start, end, &removed, &total,
+                                          &memory_total);
+    TableResizer::update_max_chain_length(&_parallel_max_chain_length,
+                                          max_chain_length);
+    Atomic::add(removed, &_parallel_removed);
+    Atomic::add(total, &_parallel_total);
+    Atomic::add((jint)memory_total, &_parallel_memory_total);
+  }
+}
+
+void SymbolTable::parallel_unlink_done() {
+  symbols_removed += _parallel_removed;
+  symbols_counted += _parallel_total;
+  _resizer->update_counters(the_table(), _parallel_max_chain_length);
   // Exclude printing for normal PrintGCDetails because people parse
   // this output.
   if (PrintGCDetails && Verbose && WizardMode) {
-    gclog_or_tty->print(" [Symbols=%d size=" SIZE_FORMAT "K] ", total,
-                        (memory_total*HeapWordSize)/1024);
+    gclog_or_tty->print(" [Symbols=%d size=" SIZE_FORMAT "K] ", _parallel_total,
+                        ((size_t)_parallel_memory_total*HeapWordSize)/1024);
   }
 }
 
+// Remove unreferenced symbols from the symbol table
+// This is done late during GC.
+void SymbolTable::unlink() {
+  clear_parallel_claimed_index();
+  possibly_parallel_unlink();
+  parallel_unlink_done();
+}
+
+void SymbolTable::unlink_incrementally() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  assert(unlinks_incrementally(), "not enabled");
+  const int limit = the_table()->table_size();
+  if (_incremental_idx >= limit) {
+    // A full pass over the table is complete.
+    _resizer->update_counters(the_table(), _incremental_max_chain_length);
+    _incremental_idx = 0;
+    _incremental_max_chain_length = 0;
+  }
+  int start = _incremental_idx;
+  int end = MIN2(limit, start + (int)IncrementalSymbolTableUnlinkBuckets);
+  int removed = 0;
+  int total = 0;
+  size_t memory_total = 0;
+  int max_chain_length = buckets_unlink(start, end, &removed, &total,
+                                        &memory_total);
+  _incremental_max_chain_length = MAX2(_incremental_max_chain_length,
+                                       max_chain_length);
+  _incremental_idx = end;
+  symbols_removed += removed;
+  symbols_counted += total;
+}
+
 
 // Lookup a symbol in a bucket.
 
@@ -156,7 +354,7 @@ Symbol* SymbolTable::lookup(const char* name, int len, TRAPS) {
   if (s != NULL) return s;
 
   // Otherwise, add to symbol to table
-  return the_table()->basic_add(index, (u1*)name, len, hashValue, CHECK_NULL);
+  return the_table()->basic_add((u1*)name, len, hashValue, CHECK_NULL);
 }
 
 Symbol* SymbolTable::lookup(const Symbol* sym, int begin, int end, TRAPS) {
@@ -192,7 +390,7 @@ Symbol* SymbolTable::lookup(const Symbol* sym, int begin, int end, TRAPS) {
   // We can't include the code in No_Safepoint_Verifier because of the
   // ResourceMark.
 
-  return the_table()->basic_add(index, (u1*)buffer, len, hashValue, CHECK_NULL);
+  return the_table()->basic_add((u1*)buffer, len, hashValue, CHECK_NULL);
 }
 
 Symbol* SymbolTable::lookup_only(const char* name, int len,
@@ -247,15 +445,14 @@ void SymbolTable::add(constantPoolHandle cp, int names_count,
   if (!added) {
     // do it the hard way
     for (int i=0; i<names_count; i++) {
-      int index = table->hash_to_index(hashValues[i]);
-      Symbol* sym = table->basic_add(index, (u1*)names[i], lengths[i],
-                                       hashValues[i], CHECK);
+      Symbol* sym = table->basic_add((u1*)names[i], lengths[i],
+                                     hashValues[i], CHECK);
       cp->symbol_at_put(cp_indices[i], sym);
     }
   }
 }
 
-Symbol* SymbolTable::basic_add(int index, u1 *name, int len,
+Symbol* SymbolTable::basic_add(u1 *name, int len,
                                  unsigned int hashValue, TRAPS) {
   assert(!Universe::heap()->is_in_reserved(name) || GC_locker::is_active(),
          "proposed name of symbol must be stable");
@@ -272,6 +469,7 @@ Symbol* SymbolTable::basic_add(int index, u1 *name, int len,
   // Since look-up was done lock-free, we need to check if another
   // thread beat us in the race to insert the symbol.
 
+  int index = hash_to_index(hashValue);
   Symbol* test = lookup(index, (char*)name, len, hashValue);
   if (test != NULL) {
     // A race occurred and another thread introduced the symbol, this one
@@ -284,6 +482,7 @@ Symbol* SymbolTable::basic_add(int index, u1 *name, int len,
   HashtableEntry<Symbol*>* entry = new_entry(hashValue, sym);
   sym->increment_refcount();
   add_entry(index, entry);
+  _resizer->check_load(this);
   return sym;
 }
 
@@ -321,6 +520,7 @@ bool SymbolTable::basic_add(constantPoolHandle cp, int names_count,
       cp->symbol_at_put(cp_indices[i], sym);
     }
   }
+  _resizer->check_load(this);
 
   return true;
 }
@@ -481,6 +681,10 @@ class StableMemoryChecker : public StackObj {
 
 // --------------------------------------------------------------------------
 StringTable* StringTable::_the_table = NULL;
+TableResizer* StringTable::_resizer = NULL;
+
+volatile jint StringTable::_parallel_claimed_idx      = 0;
+volatile jint StringTable::_parallel_max_chain_length = 0;
 
 oop StringTable::lookup(int index, jchar* name,
                         int len, unsigned int hash) {
@@ -495,7 +699,7 @@ oop StringTable::lookup(int index, jchar* name,
 }
 
 
-oop StringTable::basic_add(int index, Handle string_or_null, jchar* name,
+oop StringTable::basic_add(Handle string_or_null, jchar* name,
                            int len, unsigned int hashValue, TRAPS) {
   debug_only(StableMemoryChecker smc(name, len * sizeof(name[0])));
   assert(!Universe::heap()->is_in_reserved(name) || GC_locker::is_active(),
@@ -518,6 +722,7 @@ oop StringTable::basic_add(int index, Handle string_or_null, jchar* name,
   // Since look-up was done lock-free, we need to check if another
   // thread beat us in the race to insert the symbol.
 
+  int index = hash_to_index(hashValue);
   oop test = lookup(index, name, len, hashValue); // calls lookup(u1*, int)
   if (test != NULL) {
     // Entry already added
@@ -526,6 +731,7 @@ oop StringTable::basic_add(int index, Handle string_or_null, jchar* name,
 
   HashtableEntry<oop>* entry = new_entry(hashValue, string());
   add_entry(index, entry);
+  _resizer->check_load(this);
   return string();
 }
 
@@ -550,7 +756,7 @@ oop StringTable::intern(Handle string_or_null, jchar* name,
   if (string != NULL) return string;
 
   // Otherwise, add to symbol to table
-  return the_table()->basic_add(index, string_or_null, name, len,
+  return the_table()->basic_add(string_or_null, name, len,
                                 hashValue, CHECK_NULL);
 }
 
@@ -588,11 +794,15 @@ oop StringTable::intern(const char* utf8_string, TRAPS) {
   return result;
 }
 
-void StringTable::unlink(BoolObjectClosure* is_alive) {
-  // Readers of the table are unlocked, so we should only be removing
-  // entries at a safepoint.
-  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
-  for (int i = 0; i < the_table()->table_size(); ++i) {
+// Remove the dead strings of the buckets [start, end).  Returns the
+// length of the longest chain left.
+int StringTable::buckets_unlink(BoolObjectClosure* is_alive, int start, int end) {
+  BasicHashtableEntry* free_first = NULL;
+  BasicHashtableEntry* free_last = NULL;
+  int removed = 0;
+  int max_chain_length = 0;
+  for (int i = start; i < end; ++i) {
+    int chain_length = 0;
     for (HashtableEntry<oop>** p = the_table()->bucket_addr(i); *p != NULL; ) {
       HashtableEntry<oop>* entry = *p;
       if (entry->is_shared()) {
@@ -600,13 +810,57 @@ void StringTable::unlink(BoolObjectClosure* is_alive) {
       }
       assert(entry->literal() != NULL, "just checking");
       if (is_alive->do_object_b(entry->literal())) {
+        chain_length++;
         p = entry->next_addr();
       } else {
         *p = entry->next();
-        the_table()->free_entry(entry);
+        entry->set_next(free_first);
+        free_first = entry;
+        if (free_last == NULL) {
+          free_last = entry;
+        }
+        removed++;
       }
     }
+    max_chain_length = MAX2(max_chain_length, chain_length);
   }
+  if (free_first != NULL) {
+    the_table()->bulk_free_entries(free_first, free_last, removed);
+  }
+  return max_chain_length;
+}
+
+void StringTable::clear_parallel_claimed_index() {
+  // Readers of the table are unlocked, so we should only be removing
+  // entries at a safepoint.
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  _parallel_claimed_idx = 0;
+  _parallel_max_chain_length = 0;
+}
+
+void StringTable::possibly_parallel_unlink(BoolObjectClosure* is_alive) {
+  const int limit = the_table()->table_size();
+  while (true) {
+    // Grab next set of buckets to scan
+    int start = Atomic::add(ClaimChunkSize, &_parallel_claimed_idx) - ClaimChunkSize;
+    if (start >= limit) {
+      // End of table
+      break;
+    }
+    int end = MIN2(limit, start + ClaimChunkSize);
+    TableResizer::update_max_chain_length(&_parallel_max_chain_length,
+                                          buckets_unlink(is_alive, start, end));
+  }
+}
+
+void StringTable::parallel_unlink_done() {
+  _resizer->update_counters(the_table(), _parallel_max_chain_length);
+}
+
+void StringTable::unlink(BoolObjectClosure* is_alive) {
+  clear_parallel_claimed_index();
+  possibly_parallel_unlink(is_alive);
+  parallel_unlink_done();
 }
 
 void StringTable::oops_do(OopClosure* f) {
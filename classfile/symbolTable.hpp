@@ -27,6 +27,7 @@
 
 #include "memory/allocation.inline.hpp"
 #include "oops/symbol.hpp"
+#include "runtime/perfData.hpp"
 #include "utilities/hashtable.hpp"
 
 // The symbol table holds all Symbol*s and corresponding interned strings.
@@ -34,7 +35,8 @@
 //
 // The interned strings are created lazily.
 //
-// It is implemented as an open hash table with a fixed number of buckets.
+// It is implemented as an open hash table which is grown when its chains
+// get too long (see TableResizer below).
 //
 // %note:
 //  - symbolTableEntrys are allocated in blocks to reduce the space overhead.
@@ -42,6 +44,53 @@
 class BoolObjectClosure;
 
 
+// Support for growing the symbol and string tables.  Both tables are read
+// without locks, so they are only resized at a safepoint: adding an entry
+// which makes the average chain longer than SymbolTableMaxLoad requests a
+// resize, which the cleanup tasks of the next safepoint then perform.
+// Tables whose entries are shared with the archive are never resized.
+//
+// The size of a table, its number of entries, the length of its longest
+// chain and the number and duration of its resizes are exported through
+// PerfData in the sun.rt.<name> name space.  The entry and chain counts
+// are refreshed whenever the whole table is scanned, i.e. on a resize or
+// when the table is unlinked by the GC.
+class TableResizer : public CHeapObj {
+ private:
+  volatile bool _needs_resizing;
+
+  PerfVariable* _perf_size;
+  PerfVariable* _perf_entries;
+  PerfVariable* _perf_max_chain_length;
+  PerfCounter*  _perf_resizes;
+  PerfCounter*  _perf_resize_time;
+
+  static bool can_resize();
+
+ public:
+  enum {
+    max_table_size = 4*M
+  };
+
+  TableResizer(const char* name, BasicHashtable* table);
+
+  bool needs_resizing() const { return _needs_resizing; }
+
+  // Request a resize if the table is overloaded.  Called with the lock
+  // of the table held, after an entry has been added.
+  void check_load(BasicHashtable* table);
+
+  // Grow the table if a resize has been requested.  Called at a safepoint.
+  void resize_if_needed(BasicHashtable* table);
+
+  // Record the state of the table after a scan of all its chains.
+  void update_counters(BasicHashtable* table, int max_chain_length);
+
+  // Raise *dest to length, for the threads unlinking a table in parallel.
+  static void update_max_chain_length(volatile jint* dest, int length);
+};
+
+
 // Class to hold a newly created or referenced Symbol* temporarily in scope.
 // new_symbol() and lookup() will create a Symbol* if not already in the
 // symbol table and add to the symbol's reference count.
@@ -78,16 +127,33 @@ private:
   // The symbol table
   static SymbolTable* _the_table;
 
+  // Growing of the table, with its PerfData counters
+  static TableResizer* _resizer;
+
   // For statistics
   static int symbols_removed;
   static int symbols_counted;
 
+  // Parallel unlinking: the buckets are claimed in chunks.
+  static volatile jint _parallel_claimed_idx;
+  static volatile jint _parallel_max_chain_length;
+  static volatile jint _parallel_removed;
+  static volatile jint _parallel_total;
+  static volatile jint _parallel_memory_total;
+
+  // Incremental unlinking: the next bucket to be scanned.
+  static int _incremental_idx;
+  static int _incremental_max_chain_length;
+
+  static int buckets_unlink(int start, int end, int* removed, int* total,
+                            size_t* memory_total);
+
   Symbol* allocate_symbol(const u1* name, int len, TRAPS);   // Assumes no characters larger than 0x7F
   bool allocate_symbols(int names_count, const u1** names, int* lengths, Symbol** syms, TRAPS);
 
-  // Adding elements
-  Symbol* basic_add(int index, u1* name, int len,
-                      unsigned int hashValue, TRAPS);
+  // Adding elements.  The bucket index is computed once the table lock
+  // is held since the table may have been resized by then.
+  Symbol* basic_add(u1* name, int len, unsigned int hashValue, TRAPS);
   bool basic_add(constantPoolHandle cp, int names_count,
                  const char** names, int* lengths, int* cp_indices,
                  unsigned int* hashValues, TRAPS);
@@ -105,6 +171,11 @@ private:
     symbol_table_size = 20011
   };
 
+  // Number of buckets claimed at a time by the unlinking threads.
+  enum {
+    ClaimChunkSize = 32
+  };
+
   Symbol* lookup(int index, const char* name, int len, unsigned int hash);
 
   SymbolTable()
@@ -126,6 +197,7 @@ public:
   static void create_table() {
     assert(_the_table == NULL, "One symbol table allowed.");
     _the_table = new SymbolTable();
+    _resizer = new TableResizer("symbolTable", _the_table);
   }
 
   static void create_table(HashtableBucket* t, int length,
@@ -134,6 +206,13 @@ public:
     assert(length == symbol_table_size * sizeof(HashtableBucket),
            "bad shared symbol size.");
     _the_table = new SymbolTable(t, number_of_entries);
+    _resizer = new TableResizer("symbolTable", _the_table);
+  }
+
+  // Grow the table if adding symbols made it overloaded.  Called by the
+  // cleanup tasks of a safepoint.
+  static void resize_if_needed() {
+    _resizer->resize_if_needed(the_table());
   }
 
   static Symbol* lookup(const char* name, int len, TRAPS);
@@ -155,6 +234,25 @@ public:
   // Release any dead symbols
   static void unlink();
 
+  // Parallel version of unlink(): every thread of a gang calls
+  // possibly_parallel_unlink(), which claims chunks of buckets until the
+  // whole table has been scanned.  A single thread calls
+  // clear_parallel_claimed_index() before the gang starts and
+  // parallel_unlink_done() once it has finished.  At a safepoint.
+  static void clear_parallel_claimed_index();
+  static void possibly_parallel_unlink();
+  static void parallel_unlink_done();
+
+  // Symbols are freed when they are no longer referenced, independently
+  // of the marking, so the concurrent collectors can leave the scrubbing
+  // of the table to the safepoints: with IncrementalSymbolTableUnlinkBuckets
+  // set, their pauses skip unlink() and the cleanup tasks of every
+  // safepoint scan that many buckets instead.
+  static bool unlinks_incrementally() {
+    return IncrementalSymbolTableUnlinkBuckets > 0;
+  }
+  static void unlink_incrementally();
+
   // iterate over symbols
   static void symbols_do(SymbolClosure *cl);
 
@@ -212,8 +310,22 @@ private:
   // The string table
   static StringTable* _the_table;
 
+  // Growing of the table, with its PerfData counters
+  static TableResizer* _resizer;
+
+  // Parallel unlinking: the buckets are claimed in chunks.
+  enum {
+    ClaimChunkSize = 32
+  };
+  static volatile jint _parallel_claimed_idx;
+  static volatile jint _parallel_max_chain_length;
+
+  static int buckets_unlink(BoolObjectClosure* is_alive, int start, int end);
+
   static oop intern(Handle string_or_null, jchar* chars, int length, TRAPS);
-  oop basic_add(int index, Handle string_or_null, jchar* name, int len,
+  // The bucket index is computed once the table lock is held since the
+  // table may have been resized by then.
+  oop basic_add(Handle string_or_null, jchar* name, int len,
                 unsigned int hashValue, TRAPS);
 
   oop lookup(int index, jchar* chars, int length, unsigned int hashValue);
@@ -232,6 +344,7 @@ public:
   static void create_table() {
     assert(_the_table == NULL, "One string table allowed.");
     _the_table = new StringTable();
+    _resizer = new TableResizer("stringTable", _the_table);
   }
 
   static void create_table(HashtableBucket* t, int length,
@@ -240,12 +353,24 @@ public:
     assert((size_t)length == StringTableSize * sizeof(HashtableBucket),
            "bad shared string size.");
     _the_table = new StringTable(t, number_of_entries);
+    _resizer = new TableResizer("stringTable", _the_table);
+  }
+
+  // Grow the table if interning made it overloaded.  Called by the
+  // cleanup tasks of a safepoint.
+  static void resize_if_needed() {
+    _resizer->resize_if_needed(the_table());
   }
 
   // GC support
   //   Delete pointers to otherwise-unreachable objects.
   static void unlink(BoolObjectClosure* cl);
 
+  // Parallel version of unlink(), used as for the SymbolTable.
+  static void clear_parallel_claimed_index();
+  static void possibly_parallel_unlink(BoolObjectClosure* cl);
+  static void parallel_unlink_done();
+
   // Invoke "f->do_oop" on the locations of all oops in the table.
   static void oops_do(OopClosure* f);
 
@@ -50,6 +50,7 @@
 #include "runtime/java.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/profileSnapshot.hpp"
 #include "runtime/signature.hpp"
 #include "services/classLoadingService.hpp"
 #include "services/threadService.hpp"
@@ -1267,6 +1268,13 @@ instanceKlassHandle SystemDictionary::load_shared_class(
       }
     }
 
+    // Shared classes are linked in the archive, so they never reach the
+    // priming in instanceKlass::link_class_impl; prime them here, once
+    // their methods have their entry points and before any of them runs.
+    if (ProfileSnapshotFile != NULL) {
+      ProfileSnapshot::prime_class(ik());
+    }
+
     if (TraceClassLoading) {
       ResourceMark rm;
       tty->print("[Loaded %s", ik->external_name());
@@ -36,6 +36,7 @@
 #include "oops/methodOop.hpp"
 #include "oops/objArrayOop.hpp"
 #include "oops/oop.inline.hpp"
+#include "runtime/globals_extension.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/icache.hpp"
 #include "runtime/java.hpp"
@@ -109,7 +110,11 @@ class CodeBlob_sizes {
 
 // CodeCache implementation
 
-CodeHeap * CodeCache::_heap = new CodeHeap();
+CodeHeap* CodeCache::_heaps[CodeBlobType::NumTypes] = { NULL, NULL, NULL, NULL };
+int CodeCache::_number_of_heaps = 0;
+CodeHeap* CodeCache::_heap = NULL;
+address CodeCache::_low_bound = NULL;
+address CodeCache::_high_bound = NULL;
 int CodeCache::_number_of_blobs = 0;
 int CodeCache::_number_of_adapters = 0;
 int CodeCache::_number_of_nmethods = 0;
@@ -119,15 +124,61 @@ nmethod* CodeCache::_scavenge_root_nmethods = NULL;
 nmethod* CodeCache::_saved_nmethods = NULL;
 
 
+int CodeCache::heap_index(const void* p) {
+  for (int i = 0; i < _number_of_heaps; i++) {
+    if (_heaps[i]->contains((void*)p)) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+
+CodeHeap* CodeCache::get_code_heap(int code_blob_type) {
+  assert(0 <= code_blob_type && code_blob_type < CodeBlobType::NumTypes, "bad type");
+  if (!SegmentedCodeCache) {
+    // Everything lives in the single CodeHeap
+    return _heaps[0];
+  }
+  for (int i = 0; i < _number_of_heaps; i++) {
+    if (_heaps[i]->code_blob_type() == code_blob_type) {
+      return _heaps[i];
+    }
+  }
+  // There is no profiled CodeHeap without tiered compilation (see
+  // initialize_heaps()); profiled nmethods, if any, go with the others.
+  assert(code_blob_type == CodeBlobType::MethodProfiled, "missing CodeHeap");
+  return get_code_heap(CodeBlobType::MethodNonProfiled);
+}
+
+
+CodeBlob* CodeCache::first_blob(int heap_index, bool nmethods_only) {
+  for (int i = heap_index; i < _number_of_heaps; i++) {
+    if (nmethods_only && !heap_contains_nmethods(_heaps[i])) continue;
+    CodeBlob* cb = (CodeBlob*)_heaps[i]->first();
+    if (cb != NULL) return cb;
+  }
+  return NULL;
+}
+
+
+CodeBlob* CodeCache::next_blob(CodeBlob* cb, bool nmethods_only) {
+  int i = heap_index(cb);
+  assert(i >= 0, "not in the code cache");
+  CodeBlob* next = (CodeBlob*)_heaps[i]->next(cb);
+  return next != NULL ? next : first_blob(i + 1, nmethods_only);
+}
+
+
 CodeBlob* CodeCache::first() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->first();
+  return first_blob(0, false);
 }
 
 
 CodeBlob* CodeCache::next(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (CodeBlob*)_heap->next(cb);
+  return next_blob(cb, false);
 }
 
 
@@ -138,31 +189,55 @@ CodeBlob* CodeCache::alive(CodeBlob *cb) {
 }
 
 
+CodeBlob* CodeCache::alive_method(CodeBlob *cb) {
+  assert_locked_or_safepoint(CodeCache_lock);
+  while (cb != NULL && !cb->is_alive()) cb = next_method(cb);
+  return cb;
+}
+
+
 nmethod* CodeCache::alive_nmethod(CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  while (cb != NULL && (!cb->is_alive() || !cb->is_nmethod())) cb = next(cb);
+  while (cb != NULL && (!cb->is_alive() || !cb->is_nmethod())) cb = next_method(cb);
   return (nmethod*)cb;
 }
 
 nmethod* CodeCache::first_nmethod() {
   assert_locked_or_safepoint(CodeCache_lock);
-  CodeBlob* cb = first();
+  CodeBlob* cb = first_method();
   while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
+    cb = next_method(cb);
   }
   return (nmethod*)cb;
 }
 
 nmethod* CodeCache::next_nmethod (CodeBlob* cb) {
   assert_locked_or_safepoint(CodeCache_lock);
-  cb = next(cb);
+  cb = next_method(cb);
   while (cb != NULL && !cb->is_nmethod()) {
-    cb = next(cb);
+    cb = next_method(cb);
   }
   return (nmethod*)cb;
 }
 
-CodeBlob* CodeCache::allocate(int size) {
+CodeBlob* CodeCache::allocate_in(CodeHeap* heap, int size) {
+  while (true) {
+    CodeBlob* cb = (CodeBlob*)heap->allocate(size);
+    if (cb != NULL) return cb;
+    if (!heap->expand_by(CodeCacheExpansionSize)) {
+      // Expansion failed
+      return NULL;
+    }
+    if (PrintCodeCacheExtension) {
+      ResourceMark rm;
+      tty->print_cr("%s extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (%d bytes)",
+                    heap->name(), (intptr_t)heap->begin(), (intptr_t)heap->end(),
+                    (address)heap->end() - (address)heap->begin());
+    }
+  }
+}
+
+CodeBlob* CodeCache::allocate(int size, int code_blob_type) {
   // Do not seize the CodeCache lock here--if the caller has not
   // already done so, we are going to lose bigtime, since the code
   // cache will contain a garbage CodeBlob until the caller can
@@ -170,22 +245,31 @@ CodeBlob* CodeCache::allocate(int size) {
   // instantiating.
   guarantee(size >= 0, "allocation request must be reasonable");
   assert_locked_or_safepoint(CodeCache_lock);
-  CodeBlob* cb = NULL;
-  _number_of_blobs++;
-  while (true) {
-    cb = (CodeBlob*)_heap->allocate(size);
-    if (cb != NULL) break;
-    if (!_heap->expand_by(CodeCacheExpansionSize)) {
-      // Expansion failed
-      return NULL;
-    }
-    if (PrintCodeCacheExtension) {
-      ResourceMark rm;
-      tty->print_cr("code cache extended to [" INTPTR_FORMAT ", " INTPTR_FORMAT "] (%d bytes)",
-                    (intptr_t)_heap->begin(), (intptr_t)_heap->end(),
-                    (address)_heap->end() - (address)_heap->begin());
+  CodeHeap* heap = get_code_heap(code_blob_type);
+  CodeBlob* cb = allocate_in(heap, size);
+  if (cb == NULL && SegmentedCodeCache) {
+    // The preferred CodeHeap is full; rather than failing (and eventually
+    // disabling the compiler) while there is room left elsewhere, try the
+    // method CodeHeaps. nmethods never go to the NonMethod CodeHeap since
+    // the sweeper and the nmethod iterators skip it.
+    const int fallbacks[] = { CodeBlobType::MethodNonProfiled, CodeBlobType::MethodProfiled };
+    CodeHeap* tried = heap;
+    for (int i = 0; i < 2 && cb == NULL; i++) {
+      CodeHeap* other = get_code_heap(fallbacks[i]);
+      if (other == heap || other == tried) {
+        continue;
+      }
+      if (PrintCodeCacheExtension) {
+        tty->print_cr("%s is full, allocating %d bytes in %s", heap->name(), size, other->name());
+      }
+      cb = allocate_in(other, size);
+      tried = other;
     }
   }
+  if (cb == NULL) {
+    return NULL;
+  }
+  _number_of_blobs++;
   verify_if_often();
   print_trace("allocation", cb, size);
   return cb;
@@ -207,7 +291,7 @@ void CodeCache::free(CodeBlob* cb) {
   }
   _number_of_blobs--;
 
-  _heap->deallocate(cb);
+  _heaps[heap_index(cb)]->deallocate(cb);
 
   verify_if_often();
   assert(_number_of_blobs >= 0, "sanity check");
@@ -242,12 +326,14 @@ void CodeCache::flush() {
 
 #define FOR_ALL_BLOBS(var)       for (CodeBlob *var =       first() ; var != NULL; var =       next(var) )
 #define FOR_ALL_ALIVE_BLOBS(var) for (CodeBlob *var = alive(first()); var != NULL; var = alive(next(var)))
-#define FOR_ALL_ALIVE_NMETHODS(var) for (nmethod *var = alive_nmethod(first()); var != NULL; var = alive_nmethod(next(var)))
+#define FOR_ALL_METHOD_BLOBS(var)       for (CodeBlob *var =              first_method() ; var != NULL; var =              next_method(var) )
+#define FOR_ALL_ALIVE_METHOD_BLOBS(var) for (CodeBlob *var = alive_method(first_method()); var != NULL; var = alive_method(next_method(var)))
+#define FOR_ALL_ALIVE_NMETHODS(var) for (nmethod *var = alive_nmethod(first_method()); var != NULL; var = alive_nmethod(next_method(var)))
 
 
 bool CodeCache::contains(void *p) {
   // It should be ok to call contains without holding a lock
-  return _heap->contains(p);
+  return heap_index(p) >= 0;
 }
 
 
@@ -279,19 +365,19 @@ void CodeCache::blobs_do(void f(CodeBlob* nm)) {
 
 void CodeCache::nmethods_do(void f(nmethod* nm)) {
   assert_locked_or_safepoint(CodeCache_lock);
-  FOR_ALL_BLOBS(nm) {
+  FOR_ALL_METHOD_BLOBS(nm) {
     if (nm->is_nmethod()) f((nmethod*)nm);
   }
 }
 
 
 int CodeCache::alignment_unit() {
-  return (int)_heap->alignment_unit();
+  return (int)_heaps[0]->alignment_unit();
 }
 
 
 int CodeCache::alignment_offset() {
-  return (int)_heap->alignment_offset();
+  return (int)_heaps[0]->alignment_offset();
 }
 
 
@@ -306,9 +392,11 @@ void CodeCache::do_unloading(BoolObjectClosure* is_alive,
   }
 }
 
+// Only nmethods have oops; CodeBlobClosures ignore the other blobs, so
+// the CodeHeap for non-method code is not walked.
 void CodeCache::blobs_do(CodeBlobClosure* f) {
   assert_locked_or_safepoint(CodeCache_lock);
-  FOR_ALL_ALIVE_BLOBS(cb) {
+  FOR_ALL_ALIVE_METHOD_BLOBS(cb) {
     f->do_code_blob(cb);
 
 #ifdef ASSERT
@@ -566,13 +654,166 @@ void CodeCache::verify_oops() {
 
 address CodeCache::first_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->begin();
+  address first = NULL;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    address begin = (address)_heaps[i]->begin();
+    if (first == NULL || begin < first) first = begin;
+  }
+  return first;
 }
 
 
 address CodeCache::last_address() {
   assert_locked_or_safepoint(CodeCache_lock);
-  return (address)_heap->end();
+  address last = NULL;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    address end = (address)_heaps[i]->end();
+    if (last == NULL || end > last) last = end;
+  }
+  return last;
+}
+
+
+size_t CodeCache::capacity() {
+  size_t cap = 0;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    cap += _heaps[i]->capacity();
+  }
+  return cap;
+}
+
+
+size_t CodeCache::max_capacity() {
+  size_t max_cap = 0;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    max_cap += _heaps[i]->max_capacity();
+  }
+  return max_cap;
+}
+
+
+size_t CodeCache::unallocated_capacity() {
+  size_t unallocated_cap = 0;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    unallocated_cap += _heaps[i]->unallocated_capacity();
+  }
+  return unallocated_cap;
+}
+
+
+bool CodeCache::needs_flushing() {
+  // The sweeper only reclaims nmethods, so only the CodeHeaps that
+  // contain them are considered.
+  for (int i = 0; i < _number_of_heaps; i++) {
+    if (heap_contains_nmethods(_heaps[i]) &&
+        largest_free_block(_heaps[i]->code_blob_type()) < CodeCacheFlushingMinimumFreeSpace) {
+      return true;
+    }
+  }
+  return false;
+}
+
+
+void CodeCache::add_heap(ReservedSpace rs, const char* name, size_t committed_size, int code_blob_type) {
+  assert(_number_of_heaps < CodeBlobType::NumTypes, "too many CodeHeaps");
+  CodeHeap* heap = new CodeHeap(name, code_blob_type);
+  committed_size = MIN2(MAX2(committed_size, (size_t)os::vm_page_size()), rs.size());
+  if (!heap->reserve(rs, committed_size, CodeCacheSegmentSize)) {
+    vm_exit_during_initialization("Could not reserve enough space for code cache", name);
+  }
+  if (_number_of_heaps == 0) {
+    _heap = heap;
+  }
+  _heaps[_number_of_heaps++] = heap;
+
+  MemoryService::add_code_heap_memory_pool(heap, name);
+}
+
+
+// Splits ReservedCodeCacheSize into the CodeHeaps for non-method code,
+// profiled nmethods and non-profiled nmethods.  Sizes that are not set on
+// the command line are chosen ergonomically: the non-method code (mostly
+// stubs and adapters, whose footprint does not depend on the application)
+// gets a small fixed share and the rest is shared by the nmethods.  There
+// is no profiled code without tiered compilation, so the profiled CodeHeap
+// is not created in that case.
+void CodeCache::initialize_heaps() {
+  bool non_method_set    = !FLAG_IS_DEFAULT(NonMethodCodeHeapSize)    && NonMethodCodeHeapSize > 0;
+  bool profiled_set      = !FLAG_IS_DEFAULT(ProfiledCodeHeapSize)      && ProfiledCodeHeapSize > 0;
+  bool non_profiled_set  = !FLAG_IS_DEFAULT(NonProfiledCodeHeapSize)   && NonProfiledCodeHeapSize > 0;
+  size_t page_size = os::vm_page_size();
+
+  if (non_method_set && profiled_set && non_profiled_set &&
+      FLAG_IS_DEFAULT(ReservedCodeCacheSize)) {
+    FLAG_SET_ERGO(uintx, ReservedCodeCacheSize,
+                  NonMethodCodeHeapSize + ProfiledCodeHeapSize + NonProfiledCodeHeapSize);
+  }
+  size_t total = ReservedCodeCacheSize;
+
+  size_t non_method_size = non_method_set ? NonMethodCodeHeapSize :
+    MIN2(MAX2((size_t)2*M, total / 16), total / 4);
+  non_method_size = round_to(non_method_size, page_size);
+  if (non_method_size >= total) {
+    vm_exit_during_initialization("NonMethodCodeHeapSize is larger than ReservedCodeCacheSize");
+  }
+
+  size_t rest = total - non_method_size;
+  size_t profiled_size = 0;
+  if (TieredCompilation) {
+    profiled_size = profiled_set ? ProfiledCodeHeapSize :
+      (non_profiled_set && NonProfiledCodeHeapSize < rest ? rest - NonProfiledCodeHeapSize : rest / 2);
+    profiled_size = round_to(profiled_size, page_size);
+  }
+  if (profiled_size >= rest) {
+    vm_exit_during_initialization("Code heap sizes are larger than ReservedCodeCacheSize");
+  }
+  size_t non_profiled_size = rest - profiled_size;
+  if (non_profiled_set && non_profiled_size < NonProfiledCodeHeapSize) {
+    vm_exit_during_initialization("Code heap sizes are larger than ReservedCodeCacheSize");
+  }
+
+  FLAG_SET_ERGO(uintx, NonMethodCodeHeapSize, non_method_size);
+  FLAG_SET_ERGO(uintx, ProfiledCodeHeapSize, profiled_size);
+  FLAG_SET_ERGO(uintx, NonProfiledCodeHeapSize, non_profiled_size);
+
+  // Reserve the code cache in one piece so that all code stays within
+  // branch range, then carve it up into the individual CodeHeaps.
+  size_t rs_page_size;
+  ReservedSpace rs = CodeHeap::reserve_code_space(total, InitialCodeCacheSize, &rs_page_size);
+  if (!rs.is_reserved()) {
+    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  }
+  size_t alignment = MAX2(rs.alignment(), (size_t)os::vm_allocation_granularity());
+  non_method_size = align_size_up(non_method_size, alignment);
+  profiled_size   = align_size_down(profiled_size, alignment);
+  if (non_method_size + profiled_size >= rs.size()) {
+    vm_exit_during_initialization("Could not reserve enough space for code cache");
+  }
+
+  // Initially commit a share of InitialCodeCacheSize proportional to
+  // the size of each CodeHeap.
+  double initial_ratio = (double)InitialCodeCacheSize / (double)rs.size();
+
+  // Layout: [ profiled | non-method | non-profiled ]
+  ReservedSpace profiled_space     = rs.first_part(profiled_size);
+  ReservedSpace rest_space         = rs.last_part(profiled_size);
+  ReservedSpace non_method_space   = rest_space.first_part(non_method_size);
+  ReservedSpace non_profiled_space = rest_space.last_part(non_method_size);
+
+  add_heap(non_profiled_space, "Code Heap 'non-profiled nmethods'",
+           align_size_up((size_t)(non_profiled_space.size() * initial_ratio), rs_page_size),
+           CodeBlobType::MethodNonProfiled);
+  if (profiled_size > 0) {
+    add_heap(profiled_space, "Code Heap 'profiled nmethods'",
+             align_size_up((size_t)(profiled_space.size() * initial_ratio), rs_page_size),
+             CodeBlobType::MethodProfiled);
+  }
+  add_heap(non_method_space, "Code Heap 'non-nmethods'",
+           align_size_up((size_t)(non_method_space.size() * initial_ratio), rs_page_size),
+           CodeBlobType::NonMethod);
+
+  _low_bound  = (address)rs.base();
+  _high_bound = (address)rs.base() + rs.size();
 }
 
 
@@ -590,11 +831,20 @@ void CodeCache::initialize() {
   CodeCacheExpansionSize = round_to(CodeCacheExpansionSize, os::vm_page_size());
   InitialCodeCacheSize = round_to(InitialCodeCacheSize, os::vm_page_size());
   ReservedCodeCacheSize = round_to(ReservedCodeCacheSize, os::vm_page_size());
-  if (!_heap->reserve(ReservedCodeCacheSize, InitialCodeCacheSize, CodeCacheSegmentSize)) {
-    vm_exit_during_initialization("Could not reserve enough space for code cache");
-  }
+  if (SegmentedCodeCache) {
+    initialize_heaps();
+  } else {
+    CodeHeap* heap = new CodeHeap("Code Cache", CodeBlobType::All);
+    if (!heap->reserve(ReservedCodeCacheSize, InitialCodeCacheSize, CodeCacheSegmentSize)) {
+      vm_exit_during_initialization("Could not reserve enough space for code cache");
+    }
+    _heap = heap;
+    _heaps[_number_of_heaps++] = heap;
+    _low_bound  = (address)heap->low_boundary();
+    _high_bound = (address)heap->high_boundary();
 
-  MemoryService::add_code_heap_memory_pool(_heap);
+    MemoryService::add_code_heap_memory_pool(heap, heap->name());
+  }
 
   // Initialize ICache flush mechanism
   // This service is needed for os::register_code_area
@@ -603,7 +853,7 @@ void CodeCache::initialize() {
   // Give OS a chance to register generated code area.
   // This is used on Windows 64 bit platforms to register
   // Structured Exception Handlers for our generated code.
-  os::register_code_area(_heap->low_boundary(), _heap->high_boundary());
+  os::register_code_area((char*)_low_bound, (char*)_high_bound);
 }
 
 
@@ -767,7 +1017,9 @@ void CodeCache::make_marked_nmethods_not_entrant() {
 }
 
 void CodeCache::verify() {
-  _heap->verify();
+  for (int i = 0; i < _number_of_heaps; i++) {
+    _heaps[i]->verify();
+  }
   FOR_ALL_ALIVE_BLOBS(p) {
     p->verify();
   }
@@ -780,7 +1032,9 @@ void CodeCache::verify() {
 
 void CodeCache::verify_if_often() {
   if (VerifyCodeCacheOften) {
-    _heap->verify();
+    for (int i = 0; i < _number_of_heaps; i++) {
+      _heaps[i]->verify();
+    }
   }
 }
 
@@ -950,10 +1204,14 @@ void CodeCache::print() {
 #endif // PRODUCT
 
 void CodeCache::print_bounds(outputStream* st) {
-  st->print_cr("Code Cache  [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT ")",
-               _heap->low_boundary(),
-               _heap->high(),
-               _heap->high_boundary());
+  for (int i = 0; i < _number_of_heaps; i++) {
+    CodeHeap* heap = _heaps[i];
+    st->print_cr("%s  [" INTPTR_FORMAT ", " INTPTR_FORMAT ", " INTPTR_FORMAT ")",
+                 heap->name(),
+                 heap->low_boundary(),
+                 heap->high(),
+                 heap->high_boundary());
+  }
   st->print_cr(" total_blobs=" UINT32_FORMAT " nmethods=" UINT32_FORMAT
                " adapters=" UINT32_FORMAT " free_code_cache=" SIZE_FORMAT "Kb"
                " largest_free_block=" SIZE_FORMAT,
@@ -969,13 +1227,26 @@ void CodeCache::log_state(outputStream* st) {
             unallocated_capacity(), largest_free_block());
 }
 
-size_t CodeCache::largest_free_block() {
+size_t CodeCache::largest_free_block(int code_blob_type) {
   // This is called both with and without CodeCache_lock held so
   // handle both cases.
   if (CodeCache_lock->owned_by_self()) {
-    return _heap->largest_free_block();
+    return largest_free_block_locked(code_blob_type);
   } else {
     MutexLockerEx mu(CodeCache_lock, Mutex::_no_safepoint_check_flag);
-    return _heap->largest_free_block();
+    return largest_free_block_locked(code_blob_type);
+  }
+}
+
+size_t CodeCache::largest_free_block_locked(int code_blob_type) {
+  if (code_blob_type != CodeBlobType::All) {
+    return get_code_heap(code_blob_type)->largest_free_block();
+  }
+  size_t largest = 0;
+  for (int i = 0; i < _number_of_heaps; i++) {
+    if (heap_contains_nmethods(_heaps[i])) {
+      largest = MAX2(largest, _heaps[i]->largest_free_block());
+    }
   }
+  return largest;
 }
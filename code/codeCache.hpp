@@ -39,6 +39,18 @@
 //   - Each CodeBlob occupies one chunk of memory.
 //   - Like the offset table in oldspace the zone has at table for
 //     locating a method given a addess of an instruction.
+//
+// Code cache segmentation (-XX:+SegmentedCodeCache):
+//   The code cache is divided into separate code heaps, each of them
+//   containing CodeBlobs of a specific CodeBlobType:
+//   - Non-method code (buffers, adapters and runtime stubs)
+//   - Profiled nmethods (tiered levels 2 and 3)
+//   - Non-profiled nmethods (tiered levels 1 and 4, and native wrappers)
+//   The code heaps share one contiguous reservation, laid out as
+//   [profiled | non-method | non-profiled], so that stubs are close to
+//   all of the compiled code.  Iteration over nmethods (and hence the
+//   sweeper) skips the non-method code heap.  Without segmentation there
+//   is a single code heap of CodeBlobType::All.
 
 class OopClosure;
 class DepChange;
@@ -46,11 +58,20 @@ class DepChange;
 class CodeCache : AllStatic {
   friend class VMStructs;
  private:
-  // CodeHeap is malloc()'ed at startup and never deleted during shutdown,
+  // CodeHeaps are malloc()'ed at startup and never deleted during shutdown,
   // so that the generated assembly code is always there when it's needed.
   // This may cause memory leak, but is necessary, for now. See 4423824,
   // 4422213 or 4436291 for details.
-  static CodeHeap * _heap;
+  static CodeHeap* _heaps[CodeBlobType::NumTypes];
+  static int       _number_of_heaps;
+  // The first CodeHeap, which is the whole code cache unless
+  // SegmentedCodeCache is set.  Kept for serviceability agents that only
+  // know of a single CodeHeap; with a segmented code cache the agent has
+  // to walk the first _number_of_heaps entries of _heaps, which are all
+  // exported, to find every CodeBlob.
+  static CodeHeap* _heap;
+  static address   _low_bound;                    // lower bound of all CodeHeaps
+  static address   _high_bound;                   // upper bound of all CodeHeaps
   static int _number_of_blobs;
   static int _number_of_adapters;
   static int _number_of_nmethods;
@@ -64,13 +85,39 @@ class CodeCache : AllStatic {
   static void mark_scavenge_root_nmethods() PRODUCT_RETURN;
   static void verify_perm_nmethods(CodeBlobClosure* f_or_null) PRODUCT_RETURN;
 
+  // CodeHeap management
+  static void initialize_heaps();                         // initializes the CodeHeaps
+  static void add_heap(ReservedSpace rs, const char* name, size_t committed_size, int code_blob_type);
+  static bool heap_contains_nmethods(CodeHeap* heap) {
+    return heap->code_blob_type() != CodeBlobType::NonMethod;
+  }
+  static int  heap_index(const void* p);                  // index of the CodeHeap containing p, or -1
+  static CodeHeap* get_code_heap(int code_blob_type);     // returns the CodeHeap for the given CodeBlobType
+  static size_t largest_free_block_locked(int code_blob_type);
+  static CodeBlob* allocate_in(CodeHeap* heap, int size);  // allocates in heap, expanding it if needed
+
+  // Iteration helpers; the heaps that cannot contain nmethods are skipped
+  // if nmethods_only is set.
+  static CodeBlob* first_blob(int heap_index, bool nmethods_only);
+  static CodeBlob* next_blob(CodeBlob* cb, bool nmethods_only);
+  static CodeBlob* first_method()                { return first_blob(0, true); }
+  static CodeBlob* next_method(CodeBlob* cb)     { return next_blob(cb, true); }
+  static CodeBlob* alive_method(CodeBlob* cb);  // first alive CodeBlob at or after cb in the nmethod CodeHeaps
+
  public:
 
   // Initialization
   static void initialize();
 
+  // Returns the CodeBlobType of the nmethods compiled at comp_level
+  static int get_code_blob_type(int comp_level) {
+    return (comp_level == CompLevel_limited_profile ||
+            comp_level == CompLevel_full_profile) ?
+      CodeBlobType::MethodProfiled : CodeBlobType::MethodNonProfiled;
+  }
+
   // Allocation/administration
-  static CodeBlob* allocate(int size);              // allocates a new CodeBlob
+  static CodeBlob* allocate(int size, int code_blob_type);  // allocates a new CodeBlob
   static void commit(CodeBlob* cb);                 // called when the allocated CodeBlob has been filled
   static int alignment_unit();                      // guaranteed alignment of all CodeBlobs
   static int alignment_offset();                    // guaranteed offset of first CodeBlob byte within alignment unit (i.e., allocation header)
@@ -88,7 +135,9 @@ class CodeCache : AllStatic {
   // Lookup that does not fail if you lookup a zombie method (if you call this, be sure to know
   // what you are doing)
   static CodeBlob* find_blob_unsafe(void* start) {
-    CodeBlob* result = (CodeBlob*)_heap->find_start(start);
+    int i = heap_index(start);
+    if (i < 0) return NULL;
+    CodeBlob* result = (CodeBlob*)_heaps[i]->find_start(start);
     // this assert is too strong because the heap code will return the
     // heapblock containing start. That block can often be larger than
     // the codeBlob itself. If you look up an address that is within
@@ -151,17 +200,19 @@ class CodeCache : AllStatic {
   static void log_state(outputStream* st);
 
   // The full limits of the codeCache
-  static address  low_bound()                    { return (address) _heap->low_boundary(); }
-  static address  high_bound()                   { return (address) _heap->high_boundary(); }
+  static address  low_bound()                    { return _low_bound; }
+  static address  high_bound()                   { return _high_bound; }
 
   // Profiling
   static address first_address();                // first address used for CodeBlobs
   static address last_address();                 // last  address used for CodeBlobs
-  static size_t  capacity()                      { return _heap->capacity(); }
-  static size_t  max_capacity()                  { return _heap->max_capacity(); }
-  static size_t  unallocated_capacity()          { return _heap->unallocated_capacity(); }
-  static size_t  largest_free_block();
-  static bool    needs_flushing()                { return largest_free_block() < CodeCacheFlushingMinimumFreeSpace; }
+  static size_t  capacity();
+  static size_t  max_capacity();
+  static size_t  unallocated_capacity();
+  // The largest free block of the CodeHeap for code_blob_type; for
+  // CodeBlobType::All, the largest free block available to nmethods.
+  static size_t  largest_free_block(int code_blob_type = CodeBlobType::All);
+  static bool    needs_flushing();
 
   static bool needs_cache_clean()                { return _needs_cache_clean; }
   static void set_needs_cache_clean(bool v)      { _needs_cache_clean = v;    }
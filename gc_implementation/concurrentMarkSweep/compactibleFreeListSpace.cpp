@@ -35,12 +35,16 @@
 #include "memory/resourceArea.hpp"
 #include "memory/universe.inline.hpp"
 #include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/globals.hpp"
 #include "runtime/handles.inline.hpp"
 #include "runtime/init.hpp"
 #include "runtime/java.hpp"
+#include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
 #include "runtime/vmThread.hpp"
 #include "utilities/copy.hpp"
+#include "utilities/workgroup.hpp"
 
 /////////////////////////////////////////////////////////////////////////
 //// CompactibleFreeListSpace
@@ -85,7 +89,11 @@ CompactibleFreeListSpace::CompactibleFreeListSpace(BlockOffsetSharedArray* bs,
                     CMSRescanMultiple),
   _marking_task_size(CardTableModRefBS::card_size_in_words * BitsPerWord *
                     CMSConcMarkMultiple),
-  _collector(NULL)
+  _collector(NULL),
+  _par_compaction(false),
+  _compaction_partitions(NULL),
+  _max_compaction_partitions(0),
+  _n_compaction_partitions(0)
 {
   _bt.set_space(this);
   initialize(mr, SpaceDecorator::Clear, SpaceDecorator::Mangle);
@@ -2095,6 +2103,11 @@ bool CompactibleFreeListSpace::should_concurrent_collect() const {
 // Support for compaction
 
 void CompactibleFreeListSpace::prepare_for_compaction(CompactPoint* cp) {
+  if (_par_compaction) {
+    par_prepare_for_compaction(cp);
+    return;
+  }
+  _n_compaction_partitions = 0;
   SCAN_AND_FORWARD(cp,end,block_is_obj,block_size);
   // prepare_for_compaction() uses the space between live objects
   // so that later phase can skip dead space quickly.  So verification
@@ -2111,14 +2124,423 @@ void CompactibleFreeListSpace::adjust_pointers() {
   // Cannot test used() == 0 here because the free lists have already
   // been mangled by the compaction.
 
+  if (_n_compaction_partitions > 0) {
+    par_adjust_pointers();
+    return;
+  }
   SCAN_AND_ADJUST_POINTERS(adjust_obj_size);
   // See note about verification in prepare_for_compaction().
 }
 
 void CompactibleFreeListSpace::compact() {
+  if (_n_compaction_partitions > 0) {
+    par_compact();
+    return;
+  }
   SCAN_AND_COMPACT(obj_size);
 }
 
+// Parallel compaction.
+//
+// The space is divided into partitions of about the same size, starting
+// and ending at block boundaries, and each partition is claimed by one
+// worker in every phase.  The new addresses are those of a serial
+// compaction: the live objects of a partition are moved right after the
+// ones of the partition below it, and the free space is left in a single
+// chunk at the top of the space.  To that end the addresses are computed
+// in two steps.  The first partition is forwarded while the live words of
+// the others are counted; the destination of each partition then follows
+// from the ones below it, and the other partitions are forwarded.  Dead
+// space is only kept in the first partition, where a serial compaction
+// finds the objects that do not move.  The objects of the younger
+// generations are compacted after the ones of the last partition.
+//
+// An object never moves up, so the objects of a partition are only ever
+// copied over the partitions below it or over itself.  Before it copies an
+// object, a worker waits until the partitions below whose objects are
+// still to be copied out of the destination have been compacted (see
+// compact_partition()).  The partitions are claimed in address order, so
+// a partition only waits on partitions already claimed by running workers.
+
+// The number of partitions per worker; more partitions balance the load
+// better.
+static const int CFLSCompactionPartitionsPerWorker = 4;
+
+class CFLSParCompactionTask: public AbstractGangTask {
+ public:
+  enum Phase {
+    LiveWordsPhase,
+    ForwardPhase,
+    AdjustPointersPhase,
+    CompactPhase
+  };
+
+ private:
+  CompactibleFreeListSpace* _sp;
+  Phase                     _phase;
+  size_t                    _allowed_deadspace;
+  volatile jint             _next_partition;
+
+ public:
+  CFLSParCompactionTask(CompactibleFreeListSpace* sp, Phase phase,
+                        size_t allowed_deadspace) :
+    AbstractGangTask("CMS Parallel Compaction"),
+    _sp(sp), _phase(phase), _allowed_deadspace(allowed_deadspace),
+    _next_partition(0) { }
+
+  void work(int i) {
+    int n = _sp->n_compaction_partitions();
+    for (int k = Atomic::add(1, &_next_partition) - 1;
+         k < n;
+         k = Atomic::add(1, &_next_partition) - 1) {
+      CFLSCompactionPartition* part = _sp->compaction_partition(k);
+      switch (_phase) {
+        case LiveWordsPhase:
+          // The first partition is forwarded right away; its destination
+          // is the bottom of the space.
+          if (k == 0) {
+            _sp->forward_partition(part, _allowed_deadspace);
+          } else {
+            _sp->compute_live_words(part);
+          }
+          break;
+        case ForwardPhase:
+          if (k > 0) {
+            _sp->forward_partition(part, 0);
+          }
+          break;
+        case AdjustPointersPhase:
+          _sp->adjust_pointers_in_partition(part);
+          break;
+        case CompactPhase:
+          _sp->compact_partition(k);
+          break;
+        default:
+          ShouldNotReachHere();
+      }
+    }
+  }
+};
+
+int CompactibleFreeListSpace::compute_compaction_partitions(int n) {
+  assert(n > 0 && n <= _max_compaction_partitions, "too many partitions");
+  size_t partition_size = pointer_delta(end(), bottom()) / n;
+  int k = 0;
+  _compaction_partitions[0]._bottom = bottom();
+  for (int i = 1; i < n; i++) {
+    // Move the boundary up to the first block starting at or above
+    // the ideal one.
+    HeapWord* addr = bottom() + i * partition_size;
+    HeapWord* boundary = block_start(addr);
+    if (boundary < addr) {
+      boundary += block_size(boundary);
+    }
+    if (boundary <= _compaction_partitions[k]._bottom || boundary >= end()) {
+      // A block spans the ideal boundary of more than one partition.
+      continue;
+    }
+    _compaction_partitions[k]._end = boundary;
+    k++;
+    _compaction_partitions[k]._bottom = boundary;
+  }
+  _compaction_partitions[k]._end = end();
+  return k + 1;
+}
+
+void CompactibleFreeListSpace::par_prepare_for_compaction(CompactPoint* cp) {
+  // The space is the first one compacted, and it is only compacted into.
+  assert(cp->space == NULL && cp->gen->first_compaction_space() == this,
+         "the CMS generation is the first to be compacted");
+  FlexibleWorkGang* workers = GenCollectedHeap::heap()->workers();
+  assert(workers != NULL, "need the parallel GC threads");
+  int n_workers = workers->total_workers();
+
+  if (_compaction_partitions == NULL) {
+    _max_compaction_partitions = n_workers * CFLSCompactionPartitionsPerWorker;
+    _compaction_partitions =
+      NEW_C_HEAP_ARRAY(CFLSCompactionPartition, _max_compaction_partitions);
+  }
+  // The partitions are computed from the block offset table, which has
+  // to be read before it is updated for the new object addresses.
+  _n_compaction_partitions =
+    compute_compaction_partitions(_max_compaction_partitions);
+
+  // See SCAN_AND_FORWARD() for the dead space allowance.
+  int invocations = SharedHeap::heap()->perm_gen()->stat_record()->invocations;
+  bool skip_dead = ((invocations % MarkSweepAlwaysCompactCount) != 0);
+  size_t allowed_deadspace = 0;
+  if (skip_dead) {
+    const size_t ratio = allowed_dead_ratio();
+    allowed_deadspace = (capacity() * ratio / 100) / HeapWordSize;
+  }
+
+  CFLSCompactionPartition* first = &_compaction_partitions[0];
+  first->_destination = bottom();
+  CFLSParCompactionTask live_words_task(this,
+                                        CFLSParCompactionTask::LiveWordsPhase,
+                                        allowed_deadspace);
+  workers->run_task(&live_words_task);
+
+  // Every partition is compacted right after the one below it.
+  first->_live_words = pointer_delta(first->_compaction_top, bottom());
+  HeapWord* end_of_live = first->_end_of_live;
+  for (int i = 1; i < _n_compaction_partitions; i++) {
+    CFLSCompactionPartition* prev = &_compaction_partitions[i - 1];
+    CFLSCompactionPartition* part = &_compaction_partitions[i];
+    part->_destination = prev->_destination + prev->_live_words;
+    assert(part->_destination <= part->_bottom, "objects never move up");
+  }
+  if (_n_compaction_partitions > 1) {
+    CFLSParCompactionTask forward_task(this,
+                                       CFLSParCompactionTask::ForwardPhase, 0);
+    workers->run_task(&forward_task);
+  }
+
+  for (int i = 1; i < _n_compaction_partitions; i++) {
+    CFLSCompactionPartition* part = &_compaction_partitions[i];
+    assert(part->_compaction_top ==
+           part->_destination + part->_live_words,
+           "forwarding and counting disagree");
+    if (part->_live_words > 0) {
+      end_of_live = part->_end_of_live;
+    }
+  }
+  CFLSCompactionPartition* last =
+    &_compaction_partitions[_n_compaction_partitions - 1];
+  _first_dead = first->_first_dead;
+  _end_of_live = end_of_live;
+
+  // The younger generations are compacted after the last partition.
+  set_compaction_top(last->_compaction_top);
+  cp->space = this;
+  cp->threshold = end();
+}
+
+void CompactibleFreeListSpace::par_adjust_pointers() {
+  CFLSParCompactionTask task(this, CFLSParCompactionTask::AdjustPointersPhase,
+                             0);
+  GenCollectedHeap::heap()->workers()->run_task(&task);
+}
+
+void CompactibleFreeListSpace::par_compact() {
+  for (int i = 0; i < _n_compaction_partitions; i++) {
+    _compaction_partitions[i]._compacted = 0;
+  }
+  CFLSParCompactionTask task(this, CFLSParCompactionTask::CompactPhase, 0);
+  GenCollectedHeap::heap()->workers()->run_task(&task);
+
+  // See SCAN_AND_COMPACT().
+  bool was_empty = used_region().is_empty();
+  reset_after_compaction();
+  if (used_region().is_empty()) {
+    if (!was_empty) clear(SpaceDecorator::Mangle);
+  } else {
+    if (ZapUnusedHeapArea) mangle_unused_area();
+  }
+}
+
+// The following are the bodies of SCAN_AND_FORWARD(), SCAN_AND_ADJUST_POINTERS()
+// and SCAN_AND_COMPACT(), limited to a partition.
+
+void CompactibleFreeListSpace::compute_live_words(
+                                             CFLSCompactionPartition* part) {
+  HeapWord*       q = part->_bottom;
+  HeapWord* const t = part->_end;
+  size_t live_words = 0;
+
+  const intx interval = PrefetchScanIntervalInBytes;
+
+  while (q < t) {
+    // prefetch beyond q
+    Prefetch::read(q, interval);
+    size_t size = block_size(q);
+    if (block_is_obj(q) && oop(q)->is_gc_marked()) {
+      live_words += adjustObjectSize(size);
+    }
+    q += size;
+  }
+  assert(q == t, "just checking");
+  part->_live_words = live_words;
+}
+
+void CompactibleFreeListSpace::forward_partition(CFLSCompactionPartition* part,
+                                                 size_t allowed_deadspace) {
+  CompactPoint cp(NULL, this, end());
+  HeapWord* compact_top = part->_destination;
+
+  HeapWord*  q = part->_bottom;
+  HeapWord*  t = part->_end;
+  HeapWord*  end_of_live = q;
+  HeapWord*  first_dead = t;
+  LiveRange* liveRange = NULL;
+
+  const intx interval = PrefetchScanIntervalInBytes;
+
+  while (q < t) {
+    if (block_is_obj(q) && oop(q)->is_gc_marked()) {
+      // prefetch beyond q
+      Prefetch::write(q, interval);
+      size_t size = block_size(q);
+      compact_top = forward(oop(q), size, &cp, compact_top);
+      q += size;
+      end_of_live = q;
+    } else {
+      // run over all the contiguous dead objects
+      HeapWord* end = q;
+      do {
+        // prefetch beyond end
+        Prefetch::write(end, interval);
+        end += block_size(end);
+      } while (end < t && (!block_is_obj(end) || !oop(end)->is_gc_marked()));
+
+      // see if we might want to pretend this object is alive
+      if (allowed_deadspace > 0 && q == compact_top) {
+        size_t sz = pointer_delta(end, q);
+        if (insert_deadspace(allowed_deadspace, q, sz)) {
+          compact_top = forward(oop(q), sz, &cp, compact_top);
+          q = end;
+          end_of_live = end;
+          continue;
+        }
+      }
+
+      // otherwise, it really is a free region.
+      if (liveRange != NULL) {
+        liveRange->set_end(q);
+      }
+      liveRange = (LiveRange*)q;
+      liveRange->set_start(end);
+      liveRange->set_end(end);
+      if (q < first_dead) {
+        first_dead = q;
+      }
+      q = end;
+    }
+  }
+
+  assert(q == t, "just checking");
+  assert(cp.space == this && compact_top <= t,
+         "the space must be compacted into itself");
+  if (liveRange != NULL) {
+    liveRange->set_end(q);
+  }
+  if (end_of_live < first_dead) {
+    first_dead = end_of_live;
+  }
+  part->_compaction_top = compact_top;
+  part->_first_dead = first_dead;
+  part->_end_of_live = end_of_live;
+}
+
+void CompactibleFreeListSpace::adjust_pointers_in_partition(
+                                             CFLSCompactionPartition* part) {
+  HeapWord*       q = part->_bottom;
+  HeapWord* const t = part->_end_of_live;
+  assert(part->_first_dead <= t, "Stands to reason, no?");
+
+  if (q < t && part->_first_dead > q && !oop(q)->is_gc_marked()) {
+    // The objects below _first_dead do not move; their marks were
+    // reinitialized by the previous phase.
+    HeapWord* const end = part->_first_dead;
+    while (q < end) {
+      assert(block_is_obj(q),
+             "should be at block boundaries, and should be looking at objs");
+      q += adjust_obj_size(oop(q)->adjust_pointers());
+    }
+    if (part->_first_dead == t) {
+      q = t;
+    } else {
+      q = (HeapWord*)oop(part->_first_dead)->mark()->decode_pointer();
+    }
+  }
+
+  const intx interval = PrefetchScanIntervalInBytes;
+  debug_only(HeapWord* prev_q = NULL);
+  while (q < t) {
+    // prefetch beyond q
+    Prefetch::write(q, interval);
+    if (oop(q)->is_gc_marked()) {
+      debug_only(prev_q = q);
+      q += adjust_obj_size(oop(q)->adjust_pointers());
+    } else {
+      // q is not a live object, so its mark points at the next live object
+      debug_only(prev_q = q);
+      q = (HeapWord*) oop(q)->mark()->decode_pointer();
+      assert(q > prev_q, "we should be moving forward through memory");
+    }
+  }
+  assert(q == t, "just checking");
+}
+
+void CompactibleFreeListSpace::compact_partition(int i) {
+  CFLSCompactionPartition* part = &_compaction_partitions[i];
+  HeapWord*       q = part->_bottom;
+  HeapWord* const t = part->_end_of_live;
+  debug_only(HeapWord* prev_q = NULL);
+  // The lowest partition below this one that may still have objects to
+  // copy out of the destination of the objects of this one.
+  int k = 0;
+
+  if (q < t && part->_first_dead > q && !oop(q)->is_gc_marked()) {
+    // Skip the objects that do not move.
+    if (part->_first_dead == t) {
+      q = t;
+    } else {
+      q = (HeapWord*) oop(part->_first_dead)->mark()->decode_pointer();
+    }
+  }
+
+  const intx scan_interval = PrefetchScanIntervalInBytes;
+  const intx copy_interval = PrefetchCopyIntervalInBytes;
+  while (q < t) {
+    if (!oop(q)->is_gc_marked()) {
+      // mark is pointer to next marked oop
+      debug_only(prev_q = q);
+      q = (HeapWord*) oop(q)->mark()->decode_pointer();
+      assert(q > prev_q, "we should be moving forward through memory");
+    } else {
+      // prefetch beyond q
+      Prefetch::read(q, scan_interval);
+
+      // size and destination
+      size_t size = obj_size(q);
+      HeapWord* compaction_top = (HeapWord*)oop(q)->forwardee();
+      assert(part->_destination <= compaction_top && compaction_top < q,
+             "objects must move down, after the partitions below");
+
+      // Wait for the partitions below whose live objects may lie in
+      // [compaction_top, compaction_top + size).  The destinations only
+      // grow, so a partition ending below compaction_top is never waited on.
+      for (; k < i && _compaction_partitions[k]._bottom < compaction_top + size;
+           k++) {
+        CFLSCompactionPartition* below = &_compaction_partitions[k];
+        if (below->_end_of_live > compaction_top) {
+          for (int spins = 1; OrderAccess::load_acquire(&below->_compacted) == 0;
+               spins++) {
+            if (spins % ParallelGCThreads == 0) {
+              os::yield();
+            } else {
+              SpinPause();
+            }
+          }
+        }
+      }
+
+      // prefetch beyond compaction_top
+      Prefetch::write(compaction_top, copy_interval);
+
+      // copy object and reinit its mark
+      Copy::aligned_conjoint_words(q, compaction_top, size);
+      oop(compaction_top)->init_mark();
+      assert(oop(compaction_top)->klass() != NULL, "should have a class");
+
+      debug_only(prev_q = q);
+      q += size;
+    }
+  }
+  OrderAccess::release_store(&part->_compacted, 1);
+}
+
 // fragmentation_metric = 1 - [sum of (fbs**2) / (sum of fbs)**2]
 // where fbs is free block sizes
 double CompactibleFreeListSpace::flsFrag() const {
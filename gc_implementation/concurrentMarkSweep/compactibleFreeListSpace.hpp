@@ -61,6 +61,29 @@ class LinearAllocBlock VALUE_OBJ_CLASS_SPEC {
   void print_on(outputStream* st) const;
 };
 
+// A piece of a CompactibleFreeListSpace that is forwarded, adjusted and
+// compacted by a single worker during a parallel mark sweep compact (see
+// CMSParallelFullGC).  Partitions begin and end at block boundaries.  The
+// live objects of a partition are moved to _destination, right after the
+// ones of the partition below it, so that the space is compacted as it
+// would be by a serial compaction.
+class CFLSCompactionPartition VALUE_OBJ_CLASS_SPEC {
+ public:
+  HeapWord* _bottom;
+  HeapWord* _end;
+  // The size of the live objects of the partition, and where the first
+  // of them is moved to.
+  size_t    _live_words;
+  HeapWord* _destination;
+  // Set when the new addresses of the live objects are computed; they
+  // play the same roles as the fields of the same name in CompactibleSpace.
+  HeapWord* _compaction_top;
+  HeapWord* _first_dead;
+  HeapWord* _end_of_live;
+  // Set once the objects of the partition have been copied out of it.
+  volatile jint _compacted;
+};
+
 // Concrete subclass of CompactibleSpace that implements
 // a free list space, such as used in the concurrent mark sweep
 // generation.
@@ -151,6 +174,20 @@ class CompactibleFreeListSpace: public CompactibleSpace {
   HeapWord* cross_threshold(HeapWord* start, HeapWord* end);
   HeapWord* forward(oop q, size_t size, CompactPoint* cp, HeapWord* compact_top);
 
+  // Support for compacting cms with the parallel GC threads.  When
+  // _par_compaction is set, the next compaction of the space is done
+  // over _n_compaction_partitions partitions (0 if it was done serially).
+  bool                     _par_compaction;
+  CFLSCompactionPartition* _compaction_partitions;
+  int                      _max_compaction_partitions;
+  int                      _n_compaction_partitions;
+
+  // Divide the space into at most n partitions of about the same size.
+  int  compute_compaction_partitions(int n);
+  void par_prepare_for_compaction(CompactPoint* cp);
+  void par_adjust_pointers();
+  void par_compact();
+
   // Initialization helpers.
   void initializeIndexedFreeListArray();
 
@@ -490,6 +527,21 @@ class CompactibleFreeListSpace: public CompactibleSpace {
   void prepare_for_compaction(CompactPoint* cp);
   void adjust_pointers();
   void compact();
+  // Have the next compaction of the space done by the parallel GC
+  // threads.  Must not be used for the perm gen, whose klasses have to
+  // be moved before the objects whose size depends on them.
+  void set_par_compaction(bool v) { _par_compaction = v; }
+  int  n_compaction_partitions() const { return _n_compaction_partitions; }
+  CFLSCompactionPartition* compaction_partition(int i) const {
+    assert(i < _n_compaction_partitions, "out of bounds");
+    return &_compaction_partitions[i];
+  }
+  // The work done on a single partition by the parallel phases.
+  void compute_live_words(CFLSCompactionPartition* part);
+  void forward_partition(CFLSCompactionPartition* part,
+                         size_t allowed_deadspace);
+  void adjust_pointers_in_partition(CFLSCompactionPartition* part);
+  void compact_partition(int i);
   // reset the space to reflect the fact that a compaction of the
   // space has been done.
   virtual void reset_after_compaction();
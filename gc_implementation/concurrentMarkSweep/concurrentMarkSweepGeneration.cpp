@@ -37,6 +37,7 @@
 #include "gc_implementation/parNew/parNewGeneration.hpp"
 #include "gc_implementation/shared/collectorCounters.hpp"
 #include "gc_implementation/shared/isGCActiveMark.hpp"
+#include "gc_implementation/shared/stringSymbolTableUnlinkTask.hpp"
 #include "gc_interface/collectedHeap.inline.hpp"
 #include "memory/cardTableRS.hpp"
 #include "memory/collectorPolicy.hpp"
@@ -2028,8 +2029,12 @@ void CMSCollector::do_compaction_work(bool clear_all_soft_refs) {
   {
     TraceCMSMemoryManagerStats tmms(gch->gc_cause());
   }
+  // The CMS generation may be compacted by the parallel GC threads;
+  // the perm gen is always compacted serially.
+  _cmsGen->cmsSpace()->set_par_compaction(GenMarkSweep::use_parallel_full_gc());
   GenMarkSweep::invoke_at_safepoint(_cmsGen->level(),
     ref_processor(), clear_all_soft_refs);
+  _cmsGen->cmsSpace()->set_par_compaction(false);
   #ifdef ASSERT
     CompactibleFreeListSpace* cms_space = _cmsGen->cmsSpace();
     size_t free_size = cms_space->free();
@@ -3756,12 +3761,13 @@ class CMSConcMarkingTask: public YieldingFlexibleGangTask {
                  CompactibleFreeListSpace* perm_space,
                  bool asynch,
                  YieldingFlexibleWorkGang* workers,
+                 int n_workers,
                  OopTaskQueueSet* task_queues):
     YieldingFlexibleGangTask("Concurrent marking done multi-threaded"),
     _collector(collector),
     _cms_space(cms_space),
     _perm_space(perm_space),
-    _asynch(asynch), _n_workers(0), _result(true),
+    _asynch(asynch), _n_workers(n_workers), _result(true),
     _task_queues(task_queues),
     _term(_n_workers, task_queues, _collector),
     _bit_map_lock(collector->bitMapLock())
@@ -4242,9 +4248,15 @@ void CMSConcMarkingTask::coordinator_yield() {
 
 bool CMSCollector::do_marking_mt(bool asynch) {
   assert(ConcGCThreads > 0 && conc_workers() != NULL, "precondition");
-  // In the future this would be determined ergonomically, based
-  // on #cpu's, # active mutator threads (and load), and mutation rate.
-  int num_workers = ConcGCThreads;
+  // The number of workers follows the occupancy of the CMS generation and
+  // the number of application threads; the mutation rate and the load
+  // of the machine are not taken into account.
+  int num_workers =
+    AdaptiveSizePolicy::calc_active_workers(conc_workers()->total_workers(),
+                                            conc_workers()->active_workers(),
+                                            Threads::number_of_non_daemon_threads(),
+                                            _cmsGen->used(),
+                                            0.0);
 
   CompactibleFreeListSpace* cms_space  = _cmsGen->cmsSpace();
   CompactibleFreeListSpace* perm_space = _permGen->cmsSpace();
@@ -4254,6 +4266,7 @@ bool CMSCollector::do_marking_mt(bool asynch) {
                          perm_space,
                          asynch,
                          conc_workers(),
+                         num_workers,
                          task_queues());
 
   // Since the actual number of workers we get may be different
@@ -5720,7 +5733,7 @@ public:
   {
     assert(_collector->_span.equals(_span) && !_span.is_empty(),
            "Inconsistency in _span");
-    set_for_termination(workers->active_workers());
+    set_for_termination(workers->total_workers());
   }
 
   OopTaskQueueSet* task_queues() { return queues(); }
@@ -5856,6 +5869,122 @@ void CMSRefProcTaskExecutor::execute(EnqueueTask& task)
   workers->run_task(&enq_task);
 }
 
+// The cleanup after class unloading which does not depend on the marking
+// stack: the links to unloaded classes are removed from the subklass,
+// sibling and implementor lists of the live classes, and the symbol and
+// string tables are scrubbed, all in parallel.  The klass link cleanup
+// only writes the lists of the klass being visited (and the sibling links
+// of its subklasses, which have a single superclass), so distinct klasses
+// can be visited concurrently.  A klass may be on the revisit stack more
+// than once, and removing its dead implementors twice concurrently would
+// corrupt the implementor count, so a klass is only visited by the worker
+// which first enters it into a hash set of visited klasses.  The workers
+// claim chunks of consecutive entries once they have run out of table
+// buckets to claim.
+class CMSParUnloadingTask: public AbstractGangTask {
+  enum {
+    KlassChunkSize = 256
+  };
+
+  CMSMarkStack*      _revisit_stack;
+  BoolObjectClosure* _is_alive;
+  bool               _do_symbols;
+  volatile jint      _next_chunk;
+  // The visited klasses: an open addressing hash set, with at least twice
+  // as many slots as there are entries on the revisit stack.
+  oop*               _visited;
+  size_t             _visited_mask;
+
+  // Returns true if k was not visited yet; the caller then visits it.
+  bool claim_klass(oop k) {
+    uintptr_t h = ((uintptr_t)(oopDesc*)k) >> LogMinObjAlignmentInBytes;
+    size_t i = (size_t)h & _visited_mask;
+    while (true) {
+      oop cur = _visited[i];
+      if (cur == NULL) {
+        cur = (oop)Atomic::cmpxchg_ptr(k, &_visited[i], NULL);
+        if (cur == NULL) {
+          return true;
+        }
+      }
+      if (cur == k) {
+        return false;
+      }
+      i = (i + 1) & _visited_mask;
+    }
+  }
+
+  void follow_klass_links(size_t start, size_t end) {
+    for (size_t i = start; i < end; i++) {
+      oop k = _revisit_stack->at(i);
+      if (claim_klass(k)) {
+        // The keep alive closure is only used when ClassUnloading is off.
+        ((Klass*)(oopDesc*)k)->follow_weak_klass_links(_is_alive, NULL);
+      }
+    }
+  }
+
+ public:
+  CMSParUnloadingTask(CMSMarkStack* revisit_stack,
+                      BoolObjectClosure* is_alive,
+                      bool do_symbols) :
+    AbstractGangTask("Parallel class unloading cleanup"),
+    _revisit_stack(revisit_stack), _is_alive(is_alive),
+    _do_symbols(do_symbols), _next_chunk(0) {
+    size_t slots = 1;
+    while (slots < 2 * _revisit_stack->length()) {
+      slots <<= 1;
+    }
+    _visited = NEW_C_HEAP_ARRAY(oop, slots);
+    memset(_visited, 0, slots * sizeof(oop));
+    _visited_mask = slots - 1;
+    StringTable::clear_parallel_claimed_index();
+    if (_do_symbols) {
+      SymbolTable::clear_parallel_claimed_index();
+    }
+  }
+
+  ~CMSParUnloadingTask() {
+    FREE_C_HEAP_ARRAY(oop, _visited);
+    StringTable::parallel_unlink_done();
+    if (_do_symbols) {
+      SymbolTable::parallel_unlink_done();
+    }
+  }
+
+  void work(int i) {
+    ResourceMark rm;
+    // Clean up stale oops in StringTable
+    StringTable::possibly_parallel_unlink(_is_alive);
+    // Clean up unreferenced symbols in symbol table.
+    if (_do_symbols) {
+      SymbolTable::possibly_parallel_unlink();
+    }
+    size_t length = _revisit_stack->length();
+    while (true) {
+      size_t start = (size_t)(Atomic::add(1, &_next_chunk) - 1) * KlassChunkSize;
+      if (start >= length) {
+        break;
+      }
+      follow_klass_links(start, MIN2(start + KlassChunkSize, length));
+    }
+  }
+};
+
+void CMSCollector::par_unload_classes_cleanup() {
+  assert(ClassUnloading, "klass links are followed as strong roots");
+  assert(!_revisitStack.isEmpty(), "revisit stack should not be empty");
+  GenCollectedHeap* gch = GenCollectedHeap::heap();
+  FlexibleWorkGang* workers = gch->workers();
+  assert(workers != NULL, "Need parallel worker threads.");
+  {
+    CMSParUnloadingTask task(&_revisitStack, &_is_alive_closure,
+                             !SymbolTable::unlinks_incrementally());
+    workers->run_task(&task);
+  }
+  _revisitStack.reset();
+}
+
 void CMSCollector::refProcessingWork(bool asynch, bool clear_all_soft_refs) {
 
   ResourceMark rm;
@@ -5898,6 +6027,12 @@ void CMSCollector::refProcessingWork(bool asynch, bool clear_all_soft_refs) {
     verify_work_stacks_empty();
   }
 
+  // The klass links are only followed as strong roots when
+  // ClassUnloading is off, which needs the marking stack.
+  bool par_cleanup = should_unload_classes() &&
+                     CMSParallelClassUnloadingEnabled && ClassUnloading &&
+                     CollectedHeap::use_parallel_gc_threads();
+
   if (should_unload_classes()) {
     {
       TraceTime t("class unloading", PrintGCDetails, false, gclog_or_tty);
@@ -5913,33 +6048,46 @@ void CMSCollector::refProcessingWork(bool asynch, bool clear_all_soft_refs) {
       cmsDrainMarkingStackClosure.do_void();
       verify_work_stacks_empty();
 
-      // Update subklass/sibling/implementor links in KlassKlass descendants
-      assert(!_revisitStack.isEmpty(), "revisit stack should not be empty");
-      oop k;
-      while ((k = _revisitStack.pop()) != NULL) {
-        ((Klass*)(oopDesc*)k)->follow_weak_klass_links(
-                       &_is_alive_closure,
-                       &cmsKeepAliveClosure);
+      if (!par_cleanup) {
+        // Update subklass/sibling/implementor links in KlassKlass descendants
+        assert(!_revisitStack.isEmpty(), "revisit stack should not be empty");
+        oop k;
+        while ((k = _revisitStack.pop()) != NULL) {
+          ((Klass*)(oopDesc*)k)->follow_weak_klass_links(
+                         &_is_alive_closure,
+                         &cmsKeepAliveClosure);
+        }
+        assert(!ClassUnloading ||
+               (_markStack.isEmpty() && overflow_list_is_empty()),
+               "Should not have found new reachable objects");
+        assert(_revisitStack.isEmpty(), "revisit stack should have been drained");
+        cmsDrainMarkingStackClosure.do_void();
+        verify_work_stacks_empty();
       }
-      assert(!ClassUnloading ||
-             (_markStack.isEmpty() && overflow_list_is_empty()),
-             "Should not have found new reachable objects");
-      assert(_revisitStack.isEmpty(), "revisit stack should have been drained");
-      cmsDrainMarkingStackClosure.do_void();
-      verify_work_stacks_empty();
     }
 
-    {
+    if (par_cleanup) {
+      TraceTime t("par klass links and table scrubbing", PrintGCDetails, false, gclog_or_tty);
+      par_unload_classes_cleanup();
+      verify_work_stacks_empty();
+    } else if (!SymbolTable::unlinks_incrementally()) {
       TraceTime t("scrub symbol table", PrintGCDetails, false, gclog_or_tty);
       // Clean up unreferenced symbols in symbol table.
       SymbolTable::unlink();
     }
   }
 
-  if (should_unload_classes() || !JavaObjectsInPerm) {
+  // The string table has already been scrubbed by the parallel cleanup.
+  if (!par_cleanup && (should_unload_classes() || !JavaObjectsInPerm)) {
     TraceTime t("scrub string table", PrintGCDetails, false, gclog_or_tty);
-    // Now clean up stale oops in StringTable
-    StringTable::unlink(&_is_alive_closure);
+    FlexibleWorkGang* workers = GenCollectedHeap::heap()->workers();
+    if (CollectedHeap::use_parallel_gc_threads() && workers != NULL) {
+      StringSymbolTableUnlinkTask unlink_task(&_is_alive_closure, false);
+      workers->run_task(&unlink_task);
+    } else {
+      // Now clean up stale oops in StringTable
+      StringTable::unlink(&_is_alive_closure);
+    }
   }
 
   verify_work_stacks_empty();
@@ -5948,12 +6096,15 @@ void CMSCollector::refProcessingWork(bool asynch, bool clear_all_soft_refs) {
   restore_preserved_marks_if_any();  // done single-threaded for now
 
   rp->set_enqueuing_is_done(true);
-  if (rp->processing_is_mt()) {
-    rp->balance_all_queues();
-    CMSRefProcTaskExecutor task_executor(*this);
-    rp->enqueue_discovered_references(&task_executor);
-  } else {
-    rp->enqueue_discovered_references(NULL);
+  {
+    TraceTime t("weak refs enqueuing", PrintGCDetails, false, gclog_or_tty);
+    if (rp->processing_is_mt()) {
+      rp->balance_all_queues();
+      CMSRefProcTaskExecutor task_executor(*this);
+      rp->enqueue_discovered_references(&task_executor);
+    } else {
+      rp->enqueue_discovered_references(NULL);
+    }
   }
   rp->verify_no_references_recorded();
   assert(!rp->discovery_enabled(), "should have been disabled");
@@ -212,6 +212,11 @@ class CMSMarkStack: public CHeapObj  {
 
   size_t length() { return _index; }
 
+  oop at(size_t i) const {
+    assert(i < _index, "out of bounds");
+    return _base[i];
+  }
+
   // "Parallel versions" of some of the above
   oop par_pop() {
     // lock and pop
@@ -799,6 +804,9 @@ class CMSCollector: public CHeapObj {
   void do_remark_non_parallel();
   // reference processing work routine (during second checkpoint)
   void refProcessingWork(bool asynch, bool clear_all_soft_refs);
+  // clean up the klass links and the symbol and string tables on the
+  // parallel gc threads after class unloading
+  void par_unload_classes_cleanup();
 
   // concurrent sweeping work
   void sweepWork(ConcurrentMarkSweepGeneration* gen, bool asynch);
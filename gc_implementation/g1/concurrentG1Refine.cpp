@@ -49,7 +49,8 @@ ConcurrentG1Refine::ConcurrentG1Refine() :
   _card_counts(NULL), _card_epochs(NULL),
   _n_card_counts(0), _max_cards(0), _max_n_card_counts(0),
   _cache_size_index(0), _expand_card_counts(false),
-  _hot_cache(NULL),
+  _hot_cache(NULL), _hot_cache_size(0),
+  _n_hot_inserts(0), _n_hot_evictions(0),
   _def_use_cache(false), _use_cache(false),
   // We initialize the epochs of the array to 0. By initializing
   // _n_periods to 1 and not 0 we automatically invalidate all the
@@ -75,6 +76,7 @@ ConcurrentG1Refine::ConcurrentG1Refine() :
   }
   set_red_zone(MAX2<int>(G1ConcRefinementRedZone, yellow_zone()));
   _n_worker_threads = thread_num();
+  _n_active_worker_threads = _n_worker_threads;
   // We need one extra thread to do the young gen rset size sampling.
   _n_threads = _n_worker_threads + 1;
   reset_threshold_step();
@@ -93,7 +95,7 @@ ConcurrentG1Refine::ConcurrentG1Refine() :
 
 void ConcurrentG1Refine::reset_threshold_step() {
   if (FLAG_IS_DEFAULT(G1ConcRefinementThresholdStep)) {
-    _thread_threshold_step = (yellow_zone() - green_zone()) / (worker_thread_num() + 1);
+    _thread_threshold_step = (yellow_zone() - green_zone()) / (active_worker_thread_num() + 1);
   } else {
     _thread_threshold_step = G1ConcRefinementThresholdStep;
   }
@@ -156,19 +158,55 @@ void ConcurrentG1Refine::init() {
 
     _def_use_cache = true;
     _use_cache = true;
-    _hot_cache_size = (1 << G1ConcRSLogCacheSize);
-    _hot_cache = NEW_C_HEAP_ARRAY(jbyte*, _hot_cache_size);
-    _n_hot = 0;
-    _hot_cache_idx = 0;
-
-    // For refining the cards in the hot cache in parallel
-    int n_workers = (ParallelGCThreads > 0 ?
-                        _g1h->workers()->total_workers() : 1);
-    _hot_cache_par_chunk_size = MAX2(1, _hot_cache_size / n_workers);
+    _hot_cache_min_size = (1 << G1ConcRSLogCacheSize);
+    _hot_cache_max_size = (1 << MAX2(G1ConcRSMaxLogCacheSize, G1ConcRSLogCacheSize));
+    allocate_hot_cache(_hot_cache_min_size);
+    clear_hot_cache();
     _hot_cache_par_claimed_idx = 0;
   }
 }
 
+void ConcurrentG1Refine::allocate_hot_cache(int size) {
+  if (_hot_cache != NULL) {
+    FREE_C_HEAP_ARRAY(jbyte*, _hot_cache);
+  }
+  _hot_cache_size = size;
+  _hot_cache = NEW_C_HEAP_ARRAY(jbyte*, _hot_cache_size);
+
+  // For refining the cards in the hot cache in parallel
+  int n_workers = (ParallelGCThreads > 0 ?
+                      _g1h->workers()->total_workers() : 1);
+  _hot_cache_par_chunk_size = MAX2(1, _hot_cache_size / n_workers);
+}
+
+void ConcurrentG1Refine::adjust_hot_cache_size() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+  assert(!use_cache(), "cache should be disabled");
+  if (G1ConcRSLogCacheSize == 0 || !G1UseAdaptiveHotCardCache) {
+    clear_hot_cache();
+    return;
+  }
+
+  int new_size = _hot_cache_size;
+  if (_n_hot_evictions > _n_hot_inserts / 4) {
+    // More than a quarter of the hot cards were evicted, and refined,
+    // before the pause; they may be dirtied again.
+    new_size = MIN2(_hot_cache_size * 2, _hot_cache_max_size);
+  } else if (_n_hot_evictions == 0 && _n_hot < _hot_cache_size / 4) {
+    new_size = MAX2(_hot_cache_size / 2, _hot_cache_min_size);
+  }
+  if (G1TraceConcRefinement) {
+    gclog_or_tty->print_cr("G1-Refine-hot-cache: %d inserts, %d evictions, "
+                           "%d cards; size %d -> %d",
+                           _n_hot_inserts, _n_hot_evictions, _n_hot,
+                           _hot_cache_size, new_size);
+  }
+  if (new_size != _hot_cache_size) {
+    allocate_hot_cache(new_size);
+  }
+  clear_hot_cache();
+}
+
 void ConcurrentG1Refine::stop() {
   if (_threads != NULL) {
     for (int i = 0; i < _n_threads; i++) {
@@ -206,6 +244,16 @@ ConcurrentG1Refine::~ConcurrentG1Refine() {
   }
 }
 
+double ConcurrentG1Refine::worker_threads_vtime() const {
+  double vtime = 0.0;
+  if (_threads != NULL) {
+    for (int i = 0; i < _n_worker_threads; i++) {
+      vtime += _threads[i]->vtime_accum();
+    }
+  }
+  return vtime;
+}
+
 void ConcurrentG1Refine::threads_do(ThreadClosure *tc) {
   if (_threads != NULL) {
     for (int i = 0; i < _n_threads; i++) {
@@ -359,9 +407,11 @@ jbyte* ConcurrentG1Refine::cache_insert(jbyte* card_ptr, bool* defer) {
   // Otherwise, the pointer we got from the _card_counts cache is hot.
   jbyte* res = NULL;
   MutexLockerEx x(HotCardCache_lock, Mutex::_no_safepoint_check_flag);
+  _n_hot_inserts++;
   if (_n_hot == _hot_cache_size) {
     res = _hot_cache[_hot_cache_idx];
     _n_hot--;
+    _n_hot_evictions++;
   }
   // Now _n_hot < _hot_cache_size, and we can insert at _hot_cache_idx.
   _hot_cache[_hot_cache_idx] = cached_ptr;
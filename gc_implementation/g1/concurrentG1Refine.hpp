@@ -38,6 +38,10 @@ class ConcurrentG1Refine: public CHeapObj {
   ConcurrentG1RefineThread** _threads;
   int _n_threads;
   int _n_worker_threads;
+  // The number of worker threads which may be activated.  With
+  // G1UseAdaptiveConcRefinement it is set by the policy from the rate at
+  // which update buffers are enqueued and refined.
+  int _n_active_worker_threads;
  /*
   * The value of the update buffer queue length falls into one of 3 zones:
   * green, yellow, red. If the value is in [0, green) nothing is
@@ -149,6 +153,18 @@ class ConcurrentG1Refine: public CHeapObj {
   int          _n_hot;
   int          _hot_cache_idx;
 
+  // The bounds of _hot_cache_size with G1UseAdaptiveHotCardCache.
+  int          _hot_cache_min_size;
+  int          _hot_cache_max_size;
+  // The cards inserted into, and evicted from, the hot cache since the
+  // last pause.
+  int          _n_hot_inserts;
+  int          _n_hot_evictions;
+
+  // Allocate a hot cache of the given size, and the chunk size used
+  // to refine its cards in parallel.
+  void allocate_hot_cache(int size);
+
   int          _hot_cache_par_chunk_size;
   volatile int _hot_cache_par_claimed_idx;
 
@@ -222,8 +238,15 @@ class ConcurrentG1Refine: public CHeapObj {
   // Discard entries in the hot cache.
   void clear_hot_cache() {
     _hot_cache_idx = 0; _n_hot = 0;
+    _n_hot_inserts = 0; _n_hot_evictions = 0;
   }
 
+  // With G1UseAdaptiveHotCardCache, grow the hot cache if it evicted a
+  // large part of the hot cards since the last pause, or shrink it if
+  // it stayed mostly empty.  Discards the entries of the hot cache.
+  // Called at the end of an evacuation pause, with the cache disabled.
+  void adjust_hot_cache_size();
+
   bool hot_cache_is_empty() { return _n_hot == 0; }
 
   bool use_cache() { return _use_cache; }
@@ -249,6 +272,15 @@ class ConcurrentG1Refine: public CHeapObj {
   int total_thread_num() const  { return _n_threads;        }
   int worker_thread_num() const { return _n_worker_threads; }
 
+  int active_worker_thread_num() const { return _n_active_worker_threads; }
+  void set_active_worker_thread_num(int n) {
+    assert(n > 0 && n <= _n_worker_threads, "Bounds");
+    _n_active_worker_threads = n;
+  }
+
+  // The total virtual time of the worker threads so far, in seconds.
+  double worker_threads_vtime() const;
+
   int thread_threshold_step() const { return _thread_threshold_step; }
 };
 
@@ -59,12 +59,17 @@ ConcurrentG1RefineThread(ConcurrentG1Refine* cg1r, ConcurrentG1RefineThread *nex
 }
 
 void ConcurrentG1RefineThread::initialize() {
-  if (_worker_id < cg1r()->worker_thread_num()) {
+  if (_worker_id < cg1r()->active_worker_thread_num()) {
     // Current thread activation threshold
     _threshold = MIN2<int>(cg1r()->thread_threshold_step() * (_worker_id + 1) + cg1r()->green_zone(),
                            cg1r()->yellow_zone());
     // A thread deactivates once the number of buffer reached a deactivation threshold
     _deactivation_threshold = MAX2<int>(_threshold - cg1r()->thread_threshold_step(), cg1r()->green_zone());
+  } else if (_worker_id < cg1r()->worker_thread_num()) {
+    // The thread is not needed at the current refinement rate: it is
+    // never activated, and deactivates if it is running.
+    _threshold = max_jint;
+    _deactivation_threshold = max_jint;
   } else {
     set_active(true);
   }
@@ -31,6 +31,8 @@
 #include "gc_implementation/g1/g1RemSet.hpp"
 #include "gc_implementation/g1/heapRegionRemSet.hpp"
 #include "gc_implementation/g1/heapRegionSeq.inline.hpp"
+#include "gc_implementation/shared/adaptiveSizePolicy.hpp"
+#include "gc_implementation/shared/stringSymbolTableUnlinkTask.hpp"
 #include "gc_implementation/shared/vmGCOperations.hpp"
 #include "memory/genOopClosures.inline.hpp"
 #include "memory/referencePolicy.hpp"
@@ -459,6 +461,7 @@ ConcurrentMark::ConcurrentMark(ReservedSpace rs,
   _cleanup_sleep_factor(0.0),
   _cleanup_task_overhead(1.0),
   _cleanup_list("Cleanup List"),
+  _rem_sets_to_rebuild(0),
   _region_bm(max_regions, false /* in_resource_area*/),
   _card_bm((rs.size() + CardTableModRefBS::card_size - 1) >>
            CardTableModRefBS::card_shift,
@@ -1169,13 +1172,22 @@ void ConcurrentMark::markFromRoots() {
 
   _restart_for_overflow = false;
 
-  size_t active_workers = MAX2((size_t) 1, parallel_marking_threads());
+  size_t active_workers = 1;
+  if (parallel_marking_threads() > 0) {
+    active_workers = (size_t)
+      AdaptiveSizePolicy::calc_active_workers(parallel_marking_threads(),
+                                              _parallel_workers->active_workers(),
+                                              Threads::number_of_non_daemon_threads(),
+                                              _g1h->used_unlocked(),
+                                              0.0);
+    _parallel_workers->set_active_workers((int) active_workers);
+  }
   force_overflow_conc()->init();
   set_phase(active_workers, true /* concurrent */);
 
   CMConcurrentMarkingTask markingTask(this, cmThread());
   if (parallel_marking_threads() > 0)
-    _parallel_workers->run_task(&markingTask);
+    _parallel_workers->run_task(&markingTask, (uint) active_workers);
   else
     markingTask.work(0);
   print_stats();
@@ -1816,6 +1828,12 @@ void ConcurrentMark::cleanup() {
                            (note_end_end - note_end_start)*1000.0);
   }
 
+  // Must come before the collection set chooser is set up below, since
+  // only regions with complete remembered sets may be chosen.
+  if (G1RebuildRemSets) {
+    updateRemSetTracking();
+  }
+
 
   // call below, since it affects the metric by which we sort the heap
   // regions.
@@ -1880,6 +1898,198 @@ void ConcurrentMark::cleanup() {
   g1h->verify_region_sets_optional();
 }
 
+class G1UpdateRemSetTrackingClosure: public HeapRegionClosure {
+  size_t _live_threshold_bytes;
+  size_t _dropped;
+  size_t _to_rebuild;
+
+public:
+  G1UpdateRemSetTrackingClosure() :
+    _live_threshold_bytes(HeapRegion::GrainBytes / 100 *
+                          G1RebuildRemSetsLiveThresholdPercent),
+    _dropped(0), _to_rebuild(0) { }
+
+  bool doHeapRegion(HeapRegion* r) {
+    if (r->is_empty() || r->is_young()) {
+      return false;
+    }
+    HeapRegionRemSet* hrrs = r->rem_set();
+    assert(!hrrs->is_rebuilding(), "the last rebuild should have completed");
+    if (r->isHumongous()) {
+      // Humongous regions are never evacuated.
+      if (hrrs->is_tracked()) {
+        hrrs->set_untracked();
+        _dropped++;
+      }
+    } else if (r->is_marked()) {
+      // Regions allocated into since marking started have no liveness
+      // information, and keep their remembered sets.
+      bool is_candidate = r->max_live_bytes() <= _live_threshold_bytes;
+      if (!is_candidate && hrrs->is_tracked()) {
+        hrrs->set_untracked();
+        _dropped++;
+      } else if (is_candidate && !hrrs->is_tracked()) {
+        hrrs->set_rebuilding();
+        _to_rebuild++;
+      }
+    }
+    if (!r->continuesHumongous()) {
+      r->set_top_at_rebuild_start(r->top());
+    }
+    return false;
+  }
+
+  size_t dropped() const    { return _dropped; }
+  size_t to_rebuild() const { return _to_rebuild; }
+};
+
+void ConcurrentMark::updateRemSetTracking() {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+  double start = os::elapsedTime();
+  G1UpdateRemSetTrackingClosure cl;
+  _g1h->heap_region_iterate(&cl);
+  _rem_sets_to_rebuild = cl.to_rebuild();
+  if (G1PrintParCleanupStats) {
+    gclog_or_tty->print_cr("  remset tracking: %8.3f ms, "
+                           SIZE_FORMAT " dropped, " SIZE_FORMAT " to rebuild.",
+                           (os::elapsedTime() - start)*1000.0,
+                           cl.dropped(), cl.to_rebuild());
+  }
+}
+
+// Adds the references into the regions whose remembered sets are being
+// rebuilt.  Each rebuild worker adds them with its own id, so that it has
+// its own row of the from card cache.
+class G1RebuildRemSetClosure: public OopClosure {
+  G1CollectedHeap* _g1h;
+  HeapRegion*      _from;
+  int              _rs_id;
+
+  template <class T> void do_oop_work(T* p) {
+    oop obj = oopDesc::load_decode_heap_oop(p);
+    if (obj == NULL) {
+      return;
+    }
+    HeapRegion* to = _g1h->heap_region_containing(obj);
+    if (to != NULL && to != _from && to->rem_set()->is_rebuilding()) {
+      to->rem_set()->add_reference(p, _rs_id);
+    }
+  }
+
+public:
+  G1RebuildRemSetClosure(G1CollectedHeap* g1h, int worker_i) :
+    _g1h(g1h), _from(NULL),
+    _rs_id(HeapRegionRemSet::rebuild_rem_set_id(worker_i)) { }
+
+  void set_from(HeapRegion* from) { _from = from; }
+
+  virtual void do_oop(oop* p)       { do_oop_work(p); }
+  virtual void do_oop(narrowOop* p) { do_oop_work(p); }
+};
+
+// The rebuild scans the objects below the top at the end of cleanup of
+// every region, and skips those below the top at mark start that marking
+// found dead.  References stored since cleanup are recorded by the
+// refinement of the cards they dirty, and those of the objects that
+// evacuation pauses copy are recorded by the pauses, since the regions
+// being rebuilt are tracked.  A region that is freed while the rebuild is
+// yielding has its top at rebuild start reset, which ends its scan.
+class G1RebuildRemSetTask: public AbstractGangTask {
+  ConcurrentMark*  _cm;
+  G1CollectedHeap* _g1h;
+  bool             _scan;
+  size_t           _n_regions;
+  volatile jint    _next_region;
+
+  void scan_region(HeapRegion* hr, G1RebuildRemSetClosure* cl, int worker_i) {
+    cl->set_from(hr);
+    if (hr->startsHumongous()) {
+      if (hr->top_at_rebuild_start() > hr->bottom()) {
+        oop(hr->bottom())->oop_iterate(cl);
+      }
+      return;
+    }
+    CMBitMapRO* prev_bitmap = _cm->prevMarkBitMap();
+    HeapWord* cur = hr->bottom();
+    while (cur < hr->top_at_rebuild_start()) {
+      HeapWord* ptams = hr->prev_top_at_mark_start();
+      if (cur < ptams) {
+        cur = prev_bitmap->getNextMarkedWordAddress(cur, ptams);
+        if (cur >= ptams) {
+          cur = ptams;
+          continue;
+        }
+      }
+      oop obj = oop(cur);
+      cur += obj->size();
+      obj->oop_iterate(cl);
+      _cm->do_yield_check(worker_i);
+      if (_cm->has_aborted()) {
+        return;
+      }
+    }
+  }
+
+public:
+  G1RebuildRemSetTask(ConcurrentMark* cm, G1CollectedHeap* g1h, bool scan) :
+    AbstractGangTask("G1 Rebuild RemSets"), _cm(cm), _g1h(g1h),
+    _scan(scan), _n_regions(g1h->n_regions()), _next_region(0) { }
+
+  void work(int worker_i) {
+    assert(Thread::current()->is_ConcurrentGC_thread(),
+           "this should only be done by a conc GC thread");
+    ResourceMark rm;
+    ConcurrentGCThread::stsJoin();
+    G1RebuildRemSetClosure cl(_g1h, worker_i);
+    while (!_cm->has_aborted()) {
+      jint i = Atomic::add(1, &_next_region) - 1;
+      if ((size_t) i >= _n_regions) {
+        break;
+      }
+      HeapRegion* hr = _g1h->region_at(i);
+      HeapRegionRemSet* hrrs = hr->rem_set();
+      if (!hrrs->is_tracked()) {
+        hrrs->clear_untracked();
+      }
+      if (_scan && !hr->continuesHumongous()) {
+        scan_region(hr, &cl, worker_i);
+      }
+      _cm->do_yield_check(worker_i);
+    }
+    ConcurrentGCThread::stsLeave();
+  }
+};
+
+class G1CompleteRemSetRebuildClosure: public HeapRegionClosure {
+public:
+  bool doHeapRegion(HeapRegion* r) {
+    if (r->rem_set()->is_rebuilding()) {
+      r->rem_set()->set_rebuild_complete();
+    }
+    return false;
+  }
+};
+
+void ConcurrentMark::rebuildRemSets() {
+  assert(G1RebuildRemSets, "only in this mode");
+  G1RebuildRemSetTask rebuild_task(this, _g1h, _rem_sets_to_rebuild > 0);
+  if (parallel_marking_threads() > 0) {
+    _parallel_workers->run_task(&rebuild_task);
+  } else {
+    rebuild_task.work(0);
+  }
+
+  // If a full collection has happened, it has rebuilt all the remembered
+  // sets, and none is being rebuilt any more.
+  ConcurrentGCThread::stsJoin();
+  if (!has_aborted() && _rem_sets_to_rebuild > 0) {
+    G1CompleteRemSetRebuildClosure cl;
+    _g1h->heap_region_iterate(&cl);
+  }
+  _rem_sets_to_rebuild = 0;
+  ConcurrentGCThread::stsLeave();
+}
+
 void ConcurrentMark::completeCleanup() {
   if (has_aborted()) return;
 
@@ -1976,16 +2186,33 @@ class G1CMDrainMarkingStackClosure: public VoidClosure {
   CMMarkStack*                  _markStack;
   CMBitMap*                     _bitMap;
   G1CMKeepAliveClosure*         _oopClosure;
+  bool                          _yield_after;
  public:
   G1CMDrainMarkingStackClosure(CMBitMap* bitMap, CMMarkStack* markStack,
-                               G1CMKeepAliveClosure* oopClosure) :
+                               G1CMKeepAliveClosure* oopClosure,
+                               bool yield_after) :
     _bitMap(bitMap),
     _markStack(markStack),
-    _oopClosure(oopClosure)
+    _oopClosure(oopClosure),
+    _yield_after(yield_after)
   {}
 
   void do_void() {
-    _markStack->drain((OopClosure*)_oopClosure, _bitMap, false);
+    _markStack->drain((OopClosure*)_oopClosure, _bitMap, _yield_after);
+  }
+};
+
+// Used while precleaning the discovered references concurrently: it
+// yields to pending safepoints and stops the precleaning when marking
+// is aborted.
+class G1CMPrecleanYieldClosure: public YieldClosure {
+  ConcurrentMark* _cm;
+ public:
+  G1CMPrecleanYieldClosure(ConcurrentMark* cm) : _cm(cm) { }
+
+  virtual bool should_return() {
+    _cm->do_yield_check();
+    return _cm->has_aborted();
   }
 };
 
@@ -2182,6 +2409,37 @@ void G1RefProcTaskExecutor::execute(EnqueueTask& enq_task) {
   _g1h->set_par_threads(0);
 }
 
+void ConcurrentMark::precleanReferences() {
+  // Marking has completed, so this thread is the only one to mark or
+  // to use the discovered lists; discovery is not active outside of
+  // marking and evacuation pauses do not discover references.
+  assert(!SafepointSynchronize::is_at_safepoint(), "should be concurrent");
+  ResourceMark rm;
+  HandleMark   hm;
+  G1CollectedHeap* g1h   = G1CollectedHeap::heap();
+  ReferenceProcessor* rp = g1h->ref_processor();
+  assert(_markStack.isEmpty(), "mark stack should be empty");
+
+  G1CMIsAliveClosure       g1_is_alive(g1h);
+  G1CMKeepAliveClosure     g1_keep_alive(g1h, this, nextMarkBitMap());
+  G1CMDrainMarkingStackClosure
+    g1_drain_mark_stack(nextMarkBitMap(), &_markStack, &g1_keep_alive,
+                        true /* yield_after */);
+  G1CMPrecleanYieldClosure yield_cl(this);
+
+  rp->preclean_discovered_references(&g1_is_alive,
+                                     &g1_keep_alive,
+                                     &g1_drain_mark_stack,
+                                     &yield_cl,
+                                     false /* should_unload_classes */);
+
+  // Objects still on the mark stack (because we yielded or aborted)
+  // are taken care of by the remark pause.
+  if (_markStack.overflow()) {
+    set_has_overflown();
+  }
+}
+
 void ConcurrentMark::weakRefsWork(bool clear_all_soft_refs) {
   ResourceMark rm;
   HandleMark   hm;
@@ -2198,7 +2456,8 @@ void ConcurrentMark::weakRefsWork(bool clear_all_soft_refs) {
   G1CMIsAliveClosure   g1_is_alive(g1h);
   G1CMKeepAliveClosure g1_keep_alive(g1h, this, nextMarkBitMap());
   G1CMDrainMarkingStackClosure
-    g1_drain_mark_stack(nextMarkBitMap(), &_markStack, &g1_keep_alive);
+    g1_drain_mark_stack(nextMarkBitMap(), &_markStack, &g1_keep_alive,
+                        false /* yield_after */);
   // We use the work gang from the G1CollectedHeap and we utilize all
   // the worker threads.
   int active_workers = g1h->workers() ? g1h->workers()->total_workers() : 1;
@@ -2208,52 +2467,70 @@ void ConcurrentMark::weakRefsWork(bool clear_all_soft_refs) {
                                           g1h->workers(), active_workers);
 
 
-  if (rp->processing_is_mt()) {
-    // Set the degree of MT here.  If the discovery is done MT, there
-    // may have been a different number of threads doing the discovery
-    // and a different number of discovered lists may have Ref objects.
-    // That is OK as long as the Reference lists are balanced (see
-    // balance_all_queues() and balance_queues()).
-    rp->set_active_mt_degree(active_workers);
-
-    rp->process_discovered_references(&g1_is_alive,
-                                      &g1_keep_alive,
-                                      &g1_drain_mark_stack,
-                                      &par_task_executor);
-
-    // The work routines of the parallel keep_alive and drain_marking_stack
-    // will set the has_overflown flag if we overflow the global marking
-    // stack.
-  } else {
-    rp->process_discovered_references(&g1_is_alive,
-                                      &g1_keep_alive,
-                                      &g1_drain_mark_stack,
-                                      NULL);
+  {
+    TraceTime t("GC ref-proc", PrintGCDetails, false, gclog_or_tty);
+    if (rp->processing_is_mt()) {
+      // Set the degree of MT here.  If the discovery is done MT, there
+      // may have been a different number of threads doing the discovery
+      // and a different number of discovered lists may have Ref objects.
+      // That is OK as long as the Reference lists are balanced (see
+      // balance_all_queues() and balance_queues()).
+      rp->set_active_mt_degree(active_workers);
+
+      rp->process_discovered_references(&g1_is_alive,
+                                        &g1_keep_alive,
+                                        &g1_drain_mark_stack,
+                                        &par_task_executor);
+
+      // The work routines of the parallel keep_alive and drain_marking_stack
+      // will set the has_overflown flag if we overflow the global marking
+      // stack.
+    } else {
+      rp->process_discovered_references(&g1_is_alive,
+                                        &g1_keep_alive,
+                                        &g1_drain_mark_stack,
+                                        NULL);
 
-  }
+    }
 
-  assert(_markStack.overflow() || _markStack.isEmpty(),
-      "mark stack should be empty (unless it overflowed)");
-  if (_markStack.overflow()) {
-    // Should have been done already when we tried to push an
-    // entry on to the global mark stack. But let's do it again.
-    set_has_overflown();
+    assert(_markStack.overflow() || _markStack.isEmpty(),
+        "mark stack should be empty (unless it overflowed)");
+    if (_markStack.overflow()) {
+      // Should have been done already when we tried to push an
+      // entry on to the global mark stack. But let's do it again.
+      set_has_overflown();
+    }
   }
 
-  if (rp->processing_is_mt()) {
-    assert(rp->num_q() == active_workers, "why not");
-    rp->enqueue_discovered_references(&par_task_executor);
-  } else {
-    rp->enqueue_discovered_references();
+  {
+    TraceTime t("GC ref-enq", PrintGCDetails, false, gclog_or_tty);
+    if (rp->processing_is_mt()) {
+      assert(rp->num_q() == active_workers, "why not");
+      rp->enqueue_discovered_references(&par_task_executor);
+    } else {
+      rp->enqueue_discovered_references();
+    }
   }
 
   rp->verify_no_references_recorded();
   assert(!rp->discovery_enabled(), "should have been disabled");
 
-  // Now clean up stale oops in StringTable
-  StringTable::unlink(&g1_is_alive);
-  // Clean up unreferenced symbols in symbol table.
-  SymbolTable::unlink();
+  {
+    TraceTime t("GC scrub string and symbol tables", PrintGCDetails, false, gclog_or_tty);
+    // The symbols may be left to the safepoint cleanup tasks.
+    bool do_symbols = !SymbolTable::unlinks_incrementally();
+    if (G1CollectedHeap::use_parallel_gc_threads() && g1h->workers() != NULL) {
+      StringSymbolTableUnlinkTask unlink_task(&g1_is_alive, do_symbols);
+      g1h->workers()->run_task(&unlink_task);
+    } else {
+      // Now clean up stale oops in StringTable
+      StringTable::unlink(&g1_is_alive);
+      // Clean up unreferenced symbols in symbol table.
+      if (do_symbols) {
+        SymbolTable::unlink();
+      }
+    }
+  }
 }
 
 void ConcurrentMark::swapMarkBitMaps() {
@@ -388,6 +388,10 @@ protected:
 
   FreeRegionList        _cleanup_list;
 
+  // With G1RebuildRemSets, the number of remembered sets that cleanup set
+  // to be rebuilt.
+  size_t                _rem_sets_to_rebuild;
+
   // CMS marking support structures
   CMBitMap                _markBitMap1;
   CMBitMap                _markBitMap2;
@@ -473,7 +477,7 @@ protected:
 
   double*   _accum_task_vtime;   // accumulated task vtime
 
-  WorkGang* _parallel_workers;
+  FlexibleWorkGang* _parallel_workers;
 
   ForceOverflowSettings _force_overflow_conc;
   ForceOverflowSettings _force_overflow_stw;
@@ -769,6 +773,12 @@ public:
   // Do concurrent phase of marking, to a tentative transitive closure.
   void markFromRoots();
 
+  // Remove from the discovered lists the references which are known to
+  // be alive or inactive once marking has completed, and mark from them,
+  // so that the remark pause has fewer references to process. It is
+  // called by the concurrent mark thread, joined to the STS.
+  void precleanReferences();
+
   // Process all unprocessed SATB buffers. It is called at the
   // beginning of an evacuation pause.
   void drainAllSATBBuffers();
@@ -779,6 +789,17 @@ public:
   void cleanup();
   void completeCleanup();
 
+  // With G1RebuildRemSets: stop maintaining the remembered sets of the old
+  // regions that are not candidates for evacuation, and start maintaining
+  // those of the regions that have become candidates again.  Called during
+  // cleanup, once the liveness of the regions is known.
+  void updateRemSetTracking();
+  // Free the entries of the remembered sets that are no longer maintained,
+  // and add the references from the objects that were in the heap at the
+  // end of cleanup to the remembered sets being rebuilt.  It is called by
+  // the concurrent mark thread, not joined to the STS.
+  void rebuildRemSets();
+
   // Mark in the previous bitmap.  NB: this is usually read-only, so use
   // this carefully!
   void markPrev(oop p);
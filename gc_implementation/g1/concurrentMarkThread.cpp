@@ -162,6 +162,19 @@ void ConcurrentMarkThread::run() {
                                       mark_end_sec - mark_start_sec);
           }
 
+          if (G1PrecleanRefLists) {
+            double preclean_start_sec = os::elapsedTime();
+            _sts.join();
+            _cm->precleanReferences();
+            _sts.leave();
+            if (PrintGC) {
+              gclog_or_tty->date_stamp(PrintGCDateStamps);
+              gclog_or_tty->stamp(PrintGCTimeStamps);
+              gclog_or_tty->print_cr("[GC concurrent-preclean-refs, %1.7lf sec]",
+                                     os::elapsedTime() - preclean_start_sec);
+            }
+          }
+
           CMCheckpointRootsFinalClosure final_cl(_cm);
           sprintf(verbose_str, "GC remark");
           VM_CGC_Operation op(&final_cl, verbose_str);
@@ -274,6 +287,24 @@ void ConcurrentMarkThread::run() {
       guarantee(cm()->cleanup_list_is_empty(),
                 "at this point there should be no regions on the cleanup list");
 
+      if (G1RebuildRemSets && !cm()->has_aborted()) {
+        double rebuild_start_sec = os::elapsedTime();
+        if (PrintGC) {
+          gclog_or_tty->date_stamp(PrintGCDateStamps);
+          gclog_or_tty->stamp(PrintGCTimeStamps);
+          gclog_or_tty->print_cr("[GC concurrent-rebuild-remsets-start]");
+        }
+
+        _cm->rebuildRemSets();
+
+        if (PrintGC) {
+          gclog_or_tty->date_stamp(PrintGCDateStamps);
+          gclog_or_tty->stamp(PrintGCTimeStamps);
+          gclog_or_tty->print_cr("[GC concurrent-rebuild-remsets-end, %1.7lf sec]",
+                                 os::elapsedTime() - rebuild_start_sec);
+        }
+      }
+
       if (cm()->has_aborted()) {
         if (PrintGC) {
           gclog_or_tty->date_stamp(PrintGCDateStamps);
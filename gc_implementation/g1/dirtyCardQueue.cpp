@@ -176,18 +176,11 @@ DirtyCardQueueSet::get_completed_buffer(int stop_at) {
   MutexLockerEx x(_cbl_mon, Mutex::_no_safepoint_check_flag);
 
   if ((int)_n_completed_buffers <= stop_at) {
-    _process_completed = false;
+    reset_process_completed_locked();
     return NULL;
   }
 
-  if (_completed_buffers_head != NULL) {
-    nd = _completed_buffers_head;
-    _completed_buffers_head = nd->next();
-    if (_completed_buffers_head == NULL)
-      _completed_buffers_tail = NULL;
-    _n_completed_buffers--;
-    assert(_n_completed_buffers >= 0, "Invariant");
-  }
+  nd = get_completed_buffer_locked();
   debug_only(assert_completed_buffer_list_len_correct_locked());
   return nd;
 }
@@ -234,6 +227,11 @@ bool DirtyCardQueueSet::apply_closure_to_completed_buffer(int worker_i,
 }
 
 void DirtyCardQueueSet::apply_closure_to_all_completed_buffers() {
+  assert(SafepointSynchronize::is_at_safepoint(), "Must be at safepoint.");
+  {
+    MutexLockerEx x(_cbl_mon, Mutex::_no_safepoint_check_flag);
+    collect_pending_buffers_locked();
+  }
   BufferNode* nd = _completed_buffers_head;
   while (nd != NULL) {
     bool b =
@@ -250,14 +248,7 @@ void DirtyCardQueueSet::clear() {
   BufferNode* buffers_to_delete = NULL;
   {
     MutexLockerEx x(_cbl_mon, Mutex::_no_safepoint_check_flag);
-    while (_completed_buffers_head != NULL) {
-      BufferNode* nd = _completed_buffers_head;
-      _completed_buffers_head = nd->next();
-      nd->set_next(buffers_to_delete);
-      buffers_to_delete = nd;
-    }
-    _n_completed_buffers = 0;
-    _completed_buffers_tail = NULL;
+    buffers_to_delete = take_completed_buffers_locked();
     debug_only(assert_completed_buffer_list_len_correct_locked());
   }
   while (buffers_to_delete != NULL) {
@@ -511,7 +511,7 @@ G1CollectedHeap* G1CollectedHeap::_g1h;
 // Private methods.
 
 HeapRegion*
-G1CollectedHeap::new_region_try_secondary_free_list() {
+G1CollectedHeap::new_region_try_secondary_free_list(int numa_node_index) {
   MutexLockerEx x(SecondaryFreeList_lock, Mutex::_no_safepoint_check_flag);
   while (!_secondary_free_list.is_empty() || free_regions_coming()) {
     if (!_secondary_free_list.is_empty()) {
@@ -525,9 +525,9 @@ G1CollectedHeap::new_region_try_secondary_free_list() {
       // again to allocate from it.
       append_secondary_free_list();
 
-      assert(!_free_list.is_empty(), "if the secondary_free_list was not "
+      HeapRegion* res = remove_from_free_lists(numa_node_index);
+      assert(res != NULL, "if the secondary_free_list was not "
              "empty we should have moved at least one entry to the free_list");
-      HeapRegion* res = _free_list.remove_head();
       if (G1ConcRegionFreeingVerbose) {
         gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                                "allocated "HR_FORMAT" from secondary_free_list",
@@ -549,7 +549,8 @@ G1CollectedHeap::new_region_try_secondary_free_list() {
   return NULL;
 }
 
-HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool do_expand) {
+HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool do_expand,
+                                         int numa_node_index) {
   assert(!isHumongous(word_size) ||
                                   word_size <= (size_t) HeapRegion::GrainWords,
          "the only time we use this to allocate a humongous region is "
@@ -562,25 +563,25 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool do_expand) {
         gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                                "forced to look at the secondary_free_list");
       }
-      res = new_region_try_secondary_free_list();
+      res = new_region_try_secondary_free_list(numa_node_index);
       if (res != NULL) {
         return res;
       }
     }
   }
-  res = _free_list.remove_head_or_null();
+  res = remove_from_free_lists(numa_node_index);
   if (res == NULL) {
     if (G1ConcRegionFreeingVerbose) {
       gclog_or_tty->print_cr("G1ConcRegionFreeing [region alloc] : "
                              "res == NULL, trying the secondary_free_list");
     }
-    res = new_region_try_secondary_free_list();
+    res = new_region_try_secondary_free_list(numa_node_index);
   }
   if (res == NULL && do_expand) {
     if (expand(word_size * HeapWordSize)) {
       // The expansion succeeded and so we should have at least one
       // region on the free list.
-      res = _free_list.remove_head();
+      res = remove_from_free_lists(numa_node_index);
     }
   }
   if (res != NULL) {
@@ -594,10 +595,12 @@ HeapRegion* G1CollectedHeap::new_region(size_t word_size, bool do_expand) {
 }
 
 HeapRegion* G1CollectedHeap::new_gc_alloc_region(int purpose,
-                                                 size_t word_size) {
+                                                 size_t word_size,
+                                                 int numa_node_index) {
   HeapRegion* alloc_region = NULL;
   if (_gc_alloc_region_counts[purpose] < g1_policy()->max_regions(purpose)) {
-    alloc_region = new_region(word_size, true /* do_expand */);
+    alloc_region = new_region(word_size, true /* do_expand */,
+                              numa_node_index);
     if (purpose == GCAllocForSurvived && alloc_region != NULL) {
       alloc_region->set_survivor();
     }
@@ -618,7 +621,8 @@ int G1CollectedHeap::humongous_obj_allocate_find_first(size_t num_regions,
     // Only one region to allocate, no need to go through the slower
     // path. The caller will attempt the expasion if this fails, so
     // let's not try to expand here too.
-    HeapRegion* hr = new_region(word_size, false /* do_expand */);
+    HeapRegion* hr = new_region(word_size, false /* do_expand */,
+                                current_numa_node_index());
     if (hr != NULL) {
       first = hr->hrs_index();
     } else {
@@ -639,13 +643,22 @@ int G1CollectedHeap::humongous_obj_allocate_find_first(size_t num_regions,
     if (free_regions() >= num_regions) {
       first = _hrs->find_contiguous(num_regions);
       if (first != -1) {
+        size_t pending[max_numa_nodes];
+        for (int n = 0; n < _num_numa_nodes; n++) {
+          pending[n] = 0;
+        }
         for (int i = first; i < first + (int) num_regions; ++i) {
           HeapRegion* hr = _hrs->at(i);
           assert(hr->is_empty(), "sanity");
           assert(is_on_master_free_list(hr), "sanity");
           hr->set_pending_removal(true);
+          pending[hr->numa_node_index()] += 1;
+        }
+        for (int n = 0; n < _num_numa_nodes; n++) {
+          if (pending[n] > 0) {
+            _free_lists[n].remove_all_pending(pending[n]);
+          }
         }
-        _free_list.remove_all_pending(num_regions);
       }
     }
   }
@@ -899,6 +912,7 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
   // fails to perform the allocation. b) is the only case when we'll
   // return NULL.
   HeapWord* result = NULL;
+  MutatorAllocRegion* alloc_region = mutator_alloc_region();
   for (int try_count = 1; /* we'll return */; try_count += 1) {
     bool should_try_gc;
     unsigned int gc_count_before;
@@ -906,7 +920,7 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
     {
       MutexLockerEx x(Heap_lock);
 
-      result = _mutator_alloc_region.attempt_allocation_locked(word_size,
+      result = alloc_region->attempt_allocation_locked(word_size,
                                                       false /* bot_updates */);
       if (result != NULL) {
         return result;
@@ -914,11 +928,11 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
 
       // If we reach here, attempt_allocation_locked() above failed to
       // allocate a new region. So the mutator alloc region should be NULL.
-      assert(_mutator_alloc_region.get() == NULL, "only way to get here");
+      assert(alloc_region->get() == NULL, "only way to get here");
 
       if (GC_locker::is_active_and_needs_gc()) {
         if (g1_policy()->can_expand_young_list()) {
-          result = _mutator_alloc_region.attempt_allocation_force(word_size,
+          result = alloc_region->attempt_allocation_force(word_size,
                                                       false /* bot_updates */);
           if (result != NULL) {
             return result;
@@ -960,7 +974,7 @@ HeapWord* G1CollectedHeap::attempt_allocation_slow(size_t word_size,
     // first attempt (without holding the Heap_lock) here and the
     // follow-on attempt will be at the start of the next loop
     // iteration (after taking the Heap_lock).
-    result = _mutator_alloc_region.attempt_allocation(word_size,
+    result = alloc_region->attempt_allocation(word_size,
                                                       false /* bot_updates */);
     if (result != NULL ){
       return result;
@@ -1069,12 +1083,13 @@ HeapWord* G1CollectedHeap::attempt_allocation_humongous(size_t word_size,
 HeapWord* G1CollectedHeap::attempt_allocation_at_safepoint(size_t word_size,
                                        bool expect_null_mutator_alloc_region) {
   assert_at_safepoint(true /* should_be_vm_thread */);
-  assert(_mutator_alloc_region.get() == NULL ||
+  MutatorAllocRegion* alloc_region = mutator_alloc_region();
+  assert(alloc_region->get() == NULL ||
                                              !expect_null_mutator_alloc_region,
          "the current alloc region was unexpectedly found to be non-NULL");
 
   if (!isHumongous(word_size)) {
-    return _mutator_alloc_region.attempt_allocation_locked(word_size,
+    return alloc_region->attempt_allocation_locked(word_size,
                                                       false /* bot_updates */);
   } else {
     return humongous_obj_allocate(word_size);
@@ -1635,7 +1650,8 @@ bool G1CollectedHeap::expand(size_t expand_bytes) {
 
       // Add it to the HeapRegionSeq.
       _hrs->insert(hr);
-      _free_list.add_as_tail(hr);
+      bind_region_to_numa_node(hr);
+      free_list_for(hr)->add_as_tail(hr);
 
       // And we used up an expansion region to create it.
       _expansion_regions--;
@@ -1737,7 +1753,6 @@ G1CollectedHeap::G1CollectedHeap(G1CollectorPolicy* policy_) :
   _cg1r(NULL), _summary_bytes_used(0),
   _refine_cte_cl(NULL),
   _full_collection(false),
-  _free_list("Master Free List"),
   _secondary_free_list("Secondary Free List"),
   _humongous_set("Master Humongous Set"),
   _free_regions_coming(false),
@@ -1775,9 +1790,11 @@ G1CollectedHeap::G1CollectedHeap(G1CollectorPolicy* policy_) :
   }
 
   for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
-    _gc_alloc_regions[ap]          = NULL;
+    for (int n = 0; n < max_numa_nodes; ++n) {
+      _gc_alloc_regions[n][ap]          = NULL;
+      _retained_gc_alloc_regions[n][ap] = NULL;
+    }
     _gc_alloc_region_counts[ap]    = 0;
-    _retained_gc_alloc_regions[ap] = NULL;
     // by default, we do not retain a GC alloc region for each ap;
     // we'll override this, when appropriate, below
     _retain_gc_alloc_region[ap]    = false;
@@ -1933,6 +1950,8 @@ jint G1CollectedHeap::initialize() {
   // Initialize the from_card cache structure of HeapRegionRemSet.
   HeapRegionRemSet::init_heap(max_regions());
 
+  initialize_numa_nodes();
+
   // Now expand into the initial heap size.
   if (!expand(init_byte_size)) {
     vm_exit_during_initialization("Failed to allocate initial heap.");
@@ -2073,10 +2092,12 @@ size_t G1CollectedHeap::used() const {
   assert(Heap_lock->owner() != NULL,
          "Should be owned on this thread's behalf.");
   size_t result = _summary_bytes_used;
-  // Read only once in case it is set to NULL concurrently
-  HeapRegion* hr = _mutator_alloc_region.get();
-  if (hr != NULL)
-    result += hr->used();
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    // Read only once in case it is set to NULL concurrently
+    HeapRegion* hr = _mutator_alloc_regions[i].get();
+    if (hr != NULL)
+      result += hr->used();
+  }
   return result;
 }
 
@@ -2137,7 +2158,7 @@ size_t G1CollectedHeap::unsafe_max_alloc() {
   // to free(), resulting in a SIGSEGV. Note that this doesn't appear
   // to be a problem in the optimized build, since the two loads of the
   // current allocation region field are optimized away.
-  HeapRegion* hr = _mutator_alloc_region.get();
+  HeapRegion* hr = mutator_alloc_region()->get();
   if (hr == NULL) {
     return 0;
   }
@@ -2614,7 +2635,7 @@ size_t G1CollectedHeap::unsafe_max_tlab_alloc(Thread* ignored) const {
   // since we can't allow tlabs to grow big enough to accomodate
   // humongous objects.
 
-  HeapRegion* hr = _mutator_alloc_region.get();
+  HeapRegion* hr = mutator_alloc_region()->get();
   size_t max_tlab_size = _humongous_object_threshold_in_words * wordSize;
   if (hr == NULL) {
     return max_tlab_size;
@@ -3020,6 +3041,12 @@ void G1CollectedHeap::gc_epilogue(bool full /* Ignored */) {
   COMPILER2_PRESENT(assert(DerivedPointerTable::is_empty(),
                         "derived pointer present"));
   // always_do_update_barrier = true;
+
+  // Free the buffers which were allocated because the free lists were
+  // contended, keeping about one per thread for the next mutator phase.
+  jint max_free = (jint)(Threads::number_of_threads() + ParallelGCThreads);
+  JavaThread::satb_mark_queue_set().reduce_free_list(max_free);
+  JavaThread::dirty_card_queue_set().reduce_free_list(max_free);
 }
 
 HeapWord* G1CollectedHeap::do_collection_pause(size_t word_size,
@@ -3512,18 +3539,102 @@ size_t G1CollectedHeap::desired_plab_sz(GCAllocPurpose purpose)
   return gclab_word_size;
 }
 
+void G1CollectedHeap::initialize_numa_nodes() {
+  _num_numa_nodes = 1;
+  _numa_node_ids[0] = 0;
+  if (UseNUMA) {
+    int lgrp_limit = (int)os::numa_get_groups_num();
+    int* lgrp_ids = NEW_C_HEAP_ARRAY(int, lgrp_limit);
+    int lgrp_num = (int)os::numa_get_leaf_groups(lgrp_ids, lgrp_limit);
+    assert(lgrp_num > 0, "There should be at least one locality group");
+    _num_numa_nodes = MAX2(1, MIN2(lgrp_num, (int)max_numa_nodes));
+    for (int i = 0; i < _num_numa_nodes; i++) {
+      _numa_node_ids[i] = lgrp_ids[i];
+    }
+    FREE_C_HEAP_ARRAY(int, lgrp_ids);
+  }
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    _mutator_alloc_regions[i].set_numa_node_index(i);
+  }
+  if (PrintGCDetails && Verbose && _num_numa_nodes > 1) {
+    gclog_or_tty->print_cr("G1 regions spread over %d NUMA nodes",
+                           _num_numa_nodes);
+  }
+}
+
+void G1CollectedHeap::bind_region_to_numa_node(HeapRegion* hr) {
+  if (_num_numa_nodes > 1) {
+    int index = hr->hrs_index() % _num_numa_nodes;
+    hr->set_numa_node_index(index);
+    os::numa_make_local((char*)hr->bottom(), HeapRegion::GrainBytes,
+                        _numa_node_ids[index]);
+  }
+}
+
+HeapRegion* G1CollectedHeap::remove_from_free_lists(int numa_node_index) {
+  assert(numa_node_index >= 0 && numa_node_index < _num_numa_nodes,
+         "invalid NUMA node");
+  // Prefer the given node, then the others in turn.
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    MasterFreeRegionList* free_list =
+      &_free_lists[(numa_node_index + i) % _num_numa_nodes];
+    if (!free_list->is_empty()) {
+      return free_list->remove_head();
+    }
+  }
+  return NULL;
+}
+
+void G1CollectedHeap::add_to_free_lists(HeapRegionLinkedList* list) {
+  if (_num_numa_nodes == 1) {
+    _free_lists[0].add_as_head(list);
+    return;
+  }
+  while (!list->is_empty()) {
+    HeapRegion* hr = list->remove_head();
+    free_list_for(hr)->add_as_head(hr);
+  }
+}
+
+int G1CollectedHeap::numa_node_index_for_lgrp(int lgrp_id) {
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    if (_numa_node_ids[i] == lgrp_id) {
+      return i;
+    }
+  }
+  // A node we do not spread regions over (e.g. beyond max_numa_nodes).
+  return 0;
+}
+
+int G1CollectedHeap::current_numa_node_index_slow() {
+  Thread* thr = Thread::current();
+  int lgrp_id = thr->lgrp_id();
+  if (lgrp_id == -1 || !os::numa_has_group_homing()) {
+    lgrp_id = os::numa_get_group_id();
+    thr->set_lgrp_id(lgrp_id);
+  }
+  return numa_node_index_for_lgrp(lgrp_id);
+}
+
 void G1CollectedHeap::init_mutator_alloc_region() {
-  assert(_mutator_alloc_region.get() == NULL, "pre-condition");
-  _mutator_alloc_region.init();
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    assert(_mutator_alloc_regions[i].get() == NULL, "pre-condition");
+    _mutator_alloc_regions[i].init();
+  }
 }
 
 void G1CollectedHeap::release_mutator_alloc_region() {
-  _mutator_alloc_region.release();
-  assert(_mutator_alloc_region.get() == NULL, "post-condition");
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    _mutator_alloc_regions[i].release();
+    assert(_mutator_alloc_regions[i].get() == NULL, "post-condition");
+  }
 }
 
-void G1CollectedHeap::set_gc_alloc_region(int purpose, HeapRegion* r) {
+void G1CollectedHeap::set_gc_alloc_region(int numa_node_index, int purpose,
+                                          HeapRegion* r) {
   assert(purpose >= 0 && purpose < GCAllocPurposeCount, "invalid purpose");
+  assert(numa_node_index >= 0 && numa_node_index < _num_numa_nodes,
+         "invalid NUMA node");
   // make sure we don't call set_gc_alloc_region() multiple times on
   // the same region
   assert(r == NULL || !r->is_gc_alloc_region(),
@@ -3549,13 +3660,14 @@ void G1CollectedHeap::set_gc_alloc_region(int purpose, HeapRegion* r) {
       r->save_marks();
     }
   }
-  HeapRegion* old_alloc_region = _gc_alloc_regions[purpose];
-  _gc_alloc_regions[purpose] = r;
+  HeapRegion** gc_alloc_regions = _gc_alloc_regions[numa_node_index];
+  HeapRegion* old_alloc_region = gc_alloc_regions[purpose];
+  gc_alloc_regions[purpose] = r;
   if (old_alloc_region != NULL) {
-    // Replace aliases too.
+    // Replace aliases too. Regions are only aliased within a node.
     for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
-      if (_gc_alloc_regions[ap] == old_alloc_region) {
-        _gc_alloc_regions[ap] = r;
+      if (gc_alloc_regions[ap] == old_alloc_region) {
+        gc_alloc_regions[ap] = r;
       }
     }
   }
@@ -3654,69 +3766,77 @@ void G1CollectedHeap::get_gc_alloc_regions() {
   assert(_gc_alloc_region_list == NULL, "invariant");
 
   for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
-    assert(_gc_alloc_regions[ap] == NULL, "invariant");
     assert(_gc_alloc_region_counts[ap] == 0, "invariant");
+  }
 
-    // Create new GC alloc regions.
-    HeapRegion* alloc_region = _retained_gc_alloc_regions[ap];
-    _retained_gc_alloc_regions[ap] = NULL;
-
-    if (alloc_region != NULL) {
-      assert(_retain_gc_alloc_region[ap], "only way to retain a GC region");
-
-      // let's make sure that the GC alloc region is not tagged as such
-      // outside a GC operation
-      assert(!alloc_region->is_gc_alloc_region(), "sanity");
-
-      if (alloc_region->in_collection_set() ||
-          alloc_region->top() == alloc_region->end() ||
-          alloc_region->top() == alloc_region->bottom() ||
-          alloc_region->isHumongous()) {
-        // we will discard the current GC alloc region if
-        // * it's in the collection set (it can happen!),
-        // * it's already full (no point in using it),
-        // * it's empty (this means that it was emptied during
-        // a cleanup and it should be on the free list now), or
-        // * it's humongous (this means that it was emptied
-        // during a cleanup and was added to the free list, but
-        // has been subseqently used to allocate a humongous
-        // object that may be less than the region size).
-
-        alloc_region = NULL;
+  // Each NUMA node gets its own GC alloc regions, so that the GC workers
+  // copy objects into regions on the node they are running on.
+  for (int n = 0; n < _num_numa_nodes; ++n) {
+    HeapRegion** gc_alloc_regions = _gc_alloc_regions[n];
+    for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
+      assert(gc_alloc_regions[ap] == NULL, "invariant");
+
+      // Create new GC alloc regions.
+      HeapRegion* alloc_region = _retained_gc_alloc_regions[n][ap];
+      _retained_gc_alloc_regions[n][ap] = NULL;
+
+      if (alloc_region != NULL) {
+        assert(_retain_gc_alloc_region[ap], "only way to retain a GC region");
+
+        // let's make sure that the GC alloc region is not tagged as such
+        // outside a GC operation
+        assert(!alloc_region->is_gc_alloc_region(), "sanity");
+
+        if (alloc_region->in_collection_set() ||
+            alloc_region->top() == alloc_region->end() ||
+            alloc_region->top() == alloc_region->bottom() ||
+            alloc_region->isHumongous()) {
+          // we will discard the current GC alloc region if
+          // * it's in the collection set (it can happen!),
+          // * it's already full (no point in using it),
+          // * it's empty (this means that it was emptied during
+          // a cleanup and it should be on the free list now), or
+          // * it's humongous (this means that it was emptied
+          // during a cleanup and was added to the free list, but
+          // has been subseqently used to allocate a humongous
+          // object that may be less than the region size).
+
+          alloc_region = NULL;
+        }
       }
-    }
 
-    if (alloc_region == NULL) {
-      // we will get a new GC alloc region
-      alloc_region = new_gc_alloc_region(ap, HeapRegion::GrainWords);
-    } else {
-      // the region was retained from the last collection
-      ++_gc_alloc_region_counts[ap];
-      if (G1PrintHeapRegions) {
-        gclog_or_tty->print_cr("new alloc region %d:["PTR_FORMAT", "PTR_FORMAT"], "
-                               "top "PTR_FORMAT,
-                               alloc_region->hrs_index(), alloc_region->bottom(), alloc_region->end(), alloc_region->top());
+      if (alloc_region == NULL) {
+        // we will get a new GC alloc region
+        alloc_region = new_gc_alloc_region(ap, HeapRegion::GrainWords, n);
+      } else {
+        // the region was retained from the last collection
+        ++_gc_alloc_region_counts[ap];
+        if (G1PrintHeapRegions) {
+          gclog_or_tty->print_cr("new alloc region %d:["PTR_FORMAT", "PTR_FORMAT"], "
+                                 "top "PTR_FORMAT,
+                                 alloc_region->hrs_index(), alloc_region->bottom(), alloc_region->end(), alloc_region->top());
+        }
       }
-    }
 
-    if (alloc_region != NULL) {
-      assert(_gc_alloc_regions[ap] == NULL, "pre-condition");
-      set_gc_alloc_region(ap, alloc_region);
-    }
+      if (alloc_region != NULL) {
+        assert(gc_alloc_regions[ap] == NULL, "pre-condition");
+        set_gc_alloc_region(n, ap, alloc_region);
+      }
 
-    assert(_gc_alloc_regions[ap] == NULL ||
-           _gc_alloc_regions[ap]->is_gc_alloc_region(),
-           "the GC alloc region should be tagged as such");
-    assert(_gc_alloc_regions[ap] == NULL ||
-           _gc_alloc_regions[ap] == _gc_alloc_region_list,
-           "the GC alloc region should be the same as the GC alloc list head");
-  }
-  // Set alternative regions for allocation purposes that have reached
-  // their limit.
-  for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
-    GCAllocPurpose alt_purpose = g1_policy()->alternative_purpose(ap);
-    if (_gc_alloc_regions[ap] == NULL && alt_purpose != ap) {
-      _gc_alloc_regions[ap] = _gc_alloc_regions[alt_purpose];
+      assert(gc_alloc_regions[ap] == NULL ||
+             gc_alloc_regions[ap]->is_gc_alloc_region(),
+             "the GC alloc region should be tagged as such");
+      assert(gc_alloc_regions[ap] == NULL ||
+             gc_alloc_regions[ap] == _gc_alloc_region_list,
+             "the GC alloc region should be the same as the GC alloc list head");
+    }
+    // Set alternative regions for allocation purposes that have reached
+    // their limit.
+    for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
+      GCAllocPurpose alt_purpose = g1_policy()->alternative_purpose(ap);
+      if (gc_alloc_regions[ap] == NULL && alt_purpose != ap) {
+        gc_alloc_regions[ap] = gc_alloc_regions[alt_purpose];
+      }
     }
   }
   assert(check_gc_alloc_regions(), "alloc regions messed up");
@@ -3734,21 +3854,25 @@ void G1CollectedHeap::release_gc_alloc_regions(bool totally) {
   // The current alloc regions contain objs that have survived
   // collection. Make them no longer GC alloc regions.
   for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
-    HeapRegion* r = _gc_alloc_regions[ap];
-    _retained_gc_alloc_regions[ap] = NULL;
     _gc_alloc_region_counts[ap] = 0;
-
-    if (r != NULL) {
-      // we retain nothing on _gc_alloc_regions between GCs
-      set_gc_alloc_region(ap, NULL);
-
-      if (r->is_empty()) {
-        // We didn't actually allocate anything in it; let's just put
-        // it back on the free list.
-        _free_list.add_as_head(r);
-      } else if (_retain_gc_alloc_region[ap] && !totally) {
-        // retain it so that we can use it at the beginning of the next GC
-        _retained_gc_alloc_regions[ap] = r;
+  }
+  for (int n = 0; n < _num_numa_nodes; ++n) {
+    for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
+      HeapRegion* r = _gc_alloc_regions[n][ap];
+      _retained_gc_alloc_regions[n][ap] = NULL;
+
+      if (r != NULL) {
+        // we retain nothing on _gc_alloc_regions between GCs
+        set_gc_alloc_region(n, ap, NULL);
+
+        if (r->is_empty()) {
+          // We didn't actually allocate anything in it; let's just put
+          // it back on the free list.
+          free_list_for(r)->add_as_head(r);
+        } else if (_retain_gc_alloc_region[ap] && !totally) {
+          // retain it so that we can use it at the beginning of the next GC
+          _retained_gc_alloc_regions[n][ap] = r;
+        }
       }
     }
   }
@@ -3759,13 +3883,15 @@ void G1CollectedHeap::release_gc_alloc_regions(bool totally) {
 
 void G1CollectedHeap::print_gc_alloc_regions() {
   gclog_or_tty->print_cr("GC alloc regions");
-  for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
-    HeapRegion* r = _gc_alloc_regions[ap];
-    if (r == NULL) {
-      gclog_or_tty->print_cr("  %2d : "PTR_FORMAT, ap, NULL);
-    } else {
-      gclog_or_tty->print_cr("  %2d : "PTR_FORMAT" "SIZE_FORMAT,
-                             ap, r->bottom(), r->used());
+  for (int n = 0; n < _num_numa_nodes; ++n) {
+    for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
+      HeapRegion* r = _gc_alloc_regions[n][ap];
+      if (r == NULL) {
+        gclog_or_tty->print_cr("  %d/%2d : "PTR_FORMAT, n, ap, NULL);
+      } else {
+        gclog_or_tty->print_cr("  %d/%2d : "PTR_FORMAT" "SIZE_FORMAT,
+                               n, ap, r->bottom(), r->used());
+      }
     }
   }
 }
@@ -4103,13 +4229,16 @@ HeapWord* G1CollectedHeap::par_allocate_during_gc(GCAllocPurpose purpose,
          err_msg("we should not be seeing humongous allocation requests "
                  "during GC, word_size = "SIZE_FORMAT, word_size));
 
-  HeapRegion* alloc_region = _gc_alloc_regions[purpose];
+  // Copy into a region on the node this worker is running on.
+  int numa_node_index = current_numa_node_index();
+  HeapRegion* alloc_region = _gc_alloc_regions[numa_node_index][purpose];
   // let the caller handle alloc failure
   if (alloc_region == NULL) return NULL;
 
   HeapWord* block = alloc_region->par_allocate(word_size);
   if (block == NULL) {
-    block = allocate_during_gc_slow(purpose, alloc_region, true, word_size);
+    block = allocate_during_gc_slow(purpose, numa_node_index, alloc_region,
+                                    true, word_size);
   }
   return block;
 }
@@ -4130,6 +4259,7 @@ void G1CollectedHeap::retire_alloc_region(HeapRegion* alloc_region,
 
 HeapWord*
 G1CollectedHeap::allocate_during_gc_slow(GCAllocPurpose purpose,
+                                         int            numa_node_index,
                                          HeapRegion*    alloc_region,
                                          bool           par,
                                          size_t         word_size) {
@@ -4143,12 +4273,13 @@ G1CollectedHeap::allocate_during_gc_slow(GCAllocPurpose purpose,
   // to protect the whole call.
   MutexLockerEx x(FreeList_lock, Mutex::_no_safepoint_check_flag);
 
+  HeapRegion** gc_alloc_regions = _gc_alloc_regions[numa_node_index];
   HeapWord* block = NULL;
   // In the parallel case, a previous thread to obtain the lock may have
   // already assigned a new gc_alloc_region.
-  if (alloc_region != _gc_alloc_regions[purpose]) {
+  if (alloc_region != gc_alloc_regions[purpose]) {
     assert(par, "But should only happen in parallel case.");
-    alloc_region = _gc_alloc_regions[purpose];
+    alloc_region = gc_alloc_regions[purpose];
     if (alloc_region == NULL) return NULL;
     block = alloc_region->par_allocate(word_size);
     if (block != NULL) return block;
@@ -4162,7 +4293,7 @@ G1CollectedHeap::allocate_during_gc_slow(GCAllocPurpose purpose,
     GCAllocPurpose alt_purpose = g1_policy()->alternative_purpose(purpose);
     // Is there an alternative?
     if (purpose != alt_purpose) {
-      HeapRegion* alt_region = _gc_alloc_regions[alt_purpose];
+      HeapRegion* alt_region = gc_alloc_regions[alt_purpose];
       // Has not the alternative region been aliased?
       if (alloc_region != alt_region && alt_region != NULL) {
         // Try to allocate in the alternative region.
@@ -4172,7 +4303,7 @@ G1CollectedHeap::allocate_during_gc_slow(GCAllocPurpose purpose,
           block = alt_region->allocate(word_size);
         }
         // Make an alias.
-        _gc_alloc_regions[purpose] = _gc_alloc_regions[alt_purpose];
+        gc_alloc_regions[purpose] = gc_alloc_regions[alt_purpose];
         if (block != NULL) {
           return block;
         }
@@ -4182,13 +4313,13 @@ G1CollectedHeap::allocate_during_gc_slow(GCAllocPurpose purpose,
       // and aliased, replace them with a new allocation region.
       purpose = alt_purpose;
     } else {
-      set_gc_alloc_region(purpose, NULL);
+      set_gc_alloc_region(numa_node_index, purpose, NULL);
       return NULL;
     }
   }
 
   // Now allocate a new region for allocation.
-  alloc_region = new_gc_alloc_region(purpose, word_size);
+  alloc_region = new_gc_alloc_region(purpose, word_size, numa_node_index);
 
   // let the caller handle alloc failure
   if (alloc_region != NULL) {
@@ -4198,7 +4329,7 @@ G1CollectedHeap::allocate_during_gc_slow(GCAllocPurpose purpose,
            "Mark should have been saved already.");
     // This must be done last: once it's installed, other regions may
     // allocate in it (without holding the lock.)
-    set_gc_alloc_region(purpose, alloc_region);
+    set_gc_alloc_region(numa_node_index, purpose, alloc_region);
 
     if (par) {
       block = alloc_region->par_allocate(word_size);
@@ -4208,7 +4339,7 @@ G1CollectedHeap::allocate_during_gc_slow(GCAllocPurpose purpose,
     // Caller handles alloc failure.
   } else {
     // This sets other apis using the same old alloc region to NULL, also.
-    set_gc_alloc_region(purpose, NULL);
+    set_gc_alloc_region(numa_node_index, purpose, NULL);
   }
   return block;  // May be NULL.
 }
@@ -4829,7 +4960,7 @@ void G1CollectedHeap::evacuate_collection_set() {
   release_gc_alloc_regions(false /* totally */);
   g1_rem_set()->cleanup_after_oops_into_collection_set_do();
 
-  concurrent_g1_refine()->clear_hot_cache();
+  concurrent_g1_refine()->adjust_hot_cache_size();
   concurrent_g1_refine()->set_use_cache(true);
 
   finalize_for_evac_failure();
@@ -4939,7 +5070,7 @@ void G1CollectedHeap::update_sets_after_freeing_regions(size_t pre_used,
   }
   if (free_list != NULL && !free_list->is_empty()) {
     MutexLockerEx x(FreeList_lock, Mutex::_no_safepoint_check_flag);
-    _free_list.add_as_head(free_list);
+    add_to_free_lists(free_list);
   }
   if (humongous_proxy_set != NULL && !humongous_proxy_set->is_empty()) {
     MutexLockerEx x(OldSets_lock, Mutex::_no_safepoint_check_flag);
@@ -5324,27 +5455,32 @@ void G1CollectedHeap::empty_young_list() {
 
 bool G1CollectedHeap::all_alloc_regions_no_allocs_since_save_marks() {
   bool no_allocs = true;
-  for (int ap = 0; ap < GCAllocPurposeCount && no_allocs; ++ap) {
-    HeapRegion* r = _gc_alloc_regions[ap];
-    no_allocs = r == NULL || r->saved_mark_at_top();
+  for (int n = 0; n < _num_numa_nodes && no_allocs; ++n) {
+    for (int ap = 0; ap < GCAllocPurposeCount && no_allocs; ++ap) {
+      HeapRegion* r = _gc_alloc_regions[n][ap];
+      no_allocs = r == NULL || r->saved_mark_at_top();
+    }
   }
   return no_allocs;
 }
 
 void G1CollectedHeap::retire_all_alloc_regions() {
-  for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
-    HeapRegion* r = _gc_alloc_regions[ap];
-    if (r != NULL) {
-      // Check for aliases.
-      bool has_processed_alias = false;
-      for (int i = 0; i < ap; ++i) {
-        if (_gc_alloc_regions[i] == r) {
-          has_processed_alias = true;
-          break;
+  for (int n = 0; n < _num_numa_nodes; ++n) {
+    HeapRegion** gc_alloc_regions = _gc_alloc_regions[n];
+    for (int ap = 0; ap < GCAllocPurposeCount; ++ap) {
+      HeapRegion* r = gc_alloc_regions[ap];
+      if (r != NULL) {
+        // Check for aliases (only within a node).
+        bool has_processed_alias = false;
+        for (int i = 0; i < ap; ++i) {
+          if (gc_alloc_regions[i] == r) {
+            has_processed_alias = true;
+            break;
+          }
+        }
+        if (!has_processed_alias) {
+          retire_alloc_region(r, false /* par */);
         }
-      }
-      if (!has_processed_alias) {
-        retire_alloc_region(r, false /* par */);
       }
     }
   }
@@ -5352,7 +5488,9 @@ void G1CollectedHeap::retire_all_alloc_regions() {
 
 // Done at the start of full GC.
 void G1CollectedHeap::tear_down_region_lists() {
-  _free_list.remove_all();
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    _free_lists[i].remove_all();
+  }
 }
 
 class RegionResetter: public HeapRegionClosure {
@@ -5405,13 +5543,15 @@ bool G1CollectedHeap::is_in_closed_subset(const void* p) const {
 }
 
 HeapRegion* G1CollectedHeap::new_mutator_alloc_region(size_t word_size,
-                                                      bool force) {
+                                                      bool force,
+                                                      int numa_node_index) {
   assert_heap_locked_or_at_safepoint(true /* should_be_vm_thread */);
   assert(!force || g1_policy()->can_expand_young_list(),
          "if force is true we should be able to expand the young list");
   if (force || !g1_policy()->is_young_list_full()) {
     HeapRegion* new_alloc_region = new_region(word_size,
-                                              false /* do_expand */);
+                                              false /* do_expand */,
+                                              numa_node_index);
     if (new_alloc_region != NULL) {
       g1_policy()->update_region_num(true /* next_is_young */);
       set_region_short_lived_locked(new_alloc_region);
@@ -5433,7 +5573,7 @@ void G1CollectedHeap::retire_mutator_alloc_region(HeapRegion* alloc_region,
 
 HeapRegion* MutatorAllocRegion::allocate_new_region(size_t word_size,
                                                     bool force) {
-  return _g1h->new_mutator_alloc_region(word_size, force);
+  return _g1h->new_mutator_alloc_region(word_size, force, _numa_node_index);
 }
 
 void MutatorAllocRegion::retire_region(HeapRegion* alloc_region,
@@ -5445,14 +5585,14 @@ void MutatorAllocRegion::retire_region(HeapRegion* alloc_region,
 
 class VerifyRegionListsClosure : public HeapRegionClosure {
 private:
-  HumongousRegionSet* _humongous_set;
-  FreeRegionList*     _free_list;
-  size_t              _region_count;
+  HumongousRegionSet*   _humongous_set;
+  MasterFreeRegionList* _free_lists;
+  size_t                _region_count;
 
 public:
   VerifyRegionListsClosure(HumongousRegionSet* humongous_set,
-                           FreeRegionList* free_list) :
-    _humongous_set(humongous_set), _free_list(free_list),
+                           MasterFreeRegionList* free_lists) :
+    _humongous_set(humongous_set), _free_lists(free_lists),
     _region_count(0) { }
 
   size_t region_count()      { return _region_count;      }
@@ -5469,7 +5609,7 @@ public:
     } else if (hr->startsHumongous()) {
       _humongous_set->verify_next_region(hr);
     } else if (hr->is_empty()) {
-      _free_list->verify_next_region(hr);
+      _free_lists[hr->numa_node_index()].verify_next_region(hr);
     }
     return false;
   }
@@ -5479,7 +5619,9 @@ void G1CollectedHeap::verify_region_sets() {
   assert_heap_locked_or_at_safepoint(true /* should_be_vm_thread */);
 
   // First, check the explicit lists.
-  _free_list.verify();
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    _free_lists[i].verify();
+  }
   {
     // Given that a concurrent operation might be adding regions to
     // the secondary free list we have to take the lock before
@@ -5511,11 +5653,15 @@ void G1CollectedHeap::verify_region_sets() {
   // Finally, make sure that the region accounting in the lists is
   // consistent with what we see in the heap.
   _humongous_set.verify_start();
-  _free_list.verify_start();
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    _free_lists[i].verify_start();
+  }
 
-  VerifyRegionListsClosure cl(&_humongous_set, &_free_list);
+  VerifyRegionListsClosure cl(&_humongous_set, _free_lists);
   heap_region_iterate(&cl);
 
   _humongous_set.verify_end();
-  _free_list.verify_end();
+  for (int i = 0; i < _num_numa_nodes; i++) {
+    _free_lists[i].verify_end();
+  }
 }
@@ -133,12 +133,17 @@ public:
 };
 
 class MutatorAllocRegion : public G1AllocRegion {
+private:
+  // The NUMA node new regions are taken from.
+  int _numa_node_index;
 protected:
   virtual HeapRegion* allocate_new_region(size_t word_size, bool force);
   virtual void retire_region(HeapRegion* alloc_region, size_t allocated_bytes);
 public:
   MutatorAllocRegion()
-    : G1AllocRegion("Mutator Alloc Region", false /* bot_updates */) { }
+    : G1AllocRegion("Mutator Alloc Region", false /* bot_updates */),
+      _numa_node_index(0) { }
+  void set_numa_node_index(int index) { _numa_node_index = index; }
 };
 
 class RefineCardTableEntryClosure;
@@ -186,8 +191,29 @@ private:
   // The maximum part of _g1_storage that has ever been committed.
   MemRegion _g1_max_committed;
 
-  // The master free list. It will satisfy all new region allocations.
-  MasterFreeRegionList      _free_list;
+  enum {
+    max_numa_nodes = 8
+  };
+
+  // The master free lists, one per NUMA node (a single one without
+  // UseNUMA). They will satisfy all new region allocations. A free
+  // region is on the list of the node its memory is bound to, so a
+  // region on a given node is found in constant time.
+  MasterFreeRegionList      _free_lists[max_numa_nodes];
+
+  // The master free list of the NUMA node the memory of hr is bound to.
+  MasterFreeRegionList* free_list_for(HeapRegion* hr) {
+    return &_free_lists[hr->numa_node_index()];
+  }
+
+  // It removes and returns the head of the free list of the given NUMA
+  // node or, if that list is empty, of the next non-empty one. It
+  // returns NULL if all the free lists are empty.
+  HeapRegion* remove_from_free_lists(int numa_node_index);
+
+  // It moves the regions of list to the free lists of their NUMA nodes,
+  // at the head, and empties list.
+  void add_to_free_lists(HeapRegionLinkedList* list);
 
   // The secondary free list which contains regions that have been
   // freed up during the cleanup process. This will be appended to the
@@ -211,25 +237,57 @@ private:
   // The sequence of all heap regions in the heap.
   HeapRegionSeq* _hrs;
 
-  // Alloc region used to satisfy mutator allocation requests.
-  MutatorAllocRegion _mutator_alloc_region;
+  // The NUMA nodes the heap regions are spread over (a single one
+  // without UseNUMA), as locality group ids. Nodes beyond
+  // max_numa_nodes are not used.
+  int _num_numa_nodes;
+  int _numa_node_ids[max_numa_nodes];
+
+  // Alloc regions used to satisfy mutator allocation requests, one per
+  // NUMA node. Threads allocate out of the one of the node they are
+  // running on.
+  MutatorAllocRegion _mutator_alloc_regions[max_numa_nodes];
 
-  // It resets the mutator alloc region before new allocations can take place.
+  // It finds the NUMA nodes. It is called before the heap is expanded
+  // for the first time.
+  void initialize_numa_nodes();
+
+  // It binds the memory of a new region to a NUMA node. Regions are
+  // assigned to the nodes round-robin in address order.
+  void bind_region_to_numa_node(HeapRegion* hr);
+
+  // The index of the NUMA node of the given locality group id.
+  int numa_node_index_for_lgrp(int lgrp_id);
+  int current_numa_node_index_slow();
+
+  // The index of the NUMA node the current thread is running on.
+  int current_numa_node_index() {
+    return _num_numa_nodes == 1 ? 0 : current_numa_node_index_slow();
+  }
+
+  // The mutator alloc region of the NUMA node of the current thread.
+  MutatorAllocRegion* mutator_alloc_region() {
+    return &_mutator_alloc_regions[current_numa_node_index()];
+  }
+
+  // It resets the mutator alloc regions before new allocations can take
+  // place.
   void init_mutator_alloc_region();
 
-  // It releases the mutator alloc region.
+  // It releases the mutator alloc regions.
   void release_mutator_alloc_region();
 
   void abandon_gc_alloc_regions();
 
   // The to-space memory regions into which objects are being copied during
-  // a GC.
-  HeapRegion* _gc_alloc_regions[GCAllocPurposeCount];
+  // a GC, per NUMA node. GC workers copy into the regions of the node
+  // they are running on. The region counts are over all nodes.
+  HeapRegion* _gc_alloc_regions[max_numa_nodes][GCAllocPurposeCount];
   size_t _gc_alloc_region_counts[GCAllocPurposeCount];
-  // These are the regions, one per GCAllocPurpose, that are half-full
-  // at the end of a collection and that we want to reuse during the
-  // next collection.
-  HeapRegion* _retained_gc_alloc_regions[GCAllocPurposeCount];
+  // These are the regions, one per NUMA node and GCAllocPurpose, that
+  // are half-full at the end of a collection and that we want to reuse
+  // during the next collection.
+  HeapRegion* _retained_gc_alloc_regions[max_numa_nodes][GCAllocPurposeCount];
   // This specifies whether we will keep the last half-full region at
   // the end of a collection so that it can be reused during the next
   // collection (this is specified per GCAllocPurpose)
@@ -254,7 +312,7 @@ private:
 
   // Should be used to set an alloc region, because there's other
   // associated bookkeeping.
-  void set_gc_alloc_region(int purpose, HeapRegion* r);
+  void set_gc_alloc_region(int numa_node_index, int purpose, HeapRegion* r);
 
   // Check well-formedness of alloc region list.
   bool check_gc_alloc_regions();
@@ -391,19 +449,22 @@ protected:
   // new_region() didn't find a region on the free_list, this call will
   // check whether there's anything available on the
   // secondary_free_list and/or wait for more regions to appear on
-  // that list, if _free_regions_coming is set.
-  HeapRegion* new_region_try_secondary_free_list();
+  // that list, if _free_regions_coming is set. A region on the given
+  // NUMA node is preferred.
+  HeapRegion* new_region_try_secondary_free_list(int numa_node_index);
 
   // Try to allocate a single non-humongous HeapRegion sufficient for
   // an allocation of the given word_size. If do_expand is true,
   // attempt to expand the heap if necessary to satisfy the allocation
-  // request.
-  HeapRegion* new_region(size_t word_size, bool do_expand);
+  // request. A region on the given NUMA node is preferred.
+  HeapRegion* new_region(size_t word_size, bool do_expand,
+                         int numa_node_index);
 
   // Try to allocate a new region to be used for allocation by
   // a GC thread. It will try to expand the heap if no region is
-  // available.
-  HeapRegion* new_gc_alloc_region(int purpose, size_t word_size);
+  // available. A region on the given NUMA node is preferred.
+  HeapRegion* new_gc_alloc_region(int purpose, size_t word_size,
+                                  int numa_node_index);
 
   // Attempt to satisfy a humongous allocation request of the given
   // size by finding a contiguous set of free regions of num_regions
@@ -505,6 +566,7 @@ protected:
   HeapWord* par_allocate_during_gc(GCAllocPurpose purpose, size_t word_size);
 
   HeapWord* allocate_during_gc_slow(GCAllocPurpose purpose,
+                                    int            numa_node_index,
                                     HeapRegion*    alloc_region,
                                     bool           par,
                                     size_t         word_size);
@@ -519,7 +581,8 @@ protected:
 
   // These two methods are the "callbacks" from the G1AllocRegion class.
 
-  HeapRegion* new_mutator_alloc_region(size_t word_size, bool force);
+  HeapRegion* new_mutator_alloc_region(size_t word_size, bool force,
+                                       int numa_node_index);
   void retire_mutator_alloc_region(HeapRegion* alloc_region,
                                    size_t allocated_bytes);
 
@@ -809,9 +872,9 @@ protected:
   // We're done with GC alloc regions. We are going to tear down the
   // gc alloc list and remove the gc alloc tag from all the regions on
   // that list. However, we will also retain the last (i.e., the one
-  // that is half-full) GC alloc region, per GCAllocPurpose, for
-  // possible reuse during the next collection, provided
-  // _retain_gc_alloc_region[] indicates that it should be the
+  // that is half-full) GC alloc region, per NUMA node and
+  // GCAllocPurpose, for possible reuse during the next collection,
+  // provided _retain_gc_alloc_region[] indicates that it should be the
   // case. Said regions are kept in the _retained_gc_alloc_regions[]
   // array. If the parameter totally is set, we will not retain any
   // regions, irrespective of what _retain_gc_alloc_region[]
@@ -961,7 +1024,11 @@ public:
 
   // The number of regions that are completely free.
   size_t free_regions() {
-    return _free_list.length();
+    size_t length = 0;
+    for (int i = 0; i < _num_numa_nodes; i++) {
+      length += _free_lists[i].length();
+    }
+    return length;
   }
 
   // The number of regions that are not completely free.
@@ -993,7 +1060,7 @@ public:
 
 #ifdef ASSERT
   bool is_on_master_free_list(HeapRegion* hr) {
-    return hr->containing_set() == &_free_list;
+    return hr->containing_set() == free_list_for(hr);
   }
 
   bool is_in_humongous_set(HeapRegion* hr) {
@@ -1009,7 +1076,7 @@ public:
   }
 
   void append_secondary_free_list() {
-    _free_list.add_as_head(&_secondary_free_list);
+    add_to_free_lists(&_secondary_free_list);
   }
 
   void append_secondary_free_list_if_not_empty_with_lock() {
@@ -67,7 +67,7 @@ G1CollectedHeap::attempt_allocation(size_t word_size,
   assert(!isHumongous(word_size), "attempt_allocation() should not "
          "be called for humongous allocation requests");
 
-  HeapWord* result = _mutator_alloc_region.attempt_allocation(word_size,
+  HeapWord* result = mutator_alloc_region()->attempt_allocation(word_size,
                                                       false /* bot_updates */);
   if (result == NULL) {
     result = attempt_allocation_slow(word_size, gc_count_before_ret);
@@ -79,6 +79,14 @@ static double non_young_other_cost_per_region_ms_defaults[] = {
   1.0, 0.7, 0.7, 0.5, 0.5, 0.42, 0.42, 0.30
 };
 
+// The yellow zone of concurrent refinement as a multiple of the green
+// zone, and the red zone as a multiple of the yellow zone, and their
+// bounds when they are adjusted to the enqueueing rate.
+static const double conc_refine_yellow_factor_default = 3.0;
+static const double conc_refine_yellow_factor_min     = 1.5;
+static const double conc_refine_red_factor_default    = 2.0;
+static const double conc_refine_red_factor_max        = 8.0;
+
 // </NEW PREDICTION>
 
 // Help class for avoiding interleaved logging
@@ -293,6 +301,15 @@ G1CollectorPolicy::G1CollectorPolicy() :
   _recent_prev_end_times_for_all_gcs_sec->add(os::elapsedTime());
   _prev_collection_pause_end_ms = os::elapsedTime() * 1000.0;
 
+  _conc_refine_enqueue_rate_ms_seq = new TruncatedSeq(TruncatedSeqLength);
+  _conc_refine_thread_rate_ms_seq = new TruncatedSeq(TruncatedSeqLength);
+  _conc_refine_yellow_factor = conc_refine_yellow_factor_default;
+  _conc_refine_red_factor = conc_refine_red_factor_default;
+  _prev_conc_refine_end_sec = os::elapsedTime();
+  _prev_conc_refine_vtime = 0.0;
+  _prev_processed_buffers_mut = 0;
+  _prev_processed_buffers_rs_thread = 0;
+
   _par_last_gc_worker_start_times_ms = new double[_parallel_gc_threads];
   _par_last_ext_root_scan_times_ms = new double[_parallel_gc_threads];
   _par_last_mark_stack_scan_times_ms = new double[_parallel_gc_threads];
@@ -1680,8 +1697,28 @@ void G1CollectorPolicy::adjust_concurrent_refinement(double update_rs_time,
   DirtyCardQueueSet& dcqs = JavaThread::dirty_card_queue_set();
   ConcurrentG1Refine *cg1r = G1CollectedHeap::heap()->concurrent_g1_refine();
 
+  // The buffers enqueued since the last pause, and who refined them.
+  jint mut_buffers = dcqs.processed_buffers_mut() - _prev_processed_buffers_mut;
+  jint rs_thread_buffers =
+    dcqs.processed_buffers_rs_thread() - _prev_processed_buffers_rs_thread;
+  double rs_thread_vtime_ms =
+    (cg1r->worker_threads_vtime() - _prev_conc_refine_vtime) * 1000.0;
+  double app_time_ms =
+    (_cur_collection_start_sec - _prev_conc_refine_end_sec) * 1000.0;
+  _prev_processed_buffers_mut = dcqs.processed_buffers_mut();
+  _prev_processed_buffers_rs_thread = dcqs.processed_buffers_rs_thread();
+  _prev_conc_refine_vtime = cg1r->worker_threads_vtime();
+  _prev_conc_refine_end_sec = os::elapsedTime();
+
+  if (app_time_ms > MIN_TIMER_GRANULARITY) {
+    double enqueued = mut_buffers + rs_thread_buffers + update_rs_processed_buffers;
+    _conc_refine_enqueue_rate_ms_seq->add(enqueued / app_time_ms);
+  }
+  if (rs_thread_buffers > 0 && rs_thread_vtime_ms > MIN_TIMER_GRANULARITY) {
+    _conc_refine_thread_rate_ms_seq->add(rs_thread_buffers / rs_thread_vtime_ms);
+  }
+
   if (G1UseAdaptiveConcRefinement) {
-    const int k_gy = 3, k_gr = 6;
     const double inc_k = 1.1, dec_k = 0.9;
 
     int g = cg1r->green_zone();
@@ -1692,12 +1729,54 @@ void G1CollectorPolicy::adjust_concurrent_refinement(double update_rs_time,
         g = (int)MAX2(g * inc_k, g + 1.0);
       }
     }
+
+    if (mut_buffers > 0) {
+      // The refinement threads fell behind and the mutators had to
+      // refine buffers themselves.  Start all the threads earlier, and
+      // leave more room for bursts before the red zone.
+      _conc_refine_yellow_factor =
+        MAX2(_conc_refine_yellow_factor * dec_k, conc_refine_yellow_factor_min);
+      _conc_refine_red_factor =
+        MIN2(_conc_refine_red_factor * inc_k, conc_refine_red_factor_max);
+    } else {
+      // Otherwise move back towards the defaults.
+      _conc_refine_yellow_factor =
+        MIN2(_conc_refine_yellow_factor * inc_k, conc_refine_yellow_factor_default);
+      _conc_refine_red_factor =
+        MAX2(_conc_refine_red_factor * dec_k, conc_refine_red_factor_default);
+    }
+
+    // Activate as many threads as are needed to keep up with the
+    // predicted enqueueing rate, plus one if the mutators had to help.
+    int n_threads = cg1r->worker_thread_num();
+    if (os::supports_vtime() &&
+        _conc_refine_enqueue_rate_ms_seq->num() > 0 &&
+        _conc_refine_thread_rate_ms_seq->num() > 0) {
+      double thread_rate = _conc_refine_thread_rate_ms_seq->davg();
+      double needed = get_new_prediction(_conc_refine_enqueue_rate_ms_seq) / thread_rate;
+      int n = (int)ceil(needed) + (mut_buffers > 0 ? 1 : 0);
+      n_threads = MAX2(1, MIN2(n, n_threads));
+    }
+
     // Change the refinement threads params
+    int y = (int)(g * _conc_refine_yellow_factor);
     cg1r->set_green_zone(g);
-    cg1r->set_yellow_zone(g * k_gy);
-    cg1r->set_red_zone(g * k_gr);
+    cg1r->set_yellow_zone(y);
+    cg1r->set_red_zone((int)(y * _conc_refine_red_factor));
+    cg1r->set_active_worker_thread_num(n_threads);
     cg1r->reinitialize_threads();
 
+    if (G1TraceConcRefinement) {
+      gclog_or_tty->print_cr("G1-Refine-adjust: %d mutator buffers, %d thread buffers, "
+                             "enqueue rate %1.2f/ms, thread rate %1.2f/ms; "
+                             "zones %d/%d/%d, %d active threads",
+                             mut_buffers, rs_thread_buffers,
+                             _conc_refine_enqueue_rate_ms_seq->davg(),
+                             _conc_refine_thread_rate_ms_seq->davg(),
+                             cg1r->green_zone(), cg1r->yellow_zone(),
+                             cg1r->red_zone(), n_threads);
+    }
+
     int processing_threshold_delta = MAX2((int)(cg1r->green_zone() * sigma()), 1);
     int processing_threshold = MIN2(cg1r->green_zone() + processing_threshold_delta,
                                     cg1r->yellow_zone());
@@ -2469,7 +2548,9 @@ public:
       // sets because we collect them immediately at the end of a marking
       // cycle.  We also don't include young regions because we *must*
       // include them in the next collection pause.
-      if (!r->isHumongous() && !r->is_young()) {
+      // Nor regions whose remembered sets are not complete.
+      if (!r->isHumongous() && !r->is_young() &&
+          r->rem_set()->is_complete()) {
         _hrSorted->addMarkedHeapRegion(r);
       }
     }
@@ -2520,8 +2601,10 @@ public:
       // We don't include humongous regions in collection
       // sets because we collect them immediately at the end of a marking
       // cycle.
-      // We also do not include young regions in collection sets
-      if (!r->isHumongous() && !r->is_young()) {
+      // We also do not include young regions in collection sets, nor
+      // regions whose remembered sets are not complete.
+      if (!r->isHumongous() && !r->is_young() &&
+          r->rem_set()->is_complete()) {
         add_region(r);
       }
     }
@@ -253,6 +253,21 @@ private:
 
   TruncatedSeq* _max_conc_overhead_seq;
 
+  // Concurrent refinement control.  The rates are in update buffers per
+  // ms: the rate at which buffers are enqueued while the mutators run,
+  // and the rate at which one busy refinement thread refines them.
+  TruncatedSeq* _conc_refine_enqueue_rate_ms_seq;
+  TruncatedSeq* _conc_refine_thread_rate_ms_seq;
+  // The yellow zone, as a multiple of the green zone, and the red zone,
+  // as a multiple of the yellow zone.
+  double        _conc_refine_yellow_factor;
+  double        _conc_refine_red_factor;
+  // The values of the counters at the end of the previous pause.
+  double        _prev_conc_refine_end_sec;
+  double        _prev_conc_refine_vtime;
+  jint          _prev_processed_buffers_mut;
+  jint          _prev_processed_buffers_rs_thread;
+
   size_t _recorded_young_regions;
   size_t _recorded_non_young_regions;
   size_t _recorded_region_num;
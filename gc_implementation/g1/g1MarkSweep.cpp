@@ -30,6 +30,7 @@
 #include "code/codeCache.hpp"
 #include "code/icBuffer.hpp"
 #include "gc_implementation/g1/g1MarkSweep.hpp"
+#include "gc_implementation/shared/stringSymbolTableUnlinkTask.hpp"
 #include "memory/gcLocker.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/modRefBarrierSet.hpp"
@@ -46,9 +47,14 @@
 #include "runtime/vmThread.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/events.hpp"
+#include "utilities/workgroup.hpp"
 
 class HeapRegion;
 
+ParMarkSweep* G1MarkSweep::_par_mark_sweep    = NULL;
+HeapRegion**  G1MarkSweep::_compaction_chains = NULL;
+HeapRegion**  G1MarkSweep::_compaction_tails  = NULL;
+
 void G1MarkSweep::invoke_at_safepoint(ReferenceProcessor* rp,
                                       bool clear_all_softrefs) {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
@@ -124,6 +130,25 @@ void G1MarkSweep::allocate_stacks() {
   GenMarkSweep::_preserved_count_max = 0;
   GenMarkSweep::_preserved_marks = NULL;
   GenMarkSweep::_preserved_count = 0;
+
+  if (use_parallel_full_gc() && _par_mark_sweep == NULL) {
+    int n_workers = G1CollectedHeap::heap()->workers()->total_workers();
+    _par_mark_sweep = new ParMarkSweep(n_workers);
+    _compaction_chains = NEW_C_HEAP_ARRAY(HeapRegion*, n_workers);
+    _compaction_tails = NEW_C_HEAP_ARRAY(HeapRegion*, n_workers);
+    for (int i = 0; i < n_workers; i++) {
+      _compaction_chains[i] = NULL;
+      _compaction_tails[i] = NULL;
+    }
+  }
+}
+
+bool G1MarkSweep::use_parallel_full_gc() {
+  // The mark sweep validation code keeps global, order dependent
+  // tables; it only works with the serial phases.
+  return G1UseParallelFullGC &&
+         G1CollectedHeap::use_parallel_gc_threads()
+         NOT_PRODUCT(&& !ValidateMarkSweep && !RecordMarkSweepCompaction);
 }
 
 void G1MarkSweep::mark_sweep_phase1(bool& marked_for_unloading,
@@ -135,12 +160,16 @@ void G1MarkSweep::mark_sweep_phase1(bool& marked_for_unloading,
 
   SharedHeap* sh = SharedHeap::heap();
 
-  sh->process_strong_roots(true,  // activeate StrongRootsScope
-                           true,  // Collecting permanent generation.
-                           SharedHeap::SO_SystemClasses,
-                           &GenMarkSweep::follow_root_closure,
-                           &GenMarkSweep::follow_code_root_closure,
-                           &GenMarkSweep::follow_root_closure);
+  if (use_parallel_full_gc()) {
+    _par_mark_sweep->mark_strong_roots(GenMarkSweep::ref_processor());
+  } else {
+    sh->process_strong_roots(true,  // activeate StrongRootsScope
+                             true,  // Collecting permanent generation.
+                             SharedHeap::SO_SystemClasses,
+                             &GenMarkSweep::follow_root_closure,
+                             &GenMarkSweep::follow_code_root_closure,
+                             &GenMarkSweep::follow_root_closure);
+  }
 
   // Process reference objects found during marking
   ReferenceProcessor* rp = GenMarkSweep::ref_processor();
@@ -172,10 +201,15 @@ void G1MarkSweep::mark_sweep_phase1(bool& marked_for_unloading,
   assert(GenMarkSweep::_marking_stack.is_empty(), "just drained");
 
 
-  // Visit interned string tables and delete unmarked oops
-  StringTable::unlink(&GenMarkSweep::is_alive);
-  // Clean up unreferenced symbols in symbol table.
-  SymbolTable::unlink();
+  if (use_parallel_full_gc()) {
+    StringSymbolTableUnlinkTask unlink_task(&GenMarkSweep::is_alive, true);
+    G1CollectedHeap::heap()->workers()->run_task(&unlink_task);
+  } else {
+    // Visit interned string tables and delete unmarked oops
+    StringTable::unlink(&GenMarkSweep::is_alive);
+    // Clean up unreferenced symbols in symbol table.
+    SymbolTable::unlink();
+  }
 
   assert(GenMarkSweep::_marking_stack.is_empty(),
          "stack should be empty by now");
@@ -186,6 +220,9 @@ class G1PrepareCompactClosure: public HeapRegionClosure {
   ModRefBarrierSet* _mrbs;
   CompactPoint _cp;
   HumongousRegionSet _humongous_proxy_set;
+  // Only deal with the humongous regions; the other regions are
+  // prepared by the parallel workers.
+  bool _humongous_only;
 
   void free_humongous_region(HeapRegion* hr) {
     HeapWord* end = hr->end();
@@ -196,19 +233,24 @@ class G1PrepareCompactClosure: public HeapRegionClosure {
            "Only the start of a humongous region should be freed.");
     _g1h->free_humongous_region(hr, &dummy_pre_used, &dummy_free_list,
                                 &_humongous_proxy_set, false /* par */);
-    hr->prepare_for_compaction(&_cp);
-    // Also clear the part of the card table that will be unused after
-    // compaction.
-    _mrbs->clear(MemRegion(hr->compaction_top(), end));
+    if (!_humongous_only) {
+      hr->prepare_for_compaction(&_cp);
+      // Also clear the part of the card table that will be unused after
+      // compaction.
+      _mrbs->clear(MemRegion(hr->compaction_top(), end));
+    }
     dummy_free_list.remove_all();
   }
 
 public:
-  G1PrepareCompactClosure(CompactibleSpace* cs)
+  G1PrepareCompactClosure(CompactibleSpace* cs, bool humongous_only = false)
   : _g1h(G1CollectedHeap::heap()),
     _mrbs(G1CollectedHeap::heap()->mr_bs()),
-    _cp(NULL, cs, cs->initialize_threshold()),
-    _humongous_proxy_set("G1MarkSweep Humongous Proxy Set") { }
+    _cp(NULL, cs, cs != NULL ? cs->initialize_threshold() : NULL),
+    _humongous_proxy_set("G1MarkSweep Humongous Proxy Set"),
+    _humongous_only(humongous_only) {
+    assert(humongous_only || cs != NULL, "need a compaction space");
+  }
 
   void update_sets() {
     // We'll recalculate total used bytes and recreate the free list
@@ -231,7 +273,7 @@ public:
       } else {
         assert(hr->continuesHumongous(), "Invalid humongous.");
       }
-    } else {
+    } else if (!_humongous_only) {
       hr->prepare_for_compaction(&_cp);
       // Also clear the part of the card table that will be unused after
       // compaction.
@@ -241,6 +283,218 @@ public:
   }
 };
 
+// Prepares the regions claimed by one worker of a parallel full GC.
+// The claimed regions are linked into a compaction chain, in claiming
+// order, before their live objects are forwarded.  Objects are only
+// forwarded into regions earlier in the same chain (or into their own
+// region), so each chain can later be compacted on its own.
+class G1ParPrepareCompactClosure: public HeapRegionClosure {
+  ModRefBarrierSet* _mrbs;
+  CompactPoint _cp;
+  HeapRegion* _first;
+  HeapRegion* _last;
+
+public:
+  G1ParPrepareCompactClosure()
+  : _mrbs(G1CollectedHeap::heap()->mr_bs()),
+    _cp(NULL, NULL, NULL),
+    _first(NULL), _last(NULL) { }
+
+  HeapRegion* first() const { return _first; }
+
+  bool doHeapRegion(HeapRegion* hr) {
+    if (hr->isHumongous()) {
+      // Live humongous objects do not move and the dead ones have
+      // already been freed.
+      return false;
+    }
+    assert(hr->CompactibleSpace::next_compaction_space() == NULL,
+           "region should not be on a compaction chain yet");
+    if (_last == NULL) {
+      _first = hr;
+      _cp.space = hr;
+      _cp.threshold = hr->initialize_threshold();
+    } else {
+      _last->set_next_compaction_space(hr);
+    }
+    _last = hr;
+
+    hr->prepare_for_compaction(&_cp);
+    // Also clear the part of the card table that will be unused after
+    // compaction.
+    _mrbs->clear(MemRegion(hr->compaction_top(), hr->end()));
+    return false;
+  }
+};
+
+class G1ParPrepareCompactTask: public AbstractGangTask {
+public:
+  G1ParPrepareCompactTask() :
+    AbstractGangTask("G1 Full GC Parallel Prepare Compaction") { }
+
+  void work(int i) {
+    G1ParPrepareCompactClosure blk;
+    G1CollectedHeap::heap()->heap_region_par_iterate_chunked(&blk, i,
+                                      HeapRegion::PrepareCompactClaimValue);
+    G1MarkSweep::set_compaction_chain(i, blk.first());
+  }
+};
+
+void G1MarkSweep::par_prepare_compaction() {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  // Free the dead humongous regions first, so that the workers see
+  // them as ordinary empty regions.
+  G1PrepareCompactClosure humongous_blk(NULL, true /* humongous_only */);
+  g1h->heap_region_iterate(&humongous_blk);
+  humongous_blk.update_sets();
+
+  assert(g1h->check_heap_region_claim_values(HeapRegion::InitialClaimValue),
+         "sanity check");
+  G1ParPrepareCompactTask prepare_task;
+  int n_workers = g1h->workers()->total_workers();
+  g1h->set_par_threads(n_workers);
+  g1h->workers()->run_task(&prepare_task);
+  g1h->set_par_threads(0);
+  assert(g1h->check_heap_region_claim_values(
+           HeapRegion::PrepareCompactClaimValue), "sanity check");
+  g1h->reset_heap_region_claim_values();
+
+  coalesce_compaction_tails();
+}
+
+static HeapRegion* next_in_chain(HeapRegion* hr) {
+  return (HeapRegion*) hr->CompactibleSpace::next_compaction_space();
+}
+
+// Forwards objects into the tails of the compaction chains, filling them
+// in chain order (see G1MarkSweep::coalesce_compaction_tails()).
+class G1TailCompactPoint: public StackObj {
+  HeapRegion** _tails;
+  int          _n_tails;
+  int          _cur;
+  CompactPoint _cp;
+  HeapWord*    _compact_top;
+
+  HeapRegion* current() const { return _tails[_cur]; }
+
+  void forward(oop q, size_t size) {
+    while (size > pointer_delta(current()->end(), _compact_top)) {
+      // Switch to the next tail.
+      current()->set_compaction_top(_compact_top);
+      _cur++;
+      assert(_cur < _n_tails, "the objects of the tails must fit in them");
+      _compact_top = current()->bottom();
+      current()->set_compaction_top(_compact_top);
+      _cp.space = current();
+      _cp.threshold = current()->initialize_threshold();
+    }
+    _compact_top = current()->forward(q, size, &_cp, _compact_top);
+  }
+
+public:
+  // The objects of the first tail stay where they were forwarded to; the
+  // block offset table of that tail is extended from its compaction top.
+  G1TailCompactPoint(HeapRegion** tails, int n_tails) :
+    _tails(tails), _n_tails(n_tails), _cur(0),
+    _cp(NULL, tails[0], tails[0]->compaction_top()),
+    _compact_top(tails[0]->compaction_top()) { }
+
+  // Forward again the objects of hr that were forwarded into tail.  The
+  // live objects are found as SCAN_AND_COMPACT() finds them.
+  void reforward_region(HeapRegion* hr, HeapRegion* tail) {
+    HeapWord*       q = hr->bottom();
+    HeapWord* const t = hr->end_of_live();
+
+    if (q < t && hr->first_dead() > q && !oop(q)->is_gc_marked()) {
+      // The objects below first_dead() were not to move; this only
+      // happens in the first region of a chain that is its own tail.
+      assert(hr == tail, "only objects of a tail may not move");
+      HeapWord* const end = hr->first_dead();
+      while (q < end) {
+        size_t size = oop(q)->size();
+        forward(oop(q), size);
+        q += size;
+      }
+      if (end == t) {
+        q = t;
+      } else {
+        q = (HeapWord*) oop(end)->mark()->decode_pointer();
+      }
+    }
+
+    while (q < t) {
+      if (!oop(q)->is_gc_marked()) {
+        // mark is pointer to next marked oop
+        q = (HeapWord*) oop(q)->mark()->decode_pointer();
+      } else {
+        size_t size = oop(q)->size();
+        if (tail->is_in_reserved(oop(q)->forwardee())) {
+          forward(oop(q), size);
+        }
+        q += size;
+      }
+    }
+  }
+
+  void done() {
+    current()->set_compaction_top(_compact_top);
+  }
+};
+
+// Every chain leaves its last region (its tail) partially filled.  Only
+// objects of regions from the tail on the chain are forwarded into it, so
+// they are forwarded again, chain after chain, into the tails taken in
+// chain order: the first tail is filled up, then the second one, and so
+// on.  A tail thus only receives the objects of its own chain and of the
+// chains before it, and at most one tail is left partially filled.  The
+// regions from the tails on are compacted serially and in chain order
+// (see par_compact()), after every chain has been compacted up to its
+// tail.
+void G1MarkSweep::coalesce_compaction_tails() {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+  int n_workers = g1h->workers()->total_workers();
+
+  ResourceMark rm;
+  HeapRegion** tails = NEW_RESOURCE_ARRAY(HeapRegion*, n_workers);
+  int n_tails = 0;
+  for (int i = 0; i < n_workers; i++) {
+    // The regions after the tail are not compacted into.
+    HeapRegion* tail = NULL;
+    for (HeapRegion* hr = _compaction_chains[i];
+         hr != NULL;
+         hr = next_in_chain(hr)) {
+      if (hr->compaction_top() > hr->bottom()) {
+        tail = hr;
+      }
+    }
+    _compaction_tails[i] = tail;
+    if (tail != NULL) {
+      tails[n_tails++] = tail;
+    }
+  }
+  if (n_tails <= 1) {
+    return;
+  }
+
+  G1TailCompactPoint cp(tails, n_tails);
+  for (int k = 1; k < n_tails; k++) {
+    HeapRegion* tail = tails[k];
+    tail->set_compaction_top(tail->bottom());
+    for (HeapRegion* hr = tail; hr != NULL; hr = next_in_chain(hr)) {
+      cp.reforward_region(hr, tail);
+    }
+  }
+  cp.done();
+
+  // Also clear the part of the card table that will be unused after
+  // compaction.
+  ModRefBarrierSet* mrbs = g1h->mr_bs();
+  for (int k = 1; k < n_tails; k++) {
+    mrbs->clear(MemRegion(tails[k]->compaction_top(), tails[k]->end()));
+  }
+}
+
 // Finds the first HeapRegion.
 class FindFirstRegionClosure: public HeapRegionClosure {
   HeapRegion* _a_region;
@@ -274,17 +528,21 @@ void G1MarkSweep::mark_sweep_phase2() {
   TraceTime tm("phase 2", PrintGC && Verbose, true, gclog_or_tty);
   GenMarkSweep::trace("2");
 
-  FindFirstRegionClosure cl;
-  g1h->heap_region_iterate(&cl);
-  HeapRegion *r = cl.result();
-  CompactibleSpace* sp = r;
-  if (r->isHumongous() && oop(r->bottom())->is_gc_marked()) {
-    sp = r->next_compaction_space();
-  }
+  if (use_parallel_full_gc()) {
+    par_prepare_compaction();
+  } else {
+    FindFirstRegionClosure cl;
+    g1h->heap_region_iterate(&cl);
+    HeapRegion *r = cl.result();
+    CompactibleSpace* sp = r;
+    if (r->isHumongous() && oop(r->bottom())->is_gc_marked()) {
+      sp = r->next_compaction_space();
+    }
 
-  G1PrepareCompactClosure blk(sp);
-  g1h->heap_region_iterate(&blk);
-  blk.update_sets();
+    G1PrepareCompactClosure blk(sp);
+    g1h->heap_region_iterate(&blk);
+    blk.update_sets();
+  }
 
   CompactPoint perm_cp(pg, NULL, NULL);
   pg->prepare_for_compaction(&perm_cp);
@@ -310,6 +568,34 @@ class G1AdjustPointersClosure: public HeapRegionClosure {
   }
 };
 
+class G1ParAdjustPointersTask: public AbstractGangTask {
+public:
+  G1ParAdjustPointersTask() :
+    AbstractGangTask("G1 Full GC Parallel Adjust Pointers") { }
+
+  void work(int i) {
+    ResourceMark rm;
+    G1AdjustPointersClosure blk;
+    G1CollectedHeap::heap()->heap_region_par_iterate_chunked(&blk, i,
+                                      HeapRegion::AdjustPointersClaimValue);
+  }
+};
+
+void G1MarkSweep::par_adjust_pointers() {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  assert(g1h->check_heap_region_claim_values(HeapRegion::InitialClaimValue),
+         "sanity check");
+  G1ParAdjustPointersTask adjust_task;
+  int n_workers = g1h->workers()->total_workers();
+  g1h->set_par_threads(n_workers);
+  g1h->workers()->run_task(&adjust_task);
+  g1h->set_par_threads(0);
+  assert(g1h->check_heap_region_claim_values(
+           HeapRegion::AdjustPointersClaimValue), "sanity check");
+  g1h->reset_heap_region_claim_values();
+}
+
 void G1MarkSweep::mark_sweep_phase3() {
   G1CollectedHeap* g1h = G1CollectedHeap::heap();
   Generation* pg = g1h->perm_gen();
@@ -337,14 +623,22 @@ void G1MarkSweep::mark_sweep_phase3() {
 
   GenMarkSweep::adjust_marks();
 
-  G1AdjustPointersClosure blk;
-  g1h->heap_region_iterate(&blk);
+  if (use_parallel_full_gc()) {
+    par_adjust_pointers();
+  } else {
+    G1AdjustPointersClosure blk;
+    g1h->heap_region_iterate(&blk);
+  }
   pg->adjust_pointers();
 }
 
 class G1SpaceCompactClosure: public HeapRegionClosure {
+  // Only deal with the humongous regions; the other regions are
+  // compacted by the parallel workers.
+  bool _humongous_only;
 public:
-  G1SpaceCompactClosure() {}
+  G1SpaceCompactClosure(bool humongous_only = false) :
+    _humongous_only(humongous_only) {}
 
   bool doHeapRegion(HeapRegion* hr) {
     if (hr->isHumongous()) {
@@ -357,13 +651,62 @@ public:
         }
         hr->reset_during_compaction();
       }
-    } else {
+    } else if (!_humongous_only) {
       hr->compact();
     }
     return false;
   }
 };
 
+// Compacts the regions of a compaction chain from hr up to, but not
+// including, stop and returns stop.
+static HeapRegion* compact_chain(HeapRegion* hr, HeapRegion* stop) {
+  while (hr != stop) {
+    hr->compact();
+    // Unlink the region; outside of a parallel full GC the next
+    // compaction space is computed from the region sequence.
+    HeapRegion* next = next_in_chain(hr);
+    hr->set_next_compaction_space(NULL);
+    hr = next;
+  }
+  return hr;
+}
+
+class G1ParCompactTask: public AbstractGangTask {
+public:
+  G1ParCompactTask() :
+    AbstractGangTask("G1 Full GC Parallel Compaction") { }
+
+  void work(int i) {
+    // The regions from the tail on are compacted serially.
+    HeapRegion* hr = compact_chain(G1MarkSweep::compaction_chain(i),
+                                   G1MarkSweep::compaction_tail(i));
+    G1MarkSweep::set_compaction_chain(i, hr);
+  }
+};
+
+void G1MarkSweep::par_compact() {
+  G1CollectedHeap* g1h = G1CollectedHeap::heap();
+
+  G1ParCompactTask compact_task;
+  int n_workers = g1h->workers()->total_workers();
+  g1h->set_par_threads(n_workers);
+  g1h->workers()->run_task(&compact_task);
+  g1h->set_par_threads(0);
+
+  // The objects of the regions from the tail of a chain on may have been
+  // forwarded into the tails of the chains before it, which must have
+  // been compacted already.
+  for (int i = 0; i < n_workers; i++) {
+    compact_chain(compaction_chain(i), NULL);
+    set_compaction_chain(i, NULL);
+    _compaction_tails[i] = NULL;
+  }
+
+  G1SpaceCompactClosure humongous_blk(true /* humongous_only */);
+  g1h->heap_region_iterate(&humongous_blk);
+}
+
 void G1MarkSweep::mark_sweep_phase4() {
   // All pointers are now adjusted, move objects accordingly
 
@@ -385,8 +728,12 @@ void G1MarkSweep::mark_sweep_phase4() {
 
   pg->compact();
 
-  G1SpaceCompactClosure blk;
-  g1h->heap_region_iterate(&blk);
+  if (use_parallel_full_gc()) {
+    par_compact();
+  } else {
+    G1SpaceCompactClosure blk;
+    g1h->heap_region_iterate(&blk);
+  }
 
 }
 
@@ -27,6 +27,7 @@
 
 #include "gc_implementation/g1/g1CollectedHeap.inline.hpp"
 #include "gc_implementation/g1/heapRegion.hpp"
+#include "gc_implementation/shared/parMarkSweep.hpp"
 #include "memory/genMarkSweep.hpp"
 #include "memory/generation.hpp"
 #include "memory/universe.hpp"
@@ -43,7 +44,18 @@ class ReferenceProcessor;
 // compaction.
 //
 // Class unloading will only occur when a full gc is invoked.
-
+//
+// When G1UseParallelFullGC is set and parallel GC threads are available,
+// tracing from the strong roots is done by the G1 work gang using
+// work-stealing mark queues, and phases 2 to 4 are done region by region:
+// every worker threads the regions it claims into a compaction chain of
+// its own and only slides objects along that chain, so that the chains
+// can be forwarded, adjusted and compacted independently of each other.
+// The last region compacted into by each chain (its tail) is only
+// partially filled; the objects forwarded into the tails are forwarded
+// again, serially, so that they fill the tails one after the other, and
+// the chains are compacted serially from their tails on.  Reference
+// processing and class unloading are still done serially.
 
 class G1MarkSweep : AllStatic {
   friend class VM_G1MarkSweep;
@@ -67,6 +79,33 @@ class G1MarkSweep : AllStatic {
   static void mark_sweep_phase4();
 
   static void allocate_stacks();
+
+  // Parallel full GC support
+  static bool use_parallel_full_gc();
+
+  // Calculate new addresses, one compaction chain per worker.
+  static void par_prepare_compaction();
+  // Forward the objects of the chain tails again so that they fill the
+  // tails in chain order.
+  static void coalesce_compaction_tails();
+  // Update pointers in the heap regions with the work gang.
+  static void par_adjust_pointers();
+  // Move objects along each worker's compaction chain.
+  static void par_compact();
+
+  // Per-worker marking state, allocated at the first parallel full GC.
+  static ParMarkSweep* _par_mark_sweep;
+  // Per-worker compaction chains, linked through next_compaction_space(),
+  // and the last region compacted into by each of them.
+  static HeapRegion**  _compaction_chains;
+  static HeapRegion**  _compaction_tails;
+
+ public:
+  static HeapRegion* compaction_chain(int i) { return _compaction_chains[i]; }
+  static void set_compaction_chain(int i, HeapRegion* hr) {
+    _compaction_chains[i] = hr;
+  }
+  static HeapRegion* compaction_tail(int i) { return _compaction_tails[i]; }
 };
 
 #endif // SHARE_VM_GC_IMPLEMENTATION_G1_G1MARKSWEEP_HPP
@@ -638,7 +638,8 @@ public:
   }
 
   bool doHeapRegion(HeapRegion* r) {
-    if (!r->continuesHumongous()) {
+    // The entries of untracked remsets are about to be dropped.
+    if (!r->continuesHumongous() && r->rem_set()->is_tracked()) {
       r->rem_set()->scrub(_ctbs, _region_bm, _card_bm);
     }
     return false;
@@ -911,12 +912,22 @@ bool G1RemSet::concurrentRefineOneCard(jbyte* card_ptr, int worker_i,
 
 class HRRSStatsIter: public HeapRegionClosure {
   size_t _occupied;
+  size_t _occ_sparse;
+  size_t _occ_card_array;
+  size_t _occ_fine;
+  size_t _occ_coarse;
+  size_t _card_array_mem_saved;
   size_t _total_mem_sz;
   size_t _max_mem_sz;
   HeapRegion* _max_mem_sz_region;
 public:
   HRRSStatsIter() :
     _occupied(0),
+    _occ_sparse(0),
+    _occ_card_array(0),
+    _occ_fine(0),
+    _occ_coarse(0),
+    _card_array_mem_saved(0),
     _total_mem_sz(0),
     _max_mem_sz(0),
     _max_mem_sz_region(NULL)
@@ -932,8 +943,18 @@ public:
     _total_mem_sz += mem_sz;
     size_t occ = r->rem_set()->occupied();
     _occupied += occ;
+    _occ_sparse += r->rem_set()->occ_sparse();
+    _occ_card_array += r->rem_set()->occ_card_array();
+    _occ_fine += r->rem_set()->occ_fine();
+    _occ_coarse += r->rem_set()->occ_coarse();
+    _card_array_mem_saved += r->rem_set()->card_array_mem_saved();
     return false;
   }
+  size_t occ_sparse() { return _occ_sparse; }
+  size_t occ_card_array() { return _occ_card_array; }
+  size_t occ_fine() { return _occ_fine; }
+  size_t occ_coarse() { return _occ_coarse; }
+  size_t card_array_mem_saved() { return _card_array_mem_saved; }
   size_t total_mem_sz() { return _total_mem_sz; }
   size_t max_mem_sz() { return _max_mem_sz; }
   size_t occupied() { return _occupied; }
@@ -993,6 +1014,12 @@ void G1RemSet::print_summary_info() {
                          HeapRegionRemSet::fl_mem_size()/K);
   gclog_or_tty->print_cr("    %d occupied cards represented.",
                          blk.occupied());
+  gclog_or_tty->print_cr("      " SIZE_FORMAT " sparse, " SIZE_FORMAT " in card arrays, "
+                         SIZE_FORMAT " fine, " SIZE_FORMAT " coarse.",
+                         blk.occ_sparse(), blk.occ_card_array(),
+                         blk.occ_fine(), blk.occ_coarse());
+  gclog_or_tty->print_cr("    Card arrays save " SIZE_FORMAT "K over per-region bitmaps.",
+                         blk.card_array_mem_saved()/K);
   gclog_or_tty->print_cr("    Max sz region = [" PTR_FORMAT ", " PTR_FORMAT " )"
                          ", cap = " SIZE_FORMAT "K, occ = " SIZE_FORMAT "K.",
                          blk.max_mem_sz_region()->bottom(), blk.max_mem_sz_region()->end(),
@@ -178,13 +178,26 @@
           "A target percentage of time that is allowed to be spend on "     \
           "process RS update buffers during the collection pause.")         \
                                                                             \
+  product(bool, G1PrecleanRefLists, false,                                  \
+          "Preclean the discovered references concurrently once marking "   \
+          "has completed, to shorten reference processing during remark")   \
+                                                                            \
   product(bool, G1UseAdaptiveConcRefinement, true,                          \
-          "Select green, yellow and red zones adaptively to meet the "      \
-          "the pause requirements.")                                        \
+          "Select green, yellow and red zones, and the number of active "   \
+          "refinement threads, adaptively to meet the pause requirements "  \
+          "and the rate at which update buffers are enqueued.")             \
                                                                             \
   develop(intx, G1ConcRSLogCacheSize, 10,                                   \
           "Log base 2 of the length of conc RS hot-card cache.")            \
                                                                             \
+  develop(intx, G1ConcRSMaxLogCacheSize, 16,                                \
+          "Log base 2 of the maximum length of conc RS hot-card cache.")    \
+                                                                            \
+  product(bool, G1UseAdaptiveHotCardCache, true,                            \
+          "Grow the hot card cache when it evicts many of the hot cards "   \
+          "before the next pause, and shrink it when it stays mostly "      \
+          "empty.")                                                         \
+                                                                            \
   develop(intx, G1ConcRSHotCardLimit, 4,                                    \
           "The threshold that defines (>=) a hot card.")                    \
                                                                             \
@@ -210,6 +223,12 @@
           "Max number of entries per region in a sparse table."             \
           "Will be set ergonomically by default.")                          \
                                                                             \
+  product(intx, G1RSetCardArrayEntries, 0,                                  \
+          "Max number of cards per region kept in a card array "            \
+          "before switching to a bitmap. A value no larger than "           \
+          "G1RSetSparseRegionEntries disables card arrays. "                \
+          "Will be set ergonomically by default.")                          \
+                                                                            \
   develop(bool, G1RecordHRRSOops, false,                                    \
           "When true, record recent calls to rem set operations.")          \
                                                                             \
@@ -223,6 +242,16 @@
   develop(bool, G1ScrubRemSets, true,                                       \
           "When true, do RS scrubbing after cleanup.")                      \
                                                                             \
+  product(bool, G1RebuildRemSets, false,                                    \
+          "Maintain the remembered sets of old regions only while they "    \
+          "are candidates for evacuation, and rebuild them concurrently "   \
+          "after marking when they become candidates again")                \
+                                                                            \
+  product(uintx, G1RebuildRemSetsLiveThresholdPercent, 85,                  \
+          "With G1RebuildRemSets, old regions with more live data than "    \
+          "this percentage of the region size are not candidates for "      \
+          "evacuation")                                                     \
+                                                                            \
   develop(bool, G1RSScrubVerbose, false,                                    \
           "When true, do RS scrubbing with verbose output.")                \
                                                                             \
@@ -272,6 +301,10 @@
           "Enables the parallelization of remembered set scanning "         \
           "during evacuation pauses")                                       \
                                                                             \
+  product(bool, G1UseParallelFullGC, true,                                  \
+          "Enables the parallelization of the marking, forwarding, "        \
+          "pointer adjustment and compaction phases of full GCs")           \
+                                                                            \
   product(uintx, G1ConcRefinementThreads, 0,                                \
           "If non-0 is the number of parallel rem set update threads, "     \
           "otherwise the value is determined ergonomically.")               \
@@ -148,6 +148,7 @@ public:
           const jbyte dirty = CardTableModRefBS::dirty_card_val();
 
           bool is_bad = !(from->is_young()
+                          || !to->rem_set()->is_complete()
                           || to->rem_set()->contains_reference(p)
                           || !G1HRRSFlushLogBuffersOnVerify && // buffers were not flushed
                               (_containing_obj->is_objArray() ?
@@ -488,7 +489,7 @@ HeapRegion(G1BlockOffsetSharedArray* sharedOffsetArray,
                      MemRegion mr, bool is_zeroed)
   : G1OffsetTableContigSpace(sharedOffsetArray, mr, is_zeroed),
     _next_fk(HeapRegionDCTOC::NoFilterKind),
-    _hrs_index(-1),
+    _hrs_index(-1), _numa_node_index(0),
     _humongous_type(NotHumongous), _humongous_start_region(NULL),
     _in_collection_set(false), _is_gc_alloc_region(false),
     _next_in_special_set(NULL), _orig_end(NULL),
@@ -541,6 +542,12 @@ public:
 };
 
 CompactibleSpace* HeapRegion::next_compaction_space() const {
+  // A parallel full GC explicitly links the regions of each worker's
+  // compaction chain (see G1MarkSweep).
+  CompactibleSpace* next = CompactibleSpace::next_compaction_space();
+  if (next != NULL) {
+    return next;
+  }
   G1CollectedHeap* g1h = G1CollectedHeap::heap();
   // cast away const-ness
   HeapRegion* r = (HeapRegion*) this;
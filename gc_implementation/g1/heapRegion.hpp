@@ -241,6 +241,10 @@ class HeapRegion: public G1OffsetTableContigSpace {
   // sequence, otherwise -1.
   int  _hrs_index;
 
+  // With UseNUMA, the index (in G1CollectedHeap's list of nodes) of the
+  // NUMA node the memory of this region is bound to, otherwise 0.
+  int  _numa_node_index;
+
   HumongousType _humongous_type;
   // For a humongous region, region in which it starts.
   HeapRegion* _humongous_start_region;
@@ -319,6 +323,12 @@ class HeapRegion: public G1OffsetTableContigSpace {
   // We've counted the marked bytes of objects below here.
   HeapWord* _top_at_conc_mark_count;
 
+  // With G1RebuildRemSets, the top at the last cleanup pause.  The
+  // objects below it are scanned by the concurrent remembered set
+  // rebuild; the references in objects allocated above it are recorded
+  // as they are written.  Reset when the region is freed.
+  HeapWord* volatile _top_at_rebuild_start;
+
   void init_top_at_mark_start() {
     assert(_prev_marked_bytes == 0 &&
            _next_marked_bytes == 0,
@@ -327,6 +337,7 @@ class HeapRegion: public G1OffsetTableContigSpace {
     _prev_top_at_mark_start = bot;
     _next_top_at_mark_start = bot;
     _top_at_conc_mark_count = bot;
+    _top_at_rebuild_start = bot;
   }
 
   void set_young_type(YoungType new_type) {
@@ -379,7 +390,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
     NoteEndClaimValue     = 2,
     ScrubRemSetClaimValue = 3,
     ParVerifyClaimValue   = 4,
-    RebuildRSClaimValue   = 5
+    RebuildRSClaimValue   = 5,
+    PrepareCompactClaimValue = 6,
+    AdjustPointersClaimValue = 7
   };
 
   inline HeapWord* par_allocate_no_bot_updates(size_t word_size) {
@@ -396,6 +409,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
   int hrs_index() const { return _hrs_index; }
   void set_hrs_index(int index) { _hrs_index = index; }
 
+  int numa_node_index() const { return _numa_node_index; }
+  void set_numa_node_index(int index) { _numa_node_index = index; }
+
   // The number of bytes marked live in the region in the last marking phase.
   size_t marked_bytes()    { return _prev_marked_bytes; }
   size_t live_bytes() {
@@ -592,6 +608,9 @@ class HeapRegion: public G1OffsetTableContigSpace {
   HeapWord* prev_top_at_mark_start() const { return _prev_top_at_mark_start; }
   HeapWord* next_top_at_mark_start() const { return _next_top_at_mark_start; }
 
+  HeapWord* top_at_rebuild_start() const { return _top_at_rebuild_start; }
+  void set_top_at_rebuild_start(HeapWord* t) { _top_at_rebuild_start = t; }
+
   // Apply "cl->do_oop" to (the addresses of) all reference fields in objects
   // allocated in the current region before the last call to "save_mark".
   void oop_before_save_marks_iterate(OopClosure* cl);
@@ -848,6 +867,11 @@ class HeapRegion: public G1OffsetTableContigSpace {
 
   CompactibleSpace* next_compaction_space() const;
 
+  // The first dead object and the end of the live objects, as found by
+  // prepare_for_compaction(); the objects below first_dead() do not move.
+  HeapWord* first_dead() const  { return _first_dead; }
+  HeapWord* end_of_live() const { return _end_of_live; }
+
   virtual void reset_after_compaction();
 
   void print() const;
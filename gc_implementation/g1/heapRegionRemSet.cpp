@@ -30,6 +30,10 @@
 #include "gc_implementation/g1/heapRegionSeq.inline.hpp"
 #include "memory/allocation.hpp"
 #include "memory/space.inline.hpp"
+#include "runtime/atomic.hpp"
+#include "runtime/orderAccess.hpp"
+#include "runtime/os.hpp"
+#include "runtime/safepoint.hpp"
 #include "utilities/bitMap.inline.hpp"
 #include "utilities/globalDefinitions.hpp"
 
@@ -486,6 +490,189 @@ void PosParPRT::par_contract_all() {
 PosParPRT* PosParPRT::_free_list = NULL;
 PosParPRT* PosParPRT::_par_expanded_list = NULL;
 
+// The cards of a region that may contain pointers into the owner region,
+// as an array of card indices within that region.  An index fits in a u2,
+// since regions have at most 64K cards, so a card array of up to
+// CardsPerRegion / 16 cards is no larger than a PRT bitmap.
+//
+// Cards are added without locking: a thread claims the next slot with an
+// atomic increment and then stores the card in it, so adders of different
+// cards, and readers, never wait for one another.  Slots are never
+// overwritten; until its card is stored a slot holds NullCard, which
+// readers skip.  Two threads adding the same card at the same time may
+// both store it, which only means that the card is scanned twice.  An
+// array that is full is replaced by a larger copy (or by a PRT) under
+// "_m"; the replaced array may still be read by other threads, so it is
+// retired, and only deleted at the next safepoint cleanup.
+class CardArrayPRT: public CHeapObj {
+  friend class OtherRegionsTable;
+  friend class HeapRegionRemSetIterator;
+
+  HeapRegion*    _hr;
+  volatile u2*   _cards;
+  volatile jint  _claimed;       // May exceed _capacity once the array is full.
+  int            _capacity;
+  CardArrayPRT*  _next;
+  CardArrayPRT*  _next_retired;
+
+  // Set by HeapRegionRemSet::setup_remset_size().
+  static int    _max_cards;
+
+  static CardArrayPRT* volatile _retired_list;
+
+  // Wait until the cards of all the claimed slots have been stored.  The
+  // threads which claimed them store them right after claiming them.
+  void wait_for_claimed_cards() const {
+    for (int i = 0; i < occupied(); i++) {
+      while (_cards[i] == NullCard) {
+        SpinPause();
+      }
+    }
+  }
+
+public:
+  enum {
+    NullCard = max_jushort
+  };
+
+  CardArrayPRT(HeapRegion* hr, int capacity) :
+    _hr(hr), _claimed(0), _capacity(capacity), _next(NULL), _next_retired(NULL) {
+    _cards = NEW_C_HEAP_ARRAY(u2, _capacity);
+    for (int i = 0; i < _capacity; i++) {
+      _cards[i] = NullCard;
+    }
+  }
+
+  ~CardArrayPRT() {
+    FREE_C_HEAP_ARRAY(u2, (u2*)_cards);
+  }
+
+  // The capacity of a new card array: twice the size of a sparse table
+  // entry.
+  static int initial_capacity() {
+    return MIN2(2 * SparsePRTEntry::cards_num(), _max_cards);
+  }
+
+  static void set_max_cards(int max_cards) { _max_cards = max_cards; }
+  // Card arrays are only used if they can hold more cards than an entry
+  // of the sparse table.
+  static bool is_enabled() {
+    return _max_cards > SparsePRTEntry::cards_num();
+  }
+
+  HeapRegion* hr() const { return _hr; }
+  jint occupied() const { return MIN2((jint)_claimed, (jint)_capacity); }
+  bool can_grow() const { return _capacity < _max_cards; }
+
+  CardArrayPRT* next() const { return _next; }
+  void set_next(CardArrayPRT* nxt) { _next = nxt; }
+  CardArrayPRT** next_addr() { return &_next; }
+
+  // The card in slot "i", or NullCard if it is being added.
+  CardIdx_t card(int i) const {
+    assert(0 <= i && i < occupied(), "Must be in range.");
+    return (CardIdx_t)_cards[i];
+  }
+
+  bool contains_card(CardIdx_t card_index) const {
+    jint n = occupied();
+    for (int i = 0; i < n; i++) {
+      if (_cards[i] == card_index) return true;
+    }
+    return false;
+  }
+
+  // Add "card_index" to the array, if it is not there yet.  May be
+  // called without locking.  Returns "false" if the array is full; the
+  // caller must then take "_m" and grow the array, or transfer its
+  // cards to a PRT.
+  bool add_card(CardIdx_t card_index) {
+    assert(0 <= card_index && card_index < NullCard, "Must be in range.");
+    if (contains_card(card_index)) return true;
+    jint i = Atomic::add(1, &_claimed) - 1;
+    if (i >= _capacity) return false;
+    _cards[i] = (u2)card_index;
+    return true;
+  }
+
+  // Return a copy of this full array with room for more cards.
+  CardArrayPRT* expand() const {
+    assert(can_grow(), "Precondition");
+    CardArrayPRT* res = new CardArrayPRT(_hr, MIN2(_capacity * 2, _max_cards));
+    wait_for_claimed_cards();
+    jint n = occupied();
+    for (int i = 0; i < n; i++) {
+      res->_cards[i] = _cards[i];
+    }
+    res->_claimed = n;
+    return res;
+  }
+
+  // Transfer the cards to "prt".
+  void transfer_to(PosParPRT* prt) const {
+    wait_for_claimed_cards();
+    jint n = occupied();
+    for (int i = 0; i < n; i++) {
+      prt->add_card(card(i));
+    }
+  }
+
+  // At present, this must be called stop-world single-threaded.
+  void scrub(CardTableModRefBS* ctbs, BitMap* card_bm) {
+    size_t hr_first_card_index = ctbs->index_for(hr()->bottom());
+    jint n = occupied();
+    int j = 0;
+    for (int i = 0; i < n; i++) {
+      if (card_bm->at(hr_first_card_index + _cards[i])) {
+        _cards[j++] = _cards[i];
+      }
+    }
+    for (int i = j; i < n; i++) {
+      _cards[i] = NullCard;
+    }
+    _claimed = j;
+  }
+
+  // Mem size in bytes.
+  size_t mem_size() const {
+    return sizeof(CardArrayPRT) + _capacity * sizeof(u2);
+  }
+
+  // The size of a PRT holding the same cards.
+  static size_t prt_mem_size() {
+    return sizeof(PosParPRT) + HeapRegion::CardsPerRegion / BitsPerByte;
+  }
+
+  // Put a card array which has been unlinked, but may still be read by
+  // other threads, on the list of arrays deleted at the next cleanup.
+  static void retire(CardArrayPRT* card_array) {
+    CardArrayPRT* hd = _retired_list;
+    while (true) {
+      card_array->_next_retired = hd;
+      CardArrayPRT* res =
+        (CardArrayPRT*) Atomic::cmpxchg_ptr(card_array, &_retired_list, hd);
+      if (res == hd) return;
+      hd = res;
+    }
+  }
+
+  // Delete the retired card arrays.  Only done at a safepoint, when no
+  // other thread uses card arrays.
+  static void delete_retired() {
+    if (!SafepointSynchronize::is_at_safepoint()) return;
+    CardArrayPRT* cur = _retired_list;
+    while (cur != NULL) {
+      CardArrayPRT* nxt = cur->_next_retired;
+      delete cur;
+      cur = nxt;
+    }
+    _retired_list = NULL;
+  }
+};
+
+int CardArrayPRT::_max_cards = 0;
+CardArrayPRT* volatile CardArrayPRT::_retired_list = NULL;
+
 jint OtherRegionsTable::_cache_probes = 0;
 jint OtherRegionsTable::_cache_hits = 0;
 
@@ -507,7 +694,8 @@ OtherRegionsTable::OtherRegionsTable(HeapRegion* hr) :
 #if SAMPLE_FOR_EVICTION
   _fine_eviction_start(0),
 #endif
-  _sparse_table(hr)
+  _sparse_table(hr),
+  _card_arrays(NULL), _n_card_arrays(0)
 {
   typedef PosParPRT* PosParPRTPtr;
   if (_max_fine_entries == 0) {
@@ -626,19 +814,54 @@ void OtherRegionsTable::add_reference(OopOrNarrowOopStar from, int tid) {
   // Otherwise find a per-region table to add it to.
   size_t ind = from_hrs_ind & _mod_max_fine_entries_mask;
   PosParPRT* prt = find_region_table(ind, from_hr);
+  uintptr_t from_hr_bot_card_index =
+    uintptr_t(from_hr->bottom())
+      >> CardTableModRefBS::card_shift;
+  CardIdx_t card_index = from_card - from_hr_bot_card_index;
+  assert(0 <= card_index && card_index < HeapRegion::CardsPerRegion,
+         "Must be in range.");
+  if (prt == NULL && G1HRRSUseSparseTable) {
+    // Card arrays which are not full are added to without locking.
+    CardArrayPRT* card_array = find_card_array(from_hr);
+    if (card_array != NULL && card_array->add_card(card_index)) {
+      if (G1RecordHRRSOops) {
+        HeapRegionRemSet::record(hr(), from);
+      }
+      assert(contains_reference(from), "We just added it!");
+      return;
+    }
+  }
   if (prt == NULL) {
     MutexLockerEx x(&_m, Mutex::_no_safepoint_check_flag);
     // Confirm that it's really not there...
     prt = find_region_table(ind, from_hr);
     if (prt == NULL) {
 
-      uintptr_t from_hr_bot_card_index =
-        uintptr_t(from_hr->bottom())
-          >> CardTableModRefBS::card_shift;
-      CardIdx_t card_index = from_card - from_hr_bot_card_index;
-      assert(0 <= card_index && card_index < HeapRegion::CardsPerRegion,
-             "Must be in range.");
-      if (G1HRRSUseSparseTable &&
+      CardArrayPRT* card_array = NULL;
+      if (G1HRRSUseSparseTable) {
+        card_array = find_card_array(from_hr);
+      }
+      if (card_array != NULL) {
+        // The array may have been replaced by a larger one since it was
+        // found full; if not, replace it now while it is small enough.
+        bool added = card_array->add_card(card_index);
+        if (!added && card_array->can_grow()) {
+          grow_card_array(card_array, card_index);
+          added = true;
+        }
+        if (added) {
+          if (G1RecordHRRSOops) {
+            HeapRegionRemSet::record(hr(), from);
+          }
+          assert(contains_reference_locked(from), "We just added it!");
+          return;
+        }
+#if HRRS_VERBOSE
+        gclog_or_tty->print_cr("   [tid %d] card array "
+                      "overflow(f: %d, t: %d)",
+                      tid, from_hrs_ind, cur_hrs_ind);
+#endif
+      } else if (G1HRRSUseSparseTable &&
           _sparse_table.add_card(from_hrs_ind, card_index)) {
         if (G1RecordHRRSOops) {
           HeapRegionRemSet::record(hr(), from);
@@ -661,11 +884,21 @@ void OtherRegionsTable::add_reference(OopOrNarrowOopStar from, int tid) {
                       "overflow(f: %d, t: %d)",
                       tid, from_hrs_ind, cur_hrs_ind);
 #endif
+        if (G1HRRSUseSparseTable && CardArrayPRT::is_enabled()) {
+          add_card_array(from_hr, card_index);
+          if (G1RecordHRRSOops) {
+            HeapRegionRemSet::record(hr(), from);
+          }
+          assert(contains_reference_locked(from), "We just added it!");
+          return;
+        }
       }
 
-      if (_n_fine_entries == _max_fine_entries) {
-        prt = delete_region_table();
-      } else {
+      if (card_array == NULL) {
+        prt = make_room_for_fine_entry();
+      }
+      // else the PRT takes the place of the card array in the budget.
+      if (prt == NULL) {
         prt = PosParPRT::alloc(from_hr);
       }
       prt->init(from_hr);
@@ -675,7 +908,13 @@ void OtherRegionsTable::add_reference(OopOrNarrowOopStar from, int tid) {
       _fine_grain_regions[ind] = prt;
       _n_fine_entries++;
 
-      if (G1HRRSUseSparseTable) {
+      if (card_array != NULL) {
+        // Transfer from the card array to fine-grain.
+        card_array->transfer_to(prt);
+        // Now we can delete the card array.
+        bool res = del_card_array(from_hr);
+        assert(res, "It should have been there.");
+      } else if (G1HRRSUseSparseTable) {
         // Transfer from sparse to fine-grain.
         SparsePRTEntry *sprt_entry = _sparse_table.get_entry(from_hrs_ind);
         assert(sprt_entry != NULL, "There should have been an entry");
@@ -736,6 +975,134 @@ OtherRegionsTable::find_region_table(size_t ind, HeapRegion* hr) const {
   return prt;
 }
 
+CardArrayPRT* OtherRegionsTable::find_card_array(HeapRegion* hr) const {
+  CardArrayPRT** card_arrays = _card_arrays;
+  if (card_arrays == NULL) return NULL;
+  size_t ind = hr->hrs_index() & _mod_max_fine_entries_mask;
+  CardArrayPRT* card_array = card_arrays[ind];
+  while (card_array != NULL && card_array->hr() != hr) {
+    card_array = card_array->next();
+  }
+  return card_array;
+}
+
+void OtherRegionsTable::add_card_array(HeapRegion* hr, CardIdx_t card_index) {
+  assert(_m.owned_by_self(), "Precondition");
+  RegionIdx_t hrs_ind = (RegionIdx_t) hr->hrs_index();
+  if (_card_arrays == NULL) {
+    CardArrayPRT** card_arrays = NEW_C_HEAP_ARRAY(CardArrayPRT*, _max_fine_entries);
+    for (size_t i = 0; i < _max_fine_entries; i++) {
+      card_arrays[i] = NULL;
+    }
+    OrderAccess::release_store_ptr(&_card_arrays, card_arrays);
+  }
+  PosParPRT* evicted = make_room_for_fine_entry();
+  if (evicted != NULL) {
+    PosParPRT::free(evicted);
+  }
+  CardArrayPRT* card_array = new CardArrayPRT(hr, CardArrayPRT::initial_capacity());
+  // Transfer from sparse to the card array.
+  SparsePRTEntry* sprt_entry = _sparse_table.get_entry(hrs_ind);
+  assert(sprt_entry != NULL, "There should have been an entry");
+  for (int i = 0; i < SparsePRTEntry::cards_num(); i++) {
+    CardIdx_t c = sprt_entry->card(i);
+    if (c != SparsePRTEntry::NullEntry) {
+      card_array->add_card(c);
+    }
+  }
+  bool res = _sparse_table.delete_entry(hrs_ind);
+  assert(res, "It should have been there.");
+  res = card_array->add_card(card_index);
+  assert(res, "A new card array has room for one more card.");
+
+  // Publish the array only once it is filled in.
+  size_t ind = hrs_ind & _mod_max_fine_entries_mask;
+  card_array->set_next(_card_arrays[ind]);
+  OrderAccess::release_store_ptr(&_card_arrays[ind], card_array);
+  _n_card_arrays++;
+}
+
+void OtherRegionsTable::grow_card_array(CardArrayPRT* card_array,
+                                        CardIdx_t card_index) {
+  assert(_m.owned_by_self(), "Precondition");
+  size_t ind = card_array->hr()->hrs_index() & _mod_max_fine_entries_mask;
+  CardArrayPRT** prev_addr = &_card_arrays[ind];
+  while (*prev_addr != card_array) {
+    prev_addr = (*prev_addr)->next_addr();
+  }
+  CardArrayPRT* new_array = card_array->expand();
+  bool res = new_array->add_card(card_index);
+  assert(res, "An expanded card array has room for one more card.");
+  new_array->set_next(card_array->next());
+  OrderAccess::release_store_ptr(prev_addr, new_array);
+  CardArrayPRT::retire(card_array);
+}
+
+bool OtherRegionsTable::del_card_array(HeapRegion* hr) {
+  if (_card_arrays == NULL) return false;
+  size_t ind = hr->hrs_index() & _mod_max_fine_entries_mask;
+  CardArrayPRT** prev_addr = &_card_arrays[ind];
+  CardArrayPRT* card_array = *prev_addr;
+  while (card_array != NULL && card_array->hr() != hr) {
+    prev_addr = card_array->next_addr();
+    card_array = card_array->next();
+  }
+  if (card_array != NULL) {
+    *prev_addr = card_array->next();
+    CardArrayPRT::retire(card_array);
+    _n_card_arrays--;
+    return true;
+  } else {
+    return false;
+  }
+}
+
+void OtherRegionsTable::coarsen_card_array() {
+  assert(_m.owned_by_self(), "Precondition");
+  assert(_n_card_arrays > 0, "Precondition");
+  CardArrayPRT* max = NULL;
+  CardArrayPRT** max_prev = NULL;
+  for (size_t i = 0; i < _max_fine_entries; i++) {
+    CardArrayPRT** prev = &_card_arrays[i];
+    CardArrayPRT* cur = *prev;
+    while (cur != NULL) {
+      if (max == NULL || cur->occupied() > max->occupied()) {
+        max = cur;
+        max_prev = prev;
+      }
+      prev = cur->next_addr();
+      cur = cur->next();
+    }
+  }
+  guarantee(max != NULL, "Since _n_card_arrays > 0");
+
+  // Set the coarse bit before unlinking the array: a thread which still
+  // adds to the array then adds a card of a region scanned as a whole.
+  int max_hrs_index = max->hr()->hrs_index();
+  if (!_coarse_map.at(max_hrs_index)) {
+    _coarse_map.at_put(max_hrs_index, true);
+    _n_coarse_entries++;
+  }
+  *max_prev = max->next();
+  CardArrayPRT::retire(max);
+  Atomic::inc(&_n_coarsenings);
+  _n_card_arrays--;
+}
+
+PosParPRT* OtherRegionsTable::make_room_for_fine_entry() {
+  assert(_m.owned_by_self(), "Precondition");
+  if (_n_fine_entries + _n_card_arrays < _max_fine_entries) {
+    return NULL;
+  }
+  // PRTs hold more cards than any card array, so coarsen one of them
+  // first.
+  if (_n_fine_entries > 0) {
+    return delete_region_table();
+  }
+  coarsen_card_array();
+  return NULL;
+}
+
 
 #define DRT_CENSUS 0
 
@@ -755,7 +1122,8 @@ PosParPRT* OtherRegionsTable::delete_region_table() {
 #endif
 
   assert(_m.owned_by_self(), "Precondition");
-  assert(_n_fine_entries == _max_fine_entries, "Precondition");
+  assert(_n_fine_entries > 0 &&
+         _n_fine_entries + _n_card_arrays == _max_fine_entries, "Precondition");
   PosParPRT* max = NULL;
   jint max_occ = 0;
   PosParPRT** max_prev;
@@ -906,6 +1274,29 @@ void OtherRegionsTable::scrub(CardTableModRefBS* ctbs,
       cur = nxt;
     }
   }
+
+  // And the card arrays.
+  if (_card_arrays != NULL) {
+    for (size_t i = 0; i < _max_fine_entries; i++) {
+      CardArrayPRT** prev = &_card_arrays[i];
+      CardArrayPRT* cur = *prev;
+      while (cur != NULL) {
+        CardArrayPRT* nxt = cur->next();
+        if (region_bm->at(cur->hr()->hrs_index())) {
+          cur->scrub(ctbs, card_bm);
+        }
+        if (!region_bm->at(cur->hr()->hrs_index()) || cur->occupied() == 0) {
+          *prev = nxt;
+          _n_card_arrays--;
+          delete cur;
+        } else {
+          prev = cur->next_addr();
+        }
+        cur = nxt;
+      }
+    }
+  }
+
   // Since we may have deleted a from_card_cache entry from the RS, clear
   // the FCC.
   clear_fcc();
@@ -917,6 +1308,7 @@ size_t OtherRegionsTable::occupied() const {
   MutexLockerEx x((Mutex*)&_m, Mutex::_no_safepoint_check_flag);
   size_t sum = occ_fine();
   sum += occ_sparse();
+  sum += occ_card_array();
   sum += occ_coarse();
   return sum;
 }
@@ -941,6 +1333,38 @@ size_t OtherRegionsTable::occ_sparse() const {
   return _sparse_table.occupied();
 }
 
+size_t OtherRegionsTable::occ_card_array() const {
+  if (_card_arrays == NULL) return 0;
+  size_t sum = 0;
+  for (size_t i = 0; i < _max_fine_entries; i++) {
+    CardArrayPRT* cur = _card_arrays[i];
+    while (cur != NULL) {
+      sum += cur->occupied();
+      cur = cur->next();
+    }
+  }
+  return sum;
+}
+
+size_t OtherRegionsTable::card_array_mem_saved() const {
+  // Cast away const in this case.
+  MutexLockerEx x((Mutex*)&_m, Mutex::_no_safepoint_check_flag);
+  if (_card_arrays == NULL) return 0;
+  size_t sum = 0;
+  for (size_t i = 0; i < _max_fine_entries; i++) {
+    CardArrayPRT* cur = _card_arrays[i];
+    while (cur != NULL) {
+      // A card array may be larger than a PRT if G1RSetCardArrayEntries
+      // was set on the command line.
+      if (cur->mem_size() < CardArrayPRT::prt_mem_size()) {
+        sum += CardArrayPRT::prt_mem_size() - cur->mem_size();
+      }
+      cur = cur->next();
+    }
+  }
+  return sum;
+}
+
 size_t OtherRegionsTable::mem_size() const {
   // Cast away const in this case.
   MutexLockerEx x((Mutex*)&_m, Mutex::_no_safepoint_check_flag);
@@ -953,6 +1377,16 @@ size_t OtherRegionsTable::mem_size() const {
     }
   }
   sum += (sizeof(PosParPRT*) * _max_fine_entries);
+  if (_card_arrays != NULL) {
+    for (size_t i = 0; i < _max_fine_entries; i++) {
+      CardArrayPRT* cur = _card_arrays[i];
+      while (cur != NULL) {
+        sum += cur->mem_size();
+        cur = cur->next();
+      }
+    }
+    sum += (sizeof(CardArrayPRT*) * _max_fine_entries);
+  }
   sum += (_coarse_map.size_in_words() * HeapWordSize);
   sum += (_sparse_table.mem_size());
   sum += sizeof(*this) - sizeof(_sparse_table); // Avoid double counting above.
@@ -984,6 +1418,18 @@ void OtherRegionsTable::clear() {
     }
     _fine_grain_regions[i] = NULL;
   }
+  if (_card_arrays != NULL) {
+    for (size_t i = 0; i < _max_fine_entries; i++) {
+      CardArrayPRT* cur = _card_arrays[i];
+      while (cur != NULL) {
+        CardArrayPRT* nxt = cur->next();
+        CardArrayPRT::retire(cur);
+        cur = nxt;
+      }
+      _card_arrays[i] = NULL;
+    }
+  }
+  _n_card_arrays = 0;
   _sparse_table.clear();
   _coarse_map.clear();
   _n_fine_entries = 0;
@@ -998,7 +1444,7 @@ void OtherRegionsTable::clear_incoming_entry(HeapRegion* from_hr) {
   size_t ind = hrs_ind & _mod_max_fine_entries_mask;
   if (del_single_region_table(ind, from_hr)) {
     assert(!_coarse_map.at(hrs_ind), "Inv");
-  } else {
+  } else if (!del_card_array(from_hr)) {
     _coarse_map.par_at_put(hrs_ind, 0);
   }
   // Check to see if any of the fcc entries come from here.
@@ -1063,6 +1509,10 @@ bool OtherRegionsTable::contains_reference_locked(OopOrNarrowOopStar from) const
     CardIdx_t card_index = from_card - hr_bot_card_index;
     assert(0 <= card_index && card_index < HeapRegion::CardsPerRegion,
            "Must be in range.");
+    CardArrayPRT* card_array = find_card_array(hr);
+    if (card_array != NULL) {
+      return card_array->contains_card(card_index);
+    }
     return _sparse_table.contains_card(hr_ind, card_index);
   }
 
@@ -1077,13 +1527,26 @@ OtherRegionsTable::do_cleanup_work(HRRSCleanupTask* hrrs_cleanup_task) {
 // Determines how many threads can add records to an rset in parallel.
 // This can be done by either mutator threads together with the
 // concurrent refinement threads or GC threads.
-int HeapRegionRemSet::num_par_rem_sets() {
+static int num_update_rem_sets() {
   return (int)MAX2(DirtyCardQueueSet::num_par_ids() + ConcurrentG1Refine::thread_num(), ParallelGCThreads);
 }
 
+// The concurrent marking threads rebuilding remembered sets add records
+// at the same time as the threads above, so they get the ids after theirs.
+int HeapRegionRemSet::num_par_rem_sets() {
+  return num_update_rem_sets() + (int)MAX2(ParallelGCThreads, (size_t)1);
+}
+
+int HeapRegionRemSet::rebuild_rem_set_id(int worker_i) {
+  assert(0 <= worker_i && worker_i < (int)MAX2(ParallelGCThreads, (size_t)1),
+         "marking worker id out of range");
+  return num_update_rem_sets() + worker_i;
+}
+
 HeapRegionRemSet::HeapRegionRemSet(G1BlockOffsetSharedArray* bosa,
                                    HeapRegion* hr)
-  : _bosa(bosa), _other_regions(hr), _iter_state(Unclaimed) { }
+  : _bosa(bosa), _other_regions(hr), _iter_state(Unclaimed),
+    _tracking_state(Tracked) { }
 
 
 void HeapRegionRemSet::setup_remset_size() {
@@ -1097,6 +1560,18 @@ void HeapRegionRemSet::setup_remset_size() {
     G1RSetRegionEntries = G1RSetRegionEntriesBase * (region_size_log_mb + 1);
   }
   guarantee(G1RSetSparseRegionEntries > 0 && G1RSetRegionEntries > 0 , "Sanity");
+
+  // A card array may grow until it is as large as a PRT bitmap.  Card
+  // indices and the empty slot marker must fit in a u2, so there are no
+  // card arrays with the largest regions.
+  if (FLAG_IS_DEFAULT(G1RSetCardArrayEntries)) {
+    G1RSetCardArrayEntries =
+      HeapRegion::CardsPerRegion / (BitsPerByte * sizeof(u2));
+  }
+  if (HeapRegion::CardsPerRegion <= CardArrayPRT::NullCard) {
+    CardArrayPRT::set_max_cards(MIN2((int)G1RSetCardArrayEntries,
+                                     HeapRegion::CardsPerRegion));
+  }
 }
 
 void HeapRegionRemSet::init_for_par_iteration() {
@@ -1135,11 +1610,12 @@ void HeapRegionRemSet::print() const {
   // XXX
   if (iter.n_yielded() != occupied()) {
     gclog_or_tty->print_cr("Yielded disagrees with occupied:");
-    gclog_or_tty->print_cr("  %6d yielded (%6d coarse, %6d fine).",
+    gclog_or_tty->print_cr("  %6d yielded (%6d coarse, %6d fine, %6d card array).",
                   iter.n_yielded(),
-                  iter.n_yielded_coarse(), iter.n_yielded_fine());
-    gclog_or_tty->print_cr("  %6d occ     (%6d coarse, %6d fine).",
-                  occupied(), occ_coarse(), occ_fine());
+                  iter.n_yielded_coarse(), iter.n_yielded_fine(),
+                  iter.n_yielded_card_array());
+    gclog_or_tty->print_cr("  %6d occ     (%6d coarse, %6d fine, %6d card array).",
+                  occupied(), occ_coarse(), occ_fine(), occ_card_array());
   }
   guarantee(iter.n_yielded() == occupied(),
             "We should have yielded all the represented cards.");
@@ -1148,6 +1624,7 @@ void HeapRegionRemSet::print() const {
 
 void HeapRegionRemSet::cleanup() {
   SparsePRT::cleanup_all();
+  CardArrayPRT::delete_retired();
 }
 
 void HeapRegionRemSet::par_cleanup() {
@@ -1157,6 +1634,28 @@ void HeapRegionRemSet::par_cleanup() {
 void HeapRegionRemSet::clear() {
   _other_regions.clear();
   assert(occupied() == 0, "Should be clear.");
+  _tracking_state = Tracked;
+}
+
+void HeapRegionRemSet::set_untracked() {
+  assert(SafepointSynchronize::is_at_safepoint(), "only at safepoints");
+  _tracking_state = Untracked;
+}
+
+void HeapRegionRemSet::set_rebuilding() {
+  assert(SafepointSynchronize::is_at_safepoint(), "only at safepoints");
+  assert(_tracking_state == Untracked, "only untracked remsets are rebuilt");
+  _tracking_state = Rebuilding;
+}
+
+void HeapRegionRemSet::set_rebuild_complete() {
+  assert(_tracking_state == Rebuilding, "not being rebuilt");
+  _tracking_state = Tracked;
+}
+
+void HeapRegionRemSet::clear_untracked() {
+  assert(!is_tracked(), "entries are being added");
+  _other_regions.clear();
 }
 
 void HeapRegionRemSet::scrub(CardTableModRefBS* ctbs,
@@ -1177,6 +1676,7 @@ void HeapRegionRemSetIterator::initialize(const HeapRegionRemSet* hrrs) {
   _hrrs = hrrs;
   _coarse_map = &_hrrs->_other_regions._coarse_map;
   _fine_grain_regions = _hrrs->_other_regions._fine_grain_regions;
+  _card_arrays = _hrrs->_other_regions._card_arrays;
   _bosa = _hrrs->bosa();
 
   _is = Sparse;
@@ -1189,9 +1689,14 @@ void HeapRegionRemSetIterator::initialize(const HeapRegionRemSet* hrrs) {
   _fine_array_index = -1;
   _fine_cur_prt = NULL;
 
+  _card_array_index = -1;
+  _card_array_cur = NULL;
+  _card_array_cur_card = 0;
+
   _n_yielded_coarse = 0;
   _n_yielded_fine = 0;
   _n_yielded_sparse = 0;
+  _n_yielded_card_array = 0;
 
   _sparse_iter.init(&hrrs->_other_regions._sparse_table);
 }
@@ -1221,6 +1726,39 @@ bool HeapRegionRemSetIterator::coarse_has_next(size_t& card_index) {
   return true;
 }
 
+bool HeapRegionRemSetIterator::card_array_has_next(size_t& card_index) {
+  if (_card_arrays == NULL) return false;
+  // Go to the next card, skipping the slots of cards being added.
+  _card_array_cur_card++;
+  while (_card_array_cur == NULL ||
+         _card_array_cur_card >= _card_array_cur->occupied() ||
+         _card_array_cur->card(_card_array_cur_card) == CardArrayPRT::NullCard) {
+    if (_card_array_cur != NULL &&
+        _card_array_cur_card < _card_array_cur->occupied()) {
+      _card_array_cur_card++;
+      continue;
+    }
+    // Find the next card array, in this bucket list or in the next
+    // non-empty one.
+    if (_card_array_cur != NULL) {
+      _card_array_cur = _card_array_cur->next();
+    }
+    while (_card_array_cur == NULL) {
+      _card_array_index++;
+      if (_card_array_index >= (int) OtherRegionsTable::_max_fine_entries) {
+        return false;
+      }
+      _card_array_cur = _card_arrays[_card_array_index];
+    }
+    _card_array_cur_card = 0;
+    HeapWord* r_bot = _card_array_cur->hr()->bottom();
+    _cur_region_card_offset = _bosa->index_for(r_bot);
+  }
+  card_index = _cur_region_card_offset +
+               _card_array_cur->card(_card_array_cur_card);
+  return true;
+}
+
 void HeapRegionRemSetIterator::fine_find_next_non_null_prt() {
   // Otherwise, find the next bucket list in the array.
   _fine_array_index++;
@@ -1272,6 +1810,13 @@ bool HeapRegionRemSetIterator::has_next(size_t& card_index) {
       return true;
     }
     // Otherwise, deliberate fall-through
+    _is = CardArray;
+  case CardArray:
+    if (card_array_has_next(card_index)) {
+      _n_yielded_card_array++;
+      return true;
+    }
+    // Otherwise, deliberate fall-through
     _is = Fine;
   case Fine:
     if (fine_has_next(card_index)) {
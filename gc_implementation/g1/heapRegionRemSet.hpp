@@ -35,6 +35,7 @@ class G1CollectedHeap;
 class G1BlockOffsetSharedArray;
 class HeapRegion;
 class HeapRegionRemSetIterator;
+class CardArrayPRT;
 class PosParPRT;
 class SparsePRT;
 
@@ -53,6 +54,16 @@ class HRRSCleanupTask : public SparsePRTCleanupTask {
 // deleting an entry and setting the corresponding coarse-grained bit when
 // we would overflow this cap.
 
+// Regions with only a few cards are kept in the "_sparse_table".  When
+// the entry of a region in the sparse table overflows, its cards are
+// moved to a card array ("_card_arrays", an open hash table of
+// CardArrayPRTs) which grows as needed, and only when the card array
+// would take more space than a PRT bitmap are the cards moved to a PRT.
+// Card arrays count against the cap of the fine-grain table, and may be
+// coarsened like PRTs.  Like PRTs, they are found and added to without
+// locking; they are replaced and unlinked with "_m" held, and only
+// deleted at safepoints.
+
 // We use a mixture of locking and lock-free techniques here.  We allow
 // threads to locate PRTs without locking, but threads attempting to alter
 // a bucket list obtain a lock.  This means that any failing attempt to
@@ -91,6 +102,11 @@ class OtherRegionsTable VALUE_OBJ_CLASS_SPEC {
 
   SparsePRT   _sparse_table;
 
+  // These are modified with "_m" held.  The bucket array is allocated
+  // when the first card array is added.
+  CardArrayPRT** _card_arrays;
+  size_t         _n_card_arrays;
+
   // These are static after init.
   static size_t _max_fine_entries;
   static size_t _mod_max_fine_entries_mask;
@@ -102,14 +118,39 @@ class OtherRegionsTable VALUE_OBJ_CLASS_SPEC {
 
   // Find, delete, and return a candidate PosParPRT, if any exists,
   // adding the deleted region to the coarse bitmap.  Requires the caller
-  // to hold _m, and the fine-grain table to be full.
+  // to hold _m, and the fine-grain table and card arrays to be at the cap.
   PosParPRT* delete_region_table();
 
+  // Delete the card array with the most cards, adding its region to the
+  // coarse bitmap.  Requires the caller to hold _m.
+  void coarsen_card_array();
+
+  // If the fine-grain table and the card arrays are at the cap, coarsen
+  // a PRT or a card array.  A coarsened PRT is returned for reuse.
+  // Requires the caller to hold _m.
+  PosParPRT* make_room_for_fine_entry();
+
   // If a PRT for "hr" is in the bucket list indicated by "ind" (which must
   // be the correct index for "hr"), delete it and return true; else return
   // false.
   bool del_single_region_table(size_t ind, HeapRegion* hr);
 
+  // Return the card array for "hr", if any.  A card array found without
+  // holding _m may be concurrently replaced.
+  CardArrayPRT* find_card_array(HeapRegion* hr) const;
+
+  // Add a new card array for "hr", holding the cards of its sparse table
+  // entry and "card_index".  Requires the caller to hold _m.
+  void add_card_array(HeapRegion* hr, CardIdx_t card_index);
+
+  // Replace the full "card_array" with a larger copy holding
+  // "card_index" too.  Requires the caller to hold _m.
+  void grow_card_array(CardArrayPRT* card_array, CardIdx_t card_index);
+
+  // If there is a card array for "hr", delete it and return true; else
+  // return false.  Requires the caller to hold _m.
+  bool del_card_array(HeapRegion* hr);
+
   static jint _cache_probes;
   static jint _cache_hits;
 
@@ -140,6 +181,11 @@ public:
   size_t occ_fine() const;
   size_t occ_coarse() const;
   size_t occ_sparse() const;
+  size_t occ_card_array() const;
+
+  // The space saved by the card arrays, compared to keeping their cards
+  // in PRTs, in bytes.  Not const because it takes a lock.
+  size_t card_array_mem_saved() const;
 
   static jint n_coarsenings() { return _n_coarsenings; }
 
@@ -192,6 +238,18 @@ private:
   volatile ParIterState _iter_state;
   volatile jlong _iter_claimed;
 
+public:
+  // With G1RebuildRemSets, the remembered sets of the old regions that
+  // marking finds unlikely to be evacuated are not maintained
+  // ("Untracked").  Those of the regions that become candidates again are
+  // rebuilt concurrently after the next marking ("Rebuilding"); only
+  // regions whose remembered set is "Tracked" may be evacuated.  A state
+  // is only lowered, or set to Rebuilding, at safepoints.
+  enum TrackingState { Untracked, Rebuilding, Tracked };
+
+private:
+  volatile TrackingState _tracking_state;
+
   // Unused unless G1RecordHRRSOops is true.
 
   static const int MaxRecorded = 1000000;
@@ -212,6 +270,9 @@ public:
                    HeapRegion* hr);
 
   static int num_par_rem_sets();
+  // The id with which the concurrent marking worker worker_i adds
+  // references while rebuilding remembered sets.
+  static int rebuild_rem_set_id(int worker_i);
   static void setup_remset_size();
 
   HeapRegion* hr() const {
@@ -230,27 +291,54 @@ public:
   size_t occ_sparse() const {
     return _other_regions.occ_sparse();
   }
+  size_t occ_card_array() const {
+    return _other_regions.occ_card_array();
+  }
+  size_t card_array_mem_saved() const {
+    return _other_regions.card_array_mem_saved();
+  }
 
   static jint n_coarsenings() { return OtherRegionsTable::n_coarsenings(); }
 
   /* Used in the sequential case.  Returns "true" iff this addition causes
      the size limit to be reached. */
   void add_reference(OopOrNarrowOopStar from) {
-    _other_regions.add_reference(from);
+    if (is_tracked()) {
+      _other_regions.add_reference(from);
+    }
   }
 
   /* Used in the parallel case.  Returns "true" iff this addition causes
      the size limit to be reached. */
   void add_reference(OopOrNarrowOopStar from, int tid) {
-    _other_regions.add_reference(from, tid);
+    if (is_tracked()) {
+      _other_regions.add_reference(from, tid);
+    }
   }
 
+  bool is_tracked() const    { return _tracking_state != Untracked; }
+  bool is_rebuilding() const { return _tracking_state == Rebuilding; }
+  // True iff the remembered set holds all the references into the region.
+  bool is_complete() const   { return _tracking_state == Tracked; }
+
+  // Stop maintaining the remembered set.  Its entries are kept until
+  // clear_untracked() is called.
+  void set_untracked();
+  // Start maintaining the (empty) remembered set of an untracked region.
+  void set_rebuilding();
+  void set_rebuild_complete();
+
+  // Free the entries of an untracked remembered set.  May be called
+  // concurrently with mutators, since no entries are added to it.
+  void clear_untracked();
+
   // Removes any entries shown by the given bitmaps to contain only dead
   // objects.
   void scrub(CardTableModRefBS* ctbs, BitMap* region_bm, BitMap* card_bm);
 
   // The region is being reclaimed; clear its remset, and any mention of
-  // entries for this region in other remsets.
+  // entries for this region in other remsets.  The remset of the reclaimed
+  // region is complete.
   void clear();
 
   // Forget any entries due to pointers from "from_hr".
@@ -366,6 +454,7 @@ class HeapRegionRemSetIterator : public CHeapObj {
   // Local caching of HRRS fields.
   const BitMap*             _coarse_map;
   PosParPRT**               _fine_grain_regions;
+  CardArrayPRT**            _card_arrays;
 
   G1BlockOffsetSharedArray* _bosa;
   G1CollectedHeap*          _g1h;
@@ -374,11 +463,12 @@ class HeapRegionRemSetIterator : public CHeapObj {
   size_t _n_yielded_fine;
   size_t _n_yielded_coarse;
   size_t _n_yielded_sparse;
+  size_t _n_yielded_card_array;
 
-  // If true we're iterating over the coarse table; if false the fine
-  // table.
+  // The table we're iterating over.
   enum IterState {
     Sparse,
+    CardArray,
     Fine,
     Coarse
   };
@@ -407,6 +497,17 @@ class HeapRegionRemSetIterator : public CHeapObj {
 
   /* SparsePRT::*/ SparsePRTIter _sparse_iter;
 
+  // Card array iteration fields:
+
+  // Index of bucket-list we're working on.
+  int _card_array_index;
+  // Card array we're doing within current bucket list.
+  CardArrayPRT* _card_array_cur;
+  // Position of the current card within the card array.
+  int _card_array_cur_card;
+
+  bool card_array_has_next(size_t& card_index);
+
   void fine_find_next_non_null_prt();
 
   bool fine_has_next();
@@ -428,8 +529,10 @@ public:
   size_t n_yielded_fine() { return _n_yielded_fine; }
   size_t n_yielded_coarse() { return _n_yielded_coarse; }
   size_t n_yielded_sparse() { return _n_yielded_sparse; }
+  size_t n_yielded_card_array() { return _n_yielded_card_array; }
   size_t n_yielded() {
-    return n_yielded_fine() + n_yielded_coarse() + n_yielded_sparse();
+    return n_yielded_fine() + n_yielded_coarse() + n_yielded_sparse() +
+           n_yielded_card_array();
   }
 };
 
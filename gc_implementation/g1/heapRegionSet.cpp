@@ -359,7 +359,7 @@ void HeapRegionLinkedList::remove_all() {
 
 void HeapRegionLinkedList::remove_all_pending(size_t target_count) {
   hrs_assert_mt_safety_ok(this);
-  assert(target_count > 1, hrs_ext_msg(this, "pre-condition"));
+  assert(target_count > 0, hrs_ext_msg(this, "pre-condition"));
   assert(!is_empty(), hrs_ext_msg(this, "pre-condition"));
 
   verify_optional();
@@ -309,8 +309,7 @@ public:
   // (i.e., they have been tagged with "pending_removal"). The list
   // must not be empty, target_count should reflect the exact number
   // of regions that are pending for removal in the list, and
-  // target_count should be > 1 (currently, we never need to remove a
-  // single region using this).
+  // target_count should be > 0.
   void remove_all_pending(size_t target_count);
 
   virtual void verify();
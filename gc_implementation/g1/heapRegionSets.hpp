@@ -47,6 +47,7 @@ protected:
   virtual bool check_mt_safety();
 
 public:
+  MasterFreeRegionList() : FreeRegionList("Master Free List") { }
   MasterFreeRegionList(const char* name) : FreeRegionList(name) { }
 };
 
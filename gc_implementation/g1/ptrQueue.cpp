@@ -26,8 +26,11 @@
 #include "gc_implementation/g1/ptrQueue.hpp"
 #include "memory/allocation.hpp"
 #include "memory/allocation.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/mutex.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/orderAccess.hpp"
+#include "runtime/safepoint.hpp"
 #ifdef TARGET_OS_FAMILY_linux
 # include "thread_linux.inline.hpp"
 #endif
@@ -106,6 +109,7 @@ PtrQueueSet::PtrQueueSet(bool notify_when_complete) :
   _sz(0),
   _completed_buffers_head(NULL),
   _completed_buffers_tail(NULL),
+  _completed_buffers_pending(NULL),
   _n_completed_buffers(0),
   _process_completed_threshold(0), _process_completed(false),
   _buf_free_list(NULL), _buf_free_list_sz(0)
@@ -113,41 +117,57 @@ PtrQueueSet::PtrQueueSet(bool notify_when_complete) :
   _fl_owner = this;
 }
 
+BufferNode* PtrQueueSet::pop_free_buffer_locked() {
+  assert(_fl_lock->owned_by_self(), "Required.");
+  BufferNode* head;
+  do {
+    head = _buf_free_list;
+    if (head == NULL) {
+      return NULL;
+    }
+  } while (Atomic::cmpxchg_ptr(head->next(), &_buf_free_list, head) != head);
+  Atomic::dec(&_buf_free_list_sz);
+  return head;
+}
+
 void** PtrQueueSet::allocate_buffer() {
   assert(_sz > 0, "Didn't set a buffer size.");
-  MutexLockerEx x(_fl_owner->_fl_lock, Mutex::_no_safepoint_check_flag);
-  if (_fl_owner->_buf_free_list != NULL) {
-    void** res = BufferNode::make_buffer_from_node(_fl_owner->_buf_free_list);
-    _fl_owner->_buf_free_list = _fl_owner->_buf_free_list->next();
-    _fl_owner->_buf_free_list_sz--;
-    return res;
-  } else {
-    // Allocate space for the BufferNode in front of the buffer.
-    char *b =  NEW_C_HEAP_ARRAY(char, _sz + BufferNode::aligned_size());
-    return BufferNode::make_buffer_from_block(b);
+  PtrQueueSet* fl = _fl_owner;
+  // A thread which finds another one popping does not wait for it but
+  // allocates a new buffer: the free list is trimmed at safepoints.
+  if (fl->_buf_free_list != NULL && fl->_fl_lock->try_lock()) {
+    BufferNode* node = fl->pop_free_buffer_locked();
+    fl->_fl_lock->unlock();
+    if (node != NULL) {
+      return BufferNode::make_buffer_from_node(node);
+    }
   }
+  // Allocate space for the BufferNode in front of the buffer.
+  char *b =  NEW_C_HEAP_ARRAY(char, _sz + BufferNode::aligned_size());
+  return BufferNode::make_buffer_from_block(b);
 }
 
 void PtrQueueSet::deallocate_buffer(void** buf) {
   assert(_sz > 0, "Didn't set a buffer size.");
-  MutexLockerEx x(_fl_owner->_fl_lock, Mutex::_no_safepoint_check_flag);
+  PtrQueueSet* fl = _fl_owner;
   BufferNode *node = BufferNode::make_node_from_buffer(buf);
-  node->set_next(_fl_owner->_buf_free_list);
-  _fl_owner->_buf_free_list = node;
-  _fl_owner->_buf_free_list_sz++;
+  BufferNode* head;
+  do {
+    head = fl->_buf_free_list;
+    node->set_next(head);
+  } while (Atomic::cmpxchg_ptr(node, &fl->_buf_free_list, head) != head);
+  Atomic::inc(&fl->_buf_free_list_sz);
 }
 
-void PtrQueueSet::reduce_free_list() {
+void PtrQueueSet::reduce_free_list(jint max_free) {
   assert(_fl_owner == this, "Free list reduction is allowed only for the owner");
-  // For now we'll adopt the strategy of deleting half.
+  assert(SafepointSynchronize::is_at_safepoint(), "Must be at safepoint.");
   MutexLockerEx x(_fl_lock, Mutex::_no_safepoint_check_flag);
-  size_t n = _buf_free_list_sz / 2;
+  jint n = _buf_free_list_sz - max_free;
   while (n > 0) {
-    assert(_buf_free_list != NULL, "_buf_free_list_sz must be wrong.");
-    void* b = BufferNode::make_block_from_node(_buf_free_list);
-    _buf_free_list = _buf_free_list->next();
-    FREE_C_HEAP_ARRAY(char, b);
-    _buf_free_list_sz --;
+    BufferNode* node = pop_free_buffer_locked();
+    assert(node != NULL, "_buf_free_list_sz must be wrong.");
+    FREE_C_HEAP_ARRAY(char, BufferNode::make_block_from_node(node));
     n--;
   }
 }
@@ -228,26 +248,94 @@ bool PtrQueueSet::process_or_enqueue_complete_buffer(void** buf) {
 }
 
 void PtrQueueSet::enqueue_complete_buffer(void** buf, size_t index) {
-  MutexLockerEx x(_cbl_mon, Mutex::_no_safepoint_check_flag);
   BufferNode* cbn = BufferNode::new_from_buffer(buf);
   cbn->set_index(index);
+  jint n = Atomic::add(1, &_n_completed_buffers);
+  BufferNode* head;
+  do {
+    head = _completed_buffers_pending;
+    cbn->set_next(head);
+  } while (Atomic::cmpxchg_ptr(cbn, &_completed_buffers_pending, head) != head);
+
+  // The add above is a full fence, so either this thread sees
+  // _process_completed cleared, or the consumer clearing it sees the new
+  // count (see reset_process_completed_locked()).
+  if (!_process_completed && _process_completed_threshold >= 0 &&
+      n >= _process_completed_threshold) {
+    MutexLockerEx x(_cbl_mon, Mutex::_no_safepoint_check_flag);
+    if (!_process_completed) {
+      _process_completed = true;
+      if (_notify_when_complete)
+        _cbl_mon->notify();
+    }
+  }
+}
+
+void PtrQueueSet::collect_pending_buffers_locked() {
+  assert_lock_strong(_cbl_mon);
+  BufferNode* nd = (BufferNode*)Atomic::xchg_ptr((BufferNode*)NULL, &_completed_buffers_pending);
+  if (nd == NULL) {
+    return;
+  }
+  // The pending stack is in LIFO order.
+  BufferNode* first = NULL;
+  BufferNode* last = nd;
+  while (nd != NULL) {
+    BufferNode* next = nd->next();
+    nd->set_next(first);
+    first = nd;
+    nd = next;
+  }
   if (_completed_buffers_tail == NULL) {
     assert(_completed_buffers_head == NULL, "Well-formedness");
-    _completed_buffers_head = cbn;
-    _completed_buffers_tail = cbn;
+    _completed_buffers_head = first;
   } else {
-    _completed_buffers_tail->set_next(cbn);
-    _completed_buffers_tail = cbn;
+    _completed_buffers_tail->set_next(first);
   }
-  _n_completed_buffers++;
+  _completed_buffers_tail = last;
+}
 
-  if (!_process_completed && _process_completed_threshold >= 0 &&
+BufferNode* PtrQueueSet::get_completed_buffer_locked() {
+  assert_lock_strong(_cbl_mon);
+  if (_completed_buffers_head == NULL) {
+    collect_pending_buffers_locked();
+  }
+  BufferNode* nd = _completed_buffers_head;
+  if (nd != NULL) {
+    _completed_buffers_head = nd->next();
+    if (_completed_buffers_head == NULL)
+      _completed_buffers_tail = NULL;
+    Atomic::dec(&_n_completed_buffers);
+    assert(_n_completed_buffers >= 0, "Invariant");
+  }
+  return nd;
+}
+
+BufferNode* PtrQueueSet::take_completed_buffers_locked() {
+  assert_lock_strong(_cbl_mon);
+  collect_pending_buffers_locked();
+  BufferNode* list = _completed_buffers_head;
+  jint n = 0;
+  for (BufferNode* nd = list; nd != NULL; nd = nd->next()) {
+    n++;
+  }
+  _completed_buffers_head = NULL;
+  _completed_buffers_tail = NULL;
+  // Buffers being enqueued concurrently are already counted.
+  Atomic::add(-n, &_n_completed_buffers);
+  return list;
+}
+
+void PtrQueueSet::reset_process_completed_locked() {
+  assert_lock_strong(_cbl_mon);
+  _process_completed = false;
+  // A buffer enqueued concurrently may have seen _process_completed still
+  // set and not notified.
+  OrderAccess::fence();
+  if (_process_completed_threshold >= 0 &&
       _n_completed_buffers >= _process_completed_threshold) {
     _process_completed = true;
-    if (_notify_when_complete)
-      _cbl_mon->notify();
   }
-  debug_only(assert_completed_buffer_list_len_correct_locked());
 }
 
 int PtrQueueSet::completed_buffers_list_length() {
@@ -257,6 +345,11 @@ int PtrQueueSet::completed_buffers_list_length() {
     n++;
     cbn = cbn->next();
   }
+  cbn = _completed_buffers_pending;
+  while (cbn != NULL) {
+    n++;
+    cbn = cbn->next();
+  }
   return n;
 }
 
@@ -266,8 +359,14 @@ void PtrQueueSet::assert_completed_buffer_list_len_correct() {
 }
 
 void PtrQueueSet::assert_completed_buffer_list_len_correct_locked() {
-  guarantee(completed_buffers_list_length() ==  _n_completed_buffers,
-            "Completed buffer length is wrong.");
+  // The count is raised before a buffer is pushed onto the pending stack,
+  // so it can only be exact when no buffer is being enqueued.
+  int len = completed_buffers_list_length();
+  if (SafepointSynchronize::is_at_safepoint()) {
+    guarantee(len == _n_completed_buffers, "Completed buffer length is wrong.");
+  } else {
+    guarantee(len <= _n_completed_buffers, "Completed buffer length is wrong.");
+  }
 }
 
 void PtrQueueSet::set_buffer_size(size_t sz) {
@@ -281,6 +380,8 @@ void PtrQueueSet::set_buffer_size(size_t sz) {
 void PtrQueueSet::merge_bufferlists(PtrQueueSet *src) {
   assert(_cbl_mon == src->_cbl_mon, "Should share the same lock");
   MutexLockerEx x(_cbl_mon, Mutex::_no_safepoint_check_flag);
+  collect_pending_buffers_locked();
+  src->collect_pending_buffers_locked();
   if (_completed_buffers_tail == NULL) {
     assert(_completed_buffers_head == NULL, "Well-formedness");
     _completed_buffers_head = src->_completed_buffers_head;
@@ -292,9 +393,9 @@ void PtrQueueSet::merge_bufferlists(PtrQueueSet *src) {
       _completed_buffers_tail = src->_completed_buffers_tail;
     }
   }
-  _n_completed_buffers += src->_n_completed_buffers;
-
-  src->_n_completed_buffers = 0;
+  jint n = src->_n_completed_buffers;
+  Atomic::add(n, &_n_completed_buffers);
+  Atomic::add(-n, &src->_n_completed_buffers);
   src->_completed_buffers_head = NULL;
   src->_completed_buffers_tail = NULL;
 
@@ -193,21 +193,33 @@ public:
 // A PtrQueueSet represents resources common to a set of pointer queues.
 // In particular, the individual queues allocate buffers from this shared
 // set, and return completed buffers to the set.
-// All these variables are are protected by the TLOQ_CBL_mon. XXX ???
+//
+// Completed buffers are pushed onto the _completed_buffers_pending stack
+// with a CAS, so that enqueueing does not take _cbl_mon; the monitor is
+// only taken when the number of completed buffers crosses the processing
+// threshold, to notify the consumer.  The consumers, holding _cbl_mon,
+// detach the whole pending stack at once and append it in FIFO order to
+// the _completed_buffers_head/_tail list.  Since the pending stack is only
+// ever pushed onto or taken as a whole, it is not subject to ABA.
 class PtrQueueSet VALUE_OBJ_CLASS_SPEC {
 protected:
-  Monitor* _cbl_mon;  // Protects the fields below.
+  Monitor* _cbl_mon;  // Protects the fields below, but for the pending stack.
   BufferNode* _completed_buffers_head;
   BufferNode* _completed_buffers_tail;
-  int _n_completed_buffers;
+  BufferNode* volatile _completed_buffers_pending;
+  // Raised before a buffer is pushed onto the pending stack, so it is
+  // never below the number of buffers on the lists.
+  volatile jint _n_completed_buffers;
   int _process_completed_threshold;
   volatile bool _process_completed;
 
-  // This (and the interpretation of the first element as a "next"
-  // pointer) are protected by the TLOQ_FL_lock.
+  // Buffers are pushed onto the free list with a CAS.  Popping is
+  // serialized by the TLOQ_FL_lock: with a single popper a node cannot be
+  // popped and pushed back between the read of the head and the CAS, so
+  // there is no ABA problem.
   Mutex* _fl_lock;
-  BufferNode* _buf_free_list;
-  size_t _buf_free_list_sz;
+  BufferNode* volatile _buf_free_list;
+  volatile jint _buf_free_list_sz;
   // Queue set can share a freelist. The _fl_owner variable
   // specifies the owner. It is set to "this" by default.
   PtrQueueSet* _fl_owner;
@@ -229,6 +241,25 @@ protected:
   void assert_completed_buffer_list_len_correct_locked();
   void assert_completed_buffer_list_len_correct();
 
+  // Pop the head of the free list, or return NULL if it is empty.
+  // Requires _fl_lock.
+  BufferNode* pop_free_buffer_locked();
+
+  // Move the pending completed buffers to the tail of the completed
+  // buffer list.  Requires _cbl_mon.
+  void collect_pending_buffers_locked();
+
+  // Unlink and return the first completed buffer, or NULL if there is
+  // none.  Requires _cbl_mon.
+  BufferNode* get_completed_buffer_locked();
+
+  // Unlink and return all the completed buffers.  Requires _cbl_mon.
+  BufferNode* take_completed_buffers_locked();
+
+  // Called by the consumers, with _cbl_mon held, when they have run out
+  // of completed buffers to process.
+  void reset_process_completed_locked();
+
 protected:
   // A mutator thread does the the work of processing a buffer.
   // Returns "true" iff the work is complete (and the buffer may be
@@ -290,9 +321,10 @@ public:
   void set_process_completed_threshold(int sz) { _process_completed_threshold = sz; }
   int process_completed_threshold() const { return _process_completed_threshold; }
 
-  // Must only be called at a safe point.  Indicates that the buffer free
-  // list size may be reduced, if that is deemed desirable.
-  void reduce_free_list();
+  // Must only be called at a safe point.  Frees the buffers of the free
+  // list beyond the first max_free ones.  The list grows when threads
+  // find it contended and allocate new buffers instead of waiting.
+  void reduce_free_list(jint max_free);
 
   int completed_buffers_num() { return _n_completed_buffers; }
 
@@ -289,6 +289,25 @@ void ParScanThreadState::print_and_clear_promotion_failure_size() {
   }
 }
 
+void ParScanThreadState::preserve_mark_if_necessary(oop obj, markOop m) {
+  if (m->must_be_preserved_for_promotion_failure(obj)) {
+    _objs_with_preserved_marks.push(obj);
+    _preserved_marks_of_objs.push(m);
+  }
+}
+
+void ParScanThreadState::restore_preserved_marks() {
+  assert(_objs_with_preserved_marks.size() == _preserved_marks_of_objs.size(),
+         "should be the same");
+  while (!_objs_with_preserved_marks.is_empty()) {
+    oop obj   = _objs_with_preserved_marks.pop();
+    markOop m = _preserved_marks_of_objs.pop();
+    obj->set_mark(m);
+  }
+  _objs_with_preserved_marks.clear(true);
+  _preserved_marks_of_objs.clear(true);
+}
+
 class ParScanThreadStateSet: private ResourceArray {
 public:
   // Initializes states for the specified number of threads;
@@ -608,6 +627,7 @@ ParNewGeneration(ReservedSpace rs, size_t initial_byte_size, int level)
   : DefNewGeneration(rs, initial_byte_size, level, "PCopy"),
   _overflow_list(NULL),
   _is_alive_closure(this),
+  _recent_pause_ms(0.0),
   _plab_stats(YoungPLABSize, PLABWeight)
 {
   NOT_PRODUCT(_overflow_counter = ParGCWorkQueueOverflowInterval;)
@@ -789,21 +809,21 @@ void ParNewRefProcTaskExecutor::execute(ProcessTask& task)
   GenCollectedHeap* gch = GenCollectedHeap::heap();
   assert(gch->kind() == CollectedHeap::GenCollectedHeap,
          "not a generational heap");
-  WorkGang* workers = gch->workers();
+  FlexibleWorkGang* workers = gch->workers();
   assert(workers != NULL, "Need parallel worker threads.");
   ParNewRefProcTaskProxy rp_task(task, _generation, *_generation.next_gen(),
                                  _generation.reserved().end(), _state_set);
-  workers->run_task(&rp_task);
+  workers->run_task(&rp_task, workers->active_workers());
   _state_set.reset(_generation.promotion_failed());
 }
 
 void ParNewRefProcTaskExecutor::execute(EnqueueTask& task)
 {
   GenCollectedHeap* gch = GenCollectedHeap::heap();
-  WorkGang* workers = gch->workers();
+  FlexibleWorkGang* workers = gch->workers();
   assert(workers != NULL, "Need parallel worker threads.");
   ParNewRefEnqueueTaskProxy enq_task(task);
-  workers->run_task(&enq_task);
+  workers->run_task(&enq_task, workers->active_workers());
 }
 
 void ParNewRefProcTaskExecutor::set_single_threaded_mode()
@@ -836,6 +856,75 @@ void EvacuateFollowersClosureGeneral::do_void() {
   } while (!_gch->no_allocs_since_save_marks(_level));
 }
 
+// Removes the forwarding pointers left in eden and from-space by a
+// promotion failure.  A space cannot be divided without knowing where its
+// objects start, so the workers claim whole spaces.
+class ParRemoveForwardingPointersTask: public AbstractGangTask {
+  class RemoveForwardPointerClosure: public ObjectClosure {
+   public:
+    void do_object(oop obj) {
+      obj->init_mark();
+    }
+  };
+
+  ParNewGeneration& _gen;
+  volatile jint     _next_space;
+
+public:
+  ParRemoveForwardingPointersTask(ParNewGeneration& gen)
+    : AbstractGangTask("ParNewGeneration remove forwarding pointers"),
+      _gen(gen), _next_space(0)
+  { }
+
+  virtual void work(int i)
+  {
+    RemoveForwardPointerClosure rfpc;
+    jint space;
+    while ((space = Atomic::add(1, &_next_space) - 1) < 2) {
+      if (space == 0) {
+        _gen.eden()->object_iterate(&rfpc);
+      } else {
+        _gen.from()->object_iterate(&rfpc);
+      }
+    }
+  }
+};
+
+// Restores the marks preserved by each worker.  Must follow the removal
+// of the forwarding pointers, which resets the marks of all the objects.
+class ParRestorePreservedMarksTask: public AbstractGangTask {
+  ParScanThreadStateSet& _state_set;
+
+public:
+  ParRestorePreservedMarksTask(ParScanThreadStateSet& state_set)
+    : AbstractGangTask("ParNewGeneration restore preserved marks"),
+      _state_set(state_set)
+  { }
+
+  virtual void work(int i)
+  {
+    _state_set.thread_state(i).restore_preserved_marks();
+  }
+};
+
+void ParNewGeneration::par_remove_forwarding_pointers(
+  ParScanThreadStateSet& thread_state_set) {
+  GenCollectedHeap* gch = GenCollectedHeap::heap();
+  FlexibleWorkGang* workers = gch->workers();
+  assert(workers != NULL, "Need parallel worker threads.");
+  ParRemoveForwardingPointersTask remove_task(*this);
+  ParRestorePreservedMarksTask restore_task(thread_state_set);
+  int n_workers = workers->active_workers();
+  if (n_workers > 1) {
+    workers->run_task(&remove_task, n_workers);
+    workers->run_task(&restore_task, n_workers);
+  } else {
+    remove_task.work(0);
+    restore_task.work(0);
+  }
+  // The marks preserved by the serial phases of reference processing.
+  restore_preserved_marks();
+}
 
 bool ParNewGeneration::_avoid_promotion_undo = false;
 
@@ -856,7 +945,7 @@ void ParNewGeneration::collect(bool   full,
   assert(gch->kind() == CollectedHeap::GenCollectedHeap,
     "not a CMS generational heap");
   AdaptiveSizePolicy* size_policy = gch->gen_policy()->size_policy();
-  WorkGang* workers = gch->workers();
+  FlexibleWorkGang* workers = gch->workers();
   _next_gen = gch->next_gen(this);
   assert(_next_gen != NULL,
     "This must be the youngest gen, and not the only gen");
@@ -884,6 +973,7 @@ void ParNewGeneration::collect(bool   full,
   }
 
   TraceTime t1("GC", PrintGC && !PrintGCDetails, true, gclog_or_tty);
+  double start_sec = os::elapsedTime();
   // Capture heap used before collection (for printing).
   size_t gch_prev_used = gch->used();
 
@@ -894,13 +984,22 @@ void ParNewGeneration::collect(bool   full,
 
   gch->save_marks();
   assert(workers != NULL, "Need parallel worker threads.");
-  ParallelTaskTerminator _term(workers->total_workers(), task_queues());
-  ParScanThreadStateSet thread_state_set(workers->total_workers(),
+  int n_workers =
+    AdaptiveSizePolicy::calc_active_workers(workers->total_workers(),
+                                            workers->active_workers(),
+                                            Threads::number_of_non_daemon_threads(),
+                                            used(),
+                                            _recent_pause_ms);
+  workers->set_active_workers(n_workers);
+  // References are discovered into, and processed from, the lists of the
+  // active workers only.
+  ref_processor()->set_active_mt_degree(n_workers);
+  ParallelTaskTerminator _term(n_workers, task_queues());
+  ParScanThreadStateSet thread_state_set(n_workers,
                                          *to(), *this, *_next_gen, *task_queues(),
                                          _overflow_stacks, desired_plab_sz(), _term);
 
   ParNewGenTask tsk(this, _next_gen, reserved().end(), &thread_state_set);
-  int n_workers = workers->total_workers();
   gch->set_par_threads(n_workers);
   gch->rem_set()->prepare_for_younger_refs_iterate(true);
   // It turns out that even when we're using 1 thread, doing the work in a
@@ -909,7 +1008,7 @@ void ParNewGeneration::collect(bool   full,
   // repeatable measurements of the 1-thread overhead of the parallel code.
   if (n_workers > 1) {
     GenCollectedHeap::StrongRootsScope srs(gch);
-    workers->run_task(&tsk);
+    workers->run_task(&tsk, n_workers);
   } else {
     GenCollectedHeap::StrongRootsScope srs(gch);
     tsk.work(0);
@@ -963,7 +1062,7 @@ void ParNewGeneration::collect(bool   full,
     assert(_promo_failure_scan_stack.is_empty(), "post condition");
     _promo_failure_scan_stack.clear(true); // Clear cached segments.
 
-    remove_forwarding_pointers();
+    par_remove_forwarding_pointers(thread_state_set);
     if (PrintGCDetails) {
       gclog_or_tty->print(" (promotion failed)");
     }
@@ -1012,6 +1111,8 @@ void ParNewGeneration::collect(bool   full,
     rp->enqueue_discovered_references(NULL);
   }
   rp->verify_no_references_recorded();
+
+  _recent_pause_ms = (os::elapsedTime() - start_sec) * MILLIUNITS;
 }
 
 static int sum;
@@ -1057,15 +1158,6 @@ bool ParNewGeneration::is_legal_forward_ptr(oop p) {
 }
 #endif
 
-void ParNewGeneration::preserve_mark_if_necessary(oop obj, markOop m) {
-  if (m->must_be_preserved_for_promotion_failure(obj)) {
-    // We should really have separate per-worker stacks, rather
-    // than use locking of a common pair of stacks.
-    MutexLocker ml(ParGCRareEvent_lock);
-    preserve_mark(obj, m);
-  }
-}
-
 // Multiple GC threads may try to promote an object.  If the object
 // is successfully promoted, a forwarding pointer will be installed in
 // the object in the young generation.  This method claims the right
@@ -1120,7 +1212,7 @@ oop ParNewGeneration::copy_to_survivor_space_avoiding_promotion_undo(
       _promotion_failed = true;
       new_obj = old;
 
-      preserve_mark_if_necessary(old, m);
+      par_scan_state->preserve_mark_if_necessary(old, m);
       // Log the size of the maiden promotion failure
       par_scan_state->log_promotion_failure(sz);
     }
@@ -1236,7 +1328,7 @@ oop ParNewGeneration::copy_to_survivor_space_with_undo(
       _promotion_failed = true;
       failed_to_promote = true;
 
-      preserve_mark_if_necessary(old, m);
+      par_scan_state->preserve_mark_if_necessary(old, m);
       // Log the size of the maiden promotion failure
       par_scan_state->log_promotion_failure(sz);
     }
@@ -35,6 +35,7 @@ class ParScanWithBarrierClosure;
 class ParRootScanWithoutBarrierClosure;
 class ParRootScanWithBarrierTwoGensClosure;
 class ParEvacuateFollowersClosure;
+class ParScanThreadStateSet;
 
 // It would be better if these types could be kept local to the .cpp file,
 // but they must be here to allow ParScanClosure::do_oop_work to be defined
@@ -107,6 +108,12 @@ class ParScanThreadState {
   // Stats for promotion failure
   size_t _promotion_failure_size;
 
+  // The <object, mark> pairs of the objects which this thread forwarded
+  // to themselves after a promotion failure.  They should always contain
+  // the same number of elements.
+  Stack<oop>     _objs_with_preserved_marks;
+  Stack<markOop> _preserved_marks_of_objs;
+
   // Timing numbers.
   double _start;
   double _start_strong_roots;
@@ -188,6 +195,13 @@ class ParScanThreadState {
   }
   void print_and_clear_promotion_failure_size();
 
+  // Preserve the mark of "obj", if necessary, in preparation for its mark
+  // word being overwritten with a self-forwarding-pointer.
+  void preserve_mark_if_necessary(oop obj, markOop m);
+  // Restore the marks preserved above, once the forwarding pointers have
+  // been removed.
+  void restore_preserved_marks();
+
 #if TASKQUEUE_STATS
   TaskQueueStats & taskqueue_stats() const { return _work_queue->stats; }
 
@@ -326,12 +340,16 @@ class ParNewGeneration: public DefNewGeneration {
   // references to live referent.
   DefNewGeneration::IsAliveClosure _is_alive_closure;
 
+  // The duration of the latest collection, used to size the workers of
+  // the next one.
+  double _recent_pause_ms;
+
   static oop real_forwardee_slow(oop obj);
   static void waste_some_time();
 
-  // Preserve the mark of "obj", if necessary, in preparation for its mark
-  // word being overwritten with a self-forwarding-pointer.
-  void preserve_mark_if_necessary(oop obj, markOop m);
+  // After a promotion failure, remove the forwarding pointers from eden
+  // and from-space and restore the preserved marks, using the workers.
+  void par_remove_forwarding_pointers(ParScanThreadStateSet& thread_state_set);
 
  protected:
 
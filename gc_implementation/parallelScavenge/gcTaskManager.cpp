@@ -399,6 +399,7 @@ void GCTaskManager::initialize() {
     FREE_C_HEAP_ARRAY(uint, processor_assignment);
   }
   reset_busy_workers();
+  _active_workers = workers();
   set_unblocked();
   for (uint w = 0; w < workers(); w += 1) {
     set_resource_flag(w, false);
@@ -515,9 +516,10 @@ GCTask* GCTaskManager::get_task(uint which) {
   // Grab the queue lock.
   MutexLockerEx ml(monitor(), Mutex::_no_safepoint_check_flag);
   // Wait while the queue is block or
-  // there is nothing to do, except maybe release resources.
+  // there is nothing to do for this worker, except maybe release resources.
   while (is_blocked() ||
-         (queue()->is_empty() && !should_release_resources(which))) {
+         ((queue()->is_empty() || which >= active_workers()) &&
+          !should_release_resources(which))) {
     if (TraceGCTaskManager) {
       tty->print_cr("GCTaskManager::get_task(%u)"
                     "  blocked: %s"
@@ -534,7 +536,7 @@ GCTask* GCTaskManager::get_task(uint which) {
   }
   // We've reacquired the queue lock here.
   // Figure out which condition caused us to exit the loop above.
-  if (!queue()->is_empty()) {
+  if (!queue()->is_empty() && which < active_workers()) {
     if (UseGCTaskAffinity) {
       result = queue()->dequeue(which);
     } else {
@@ -564,6 +566,18 @@ GCTask* GCTaskManager::get_task(uint which) {
   // Release monitor().
 }
 
+void GCTaskManager::set_active_workers(uint v) {
+  assert(v > 0 && v <= workers(), "Active workers out of range");
+  MutexLockerEx ml(monitor(), Mutex::_no_safepoint_check_flag);
+  assert(queue()->is_empty(), "Tasks are still queued");
+  _active_workers = v;
+  if (TraceGCTaskManager) {
+    tty->print_cr("GCTaskManager::set_active_workers(%u)", v);
+  }
+  // Wake the workers which are now active.
+  (void) monitor()->notify_all();
+}
+
 void GCTaskManager::note_completion(uint which) {
   MutexLockerEx ml(monitor(), Mutex::_no_safepoint_check_flag);
   if (TraceGCTaskManager) {
@@ -295,6 +295,7 @@ private:
   // Instance state.
   NotifyDoneClosure*        _ndc;               // Notify on completion.
   const uint                _workers;           // Number of workers.
+  uint                      _active_workers;    // Number handed tasks.
   Monitor*                  _monitor;           // Notification of changes.
   SynchronizedGCTaskQueue*  _queue;             // Queue of tasks.
   GCTaskThread**            _thread;            // Array of worker threads.
@@ -324,6 +325,15 @@ public:
   uint busy_workers() const {
     return _busy_workers;
   }
+  //     Only workers [0, active_workers()) are handed tasks; the others
+  //     wait.  Tasks which need one worker each, such as StealTasks,
+  //     must be enqueued active_workers() times.
+  uint active_workers() const {
+    return _active_workers;
+  }
+  //     Set the number of workers handed tasks.  Called by the VM thread
+  //     between lists of tasks.
+  void set_active_workers(uint v);
   //     Pun between Monitor* and Mutex*
   Monitor* monitor() const {
     return _monitor;
@@ -1009,6 +1009,9 @@ void PSParallelCompact::pre_compact(PreGCValues* pre_gc_values)
 
   // Have worker threads release resources the next time they run a task.
   gc_task_manager()->release_all_resources();
+
+  // The tasks of a full collection are divided among all the workers.
+  gc_task_manager()->set_active_workers(gc_task_manager()->workers());
 }
 
 void PSParallelCompact::post_compact()
@@ -184,11 +184,12 @@ void PSRefProcTaskExecutor::execute(ProcessTask& task)
   for(uint i=0; i<ParallelGCThreads; i++) {
     q->enqueue(new PSRefProcTaskProxy(task, i));
   }
+  uint active_workers = ParallelScavengeHeap::gc_task_manager()->active_workers();
   ParallelTaskTerminator terminator(
-                 ParallelScavengeHeap::gc_task_manager()->workers(),
+                 active_workers,
                  (TaskQueueSetSuper*) PSPromotionManager::stack_array_depth());
-  if (task.marks_oops_alive() && ParallelGCThreads > 1) {
-    for (uint j=0; j<ParallelGCThreads; j++) {
+  if (task.marks_oops_alive() && active_workers > 1) {
+    for (uint j=0; j<active_workers; j++) {
       q->enqueue(new StealTask(&terminator));
     }
   }
@@ -376,6 +377,16 @@ bool PSScavenge::invoke_no_policy() {
     // Release all previously held resources
     gc_task_manager()->release_all_resources();
 
+    // The workers which are not needed for this scavenge stay idle.
+    uint active_workers =
+      (uint) AdaptiveSizePolicy::calc_active_workers(
+               gc_task_manager()->workers(),
+               gc_task_manager()->active_workers(),
+               Threads::number_of_non_daemon_threads(),
+               young_gen_used_before,
+               size_policy->avg_minor_pause()->last_sample() * MILLIUNITS);
+    gc_task_manager()->set_active_workers(active_workers);
+
     PSPromotionManager::pre_scavenge();
 
     // We'll use the promotion manager again later.
@@ -404,10 +415,10 @@ bool PSScavenge::invoke_no_policy() {
       q->enqueue(new ScavengeRootsTask(ScavengeRootsTask::code_cache));
 
       ParallelTaskTerminator terminator(
-                  gc_task_manager()->workers(),
+                  active_workers,
                   (TaskQueueSetSuper*) promotion_manager->stack_array_depth());
-      if (ParallelGCThreads>1) {
-        for (uint j=0; j<ParallelGCThreads; j++) {
+      if (active_workers>1) {
+        for (uint j=0; j<active_workers; j++) {
           q->enqueue(new StealTask(&terminator));
         }
       }
@@ -88,6 +88,44 @@ AdaptiveSizePolicy::AdaptiveSizePolicy(size_t init_eden_size,
   _young_gen_policy_is_ready = false;
 }
 
+int AdaptiveSizePolicy::calc_active_workers(uintx total_workers,
+                                            uintx prior_workers,
+                                            uintx application_workers,
+                                            size_t occupancy,
+                                            double recent_pause_ms) {
+  assert(total_workers > 0, "Always need at least 1");
+  if (!UseDynamicNumberOfGCThreads) {
+    return (int) total_workers;
+  }
+
+  size_t heap_per_worker = MAX2((size_t) HeapSizePerGCThread, (size_t) 1);
+  uintx workers_by_heap = (uintx) (occupancy / heap_per_worker) + 1;
+  uintx workers_by_java = 2 * application_workers;
+  uintx new_workers = MAX2(workers_by_heap, workers_by_java);
+
+  if (prior_workers > 0) {
+    if (recent_pause_ms > (double) MaxGCPauseMillis) {
+      // The pauses are too long for the work to be spread more thinly.
+      new_workers = MAX2(new_workers, 2 * prior_workers);
+    } else {
+      // Avoid swinging between few and many workers on a single
+      // small collection.
+      new_workers = MAX2(new_workers, prior_workers / 2);
+    }
+  }
+  new_workers = MAX2((uintx) 1, MIN2(new_workers, total_workers));
+
+  if (TraceDynamicGCThreads) {
+    gclog_or_tty->print_cr("GC workers: " UINTX_FORMAT " of " UINTX_FORMAT
+                           " (prior " UINTX_FORMAT ", by heap " UINTX_FORMAT
+                           ", by application threads " UINTX_FORMAT
+                           ", recent pause %.3f ms)",
+                           new_workers, total_workers, prior_workers,
+                           workers_by_heap, workers_by_java, recent_pause_ms);
+  }
+  return (int) new_workers;
+}
+
 bool AdaptiveSizePolicy::tenuring_threshold_change() const {
   return decrement_tenuring_threshold_for_gc_cost() ||
          increment_tenuring_threshold_for_gc_cost() ||
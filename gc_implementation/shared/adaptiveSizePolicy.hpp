@@ -332,6 +332,19 @@ class AdaptiveSizePolicy : public CHeapObj {
   bool tenuring_threshold_change() const;
 
  public:
+  // Return the number of the total_workers of a gang or task manager to
+  // use for the next pause or concurrent phase.  All of them unless
+  // UseDynamicNumberOfGCThreads is set; otherwise one worker per
+  // HeapSizePerGCThread of occupancy or two per application thread,
+  // whichever is more.  The number at most halves from prior_workers,
+  // and it doubles instead if recent_pause_ms exceeded MaxGCPauseMillis.
+  // Concurrent phases pass 0.0 for recent_pause_ms.
+  static int calc_active_workers(uintx total_workers,
+                                 uintx prior_workers,
+                                 uintx application_workers,
+                                 size_t occupancy,
+                                 double recent_pause_ms);
+
   AdaptiveSizePolicy(size_t init_eden_size,
                      size_t init_promo_size,
                      size_t init_survivor_size,
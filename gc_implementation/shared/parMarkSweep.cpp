@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "code/codeCache.hpp"
+#include "gc_implementation/shared/parMarkSweep.hpp"
+#include "memory/referenceProcessor.hpp"
+#include "memory/sharedHeap.hpp"
+#include "oops/instanceKlass.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/handles.inline.hpp"
+#include "utilities/stack.inline.hpp"
+#include "utilities/workgroup.hpp"
+
+template <class T> inline void ParMarkSweepMarkClosure::do_oop_work(T* p) {
+  if (_implementors != NULL &&
+      (oop*)p >= _implementors &&
+      (oop*)p < _implementors + instanceKlass::implementors_limit) {
+    return;
+  }
+  _marker->mark_and_push(p);
+}
+
+void ParMarkSweepMarkClosure::do_oop(oop* p)       { do_oop_work(p); }
+void ParMarkSweepMarkClosure::do_oop(narrowOop* p) { do_oop_work(p); }
+
+void ParMarkSweepMarkClosure::remember_klass(Klass* k) {
+  _marker->revisit_klass(k);
+}
+
+void ParMarkSweepMarkClosure::remember_mdo(DataLayout* p) {
+  _marker->revisit_mdo(p);
+}
+
+ParMarkSweepMarker::ParMarkSweepMarker(int worker_id,
+                                       ParMarkSweepMarkQueueSet* queues) :
+  _worker_id(worker_id), _queues(queues), _mark_closure(this) {
+  _queue.initialize();
+}
+
+inline bool ParMarkSweepMarker::par_mark(oop obj) {
+  markOop mark = obj->mark();
+  while (!mark->is_marked()) {
+    markOop cur = obj->cas_set_mark(markOopDesc::prototype()->set_marked(),
+                                    mark);
+    if (cur == mark) {
+      if (mark->must_be_preserved(obj)) {
+        _preserved_mark_stack.push(mark);
+        _preserved_oop_stack.push(obj);
+      }
+      return true;
+    }
+    mark = cur;
+  }
+  return false;
+}
+
+template <class T> inline void ParMarkSweepMarker::mark_and_push(T* p) {
+  T heap_oop = oopDesc::load_heap_oop(p);
+  if (!oopDesc::is_null(heap_oop)) {
+    oop obj = oopDesc::decode_heap_oop_not_null(heap_oop);
+    if (par_mark(obj)) {
+      _queue.push(obj);
+    }
+  }
+}
+
+inline void ParMarkSweepMarker::follow_contents(oop obj) {
+  if (obj->blueprint()->oop_is_instanceKlass()) {
+    instanceKlass* ik = instanceKlass::cast(klassOop(obj));
+    _mark_closure.set_implementors(ik->adr_implementors());
+    obj->oop_iterate(&_mark_closure);
+    _mark_closure.set_implementors(NULL);
+  } else {
+    obj->oop_iterate(&_mark_closure);
+  }
+}
+
+void ParMarkSweepMarker::drain_queue() {
+  oop obj;
+  do {
+    while (_queue.pop_overflow(obj)) {
+      follow_contents(obj);
+    }
+    while (_queue.pop_local(obj)) {
+      follow_contents(obj);
+    }
+  } while (!_queue.is_empty());
+}
+
+void ParMarkSweepMarker::complete_marking(ParallelTaskTerminator* terminator) {
+  int seed = 17;
+  oop obj;
+  do {
+    drain_queue();
+    while (_queues->steal(_worker_id, &seed, obj)) {
+      follow_contents(obj);
+      drain_queue();
+    }
+  } while (!terminator->offer_termination());
+}
+
+void ParMarkSweepMarker::publish() {
+  assert(_queue.is_empty(), "marking should be complete");
+  while (!_preserved_oop_stack.is_empty()) {
+    oop obj      = _preserved_oop_stack.pop();
+    markOop mark = _preserved_mark_stack.pop();
+    MarkSweep::preserve_mark(obj, mark);
+  }
+  assert(_preserved_mark_stack.is_empty(), "stacks should match");
+  while (!_revisit_klass_stack.is_empty()) {
+    MarkSweep::revisit_weak_klass_link(_revisit_klass_stack.pop());
+  }
+  while (!_revisit_mdo_stack.is_empty()) {
+    MarkSweep::revisit_mdo(_revisit_mdo_stack.pop());
+  }
+}
+
+ParMarkSweep::ParMarkSweep(int n_workers) : _n_workers(n_workers) {
+  _queues = new ParMarkSweepMarkQueueSet(n_workers);
+  _markers = NEW_C_HEAP_ARRAY(ParMarkSweepMarker*, n_workers);
+  for (int i = 0; i < n_workers; i++) {
+    _markers[i] = new ParMarkSweepMarker(i, _queues);
+    _queues->register_queue(i, _markers[i]->queue());
+  }
+}
+
+class ParMarkSweepMarkTask: public AbstractGangTask {
+  ParMarkSweep*          _state;
+  ParallelTaskTerminator _terminator;
+ public:
+  ParMarkSweepMarkTask(ParMarkSweep* state) :
+    AbstractGangTask("Parallel Full GC Mark"),
+    _state(state),
+    _terminator(state->n_workers(), state->queues()) { }
+
+  void work(int i) {
+    ResourceMark rm;
+    HandleMark   hm;
+    ParMarkSweepMarker* marker = _state->marker(i);
+    CodeBlobToOopClosure code_roots(marker->mark_closure(),
+                                    /*do_marking=*/ true);
+    SharedHeap::heap()->process_strong_roots(false, // no scope; done by caller
+                                             true,  // Collecting permanent generation.
+                                             SharedHeap::SO_SystemClasses,
+                                             marker->mark_closure(),
+                                             &code_roots,
+                                             NULL);
+    marker->complete_marking(&_terminator);
+  }
+};
+
+void ParMarkSweep::mark_strong_roots(ReferenceProcessor* rp) {
+  SharedHeap* sh = SharedHeap::heap();
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
+  assert(sh->workers() != NULL &&
+         sh->workers()->total_workers() == _n_workers, "wrong work gang");
+
+  for (int i = 0; i < _n_workers; i++) {
+    _markers[i]->set_ref_processor(rp);
+  }
+
+  {
+    // References are discovered by the workers into their own lists.
+    ReferenceProcessorMTDiscoveryMutator rp_disc_mt(rp, true);
+    SharedHeap::StrongRootsScope srs(sh);
+    ParMarkSweepMarkTask mark_task(this);
+    sh->set_par_threads(_n_workers);
+    sh->workers()->run_task(&mark_task);
+    sh->set_par_threads(0);
+  }
+
+  for (int i = 0; i < _n_workers; i++) {
+    _markers[i]->publish();
+  }
+}
@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_SHARED_PARMARKSWEEP_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_SHARED_PARMARKSWEEP_HPP
+
+#include "gc_implementation/shared/markSweep.hpp"
+#include "memory/iterator.hpp"
+#include "oops/markOop.hpp"
+#include "oops/oop.hpp"
+#include "utilities/stack.hpp"
+#include "utilities/taskqueue.hpp"
+
+class FlexibleWorkGang;
+class ParMarkSweepMarker;
+class ReferenceProcessor;
+
+typedef OverflowTaskQueue<oop>                     ParMarkSweepMarkQueue;
+typedef GenericTaskQueueSet<ParMarkSweepMarkQueue> ParMarkSweepMarkQueueSet;
+
+// Support for tracing the heap from the strong roots with a work gang
+// during a full (mark-compact) collection.  Live objects are marked in
+// their header, exactly as MarkSweep::mark_object() does, so that the
+// remaining phases of the collection need not know that marking was done
+// in parallel.  Every worker keeps the marks it had to overwrite and the
+// klasses and MDOs it had to remember on stacks of its own; publish()
+// hands them over to MarkSweep once marking is complete.
+
+// Closure used by the parallel marking.  Visited oops are marked and
+// pushed on the worker's mark queue.  Klass weak links and MDO receiver
+// rows are remembered on the worker's revisit stacks, as MarkSweep does,
+// so that class unloading is not prevented.
+class ParMarkSweepMarkClosure: public OopClosure {
+  ParMarkSweepMarker* _marker;
+  // The implementors of the instanceKlass being scanned, if any.  They are
+  // skipped, as by instanceKlassKlass::oop_follow_contents(); the live ones
+  // are kept by instanceKlass::follow_weak_klass_links().
+  oop*                _implementors;
+ public:
+  ParMarkSweepMarkClosure(ParMarkSweepMarker* marker) :
+    _marker(marker), _implementors(NULL) { }
+  void set_implementors(oop* p) { _implementors = p; }
+  template <class T> inline void do_oop_work(T* p);
+  virtual void do_oop(oop* p);
+  virtual void do_oop(narrowOop* p);
+  virtual const bool should_remember_klasses() const { return true; }
+  virtual void remember_klass(Klass* k);
+  virtual const bool should_remember_mdo() const { return true; }
+  virtual void remember_mdo(DataLayout* p);
+};
+
+class ParMarkSweepMarker: public CHeapObj {
+  int                       _worker_id;
+  ParMarkSweepMarkQueue     _queue;
+  ParMarkSweepMarkQueueSet* _queues;
+  ParMarkSweepMarkClosure   _mark_closure;
+
+  // Marks overwritten while marking, handed over to MarkSweep afterwards.
+  Stack<markOop>            _preserved_mark_stack;
+  Stack<oop>                _preserved_oop_stack;
+  Stack<Klass*>             _revisit_klass_stack;
+  Stack<DataLayout*>        _revisit_mdo_stack;
+
+  // Claim obj for this worker by installing the mark bit; the old mark
+  // is preserved if needed.  Returns false if obj was already marked.
+  inline bool par_mark(oop obj);
+
+ public:
+  ParMarkSweepMarker(int worker_id, ParMarkSweepMarkQueueSet* queues);
+
+  ParMarkSweepMarkQueue* queue()          { return &_queue; }
+  ParMarkSweepMarkClosure* mark_closure() { return &_mark_closure; }
+
+  void set_ref_processor(ReferenceProcessor* rp) {
+    _mark_closure._ref_processor = rp;
+  }
+
+  template <class T> inline void mark_and_push(T* p);
+
+  // Push the unmarked objects obj refers to, treating the weak klass
+  // links as MarkSweep::follow_contents() does.
+  inline void follow_contents(oop obj);
+
+  void revisit_klass(Klass* k)     { _revisit_klass_stack.push(k); }
+  void revisit_mdo(DataLayout* p)  { _revisit_mdo_stack.push(p); }
+
+  // Process all the objects on the local queue and overflow stack.
+  void drain_queue();
+
+  // Drain the local queue, then steal from the other workers until all
+  // of the queues are empty.
+  void complete_marking(ParallelTaskTerminator* terminator);
+
+  // Hand the preserved marks and the revisit stacks over to MarkSweep,
+  // which restores and processes them serially.  Called by the VM thread.
+  void publish();
+};
+
+// The marking state of all the workers of the work gang.  It is allocated
+// at the first parallel full collection and reused afterwards.
+class ParMarkSweep: public CHeapObj {
+  int                       _n_workers;
+  ParMarkSweepMarkQueueSet* _queues;
+  ParMarkSweepMarker**      _markers;
+
+ public:
+  ParMarkSweep(int n_workers);
+
+  int n_workers() const                    { return _n_workers; }
+  ParMarkSweepMarker* marker(int i) const  { return _markers[i]; }
+  ParMarkSweepMarkQueueSet* queues() const { return _queues; }
+
+  // Mark everything reachable from the strong roots (the permanent
+  // generation is assumed to be collected) with the workers of the
+  // heap's work gang.  References are discovered by rp, which must
+  // support multi-threaded discovery by n_workers() workers.  On return
+  // the marking state has been published to MarkSweep.
+  void mark_strong_roots(ReferenceProcessor* rp);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_SHARED_PARMARKSWEEP_HPP
@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_GC_IMPLEMENTATION_SHARED_STRINGSYMBOLTABLEUNLINKTASK_HPP
+#define SHARE_VM_GC_IMPLEMENTATION_SHARED_STRINGSYMBOLTABLEUNLINKTASK_HPP
+
+#include "memory/iterator.hpp"
+#include "utilities/workgroup.hpp"
+
+// Scrubs the interned String table and, unless do_symbols is false, the
+// SymbolTable on all the threads of a work gang, once the marking of a
+// collection is complete.  The workers claim the buckets of each table in
+// chunks.  Must only be constructed at a safepoint, and run once.
+class StringSymbolTableUnlinkTask: public AbstractGangTask {
+  BoolObjectClosure* _is_alive;
+  bool               _do_symbols;
+
+ public:
+  StringSymbolTableUnlinkTask(BoolObjectClosure* is_alive, bool do_symbols);
+  ~StringSymbolTableUnlinkTask();
+
+  void work(int i);
+};
+
+#endif // SHARE_VM_GC_IMPLEMENTATION_SHARED_STRINGSYMBOLTABLEUNLINKTASK_HPP
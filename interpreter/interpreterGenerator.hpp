@@ -57,6 +57,8 @@ InterpreterGenerator(StubQueue* _code);
   address generate_empty_entry(void);
   address generate_accessor_entry(void);
   address generate_Reference_get_entry();
+  address generate_CRC32_update_entry();
+  address generate_CRC32_updateBytes_entry();
   void lock_method(void);
   void generate_stack_overflow_check(void);
 
@@ -372,6 +372,10 @@ void TemplateInterpreterGenerator::generate_all() {
   method_entry(java_lang_math_log10)
   method_entry(java_lang_ref_reference_get)
 
+  // all intrinsified native method kinds
+  method_entry(java_util_zip_CRC32_update)
+  method_entry(java_util_zip_CRC32_updateBytes)
+
   // all native method kinds (must be one contiguous block)
   Interpreter::_native_entry_begin = Interpreter::code()->code_end();
   method_entry(native)
@@ -2107,6 +2111,8 @@ address AbstractInterpreterGenerator::generate_method_entry(AbstractInterpreter:
     case Interpreter::java_lang_math_sqrt    : entry_point = ((InterpreterGenerator*)this)->generate_math_entry(kind);     break;
     case Interpreter::java_lang_ref_reference_get
                                              : entry_point = ((InterpreterGenerator*)this)->generate_Reference_get_entry(); break;
+    case Interpreter::java_util_zip_CRC32_update      : // fall thru
+    case Interpreter::java_util_zip_CRC32_updateBytes : entry_point = ((InterpreterGenerator*)this)->generate_native_entry(false); break;
     default                                  : ShouldNotReachHere();                                                       break;
   }
 
@@ -673,6 +673,10 @@ void DefNewGeneration::remove_forwarding_pointers() {
   from()->object_iterate(&rspc);
 
   // Now restore saved marks, if any.
+  restore_preserved_marks();
+}
+
+void DefNewGeneration::restore_preserved_marks() {
   assert(_objs_with_preserved_marks.size() == _preserved_marks_of_objs.size(),
          "should be the same");
   while (!_objs_with_preserved_marks.is_empty()) {
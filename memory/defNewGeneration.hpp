@@ -81,6 +81,9 @@ protected:
   // the subsequent full collection will look at from-space objects:
   // therefore we must remove their forwarding pointers.
   void remove_forwarding_pointers();
+  // Restore the marks saved by preserve_mark(), after the forwarding
+  // pointers have been removed.
+  void restore_preserved_marks();
 
   // Preserve the mark of "obj", if necessary, in preparation for its mark
   // word being overwritten with a self-forwarding-pointer.
@@ -1440,6 +1440,120 @@ jsum(jlong start, const char *buf, const int len)
 
 
 
+// Load and link a class to be shared by the boot loader, and record it in
+// the class promotion order.  Returns false if the class was not found or
+// could not be loaded; the class is then skipped with a warning.
+
+static bool preload_shared_class(const char* class_name,
+                                 GrowableArray<oop>* class_promote_order,
+                                 TRAPS) {
+  TempNewSymbol class_name_symbol = SymbolTable::new_symbol(class_name, THREAD);
+  klassOop klass = NULL;
+  if (!HAS_PENDING_EXCEPTION) {
+    klass = SystemDictionary::resolve_or_null(class_name_symbol, THREAD);
+  }
+  if (HAS_PENDING_EXCEPTION) {
+    ResourceMark rm(THREAD);
+    warning("Preload failed: %s: %s", class_name,
+            Klass::cast(PENDING_EXCEPTION->klass())->external_name());
+    CLEAR_PENDING_EXCEPTION;
+    return false;
+  }
+  if (klass == NULL) {
+    if (PrintSharedSpaces) {
+      tty->cr();
+      tty->print_cr(" Preload failed: %s", class_name);
+    }
+    return false;
+  }
+  if (PrintSharedSpaces) {
+    tty->print_cr("Shared spaces preloaded: %s", class_name);
+  }
+
+  instanceKlass* ik = instanceKlass::cast(klass);
+
+  // Should be class load order as per -XX:+TraceClassLoadingPreorder
+  class_promote_order->append(ik->as_klassOop());
+
+  // Link the class to cause the bytecodes to be rewritten and the
+  // cpcache to be created. The linking is done as soon as classes
+  // are loaded in order that the related data structures (klass,
+  // cpCache, Sting constants) are located together.
+
+  if (ik->get_init_state() < instanceKlass::linked) {
+    ik->link_class(THREAD);
+    guarantee(!(HAS_PENDING_EXCEPTION), "exception in class rewriting");
+  }
+
+  // Create String objects from string initializer symbols.
+
+  ik->constants()->resolve_string_constants(THREAD);
+  return true;
+}
+
+
+// Load the application classes listed in SharedClassListFile.  Unlike
+// the JDK class list, this list carries no checksum.  The classes are
+// loaded by the boot loader, so they must be found in a jar file of the
+// boot class path, typically appended with -Xbootclasspath/a.  Those jar
+// files are recorded in the archive header and validated when the
+// archive is mapped, so an archive is rejected if they have changed.
+//
+// Only the boot loader has a shared dictionary, so the archived classes
+// are defined by the boot loader, at dump time and when the archive is
+// used.  The application must therefore run with the same
+// -Xbootclasspath/a, and its classes see a null class loader: code that
+// relies on getClassLoader(), on the application class loader's
+// protection domain or on class loader delegation will behave
+// differently.
+//
+// Lines naming classes longer than the name buffer are skipped with a
+// warning, as are classes that cannot be found or loaded.
+
+static int preload_application_classes(GrowableArray<oop>* class_promote_order,
+                                       TRAPS) {
+  FILE* file = fopen(SharedClassListFile, "r");
+  if (file == NULL) {
+    char errmsg[JVM_MAXPATHLEN];
+    os::lasterror(errmsg, JVM_MAXPATHLEN);
+    tty->print_cr("Loading application class list %s failed: %s",
+                  SharedClassListFile, errmsg);
+    exit(1);
+  }
+
+  char class_name[JVM_MAXPATHLEN];
+  int class_count = 0;
+  while ((fgets(class_name, sizeof class_name, file)) != NULL) {
+    size_t name_len = strlen(class_name);
+    if (name_len == sizeof class_name - 1 &&
+        class_name[name_len - 1] != '\n' && !feof(file)) {
+      // The line did not fit: skip the rest of it.
+      warning("Class name too long in %s, skipped: %.64s...",
+              SharedClassListFile, class_name);
+      int c;
+      while ((c = getc(file)) != EOF && c != '\n') {
+      }
+      continue;
+    }
+    // Skip comments and blank lines, remove trailing white space.
+    if (*class_name == '#') {
+      continue;
+    }
+    while (name_len > 0 && isspace(class_name[name_len-1])) {
+      class_name[--name_len] = '\0';
+    }
+    if (name_len == 0) {
+      continue;
+    }
+    if (preload_shared_class(class_name, class_promote_order, THREAD)) {
+      class_count++;
+    }
+  }
+  fclose(file);
+  return class_count;
+}
+
+
 // Preload classes from a list, populate the shared spaces and dump to a
 // file.
 
@@ -1514,42 +1628,8 @@ void GenCollectedHeap::preload_and_dump(TRAPS) {
       computed_jsum = jsum(computed_jsum, class_name, (const int)name_len - 1);
 
       // Got a class name - load it.
-      TempNewSymbol class_name_symbol = SymbolTable::new_symbol(class_name, THREAD);
-      guarantee(!HAS_PENDING_EXCEPTION, "Exception creating a symbol.");
-      klassOop klass = SystemDictionary::resolve_or_null(class_name_symbol,
-                                                         THREAD);
-      guarantee(!HAS_PENDING_EXCEPTION, "Exception resolving a class.");
-      if (klass != NULL) {
-        if (PrintSharedSpaces) {
-          tty->print_cr("Shared spaces preloaded: %s", class_name);
-        }
-
-
-        instanceKlass* ik = instanceKlass::cast(klass);
-
-        // Should be class load order as per -XX:+TraceClassLoadingPreorder
-        class_promote_order->append(ik->as_klassOop());
-
-        // Link the class to cause the bytecodes to be rewritten and the
-        // cpcache to be created. The linking is done as soon as classes
-        // are loaded in order that the related data structures (klass,
-        // cpCache, Sting constants) are located together.
-
-        if (ik->get_init_state() < instanceKlass::linked) {
-          ik->link_class(THREAD);
-          guarantee(!(HAS_PENDING_EXCEPTION), "exception in class rewriting");
-        }
-
-        // Create String objects from string initializer symbols.
-
-        ik->constants()->resolve_string_constants(THREAD);
-
+      if (preload_shared_class(class_name, class_promote_order, THREAD)) {
         class_count++;
-      } else {
-        if (PrintSharedSpaces) {
-          tty->cr();
-          tty->print_cr(" Preload failed: %s", class_name);
-        }
       }
       file_jsum = 0; // Checksum must be on last line of file
     }
@@ -1561,6 +1641,12 @@ void GenCollectedHeap::preload_and_dump(TRAPS) {
 
     tty->print_cr("done. ");
 
+    if (SharedClassListFile != NULL) {
+      tty->print("Loading application classes to share ... ");
+      class_count += preload_application_classes(class_promote_order, THREAD);
+      tty->print_cr("done. ");
+    }
+
     if (PrintSharedSpaces) {
       tty->print_cr("Shared spaces: preloaded %d classes", class_count);
     }
@@ -82,6 +82,27 @@ void FileMapInfo::fail_continue(const char *msg, ...) {
 }
 
 
+// Hash of a boot class path entry, recorded so that an archive dumped with
+// application jar files appended to the boot class path is not used with
+// different jar files that happen to have the same size and timestamp.
+// The jar files of the JDK are hashed by their path relative to the JDK
+// home, so that the archive stays valid when the JDK is moved.
+
+unsigned int FileMapInfo::path_hash(const char* path) {
+  const char* java_home = Arguments::get_java_home();
+  size_t home_len = strlen(java_home);
+  if (home_len > 0 && strncmp(path, java_home, home_len) == 0 &&
+      strncmp(path + home_len, os::file_separator(), strlen(os::file_separator())) == 0) {
+    path += home_len;
+  }
+  unsigned int h = 0;
+  while (*path != '\0') {
+    h = 31*h + (unsigned int)(unsigned char)*path++;
+  }
+  return h;
+}
+
+
 // Fill in the fileMapInfo structure with data about this VM instance.
 
 void FileMapInfo::populate_header(size_t alignment) {
@@ -122,6 +143,7 @@ void FileMapInfo::populate_header(size_t alignment) {
       }
       _header._jar[_header._num_jars]._timestamp = st.st_mtime;
       _header._jar[_header._num_jars]._filesize = st.st_size;
+      _header._jar[_header._num_jars]._path_hash = path_hash(path);
       _header._num_jars++;
     } else {
 
@@ -484,7 +506,8 @@ bool FileMapInfo::validate() {
           return false;
         }
         if (_header._jar[num_jars_now]._timestamp != st.st_mtime ||
-            _header._jar[num_jars_now]._filesize != st.st_size) {
+            _header._jar[num_jars_now]._filesize != st.st_size ||
+            _header._jar[num_jars_now]._path_hash != path_hash(path)) {
           fail_continue("A jar file is not the one used while building"
                         " the shared archive file.");
           return false;
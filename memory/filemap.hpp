@@ -48,7 +48,7 @@ class FileMapInfo : public CHeapObj {
 private:
   enum {
     _invalid_version = -1,
-    _current_version = 1
+    _current_version = 2
   };
 
   bool  _file_open;
@@ -80,11 +80,12 @@ private:
     char  _jvm_ident[JVM_IDENT_MAX];      // identifier for jvm
     int   _num_jars;              // Number of jars in bootclasspath
 
-    // Per jar file data:  timestamp, size.
+    // Per jar file data:  timestamp, size, path.
 
     struct {
       time_t _timestamp;          // jar timestamp.
       long   _filesize;           // jar file size.
+      unsigned int _path_hash;    // hash of the jar file path.
     } _jar[JVM_SHARED_JARS_MAX];
   } _header;
   const char* _full_path;
@@ -92,6 +93,7 @@ private:
   static FileMapInfo* _current_info;
 
   bool  init_from_file(int fd);
+  static unsigned int path_hash(const char* path);
   void  align_file_position();
 
 public:
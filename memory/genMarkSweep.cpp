@@ -29,6 +29,8 @@
 #include "classfile/vmSymbols.hpp"
 #include "code/codeCache.hpp"
 #include "code/icBuffer.hpp"
+#include "gc_implementation/shared/parMarkSweep.hpp"
+#include "gc_implementation/shared/stringSymbolTableUnlinkTask.hpp"
 #include "gc_interface/collectedHeap.inline.hpp"
 #include "memory/genCollectedHeap.hpp"
 #include "memory/genMarkSweep.hpp"
@@ -46,6 +48,7 @@
 #include "runtime/vmThread.hpp"
 #include "utilities/copy.hpp"
 #include "utilities/events.hpp"
+#include "utilities/workgroup.hpp"
 #ifdef TARGET_OS_FAMILY_linux
 # include "thread_linux.inline.hpp"
 #endif
@@ -56,6 +59,8 @@
 # include "thread_windows.inline.hpp"
 #endif
 
+ParMarkSweep* GenMarkSweep::_par_mark_sweep = NULL;
+
 void GenMarkSweep::invoke_at_safepoint(int level, ReferenceProcessor* rp,
   bool clear_all_softrefs) {
   assert(SafepointSynchronize::is_at_safepoint(), "must be at a safepoint");
@@ -194,6 +199,10 @@ void GenMarkSweep::allocate_stacks() {
   _preserved_marks = (PreservedMark*)scratch;
   _preserved_count = 0;
 
+  if (use_parallel_full_gc() && _par_mark_sweep == NULL) {
+    _par_mark_sweep = new ParMarkSweep(gch->workers()->total_workers());
+  }
+
 #ifdef VALIDATE_MARK_SWEEP
   if (ValidateMarkSweep) {
     _root_refs_stack    = new (ResourceObj::C_HEAP) GrowableArray<void*>(100, true);
@@ -248,6 +257,15 @@ void GenMarkSweep::deallocate_stacks() {
 #endif
 }
 
+bool GenMarkSweep::use_parallel_full_gc() {
+  // The mark sweep validation code keeps global, order dependent
+  // tables; it only works with the serial phases.
+  return UseConcMarkSweepGC && CMSParallelFullGC &&
+         CollectedHeap::use_parallel_gc_threads() &&
+         GenCollectedHeap::heap()->workers() != NULL
+         NOT_PRODUCT(&& !ValidateMarkSweep && !RecordMarkSweepCompaction);
+}
+
 void GenMarkSweep::mark_sweep_phase1(int level,
                                   bool clear_all_softrefs) {
   // Recursively traverse all live objects and mark them
@@ -265,14 +283,21 @@ void GenMarkSweep::mark_sweep_phase1(int level,
   // are run.
   follow_root_closure.set_orig_generation(gch->get_gen(level));
 
-  gch->gen_process_strong_roots(level,
-                                false, // Younger gens are not roots.
-                                true,  // activate StrongRootsScope
-                                true,  // Collecting permanent generation.
-                                SharedHeap::SO_SystemClasses,
-                                &follow_root_closure,
-                                true,   // walk code active on stacks
-                                &follow_root_closure);
+  if (use_parallel_full_gc()) {
+    // All the generations are collected, so there are no older
+    // generation roots to scan.
+    assert(level == gch->n_gens() - 1, "must be collecting the whole heap");
+    _par_mark_sweep->mark_strong_roots(ref_processor());
+  } else {
+    gch->gen_process_strong_roots(level,
+                                  false, // Younger gens are not roots.
+                                  true,  // activate StrongRootsScope
+                                  true,  // Collecting permanent generation.
+                                  SharedHeap::SO_SystemClasses,
+                                  &follow_root_closure,
+                                  true,   // walk code active on stacks
+                                  &follow_root_closure);
+  }
 
   // Process reference objects found during marking
   {
@@ -296,10 +321,15 @@ void GenMarkSweep::mark_sweep_phase1(int level,
   follow_mdo_weak_refs();
   assert(_marking_stack.is_empty(), "just drained");
 
-  // Visit interned string tables and delete unmarked oops
-  StringTable::unlink(&is_alive);
-  // Clean up unreferenced symbols in symbol table.
-  SymbolTable::unlink();
+  if (use_parallel_full_gc()) {
+    StringSymbolTableUnlinkTask unlink_task(&is_alive, true);
+    gch->workers()->run_task(&unlink_task);
+  } else {
+    // Visit interned string tables and delete unmarked oops
+    StringTable::unlink(&is_alive);
+    // Clean up unreferenced symbols in symbol table.
+    SymbolTable::unlink();
+  }
 
   assert(_marking_stack.is_empty(), "stack should be empty by now");
 }
@@ -27,6 +27,8 @@
 
 #include "gc_implementation/shared/markSweep.hpp"
 
+class ParMarkSweep;
+
 class GenMarkSweep : public MarkSweep {
   friend class VM_MarkSweep;
   friend class G1MarkSweep;
@@ -34,6 +36,12 @@ class GenMarkSweep : public MarkSweep {
   static void invoke_at_safepoint(int level, ReferenceProcessor* rp,
                                   bool clear_all_softrefs);
 
+  // Whether the parallel GC threads should be used for the full
+  // collections of a CMS heap (see CMSParallelFullGC).  Tracing from the
+  // strong roots is then done by the work gang, and the CMS generation
+  // is compacted in parallel (see CompactibleFreeListSpace).
+  static bool use_parallel_full_gc();
+
  private:
 
   // Mark live objects
@@ -48,6 +56,9 @@ class GenMarkSweep : public MarkSweep {
   // Temporary data structures for traversal and storing/restoring marks
   static void allocate_stacks();
   static void deallocate_stacks();
+
+  // Per-worker marking state, allocated at the first parallel full GC.
+  static ParMarkSweep* _par_mark_sweep;
 };
 
 #endif // SHARE_VM_MEMORY_GENMARKSWEEP_HPP
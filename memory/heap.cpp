@@ -35,7 +35,8 @@ size_t CodeHeap::header_size() {
 
 // Implementation of Heap
 
-CodeHeap::CodeHeap() {
+CodeHeap::CodeHeap(const char* name, const int code_blob_type)
+  : _name(name), _code_blob_type(code_blob_type) {
   _number_of_committed_segments = 0;
   _number_of_reserved_segments  = 0;
   _segment_size                 = 0;
@@ -94,30 +95,48 @@ void CodeHeap::on_code_mapping(char* base, size_t size) {
 }
 
 
-bool CodeHeap::reserve(size_t reserved_size, size_t committed_size,
-                       size_t segment_size) {
+ReservedSpace CodeHeap::reserve_code_space(size_t reserved_size,
+                                           size_t committed_size,
+                                           size_t* page_size_ret) {
   assert(reserved_size >= committed_size, "reserved < committed");
-  assert(segment_size >= sizeof(FreeBlock), "segment size is too small");
-  assert(is_power_of_2(segment_size), "segment_size must be a power of 2");
 
-  _segment_size      = segment_size;
-  _log2_segment_size = exact_log2(segment_size);
-
-  // Reserve and initialize space for _memory.
+  // Reserve space for _memory.
   const size_t page_size = os::can_execute_large_page_memory() ?
           os::page_size_for_region(committed_size, reserved_size, 8) :
           os::vm_page_size();
   const size_t granularity = os::vm_allocation_granularity();
   const size_t r_align = MAX2(page_size, granularity);
   const size_t r_size = align_size_up(reserved_size, r_align);
-  const size_t c_size = align_size_up(committed_size, page_size);
 
   const size_t rs_align = page_size == (size_t) os::vm_page_size() ? 0 :
     MAX2(page_size, granularity);
   ReservedCodeSpace rs(r_size, rs_align, rs_align > 0);
   os::trace_page_sizes("code heap", committed_size, reserved_size, page_size,
                        rs.base(), rs.size());
-  if (!_memory.initialize(rs, c_size)) {
+  *page_size_ret = page_size;
+  return rs;
+}
+
+
+bool CodeHeap::reserve(size_t reserved_size, size_t committed_size,
+                       size_t segment_size) {
+  size_t page_size;
+  ReservedSpace rs = reserve_code_space(reserved_size, committed_size,
+                                        &page_size);
+  return reserve(rs, align_size_up(committed_size, page_size), segment_size);
+}
+
+
+bool CodeHeap::reserve(ReservedSpace rs, size_t committed_size,
+                       size_t segment_size) {
+  assert(rs.size() >= committed_size, "reserved < committed");
+  assert(segment_size >= sizeof(FreeBlock), "segment size is too small");
+  assert(is_power_of_2(segment_size), "segment_size must be a power of 2");
+
+  _segment_size      = segment_size;
+  _log2_segment_size = exact_log2(segment_size);
+
+  if (!_memory.initialize(rs, committed_size)) {
     return false;
   }
 
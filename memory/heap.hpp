@@ -93,6 +93,9 @@ class CodeHeap : public CHeapObj {
   FreeBlock*   _freelist;
   size_t       _free_segments;                   // No. of segments in freelist
 
+  const char*  _name;                            // Name of the CodeHeap
+  const int    _code_blob_type;                  // CodeBlobType it contains
+
   // Helper functions
   size_t   number_of_segments(size_t size) const { return (size + _segment_size - 1) >> _log2_segment_size; }
   size_t   size(size_t number_of_segments) const { return number_of_segments << _log2_segment_size; }
@@ -122,10 +125,16 @@ class CodeHeap : public CHeapObj {
   void on_code_mapping(char* base, size_t size);
 
  public:
-  CodeHeap();
+  CodeHeap(const char* name, const int code_blob_type);
 
   // Heap extents
   bool  reserve(size_t reserved_size, size_t committed_size, size_t segment_size);
+  bool  reserve(ReservedSpace rs, size_t committed_size, size_t segment_size);
+  // Reserves the address range for code heaps of reserved_size bytes in
+  // total; the page size used is returned in page_size.
+  static ReservedSpace reserve_code_space(size_t reserved_size,
+                                          size_t committed_size,
+                                          size_t* page_size);
   void  release();                               // releases all allocated memory
   bool  expand_by(size_t size);                  // expands commited memory by size
   void  shrink_by(size_t size);                  // shrinks commited memory by size
@@ -156,6 +165,9 @@ class CodeHeap : public CHeapObj {
   // returns the next block given a block p or NULL
   void* next(void* p) const { return next_free(next_block(block_start(p))); }
 
+  const char* name() const                       { return _name; }
+  int code_blob_type() const                     { return _code_blob_type; }
+
   // Statistics
   size_t capacity() const;
   size_t max_capacity() const;
@@ -30,6 +30,7 @@
 #include "memory/referencePolicy.hpp"
 #include "memory/referenceProcessor.hpp"
 #include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/java.hpp"
 #include "runtime/jniHandles.hpp"
 
@@ -699,7 +700,7 @@ ReferenceProcessor::pp2_work_concurrent_discovery(DiscoveredList&    refs_list,
 // Traverse the list and process the referents, by either
 // clearing them or keeping them (and their reachable
 // closure) alive.
-void
+oop
 ReferenceProcessor::process_phase3(DiscoveredList&    refs_list,
                                    bool               clear_referent,
                                    BoolObjectClosure* is_alive,
@@ -707,6 +708,7 @@ ReferenceProcessor::process_phase3(DiscoveredList&    refs_list,
                                    VoidClosure*       complete_gc) {
   ResourceMark rm;
   DiscoveredListIterator iter(refs_list, keep_alive, is_alive);
+  oop last = sentinel_ref();
   while (iter.has_next()) {
     iter.update_discovered();
     iter.load_ptrs(DEBUG_ONLY(false /* allow_null_referent */));
@@ -723,12 +725,14 @@ ReferenceProcessor::process_phase3(DiscoveredList&    refs_list,
                              iter.obj(), iter.obj()->blueprint()->internal_name());
     }
     assert(iter.obj()->is_oop(UseConcMarkSweepGC), "Adding a bad reference");
+    last = iter.obj();
     iter.next();
   }
   // Remember to keep sentinel pointer around
   iter.update_discovered();
   // Close the reachable set
   complete_gc->do_void();
+  return last;
 }
 
 void
@@ -754,57 +758,205 @@ void ReferenceProcessor::abandon_partial_discovery() {
   }
 }
 
+// The discovered lists of one kind of reference, cut into chunks of at
+// most ParallelRefProcChunkSize references.  The workers of a parallel
+// phase claim the chunks one at a time, so that the work is spread over
+// all the workers even if a few threads discovered most of the references.
+class DiscoveredListChunks: public StackObj {
+  DiscoveredList* _chunks;
+  oop*            _tails;      // last reference of each chunk, after phase 3
+  int             _n_chunks;
+  volatile jint   _next_chunk; // next chunk to be claimed
+
+ public:
+  DiscoveredListChunks() :
+    _chunks(NULL), _tails(NULL), _n_chunks(0), _next_chunk(0) { }
+  ~DiscoveredListChunks() {
+    if (_chunks != NULL) {
+      FREE_C_HEAP_ARRAY(DiscoveredList, _chunks);
+      FREE_C_HEAP_ARRAY(oop, _tails);
+    }
+  }
+
+  bool is_split() const { return _chunks != NULL; }
+
+  // Move the references of refs_lists[0, n_lists) into the chunks.
+  void split(DiscoveredList refs_lists[], int n_lists, size_t chunk_size);
+
+  // Prepend the chunks to refs_lists[0, n_lists) in turn.  The chunks must
+  // have gone through phase 3.
+  void join(DiscoveredList refs_lists[], int n_lists);
+
+  void reset_claims() { _next_chunk = 0; }
+
+  // Returns the next unclaimed chunk, or NULL if all have been claimed.
+  DiscoveredList* claim() {
+    jint i = Atomic::add(1, &_next_chunk) - 1;
+    return i < _n_chunks ? &_chunks[i] : NULL;
+  }
+
+  void set_tail(DiscoveredList* chunk, oop tail) {
+    _tails[chunk - _chunks] = tail;
+  }
+};
+
+void DiscoveredListChunks::split(DiscoveredList refs_lists[], int n_lists,
+                                 size_t chunk_size) {
+  assert(!is_split(), "already split");
+  assert(chunk_size > 0, "Sanity Check!");
+  int max_chunks = 0;
+  for (int i = 0; i < n_lists; i++) {
+    max_chunks += (int)((refs_lists[i].length() + chunk_size - 1) / chunk_size);
+  }
+  // Allocate at least one chunk so that is_split() holds.
+  max_chunks = MAX2(max_chunks, 1);
+  _chunks = NEW_C_HEAP_ARRAY(DiscoveredList, max_chunks);
+  _tails  = NEW_C_HEAP_ARRAY(oop, max_chunks);
+
+  oop sentinel = ReferenceProcessor::sentinel_ref();
+  for (int i = 0; i < n_lists; i++) {
+    oop obj = refs_lists[i].head();
+    while (obj != sentinel) {
+      assert(_n_chunks < max_chunks, "list length is wrong");
+      DiscoveredList& chunk = _chunks[_n_chunks];
+      chunk.set_head(obj);
+      oop last = obj;
+      size_t len = 0;
+      do {
+        last = obj;
+        obj = java_lang_ref_Reference::discovered(obj);
+        len++;
+      } while (len < chunk_size && obj != sentinel);
+      if (obj != sentinel) {
+        java_lang_ref_Reference::set_discovered(last, sentinel);
+      }
+      chunk.set_length(len);
+      _tails[_n_chunks] = last;
+      _n_chunks++;
+    }
+    refs_lists[i].set_head(sentinel);
+    refs_lists[i].set_length(0);
+  }
+}
+
+void DiscoveredListChunks::join(DiscoveredList refs_lists[], int n_lists) {
+  assert(is_split(), "not split");
+  for (int c = 0; c < _n_chunks; c++) {
+    DiscoveredList& chunk = _chunks[c];
+    if (chunk.empty()) {
+      continue;
+    }
+    DiscoveredList& refs_list = refs_lists[c % n_lists];
+    java_lang_ref_Reference::set_discovered(_tails[c], refs_list.head());
+    refs_list.set_head(chunk.head());
+    refs_list.inc_length(chunk.length());
+  }
+}
+
+// With chunks, the reachable set is closed once per worker, after it has
+// run out of chunks to claim, rather than once per chunk: the complete_gc
+// closures of the parallel collectors end with a termination protocol.
+class RefProcDeferredCompleteGCClosure: public VoidClosure {
+ public:
+  void do_void() { }
+};
+
 class RefProcPhase1Task: public AbstractRefProcTaskExecutor::ProcessTask {
 public:
-  RefProcPhase1Task(ReferenceProcessor& ref_processor,
-                    DiscoveredList      refs_lists[],
-                    ReferencePolicy*    policy,
-                    bool                marks_oops_alive)
+  RefProcPhase1Task(ReferenceProcessor&   ref_processor,
+                    DiscoveredList        refs_lists[],
+                    DiscoveredListChunks* chunks,
+                    ReferencePolicy*      policy,
+                    bool                  marks_oops_alive)
     : ProcessTask(ref_processor, refs_lists, marks_oops_alive),
+      _chunks(chunks),
       _policy(policy)
   { }
   virtual void work(unsigned int i, BoolObjectClosure& is_alive,
                     OopClosure& keep_alive,
                     VoidClosure& complete_gc)
   {
+    if (_chunks != NULL) {
+      RefProcDeferredCompleteGCClosure deferred;
+      for (DiscoveredList* chunk = _chunks->claim();
+           chunk != NULL;
+           chunk = _chunks->claim()) {
+        _ref_processor.process_phase1(*chunk, _policy,
+                                      &is_alive, &keep_alive, &deferred);
+      }
+      complete_gc.do_void();
+      return;
+    }
     Thread* thr = Thread::current();
     int refs_list_index = ((WorkerThread*)thr)->id();
     _ref_processor.process_phase1(_refs_lists[refs_list_index], _policy,
                                   &is_alive, &keep_alive, &complete_gc);
   }
 private:
-  ReferencePolicy* _policy;
+  DiscoveredListChunks* _chunks;
+  ReferencePolicy*      _policy;
 };
 
 class RefProcPhase2Task: public AbstractRefProcTaskExecutor::ProcessTask {
 public:
-  RefProcPhase2Task(ReferenceProcessor& ref_processor,
-                    DiscoveredList      refs_lists[],
-                    bool                marks_oops_alive)
-    : ProcessTask(ref_processor, refs_lists, marks_oops_alive)
+  RefProcPhase2Task(ReferenceProcessor&   ref_processor,
+                    DiscoveredList        refs_lists[],
+                    DiscoveredListChunks* chunks,
+                    bool                  marks_oops_alive)
+    : ProcessTask(ref_processor, refs_lists, marks_oops_alive),
+      _chunks(chunks)
   { }
   virtual void work(unsigned int i, BoolObjectClosure& is_alive,
                     OopClosure& keep_alive,
                     VoidClosure& complete_gc)
   {
+    if (_chunks != NULL) {
+      RefProcDeferredCompleteGCClosure deferred;
+      for (DiscoveredList* chunk = _chunks->claim();
+           chunk != NULL;
+           chunk = _chunks->claim()) {
+        _ref_processor.process_phase2(*chunk,
+                                      &is_alive, &keep_alive, &deferred);
+      }
+      if (!_ref_processor.discovery_is_atomic()) {
+        complete_gc.do_void();
+      }
+      return;
+    }
     _ref_processor.process_phase2(_refs_lists[i],
                                   &is_alive, &keep_alive, &complete_gc);
   }
+private:
+  DiscoveredListChunks* _chunks;
 };
 
 class RefProcPhase3Task: public AbstractRefProcTaskExecutor::ProcessTask {
 public:
-  RefProcPhase3Task(ReferenceProcessor& ref_processor,
-                    DiscoveredList      refs_lists[],
-                    bool                clear_referent,
-                    bool                marks_oops_alive)
+  RefProcPhase3Task(ReferenceProcessor&   ref_processor,
+                    DiscoveredList        refs_lists[],
+                    DiscoveredListChunks* chunks,
+                    bool                  clear_referent,
+                    bool                  marks_oops_alive)
     : ProcessTask(ref_processor, refs_lists, marks_oops_alive),
+      _chunks(chunks),
       _clear_referent(clear_referent)
   { }
   virtual void work(unsigned int i, BoolObjectClosure& is_alive,
                     OopClosure& keep_alive,
                     VoidClosure& complete_gc)
   {
+    if (_chunks != NULL) {
+      RefProcDeferredCompleteGCClosure deferred;
+      for (DiscoveredList* chunk = _chunks->claim();
+           chunk != NULL;
+           chunk = _chunks->claim()) {
+        oop tail = _ref_processor.process_phase3(*chunk, _clear_referent,
+                                                 &is_alive, &keep_alive, &deferred);
+        _chunks->set_tail(chunk, tail);
+      }
+      complete_gc.do_void();
+      return;
+    }
     // Don't use "refs_list_index" calculated in this way because
     // balance_queues() has moved the Ref's into the first n queues.
     // Thread* thr = Thread::current();
@@ -814,7 +966,8 @@ public:
                                   &is_alive, &keep_alive, &complete_gc);
   }
 private:
-  bool _clear_referent;
+  DiscoveredListChunks* _chunks;
+  bool                  _clear_referent;
 };
 
 // Balances reference queues.
@@ -914,15 +1067,18 @@ ReferenceProcessor::process_discovered_reflist(
   AbstractRefProcTaskExecutor* task_executor)
 {
   bool mt_processing = task_executor != NULL && _processing_is_mt;
+  // With chunking, the workers of the parallel phases claim the work in
+  // chunks cut from all the lists, so the lists need not be balanced.
+  bool use_chunks = mt_processing && ParallelRefProcChunkSize > 0;
   // If discovery used MT and a dynamic number of GC threads, then
   // the queues must be balanced for correctness if fewer than the
   // maximum number of queues were used.  The number of queue used
   // during discovery may be different than the number to be used
   // for processing so don't depend of _num_q < _max_num_q as part
   // of the test.
-  bool must_balance = _discovery_is_mt;
+  bool must_balance = _discovery_is_mt && !use_chunks;
 
-  if ((mt_processing && ParallelRefProcBalancingEnabled) ||
+  if ((mt_processing && ParallelRefProcBalancingEnabled && !use_chunks) ||
       must_balance) {
     balance_queues(refs_lists);
   }
@@ -934,6 +1090,12 @@ ReferenceProcessor::process_discovered_reflist(
     gclog_or_tty->print(", %u refs", total);
   }
 
+  DiscoveredListChunks chunks;
+  if (use_chunks) {
+    chunks.split(refs_lists, _max_num_q, ParallelRefProcChunkSize);
+  }
+  DiscoveredListChunks* mt_chunks = use_chunks ? &chunks : NULL;
+
   // Phase 1 (soft refs only):
   // . Traverse the list and remove any SoftReferences whose
   //   referents are not alive, but that should be kept alive for
@@ -941,7 +1103,11 @@ ReferenceProcessor::process_discovered_reflist(
   //   such referents.
   if (policy != NULL) {
     if (mt_processing) {
-      RefProcPhase1Task phase1(*this, refs_lists, policy, true /*marks_oops_alive*/);
+      if (use_chunks) {
+        chunks.reset_claims();
+      }
+      RefProcPhase1Task phase1(*this, refs_lists, mt_chunks, policy,
+                               true /*marks_oops_alive*/);
       task_executor->execute(phase1);
     } else {
       for (int i = 0; i < _max_num_q; i++) {
@@ -957,7 +1123,11 @@ ReferenceProcessor::process_discovered_reflist(
   // Phase 2:
   // . Traverse the list and remove any refs whose referents are alive.
   if (mt_processing) {
-    RefProcPhase2Task phase2(*this, refs_lists, !discovery_is_atomic() /*marks_oops_alive*/);
+    if (use_chunks) {
+      chunks.reset_claims();
+    }
+    RefProcPhase2Task phase2(*this, refs_lists, mt_chunks,
+                             !discovery_is_atomic() /*marks_oops_alive*/);
     task_executor->execute(phase2);
   } else {
     for (int i = 0; i < _max_num_q; i++) {
@@ -968,8 +1138,16 @@ ReferenceProcessor::process_discovered_reflist(
   // Phase 3:
   // . Traverse the list and process referents as appropriate.
   if (mt_processing) {
-    RefProcPhase3Task phase3(*this, refs_lists, clear_referent, true /*marks_oops_alive*/);
+    if (use_chunks) {
+      chunks.reset_claims();
+    }
+    RefProcPhase3Task phase3(*this, refs_lists, mt_chunks, clear_referent,
+                             true /*marks_oops_alive*/);
     task_executor->execute(phase3);
+    if (use_chunks) {
+      // The references are enqueued from the first _num_q lists only.
+      chunks.join(refs_lists, _num_q);
+    }
   } else {
     for (int i = 0; i < _max_num_q; i++) {
       process_phase3(refs_lists[i], clear_referent,
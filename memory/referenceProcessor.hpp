@@ -104,7 +104,7 @@ class ReferenceProcessor : public CHeapObj {
  public:
   int num_q()                            { return _num_q; }
   int max_num_q()                        { return _max_num_q; }
-  void set_active_mt_degree(int v)       { _num_q = v; }
+  void set_active_mt_degree(int v)       { _num_q = v; _next_id = 0; }
   DiscoveredList* discovered_soft_refs() { return _discoveredSoftRefs; }
   static oop  sentinel_ref()             { return _sentinelRef; }
   static oop* adr_sentinel_ref()         { return &_sentinelRef; }
@@ -162,8 +162,9 @@ class ReferenceProcessor : public CHeapObj {
                 OopClosure*        keep_alive,
                 VoidClosure*       complete_gc);
   // Phase3: process the referents by either clearing them
-  // or keeping them alive (and their closure)
-  void process_phase3(DiscoveredList&    refs_list,
+  // or keeping them alive (and their closure).  Returns the
+  // last reference of the list, or the sentinel if it is empty.
+  oop  process_phase3(DiscoveredList&    refs_list,
                       bool               clear_referent,
                       BoolObjectClosure* is_alive,
                       OopClosure*        keep_alive,
@@ -49,6 +49,7 @@
 #include "runtime/handles.inline.hpp"
 #include "runtime/javaCalls.hpp"
 #include "runtime/mutexLocker.hpp"
+#include "runtime/profileSnapshot.hpp"
 #include "services/threadService.hpp"
 #include "utilities/dtrace.hpp"
 #ifdef TARGET_OS_FAMILY_linux
@@ -355,6 +356,11 @@ bool instanceKlass::link_class_impl(
         // this_oop->itable()->verify(tty, true);
       }
 #endif
+      // Raise the counters of the methods found hot in the profile
+      // snapshot before any of them can run.
+      if (ProfileSnapshotFile != NULL) {
+        ProfileSnapshot::prime_class(this_oop());
+      }
       this_oop->set_init_state(linked);
       if (JvmtiExport::should_post_class_prepare()) {
         Thread *thread = THREAD;
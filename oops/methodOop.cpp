@@ -1110,7 +1110,11 @@ methodHandle methodOopDesc:: clone_with_new_data(methodHandle m, u_char* new_cod
 vmSymbols::SID methodOopDesc::klass_id_for_intrinsics(klassOop holder) {
   // if loader is not the default loader (i.e., != NULL), we can't know the intrinsics
   // because we are not loading from core libraries
-  if (instanceKlass::cast(holder)->class_loader() != NULL)
+  // exception: the AES intrinsics come from lib/ext/sunjce_provider.jar
+  // which is loaded by the extension class loader, so we check for it here
+  oop loader = instanceKlass::cast(holder)->class_loader();
+  if (loader != NULL &&
+      Klass::cast(loader->klass())->name() != vmSymbols::sun_misc_Launcher_ExtClassLoader())
     return vmSymbols::NO_SID;   // regardless of name, no intrinsics here
 
   // see if the klass name is well-known:
@@ -163,10 +163,12 @@ const char* InlineTree::should_inline(ciMethod* callee_method, ciMethod* caller_
   } else {
     // Not hot.  Check for medium-sized pre-existing nmethod at cold sites.
     if (callee_method->has_compiled_code() &&
-        callee_method->instructions_size(CompLevel_full_optimization) > inline_small_code_size)
+        callee_method->instructions_size(CompLevel_full_optimization) > inline_small_code_size &&
+        !inline_within_budget(callee_method, caller_bci, profile, "InlineSmallCode"))
       return "already compiled into a medium method";
   }
-  if (size > max_inline_size) {
+  if (size > max_inline_size &&
+      !inline_within_budget(callee_method, caller_bci, profile, "MaxInlineSize")) {
     if (max_inline_size > default_max_inline_size)
       return "hot method too big";
     return "too big";
@@ -176,7 +178,7 @@ const char* InlineTree::should_inline(ciMethod* callee_method, ciMethod* caller_
 
 
 // negative filter: should send NOT be inlined?  returns NULL, ok to inline, or rejection msg
-const char* InlineTree::should_not_inline(ciMethod *callee_method, ciMethod* caller_method, WarmCallInfo* wci_result) const {
+const char* InlineTree::should_not_inline(ciMethod *callee_method, ciMethod* caller_method, int caller_bci, ciCallProfile& profile, WarmCallInfo* wci_result) const {
   // negative filter: should send NOT be inlined?  returns NULL (--> inline) or rejection msg
   if (!UseOldInlining) {
     const char* fail = NULL;
@@ -229,7 +231,8 @@ const char* InlineTree::should_not_inline(ciMethod *callee_method, ciMethod* cal
 
   // Now perform checks which are heuristic
 
-  if( callee_method->has_compiled_code() && callee_method->instructions_size(CompLevel_full_optimization) > InlineSmallCode )
+  if( callee_method->has_compiled_code() && callee_method->instructions_size(CompLevel_full_optimization) > InlineSmallCode &&
+      !inline_within_budget(callee_method, caller_bci, profile, "InlineSmallCode") )
     return "already compiled into a big method";
 
   // don't inline exception code unless the top method belongs to an
@@ -279,6 +282,63 @@ const char* InlineTree::should_not_inline(ciMethod *callee_method, ciMethod* cal
   return NULL;
 }
 
+//------------------------------inline_within_budget---------------------------
+// Rough number of ideal nodes parsed per bytecode, and of bytes of machine
+// code per ideal node, used to estimate the size of an inlined method.
+static const int inline_nodes_per_bytecode  = 6;
+static const int inline_code_bytes_per_node = 4;
+
+static int estimated_inline_nodes(ciMethod* callee_method) {
+  int nodes = callee_method->code_size() * inline_nodes_per_bytecode;
+  if (callee_method->has_compiled_code()) {
+    // The compiled code also accounts for the methods inlined into it.
+    int code_size = callee_method->instructions_size(CompLevel_full_optimization);
+    nodes = MAX2(nodes, code_size / inline_code_bytes_per_node);
+  }
+  return nodes;
+}
+
+// Cost/benefit check for a call site which one of the fixed size or depth
+// limits rejects.  With UseInliningBudget the call is inlined anyway if it
+// is frequent enough for its estimated size.  The frequency needed grows
+// as the compilation approaches InliningNodeBudget, so the last nodes of
+// the budget go to the most frequent and smallest call sites.
+bool InlineTree::inline_within_budget(ciMethod* callee_method, int caller_bci, ciCallProfile& profile, const char* limit) const {
+  if (!UseInliningBudget || !UseOldInlining || profile.count() <= 0) {
+    return false;
+  }
+  int invoke_count = method()->interpreter_invocation_count();
+  if (invoke_count <= 0) {
+    return false;
+  }
+  // Calls per invocation of the method being compiled.
+  float freq = _site_invoke_ratio * (float)method()->scale_count(profile.count()) / (float)invoke_count;
+  int nodes  = estimated_inline_nodes(callee_method);
+  int used   = C->unique();
+  int budget = InliningNodeBudget;
+
+  bool inline_it = false;
+  const char* decision = "over budget";
+  float required = 0.0F;
+  if (used + nodes < budget) {
+    required = ((float)InliningBudgetMinFrequency / 100.0F) / (1.0F - (float)(used + nodes) / (float)budget);
+    inline_it = freq >= required;
+    decision = inline_it ? "inline" : "too infrequent";
+  }
+
+  CompileLog* log = C->log();
+  if (log != NULL) {
+    log->elem("inline_budget method='%d' bci='%d' limit='%s' freq='%g' required='%g' nodes='%d' used='%d' budget='%d' decision='%s'",
+              log->identify(callee_method), caller_bci, limit, freq, required, nodes, used, budget, decision);
+  }
+  if (PrintInlining && Verbose) {
+    CompileTask::print_inline_indent(inline_level());
+    tty->print_cr("Inlining budget past %s: %s (freq=%g required=%g nodes=%d used=%d)",
+                  limit, decision, freq, required, nodes, used);
+  }
+  return inline_it;
+}
+
 //-----------------------------try_to_inline-----------------------------------
 // return NULL if ok, reason for not inlining otherwise
 // Relocated from "InliningClosure::try_to_inline"
@@ -286,7 +346,8 @@ const char* InlineTree::try_to_inline(ciMethod* callee_method, ciMethod* caller_
 
   // Old algorithm had funny accumulating BC-size counters
   if (UseOldInlining && ClipInlining
-      && (int)count_inline_bcs() >= DesiredMethodLimit) {
+      && (int)count_inline_bcs() >= DesiredMethodLimit
+      && !inline_within_budget(callee_method, caller_bci, profile, "DesiredMethodLimit")) {
     return "size > DesiredMethodLimit";
   }
 
@@ -295,7 +356,7 @@ const char* InlineTree::try_to_inline(ciMethod* callee_method, ciMethod* caller_
   if (msg != NULL)
     return msg;
 
-  msg = should_not_inline(callee_method, caller_method, wci_result);
+  msg = should_not_inline(callee_method, caller_method, caller_bci, profile, wci_result);
   if (msg != NULL)
     return msg;
 
@@ -308,7 +369,8 @@ const char* InlineTree::try_to_inline(ciMethod* callee_method, ciMethod* caller_
   if (callee_method->code_size() > MaxTrivialSize) {
 
     // don't inline into giant methods
-    if (C->unique() > (uint)NodeCountInliningCutoff) {
+    if (C->unique() > (uint)NodeCountInliningCutoff &&
+        !inline_within_budget(callee_method, caller_bci, profile, "NodeCountInliningCutoff")) {
       return "NodeCountInliningCutoff";
     }
 
@@ -328,7 +390,11 @@ const char* InlineTree::try_to_inline(ciMethod* callee_method, ciMethod* caller_
     return "not an accessor";
   }
   if (inline_level() > _max_inline_level) {
-    return "inlining too deep";
+    // The budget may at most double the inlining depth.
+    if (inline_level() > 2 * _max_inline_level ||
+        !inline_within_budget(callee_method, caller_bci, profile, "MaxInlineLevel")) {
+      return "inlining too deep";
+    }
   }
 
   // detect direct and indirect recursive inlining
@@ -352,7 +418,8 @@ const char* InlineTree::try_to_inline(ciMethod* callee_method, ciMethod* caller_
   int size = callee_method->code_size();
 
   if (UseOldInlining && ClipInlining
-      && (int)count_inline_bcs() + size >= DesiredMethodLimit) {
+      && (int)count_inline_bcs() + size >= DesiredMethodLimit
+      && !inline_within_budget(callee_method, caller_bci, profile, "DesiredMethodLimit")) {
     return "size > DesiredMethodLimit";
   }
 
@@ -286,6 +286,10 @@
   product(bool, UseSuperWord, true,                                         \
           "Transform scalar operations into superword operations")          \
                                                                             \
+  product(bool, SuperWordReductions, false,                                 \
+          "Vectorize integer sum, and, or and xor reductions carried "      \
+          "across loop iterations; min and max are not handled")            \
+                                                                            \
   develop(bool, SuperWordRTDepCheck, false,                                 \
           "Enable runtime dependency checks.")                              \
                                                                             \
@@ -325,12 +329,36 @@
   product(bool, UseOldInlining, true,                                       \
           "Enable the 1.3 inlining strategy")                               \
                                                                             \
+  product(bool, UseInliningBudget, false,                                   \
+          "Inline frequent call sites beyond the inlining size and depth "  \
+          "limits while the compilation stays within InliningNodeBudget")   \
+                                                                            \
+  product(intx, InliningNodeBudget, 30000,                                  \
+          "Number of nodes up to which UseInliningBudget may grow a "       \
+          "compilation")                                                    \
+                                                                            \
+  product(intx, InliningBudgetMinFrequency, 10,                             \
+          "Calls per 100 invocations of the compiled method needed to "     \
+          "inline on the budget when it is unused; the needed frequency "   \
+          "grows as the budget is used")                                    \
+                                                                            \
   product(bool, UseBimorphicInlining, true,                                 \
           "Profiling based inlining for two receivers")                     \
                                                                             \
   product(bool, UseOnlyInlinedBimorphic, true,                              \
           "Don't use BimorphicInlining if can't inline a second method")    \
                                                                             \
+  product(bool, UsePolymorphicInlining, false,                              \
+          "Profiling based inlining for call sites with more than two "     \
+          "receivers, guarded by a type switch over the hot receivers")     \
+                                                                            \
+  product(intx, PolymorphicInlineLimit, 4,                                  \
+          "Maximum number of receivers inlined at a polymorphic call site") \
+                                                                            \
+  product(intx, PolymorphicInlineMinReceiverPercent, 10,                    \
+          "Minimum percentage of the calls of a polymorphic call site "     \
+          "a receiver needs to be inlined")                                 \
+                                                                            \
   product(bool, InsertMemBarAfterArraycopy, true,                           \
           "Insert memory barrier after arraycopy call")                     \
                                                                             \
@@ -450,9 +478,22 @@
   notproduct(bool, PrintEliminateAllocations, false,                        \
           "Print out when allocations are eliminated")                      \
                                                                             \
+  product(bool, PartialEscapeAnalysis, false,                               \
+          "Allocate objects on the heap only at the rarely executed calls " \
+          "they escape to, so that they can be scalar replaced on the "     \
+          "other paths")                                                    \
+                                                                            \
+  product(intx, RareEscapeCallPercent, 1,                                   \
+          "Percentage of the invocations of a method below which a call "   \
+          "site is rare for PartialEscapeAnalysis")                         \
+                                                                            \
   product(intx, EliminateAllocationArraySizeLimit, 64,                      \
           "Array size (number of elements) limit for scalar replacement")   \
                                                                             \
+  product(intx, EliminateAllocationIndexedArrayLimit, 8,                    \
+          "Array size limit for scalar replacement of primitive arrays "    \
+          "accessed with non-constant indexes")                             \
+                                                                            \
   product(bool, UseOptoBiasInlining, true,                                  \
           "Generate biased locking code in C2 ideal graph")                 \
                                                                             \
@@ -24,6 +24,7 @@
 
 #include "precompiled.hpp"
 #include "opto/c2compiler.hpp"
+#include "opto/escape.hpp"
 #include "opto/runtime.hpp"
 #ifdef TARGET_ARCH_MODEL_x86_32
 # include "adfiles/ad_x86_32.hpp"
@@ -57,6 +58,9 @@ const char* C2Compiler::retry_no_subsuming_loads() {
 const char* C2Compiler::retry_no_escape_analysis() {
   return "retry without escape analysis";
 }
+const char* C2Compiler::retry_materialize_rare_escapes() {
+  return "retry with objects materialized at rare escapes";
+}
 void C2Compiler::initialize_runtime() {
 
   // Check assumptions used while running ADLC
@@ -125,9 +129,16 @@ void C2Compiler::compile_method(ciEnv* env,
   bool subsume_loads = SubsumeLoads;
   bool do_escape_analysis = DoEscapeAnalysis &&
     !env->jvmti_can_access_local_variables();
+  // Filled in by escape analysis on the first attempt.
+  RareEscapeSites rare_escapes;
   while (!env->failing()) {
+    RareEscapeSites* rare_escape_sites = NULL;
+    if (PartialEscapeAnalysis && do_escape_analysis) {
+      rare_escape_sites = &rare_escapes;
+    }
     // Attempt to compile while subsuming loads into machine instructions.
-    Compile C(env, this, target, entry_bci, subsume_loads, do_escape_analysis);
+    Compile C(env, this, target, entry_bci, subsume_loads, do_escape_analysis,
+              rare_escape_sites);
 
 
     // Check result and retry if appropriate.
@@ -142,6 +153,10 @@ void C2Compiler::compile_method(ciEnv* env,
         do_escape_analysis = false;
         continue;  // retry
       }
+      if (C.failure_reason_is(retry_materialize_rare_escapes())) {
+        assert(!rare_escapes.is_empty(), "must make progress");
+        continue;  // retry
+      }
       // Pass any other failure reason up to the ciEnv.
       // Note that serious, irreversible failures are already logged
       // on the ciEnv via env->record_method_not_compilable().
@@ -56,6 +56,7 @@ public:
   // sentinel value used to trigger backtracking in compile_method().
   static const char* retry_no_subsuming_loads();
   static const char* retry_no_escape_analysis();
+  static const char* retry_materialize_rare_escapes();
 
   // Print compilation timers and statistics
   void print_timers();
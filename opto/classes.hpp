@@ -255,6 +255,9 @@ macro(SubVI)
 macro(SubVL)
 macro(SubVF)
 macro(SubVD)
+macro(MulVC)
+macro(MulVS)
+macro(MulVI)
 macro(MulVF)
 macro(MulVD)
 macro(DivVF)
@@ -332,3 +335,8 @@ macro(ExtractI)
 macro(ExtractL)
 macro(ExtractF)
 macro(ExtractD)
+macro(Reduction)
+macro(AddReductionVI)
+macro(AndReductionVI)
+macro(OrReductionVI)
+macro(XorReductionVI)
@@ -63,6 +63,7 @@ class PhaseIterGVN;
 class PhaseRegAlloc;
 class PhaseCCP;
 class PhaseCCP_DCE;
+class RareEscapeSites;
 class RootNode;
 class relocInfo;
 class Scope;
@@ -223,6 +224,7 @@ class Compile : public Phase {
   const bool            _save_argument_registers; // save/restore arg regs for trampolines
   const bool            _subsume_loads;         // Load can be matched as part of a larger op.
   const bool            _do_escape_analysis;    // Do escape analysis.
+  RareEscapeSites*      _rare_escape_sites;     // Calls to materialize objects at for partial escape analysis, or NULL
   ciMethod*             _method;                // The method being compiled.
   int                   _entry_bci;             // entry bci for osr methods.
   const TypeFunc*       _tf;                    // My kind of signature
@@ -375,6 +377,8 @@ class Compile : public Phase {
   bool              subsume_loads() const       { return _subsume_loads; }
   // Do escape analysis.
   bool              do_escape_analysis() const  { return _do_escape_analysis; }
+  // Call sites at which objects are materialized so that they do not escape.
+  RareEscapeSites*  rare_escape_sites() const   { return _rare_escape_sites; }
   bool              save_argument_registers() const { return _save_argument_registers; }
 
 
@@ -722,7 +726,8 @@ class Compile : public Phase {
   // replacement, entry_bci indicates the bytecode for which to compile a
   // continuation.
   Compile(ciEnv* ci_env, C2Compiler* compiler, ciMethod* target,
-          int entry_bci, bool subsume_loads, bool do_escape_analysis);
+          int entry_bci, bool subsume_loads, bool do_escape_analysis,
+          RareEscapeSites* rare_escape_sites);
 
   // Second major entry point.  From the TypeFunc signature, generate code
   // to pass arguments from the Java calling convention to the C calling
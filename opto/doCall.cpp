@@ -33,6 +33,7 @@
 #include "opto/addnode.hpp"
 #include "opto/callGenerator.hpp"
 #include "opto/cfgnode.hpp"
+#include "opto/escape.hpp"
 #include "opto/mulnode.hpp"
 #include "opto/parse.hpp"
 #include "opto/rootnode.hpp"
@@ -278,6 +279,68 @@ CallGenerator* Compile::call_generator(ciMethod* call_method, int vtable_index,
           }
         }
       }
+      if (receiver_method == NULL && UsePolymorphicInlining &&
+          profile.morphism() != 1 && profile.morphism() != 2) {
+        // The site has seen more than two receivers and none of them
+        // dominates.  Build a guarded type switch over the hot receivers
+        // which can be inlined, tested in profile order.  It ends in an
+        // uncommon trap if every receiver the profile has seen is inlined,
+        // otherwise in a virtual call.
+        int max_receivers = (int)PolymorphicInlineLimit;
+        ciKlass**       receivers = NEW_RESOURCE_ARRAY(ciKlass*, max_receivers);
+        ciMethod**      methods   = NEW_RESOURCE_ARRAY(ciMethod*, max_receivers);
+        CallGenerator** hit_cgs   = NEW_RESOURCE_ARRAY(CallGenerator*, max_receivers);
+        int*            counts    = NEW_RESOURCE_ARRAY(int, max_receivers);
+        int  hits        = 0;
+        bool all_inlined = true;
+        for (int i = 0; i < max_receivers && profile.has_receiver(i); i++) {
+          CallGenerator* next_hit_cg = NULL;
+          ciMethod* next_receiver_method = NULL;
+          if (100.*profile.receiver_prob(i) >= (float)PolymorphicInlineMinReceiverPercent) {
+            next_receiver_method = call_method->resolve_invoke(jvms->method()->holder(),
+                                                               profile.receiver(i));
+          }
+          if (next_receiver_method != NULL) {
+            next_hit_cg = this->call_generator(next_receiver_method,
+                                vtable_index, !call_is_virtual, jvms,
+                                allow_inline, prof_factor);
+          }
+          if (next_hit_cg == NULL || !next_hit_cg->is_inline()) {
+            // A type check is only worth it if it leads to inlined code.
+            all_inlined = false;
+            continue;
+          }
+          receivers[hits] = profile.receiver(i);
+          methods[hits]   = next_receiver_method;
+          hit_cgs[hits]   = next_hit_cg;
+          counts[hits]    = profile.receiver_count(i);
+          hits++;
+        }
+        if (hits > 0) {
+          CallGenerator* miss_cg;
+          if (all_inlined && profile.morphism() == hits &&
+              !too_many_traps(jvms->method(), jvms->bci(), Deoptimization::Reason_bimorphic)) {
+            miss_cg = CallGenerator::for_uncommon_trap(call_method, Deoptimization::Reason_bimorphic,
+                        Deoptimization::Action_maybe_recompile);
+          } else {
+            miss_cg = CallGenerator::for_virtual_call(call_method, vtable_index);
+          }
+          // Each type check is only reached by the calls which missed the
+          // checks before it, so its hit probability is relative to those.
+          int* reached = NEW_RESOURCE_ARRAY(int, hits);
+          int reach = site_count;
+          for (int i = 0; i < hits; i++) {
+            reached[i] = reach;
+            reach -= counts[i];
+          }
+          for (int i = hits - 1; i >= 0 && miss_cg != NULL; i--) {
+            float hit_prob = (reached[i] > counts[i]) ? (float)counts[i] / (float)reached[i] : PROB_MAX;
+            NOT_PRODUCT(trace_type_profile(jvms->method(), jvms->depth() - 1, jvms->bci(), methods[i], receivers[i], site_count, counts[i]));
+            miss_cg = CallGenerator::for_predicted_call(receivers[i], miss_cg, hit_cgs[i], hit_prob);
+          }
+          if (miss_cg != NULL)  return miss_cg;
+        }
+      }
     }
   }
 
@@ -371,6 +434,70 @@ bool Parse::can_not_compile_call_site(ciMethod *dest_method, ciInstanceKlass* kl
 }
 
 
+//-------------------------materialize_rare_escapes----------------------------
+// Allocate a heap copy of each object passed in the argument slots set in
+// args, and use the copy instead of the object from here on along this
+// path: for the call itself and in the locals and stack of this frame.
+// The object then no longer escapes at this call.
+void Parse::materialize_rare_escapes(juint args, int nargs) {
+  // Reexecute the invoke if the allocation of a copy deoptimizes.
+  PreserveReexecuteState preexecs(this);
+  jvms()->set_should_reexecute(true);
+
+  for (int k = 0; k < nargs && k < BitsPerInt; k++) {
+    if ((args & nth_bit(k)) == 0)  continue;
+    Node* obj = stack(sp() - nargs + k);
+    const TypeInstPtr* tinst = _gvn.type(obj)->isa_instptr();
+    if (AllocateNode::Ideal_allocation(obj, &_gvn) == NULL ||
+        tinst == NULL || !tinst->klass_is_exact()) {
+      continue;
+    }
+    ciInstanceKlass* ik = tinst->klass()->as_instance_klass();
+    if (ik->has_finalizer())  continue;
+
+    // Only the locals and stack of this frame are switched to the copy, so
+    // give up if the caller frames or the monitors refer to the object.
+    Node* orig = obj->uncast();
+    bool replaceable = true;
+    for (uint i = TypeFunc::Parms; i < map()->req() && replaceable; i++) {
+      Node* n = map()->in(i);
+      if ((i < jvms()->locoff() || i >= jvms()->monoff()) &&
+          n != NULL && n->uncast() == orig) {
+        replaceable = false;
+      }
+    }
+    if (!replaceable)  continue;
+
+    Node* copy = new_instance(makecon(TypeKlassPtr::make(ik)));
+    for (int f = 0; f < ik->nof_nonstatic_fields(); f++) {
+      ciField* field = ik->nonstatic_field_at(f);
+      int offset = field->offset_in_bytes();
+      const TypePtr* adr_type = C->alias_type(field)->adr_type();
+      BasicType bt = field->layout_type();
+      bool is_vol = field->is_volatile();
+      const Type* type = (bt == T_OBJECT) ? (const Type*)TypeInstPtr::BOTTOM
+                                          : Type::get_const_basic_type(bt);
+      Node* val = make_load(NULL, basic_plus_adr(obj, obj, offset),
+                            type, bt, adr_type, is_vol);
+      Node* adr = basic_plus_adr(copy, copy, offset);
+      if (bt == T_OBJECT) {
+        store_oop_to_object(control(), copy, adr, adr_type, val,
+                            TypeInstPtr::BOTTOM, bt);
+      } else {
+        store_to_memory(control(), adr, val, bt, adr_type, is_vol);
+      }
+    }
+
+    for (uint i = jvms()->locoff(); i < jvms()->monoff(); i++) {
+      Node* n = map()->in(i);
+      if (n != NULL && n->uncast() == orig) {
+        map()->set_req(i, copy);
+      }
+    }
+  }
+}
+
+
 //------------------------------do_call----------------------------------------
 // Handle your basic call.  Inline if we can & want to, else just setup call.
 void Parse::do_call() {
@@ -406,6 +533,18 @@ void Parse::do_call() {
 #endif
     return;
   }
+
+  // Escape analysis found that allocated objects escape to this call in an
+  // earlier attempt to compile the method and that the call is rarely
+  // executed.  Pass heap copies of the objects to the call so that the
+  // objects can be scalar replaced on the other paths.
+  RareEscapeSites* rare_escapes = C->rare_escape_sites();
+  if (rare_escapes != NULL && !is_invokedynamic) {
+    juint rare_escape_args = rare_escapes->materialized_args(jvms());
+    if (rare_escape_args != 0) {
+      materialize_rare_escapes(rare_escape_args, nargs);
+    }
+  }
   assert(holder_klass->is_loaded(), "");
   assert((dest_method->is_static() || is_invokedynamic) == !has_receiver , "must match bc");
   // Note: this takes into account invokeinterface of methods declared in java/lang/Object,
@@ -24,15 +24,20 @@
 
 #include "precompiled.hpp"
 #include "ci/bcEscapeAnalyzer.hpp"
+#include "ci/ciCallProfile.hpp"
+#include "ci/ciMethod.hpp"
 #include "libadt/vectset.hpp"
 #include "memory/allocation.hpp"
 #include "opto/c2compiler.hpp"
 #include "opto/callnode.hpp"
 #include "opto/cfgnode.hpp"
 #include "opto/compile.hpp"
+#include "opto/connode.hpp"
 #include "opto/escape.hpp"
+#include "opto/memnode.hpp"
 #include "opto/phaseX.hpp"
 #include "opto/rootnode.hpp"
+#include "opto/subnode.hpp"
 
 void PointsToNode::add_edge(uint targIdx, PointsToNode::EdgeType et) {
   uint v = (targIdx << EdgeShift) + ((uint) et);
@@ -98,6 +103,8 @@ ConnectionGraph::ConnectionGraph(Compile * C, PhaseIterGVN *igvn) :
   pt_worklist(C->comp_arena(), 4, 0, 0),
   _collecting(true),
   _progress(false),
+  _expand_arrays(false),
+  _indexed_arrays(C->comp_arena(), 4, 0, 0),
   _compile(C),
   _igvn(igvn),
   _node_map(C->comp_arena()) {
@@ -1483,6 +1490,282 @@ void ConnectionGraph::split_unique_types(GrowableArray<Node *>  &alloc_worklist)
 #endif
 }
 
+// Split the field loads from a Phi which merges newly allocated objects
+// into a Phi of loads from each object.  This is only done if all the uses
+// of the Phi are such loads, so that the Phi goes away and the objects are
+// no longer merged, and if the loads see the memory state merged at the
+// Phi's region, so that each load can be moved to its path.
+static bool split_merged_field_loads(PhiNode* phi, PhaseIterGVN* igvn) {
+  Node* region = phi->in(0);
+  if (region == NULL || !region->is_Region() || region->is_Loop()) {
+    return false;
+  }
+  for (uint i = 1; i < phi->req(); i++) {
+    Node* in = phi->in(i);
+    Node* rc = region->in(i);
+    if (in == NULL || rc == NULL || igvn->type(rc) == Type::TOP ||
+        !in->is_CheckCastPP() ||
+        AllocateNode::Ideal_allocation(in, igvn) == NULL) {
+      return false;
+    }
+  }
+
+  GrowableArray<Node*> loads;
+  for (DUIterator_Fast imax, i = phi->fast_outs(imax); i < imax; i++) {
+    Node* addp = phi->fast_out(i);
+    if (!addp->is_AddP() ||
+        addp->in(AddPNode::Base) != phi ||
+        addp->in(AddPNode::Address) != phi ||
+        !addp->in(AddPNode::Offset)->is_Con()) {
+      return false;
+    }
+    for (DUIterator_Fast jmax, j = addp->fast_outs(jmax); j < jmax; j++) {
+      Node* load = addp->fast_out(j);
+      if (!load->is_Load()) {
+        return false;
+      }
+      Node* mem = load->in(MemNode::Memory);
+      if (!mem->is_Phi() || mem->in(0) != region) {
+        return false;
+      }
+      for (uint m = 1; m < mem->req(); m++) {
+        if (mem->in(m) == NULL) {
+          return false;  // Wait stable graph
+        }
+      }
+      loads.append(load);
+    }
+  }
+  if (loads.length() == 0) {
+    return false;
+  }
+
+  for (int k = 0; k < loads.length(); k++) {
+    Node* load = loads.at(k);
+    Node* adr = load->in(MemNode::Address);
+    Node* mem = load->in(MemNode::Memory);
+    PhiNode* value = PhiNode::make_blank(region, load);
+    for (uint i = 1; i < region->req(); i++) {
+      // The object is not null, so the load can be done on the path.
+      Node* obj = phi->in(i);
+      Node* obj_adr = adr->clone();
+      obj_adr->set_req(AddPNode::Base, obj);
+      obj_adr->set_req(AddPNode::Address, obj);
+      igvn->register_new_node_with_optimizer(obj_adr);
+      Node* obj_load = load->clone();
+      obj_load->set_req(MemNode::Control, region->in(i));
+      obj_load->set_req(MemNode::Memory, mem->in(i));
+      obj_load->set_req(MemNode::Address, obj_adr);
+      igvn->register_new_node_with_optimizer(obj_load);
+      value->init_req(i, obj_load);
+    }
+    igvn->register_new_node_with_optimizer(value);
+    igvn->replace_node(load, value);
+  }
+  return true;
+}
+
+bool ConnectionGraph::split_allocation_merges(Compile *C, PhaseIterGVN *igvn) {
+  // Collect the Phis first since splitting adds uses to the allocations.
+  GrowableArray<PhiNode*> phis;
+  for (int i = 0; i < C->macro_count(); i++) {
+    Node* n = C->macro_node(i);
+    if (!n->is_Allocate()) {
+      continue;
+    }
+    Node* res = n->as_Allocate()->result_cast();
+    if (res == NULL) {
+      continue;
+    }
+    for (DUIterator_Fast jmax, j = res->fast_outs(jmax); j < jmax; j++) {
+      Node* use = res->fast_out(j);
+      if (use->is_Phi()) {
+        phis.append_if_missing(use->as_Phi());
+      }
+    }
+  }
+  bool progress = false;
+  for (int i = 0; i < phis.length(); i++) {
+    if (split_merged_field_loads(phis.at(i), igvn)) {
+      progress = true;
+    }
+  }
+  return progress;
+}
+
+// The offset from the array base of an address computed by AddPs on the
+// array, or NULL if the address has another shape or may not be the
+// address of an element: the constant part of the offset must be the
+// header plus a multiple of the element size, and every other part a
+// multiple of the element size.
+static Node* array_offset(Node* adr, Node* ary, int header, int shift, PhaseIterGVN* igvn) {
+  Compile* C = igvn->C;
+  Node* offset = NULL;
+  intptr_t con = 0;
+  while (adr != ary) {
+    if (!adr->is_AddP() || adr->in(AddPNode::Base) != ary) {
+      return NULL;
+    }
+    Node* off = adr->in(AddPNode::Offset);
+    intptr_t off_con = igvn->find_intptr_t_con(off, Type::OffsetBot);
+    if (off_con != Type::OffsetBot) {
+      con += off_con;
+    } else if (shift > 0 &&
+               (off->Opcode() != Op_LShiftX || off->in(2)->find_int_con(-1) < shift)) {
+      return NULL;
+    }
+    offset = (offset == NULL) ? off : igvn->transform(new (C, 3) AddXNode(offset, off));
+    adr = adr->in(AddPNode::Address);
+  }
+  if (con < header || ((con - header) & right_n_bits(shift)) != 0) {
+    return NULL;
+  }
+  return offset;
+}
+
+// The memory type of the loads and stores of the elements of an array of
+// elem_bt.  Booleans are accessed as bytes, and shorts are stored as chars.
+static BasicType element_memory_type(BasicType elem_bt, bool is_store) {
+  if (elem_bt == T_BOOLEAN) {
+    return T_BYTE;
+  }
+  if (elem_bt == T_SHORT && is_store) {
+    return T_CHAR;
+  }
+  return elem_bt;
+}
+
+// The small primitive arrays the indexed accesses of which may be expanded.
+static bool is_expandable_array(Node* n, PhaseTransform* phase) {
+  if (!n->is_AllocateArray()) {
+    return false;
+  }
+  AllocateNode* alloc = n->as_Allocate();
+  Node* res = alloc->result_cast();
+  int length = alloc->in(AllocateNode::ALength)->find_int_con(-1);
+  if (res == NULL || !res->is_CheckCastPP() ||
+      length <= 0 || length > EliminateAllocationIndexedArrayLimit) {
+    return false;
+  }
+  const TypeAryPtr* ary_type = phase->type(res)->isa_aryptr();
+  return ary_type != NULL && is_java_primitive(ary_type->elem()->array_element_basic_type());
+}
+
+// Expand the loads and stores with non-constant indexes of a small
+// primitive array into loads and stores of each element:
+//
+//   a[i]      becomes  i == 0 ? a[0] : (i == 1 ? a[1] : ...)
+//   a[i] = v  becomes  a[0] = (i == 0 ? v : a[0]); a[1] = (i == 1 ? v : a[1]); ...
+//
+// The index is known to be in range since the accesses are range checked.
+// Nothing is expanded if an access, such as an Unsafe one, may not be
+// exactly one element wide and aligned.
+static bool expand_indexed_accesses(AllocateNode* alloc, PhaseIterGVN* igvn) {
+  Compile* C = igvn->C;
+  if (!is_expandable_array(alloc, igvn)) {
+    return false;
+  }
+  Node* res = alloc->result_cast();
+  int length = alloc->in(AllocateNode::ALength)->find_int_con(-1);
+  BasicType elem_bt = igvn->type(res)->is_aryptr()->elem()->array_element_basic_type();
+  int header = arrayOopDesc::base_offset_in_bytes(elem_bt);
+  int shift  = exact_log2(type2aelembytes(elem_bt));
+
+  // Find the accesses to an unknown element.
+  GrowableArray<Node*> accesses;
+  GrowableArray<Node*> offsets;
+  GrowableArray<Node*> worklist;
+  worklist.append(res);
+  while (worklist.length() > 0) {
+    Node* adr = worklist.pop();
+    for (DUIterator_Fast imax, i = adr->fast_outs(imax); i < imax; i++) {
+      Node* use = adr->fast_out(i);
+      if (use->is_AddP() && use->in(AddPNode::Address) == adr) {
+        if (use->in(AddPNode::Base) != res) {
+          return false;
+        }
+        worklist.append(use);
+      } else if (adr != res &&
+                 igvn->type(adr)->is_ptr()->offset() == Type::OffsetBot) {
+        if (!(use->is_Load() || use->is_Store()) ||
+            use->in(MemNode::Address) != adr ||
+            use->as_Mem()->memory_type() != element_memory_type(elem_bt, use->is_Store())) {
+          return false;  // Not an access the elements of which are known
+        }
+        Node* offset = array_offset(adr, res, header, shift, igvn);
+        if (offset == NULL) {
+          return false;
+        }
+        accesses.append(use);
+        offsets.append(offset);
+      }
+    }
+  }
+  if (accesses.length() == 0) {
+    return false;
+  }
+
+  const Type* value_type = Type::get_const_basic_type(is_subword_type(elem_bt) ? T_INT : elem_bt);
+  for (int k = 0; k < accesses.length(); k++) {
+    Node* access = accesses.at(k);
+    Node* offset = offsets.at(k);
+    Node* result = NULL;
+    if (access->is_Load()) {
+      for (int e = length - 1; e >= 0; e--) {
+        intptr_t elem_offset = header + ((intptr_t)e << shift);
+        Node* elem_adr = igvn->transform(new (C, 4) AddPNode(res, res, igvn->MakeConX(elem_offset)));
+        Node* elem_load = access->clone();
+        elem_load->set_req(MemNode::Address, elem_adr);
+        elem_load = igvn->transform(elem_load);
+        if (result == NULL) {
+          result = elem_load;
+        } else {
+          Node* cmp = igvn->transform(new (C, 3) CmpXNode(offset, igvn->MakeConX(elem_offset)));
+          Node* bol = igvn->transform(new (C, 2) BoolNode(cmp, BoolTest::eq));
+          result = igvn->transform(CMoveNode::make(C, NULL, bol, result, elem_load, value_type));
+        }
+      }
+    } else {
+      Node* ctl = access->in(MemNode::Control);
+      Node* val = access->in(MemNode::ValueIn);
+      result = access->in(MemNode::Memory);
+      for (int e = 0; e < length; e++) {
+        intptr_t elem_offset = header + ((intptr_t)e << shift);
+        Node* elem_adr = igvn->transform(new (C, 4) AddPNode(res, res, igvn->MakeConX(elem_offset)));
+        const TypePtr* elem_adr_type = igvn->type(elem_adr)->is_ptr();
+        Node* old_val = igvn->transform(LoadNode::make(*igvn, ctl, result, elem_adr, elem_adr_type,
+                                                       Type::get_const_basic_type(elem_bt), elem_bt));
+        Node* cmp = igvn->transform(new (C, 3) CmpXNode(offset, igvn->MakeConX(elem_offset)));
+        Node* bol = igvn->transform(new (C, 2) BoolNode(cmp, BoolTest::eq));
+        Node* new_val = igvn->transform(CMoveNode::make(C, NULL, bol, old_val, val, value_type));
+        Node* elem_store = access->clone();
+        elem_store->set_req(MemNode::Memory, result);
+        elem_store->set_req(MemNode::Address, elem_adr);
+        elem_store->set_req(MemNode::ValueIn, new_val);
+        result = igvn->transform(elem_store);
+      }
+    }
+    igvn->replace_node(access, result);
+  }
+  return true;
+}
+
+// Expand the indexed accesses of the arrays which were analyzed as if
+// they were expanded, and which are then scalar replaceable: the expansion
+// makes every indexed access slower and is only worth it if the array is
+// then eliminated.
+bool ConnectionGraph::expand_indexed_array_accesses() {
+  bool progress = false;
+  for (int i = 0; i < _indexed_arrays.length(); i++) {
+    PointsToNode* ptn = ptnode_adr(_indexed_arrays.at(i));
+    if (ptn->escape_state() == PointsToNode::NoEscape && ptn->_scalar_replaceable &&
+        expand_indexed_accesses(ptn->_node->as_Allocate(), _igvn)) {
+      progress = true;
+    }
+  }
+  return progress;
+}
+
 bool ConnectionGraph::has_candidates(Compile *C) {
   // EA brings benefits only when the code has allocations and/or locks which
   // are represented by ideal Macro nodes.
@@ -1501,6 +1784,15 @@ bool ConnectionGraph::has_candidates(Compile *C) {
 }
 
 void ConnectionGraph::do_analysis(Compile *C, PhaseIterGVN *igvn) {
+  if (EliminateAllocations && C->AliasLevel() >= 3) {
+    // Remove the merges which would keep allocations from being scalar
+    // replaced.
+    if (split_allocation_merges(C, igvn)) {
+      igvn->optimize();
+      if (C->failing())  return;
+    }
+  }
+
   // Add ConP#NULL and ConN#NULL nodes before ConnectionGraph construction
   // to create space for them in ConnectionGraph::_nodes[].
   Node* oop_null = igvn->zerocon(T_OBJECT);
@@ -1508,7 +1800,17 @@ void ConnectionGraph::do_analysis(Compile *C, PhaseIterGVN *igvn) {
 
   ConnectionGraph* congraph = new(C->comp_arena()) ConnectionGraph(C, igvn);
   // Perform escape analysis
-  if (congraph->compute_escape()) {
+  bool has_non_escaping_obj = congraph->compute_escape(true);
+  if (congraph->_indexed_arrays.length() > 0) {
+    // The indexed accesses of non-escaping arrays were expanded, or the
+    // arrays were wrongly analyzed as if they were: analyze the graph
+    // again.
+    igvn->optimize();
+    if (C->failing())  return;
+    congraph = new(C->comp_arena()) ConnectionGraph(C, igvn);
+    has_non_escaping_obj = congraph->compute_escape(false);
+  }
+  if (has_non_escaping_obj) {
     // There are non escaping objects.
     C->set_congraph(congraph);
   }
@@ -1520,8 +1822,9 @@ void ConnectionGraph::do_analysis(Compile *C, PhaseIterGVN *igvn) {
     igvn->hash_delete(noop_null);
 }
 
-bool ConnectionGraph::compute_escape() {
+bool ConnectionGraph::compute_escape(bool expand_arrays) {
   Compile* C = _compile;
+  _expand_arrays = expand_arrays && C->AliasLevel() >= 3 && EliminateAllocations;
 
   // 1. Populate Connection Graph (CG) with Ideal nodes.
 
@@ -1744,6 +2047,26 @@ bool ConnectionGraph::compute_escape() {
     }
   }
 
+  if (_indexed_arrays.length() > 0) {
+    // Some arrays were analyzed as if their indexed accesses were
+    // expanded.  The caller analyzes the graph again, once the accesses
+    // of the arrays which are scalar replaceable are expanded, before
+    // anything is done with the escape states.
+    _collecting = false;
+    expand_indexed_array_accesses();
+    return false;
+  }
+
+  RareEscapeSites* rare_escapes = C->rare_escape_sites();
+  if (rare_escapes != NULL && rare_escapes->is_empty() &&
+      record_rare_escapes(rare_escapes)) {
+    // Recompile with the objects materialized at the rare escapes so
+    // that they do not escape on the other paths.
+    C->record_failure(C2Compiler::retry_materialize_rare_escapes());
+    _collecting = false;
+    return false;
+  }
+
   _collecting = false;
   assert(C->unique() == nodes_size(), "there should be no new ideal nodes during ConnectionGraph build");
 
@@ -1801,6 +2124,137 @@ bool ConnectionGraph::compute_escape() {
   return has_non_escaping_obj;
 }
 
+// A call site is rare if it has been executed for less than
+// RareEscapeCallPercent of the invocations of its method.
+static bool is_rare_call_site(ciMethod* method, int bci) {
+  ciCallProfile profile = method->call_profile_at_bci(bci);
+  int invocations = method->interpreter_invocation_count();
+  if (profile.count() < 0 || invocations <= 0) {
+    return false;  // No mature profile
+  }
+  return (jlong)profile.count() * 100 < (jlong)invocations * RareEscapeCallPercent;
+}
+
+// An escaping allocation can be materialized at the rare calls it is
+// passed to if these are its only escapes: its other uses only access its
+// fields, compare it or describe it in debug info.  It must not be stored,
+// merged, returned or locked, since the parser then could not replace all
+// the references to it by the copy on the rare paths.
+bool ConnectionGraph::is_materializable(AllocateNode* alloc,
+                                        GrowableArray<CallJavaNode*>* rare_calls) {
+  Node* res = alloc->result_cast();
+  if (res == NULL || alloc->is_AllocateArray()) {
+    return false;
+  }
+  const TypeInstPtr* tinst = _igvn->type(res)->isa_instptr();
+  if (tinst == NULL || !tinst->klass_is_exact() ||
+      tinst->klass()->as_instance_klass()->has_finalizer()) {
+    return false;
+  }
+  ResourceMark rm;
+  Unique_Node_List worklist;
+  worklist.push(res);
+  for (uint next = 0; next < worklist.size(); next++) {
+    Node* n = worklist.at(next);
+    for (DUIterator_Fast imax, i = n->fast_outs(imax); i < imax; i++) {
+      Node* use = n->fast_out(i);
+      if (use->is_ConstraintCast() || use->Opcode() == Op_CheckCastPP ||
+          use->Opcode() == Op_EncodeP) {
+        worklist.push(use);
+      } else if (use->is_AddP()) {
+        // Only loads from and stores into the fields of the object.
+        for (DUIterator_Fast jmax, j = use->fast_outs(jmax); j < jmax; j++) {
+          Node* mem = use->fast_out(j);
+          if (!mem->is_Mem() || mem->in(MemNode::Address) != use ||
+              (mem->is_Store() && mem->in(MemNode::ValueIn)->uncast() == res->uncast())) {
+            return false;
+          }
+        }
+      } else if (use->is_CallJava() &&
+                 rare_calls->contains(use->as_CallJava())) {
+        // A rare escape, or debug info of one.
+      } else if (use->is_SafePoint()) {
+        SafePointNode* sfpt = use->as_SafePoint();
+        JVMState* jvms = sfpt->jvms();
+        if (jvms == NULL) {
+          return false;
+        }
+        for (uint k = 0; k < sfpt->req(); k++) {
+          if (sfpt->in(k) != n) {
+            continue;
+          }
+          if (k < jvms->debug_start()) {
+            return false;  // An argument
+          }
+          for (JVMState* j = jvms; j != NULL; j = j->caller()) {
+            if (k >= j->monoff() && k < j->endoff()) {
+              return false;  // A locked object
+            }
+          }
+        }
+      } else if (!use->is_Cmp()) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Find the Java calls which are rarely executed and at which allocated
+// objects, which escape nowhere else, can be materialized, and record
+// their call sites with the argument slots of the objects.
+bool ConnectionGraph::record_rare_escapes(RareEscapeSites* sites) {
+  GrowableArray<CallJavaNode*> rare_calls;
+  for (uint ni = 0; ni < nodes_size(); ni++) {
+    Node* n = ptnode_adr(ni)->_node;
+    if (n == NULL || !n->is_CallJava()) {
+      continue;
+    }
+    CallJavaNode* call = n->as_CallJava();
+    JVMState* jvms = call->jvms();
+    if (call->method() == NULL || jvms == NULL) {
+      continue;  // A runtime call, such as an uncommon trap
+    }
+    if (jvms->method()->java_code_at_bci(jvms->bci()) == Bytecodes::_invokedynamic) {
+      continue;  // The parser does not materialize objects at these
+    }
+    if (is_rare_call_site(jvms->method(), jvms->bci())) {
+      rare_calls.append(call);
+    }
+  }
+
+  bool found = false;
+  for (int ci = 0; ci < rare_calls.length(); ci++) {
+    CallJavaNode* call = rare_calls.at(ci);
+    JVMState* jvms = call->jvms();
+    juint args = 0;
+    const TypeTuple* d = call->tf()->domain();
+    for (uint i = TypeFunc::Parms; i < d->cnt() && (int)(i - TypeFunc::Parms) < BitsPerInt; i++) {
+      if (d->field_at(i)->isa_oopptr() == NULL) {
+        continue;
+      }
+      AllocateNode* alloc = AllocateNode::Ideal_allocation(call->in(i), _igvn);
+      if (alloc != NULL &&
+          ptnode_adr(alloc->_idx)->escape_state() != PointsToNode::NoEscape &&
+          is_materializable(alloc, &rare_calls)) {
+        args |= (juint)nth_bit(i - TypeFunc::Parms);
+      }
+    }
+    if (args != 0) {
+#ifndef PRODUCT
+      if (PrintEscapeAnalysis) {
+        tty->print("=== Rare escape at bci %d of ", jvms->bci());
+        jvms->method()->print_short_name();
+        tty->print_cr(" ===");
+      }
+#endif
+      sites->append(jvms, args);
+      found = true;
+    }
+  }
+  return found;
+}
+
 // Adjust escape state after Connection Graph is built.
 void ConnectionGraph::adjust_escape_state(int nidx, PhaseTransform* phase) {
   PointsToNode* ptn = ptnode_adr(nidx);
@@ -1926,6 +2380,15 @@ void ConnectionGraph::adjust_escape_state(int nidx, PhaseTransform* phase) {
       break;
     }
   }
+  // The indexed accesses of a small primitive array may be expanded into
+  // accesses of each element: analyze the array as if they were.
+  //
+  if (_expand_arrays && ptset_size == 1 && !has_LoadStore &&
+      offset == Type::OffsetBot &&
+      is_expandable_array(ptnode_adr(ptset->getelem())->_node, phase)) {
+    _indexed_arrays.append_if_missing(ptset->getelem());
+    return;
+  }
   // An object is not scalar replaceable if the address points
   // to unknown field (unknown element for arrays, offset is OffsetBot).
   //
@@ -26,6 +26,7 @@
 #define SHARE_VM_OPTO_ESCAPE_HPP
 
 #include "opto/addnode.hpp"
+#include "opto/callnode.hpp"
 #include "opto/node.hpp"
 #include "utilities/growableArray.hpp"
 
@@ -108,8 +109,29 @@
 // is marked GlobalEscape.  Finally, for any node marked ArgEscape, anything
 // it could point to is marked ArgEscape.
 //
+// The analysis is flow-insensitive: an object which escapes on any path
+// escapes on all of them.  With PartialEscapeAnalysis, the calls which are
+// rarely executed according to the profile and which are the only places
+// an allocated object escapes to are recorded in a RareEscapeSites, and
+// the method is compiled again.  The second time, the parser materializes
+// the object at these calls: it allocates a copy on the heap, passes the
+// copy to the call and uses it instead of the object from then on along
+// that path.  The object itself no longer escapes, so it can be scalar
+// replaced and its locks eliminated on the other paths, and only the rare
+// paths pay for the heap allocation.
+//
+// Before the graph is built, two kinds of uses which would make an
+// allocation not scalar replaceable are rewritten:
+//
+//   - Field loads through a Phi which merges several allocations are
+//     split into a Phi of loads from each allocation.
+//   - Accesses to a small primitive array with a non-constant index are
+//     expanded into accesses to each element with a constant index,
+//     selected with conditional moves.
+//
 
 class  Compile;
+class  ciMethod;
 class  Node;
 class  CallNode;
 class  PhiNode;
@@ -118,6 +140,61 @@ class  Type;
 class  TypePtr;
 class  VectorSet;
 
+// The call sites at which objects are materialized when a method is
+// compiled again after escape analysis found rare escapes, with the
+// argument slots of the objects as a bit mask.  A site is identified by
+// its whole inlining context, so that only the copy of an inlined method
+// whose call was found rare materializes objects.  The sites outlive the
+// resource marks of the compilation attempts, so they are kept in the
+// C heap.
+class RareEscapeSites : public StackObj {
+ private:
+  // The (method, bci) pairs of the JVMStates of all the sites, innermost
+  // first; the pairs of site i start at _starts.at(i).
+  GrowableArray<ciMethod*> _methods;
+  GrowableArray<int>       _bcis;
+  GrowableArray<int>       _starts;
+  GrowableArray<juint>     _args;
+
+  bool matches(int i, JVMState* jvms) const {
+    int end = (i + 1 < _starts.length()) ? _starts.at(i + 1) : _bcis.length();
+    int k = _starts.at(i);
+    for (; jvms != NULL && k < end; jvms = jvms->caller(), k++) {
+      if (_methods.at(k) != jvms->method() || _bcis.at(k) != jvms->bci()) {
+        return false;
+      }
+    }
+    return jvms == NULL && k == end;
+  }
+
+ public:
+  RareEscapeSites() : _methods(8, true), _bcis(8, true), _starts(4, true),
+                      _args(4, true) { }
+
+  bool is_empty() const { return _starts.is_empty(); }
+  int  length() const   { return _starts.length(); }
+
+  void append(JVMState* jvms, juint args) {
+    _starts.append(_bcis.length());
+    _args.append(args);
+    for (; jvms != NULL; jvms = jvms->caller()) {
+      _methods.append(jvms->method());
+      _bcis.append(jvms->bci());
+    }
+  }
+
+  // The argument slots, relative to TypeFunc::Parms, of the objects to
+  // materialize at the call of the given JVMState, or 0.
+  juint materialized_args(JVMState* jvms) const {
+    for (int i = 0; i < _starts.length(); i++) {
+      if (matches(i, jvms)) {
+        return _args.at(i);
+      }
+    }
+    return 0;
+  }
+};
+
 class PointsToNode {
 friend class ConnectionGraph;
 public:
@@ -229,6 +306,13 @@ private:
   bool                    _progress;   // Indicates whether new Graph's edges
                                        // were created.
 
+  bool                    _expand_arrays; // Indicates whether the indexed
+                                       // accesses of small primitive arrays
+                                       // are analyzed as if they were expanded.
+
+  GrowableArray<int>     _indexed_arrays; // The arrays analyzed as if their
+                                       // indexed accesses were expanded.
+
   uint                _phantom_object; // Index of globally escaping object
                                        // that pointer values loaded from
                                        // a field which has not been set
@@ -342,8 +426,21 @@ private:
   // Adjust escape state after Connection Graph is built.
   void adjust_escape_state(int nidx, PhaseTransform* phase);
 
-  // Compute the escape information
-  bool compute_escape();
+  // Record the rarely executed calls at which allocated objects, which
+  // escape nowhere else, can be materialized.
+  bool record_rare_escapes(RareEscapeSites* sites);
+  bool is_materializable(AllocateNode* alloc,
+                         GrowableArray<CallJavaNode*>* rare_calls);
+
+  // Compute the escape information.  If expand_arrays, the indexed
+  // accesses of small scalar replaceable arrays may be expanded instead,
+  // and the graph has to be analyzed again.
+  bool compute_escape(bool expand_arrays);
+
+  // Rewrite the uses of allocations which prevent scalar replacement.
+  // Return true if the graph was changed.
+  static bool split_allocation_merges(Compile *C, PhaseIterGVN *igvn);
+  bool expand_indexed_array_accesses();
 
 public:
   ConnectionGraph(Compile *C, PhaseIterGVN *igvn);
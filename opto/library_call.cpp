@@ -246,6 +246,12 @@ class LibraryCallKit : public GraphKit {
   bool inline_reverseBytes(vmIntrinsics::ID id);
 
   bool inline_reference_get();
+  bool inline_aescrypt_Block(vmIntrinsics::ID id);
+  bool inline_cipherBlockChaining_AESCrypt(vmIntrinsics::ID id);
+  Node* load_field_from_object(Node* fromObj, const char* fieldName, const char* fieldTypeString);
+  Node* get_key_start_from_aescrypt_object(Node* aescrypt_object);
+  bool inline_updateCRC32();
+  bool inline_updateBytesCRC32();
 };
 
 
@@ -350,6 +356,18 @@ CallGenerator* Compile::make_vm_intrinsic(ciMethod* m, bool is_virtual) {
     if (!UseG1GC) return NULL;
     break;
 
+  case vmIntrinsics::_aescrypt_encryptBlock:
+  case vmIntrinsics::_aescrypt_decryptBlock:
+  case vmIntrinsics::_cipherBlockChaining_encryptAESCrypt:
+  case vmIntrinsics::_cipherBlockChaining_decryptAESCrypt:
+    if (!UseAESIntrinsics) return NULL;
+    break;
+
+  case vmIntrinsics::_updateCRC32:
+  case vmIntrinsics::_updateBytesCRC32:
+    if (!UseCRC32Intrinsics) return NULL;
+    break;
+
  default:
     assert(id <= vmIntrinsics::LAST_COMPILER_INLINE, "caller responsibility");
     assert(id != vmIntrinsics::_Object_init && id != vmIntrinsics::_invoke, "enum out of order?");
@@ -692,6 +710,19 @@ bool LibraryCallKit::try_to_inline() {
   case vmIntrinsics::_Reference_get:
     return inline_reference_get();
 
+  case vmIntrinsics::_aescrypt_encryptBlock:
+  case vmIntrinsics::_aescrypt_decryptBlock:
+    return inline_aescrypt_Block(intrinsic_id());
+
+  case vmIntrinsics::_cipherBlockChaining_encryptAESCrypt:
+  case vmIntrinsics::_cipherBlockChaining_decryptAESCrypt:
+    return inline_cipherBlockChaining_AESCrypt(intrinsic_id());
+
+  case vmIntrinsics::_updateCRC32:
+    return inline_updateCRC32();
+  case vmIntrinsics::_updateBytesCRC32:
+    return inline_updateBytesCRC32();
+
   default:
     // If you get here, it may be that someone has added a new intrinsic
     // to the list in vmSymbols.hpp without implementing it here.
@@ -5423,3 +5454,270 @@ bool LibraryCallKit::inline_reference_get() {
   return true;
 }
 
+
+
+//----------------------------load_field_from_object--------------------------
+// Load the instance field fieldName of fromObj, whose static type must be
+// a loaded instance klass declaring the field.  Returns NULL if the field
+// does not exist in the loaded class.
+Node* LibraryCallKit::load_field_from_object(Node* fromObj, const char* fieldName, const char* fieldTypeString) {
+  const TypeInstPtr* tinst = _gvn.type(fromObj)->isa_instptr();
+  assert(tinst != NULL && tinst->klass()->is_loaded(), "must be a loaded instance");
+
+  ciField* field = tinst->klass()->as_instance_klass()->get_field_by_name(ciSymbol::make(fieldName),
+                                                                           ciSymbol::make(fieldTypeString),
+                                                                           false);
+  if (field == NULL) return NULL;
+
+  // Compute address and memory type, as Parse::do_get_xxx() does.
+  int offset = field->offset_in_bytes();
+  bool is_vol = field->is_volatile();
+  ciType* field_klass = field->type();
+  assert(field_klass->is_loaded(), "should be loaded");
+  const TypePtr* adr_type = C->alias_type(field)->adr_type();
+  Node* adr = basic_plus_adr(fromObj, fromObj, offset);
+  BasicType bt = field->layout_type();
+
+  // Build the resultant type of the load
+  const Type* type = TypeOopPtr::make_from_klass(field_klass->as_klass());
+
+  if (is_vol) {
+    // Memory barrier includes bogus read of value to force load BEFORE membar
+    Node* ld = make_load(NULL, adr, type, bt, adr_type);
+    insert_mem_bar(Op_MemBarAcquire, ld);
+    return ld;
+  }
+  return make_load(NULL, adr, type, bt, adr_type);
+}
+
+//------------------------get_key_start_from_aescrypt_object------------------
+// The expanded key is kept by AESCrypt in the int array K; the stubs read
+// it as little-endian ints.
+Node* LibraryCallKit::get_key_start_from_aescrypt_object(Node* aescrypt_object) {
+  Node* objAESCryptKey = load_field_from_object(aescrypt_object, "K", "[I");
+  if (objAESCryptKey == NULL) return NULL;
+
+  // now have the array, need to get the start address of the K array
+  return array_element_address(objAESCryptKey, intcon(0), T_INT);
+}
+
+//------------------------------inline_aescrypt_Block-------------------------
+// void com.sun.crypto.provider.AESCrypt.encryptBlock(byte[] in, int inOfs, byte[] out, int outOfs)
+// void com.sun.crypto.provider.AESCrypt.decryptBlock(byte[] in, int inOfs, byte[] out, int outOfs)
+bool LibraryCallKit::inline_aescrypt_Block(vmIntrinsics::ID id) {
+  address stubAddr = NULL;
+  const char *stubName = NULL;
+  assert(UseAES, "need AES instruction support");
+
+  switch (id) {
+  case vmIntrinsics::_aescrypt_encryptBlock:
+    stubAddr = StubRoutines::aescrypt_encryptBlock();
+    stubName = "aescrypt_encryptBlock";
+    break;
+  case vmIntrinsics::_aescrypt_decryptBlock:
+    stubAddr = StubRoutines::aescrypt_decryptBlock();
+    stubName = "aescrypt_decryptBlock";
+    break;
+  default:
+    ShouldNotReachHere();
+  }
+  if (stubAddr == NULL) return false;
+
+  const int nargs = 5;  // this + 4 args
+
+  // Restore the stack and pop off the arguments.
+  _sp += nargs;
+  Node* dest_offset     = pop();
+  Node* dest            = pop();
+  Node* src_offset      = pop();
+  Node* src             = pop();
+  Node* aescrypt_object = pop();
+
+  // The Java code has checked the arrays and the offsets.
+  assert(_gvn.type(src)->isa_aryptr() != NULL && _gvn.type(dest)->isa_aryptr() != NULL,
+         "args are strange");
+
+  // Null check on self without removing any arguments.
+  _sp += nargs;
+  aescrypt_object = do_null_check(aescrypt_object, T_OBJECT);
+  _sp -= nargs;
+  if (stopped()) return true;
+
+  // The stubs need the expanded key as an int array, otherwise we
+  // revert to the Java code.
+  Node* k_start = get_key_start_from_aescrypt_object(aescrypt_object);
+  if (k_start == NULL) return false;
+
+  Node* src_start  = array_element_address(src,  src_offset,  T_BYTE);
+  Node* dest_start = array_element_address(dest, dest_offset, T_BYTE);
+
+  // Call the stub.
+  make_runtime_call(RC_LEAF|RC_NO_FP, OptoRuntime::aescrypt_block_Type(),
+                    stubAddr, stubName, TypePtr::BOTTOM,
+                    src_start, dest_start, k_start);
+
+  return true;
+}
+
+//-------------------inline_cipherBlockChaining_AESCrypt----------------------
+// void com.sun.crypto.provider.CipherBlockChaining.encrypt(byte[] plain, int plainOffset, int plainLen, byte[] cipher, int cipherOffset)
+// void com.sun.crypto.provider.CipherBlockChaining.decrypt(byte[] cipher, int cipherOffset, int cipherLen, byte[] plain, int plainOffset)
+//
+// The stubs are only correct if the embedded cipher is an AESCrypt; other
+// embedded ciphers take an uncommon trap and the method is recompiled
+// without the intrinsic.
+bool LibraryCallKit::inline_cipherBlockChaining_AESCrypt(vmIntrinsics::ID id) {
+  address stubAddr = NULL;
+  const char *stubName = NULL;
+  assert(UseAES, "need AES instruction support");
+
+  switch (id) {
+  case vmIntrinsics::_cipherBlockChaining_encryptAESCrypt:
+    stubAddr = StubRoutines::cipherBlockChaining_encryptAESCrypt();
+    stubName = "cipherBlockChaining_encryptAESCrypt";
+    break;
+  case vmIntrinsics::_cipherBlockChaining_decryptAESCrypt:
+    stubAddr = StubRoutines::cipherBlockChaining_decryptAESCrypt();
+    stubName = "cipherBlockChaining_decryptAESCrypt";
+    break;
+  default:
+    ShouldNotReachHere();
+  }
+  if (stubAddr == NULL) return false;
+
+  // If the embedded cipher was not an AESCrypt in the past, do not
+  // intrinsify again.
+  if (too_many_traps(Deoptimization::Reason_intrinsic))  return false;
+
+  // AESCrypt must have been loaded by the loader of CipherBlockChaining
+  // for the instanceof check below.
+  ciKlass* klass_AESCrypt = callee()->holder()->find_klass(ciSymbol::make("com/sun/crypto/provider/AESCrypt"));
+  if (klass_AESCrypt == NULL || !klass_AESCrypt->is_loaded())  return false;
+
+  const int nargs = 6;  // this + 5 args
+
+  // Restore the stack and pop off the arguments.
+  _sp += nargs;
+  Node* dest_offset = pop();
+  Node* dest        = pop();
+  Node* len         = pop();
+  Node* src_offset  = pop();
+  Node* src         = pop();
+  Node* cbc_object  = pop();
+
+  // The Java code has checked the arrays, the offsets and the length.
+  assert(_gvn.type(src)->isa_aryptr() != NULL && _gvn.type(dest)->isa_aryptr() != NULL,
+         "args are strange");
+
+  // Null check on self without removing any arguments.
+  _sp += nargs;
+  cbc_object = do_null_check(cbc_object, T_OBJECT);
+  _sp -= nargs;
+  if (stopped()) return true;
+
+  Node* embeddedCipherObj = load_field_from_object(cbc_object, "embeddedCipher",
+                                                   "Lcom/sun/crypto/provider/SymmetricCipher;");
+  if (embeddedCipherObj == NULL) return false;
+
+  // Is the embedded cipher an AESCrypt?
+  _sp += nargs;          // gen_instanceof might do an uncommon trap
+  Node* inst = gen_instanceof(embeddedCipherObj, makecon(TypeKlassPtr::make(klass_AESCrypt)));
+  _sp -= nargs;
+  Node* cmp_inst = _gvn.transform(new (C, 3) CmpINode(inst, intcon(1)));
+  Node* bol_inst = _gvn.transform(new (C, 2) BoolNode(cmp_inst, BoolTest::eq));
+  { BuildCutout unless(this, bol_inst, PROB_MAX);
+    _sp += nargs;
+    uncommon_trap(Deoptimization::Reason_intrinsic,
+                  Deoptimization::Action_make_not_entrant);
+  }
+  if (stopped()) return true;
+
+  // Cast the embedded cipher to AESCrypt and get the start of its
+  // expanded key array.
+  const TypeInstPtr* aescrypt_type = TypeInstPtr::make(TypePtr::NotNull, klass_AESCrypt);
+  Node* aescrypt_object = _gvn.transform(new (C, 2) CheckCastPPNode(control(), embeddedCipherObj, aescrypt_type));
+  Node* k_start = get_key_start_from_aescrypt_object(aescrypt_object);
+  if (k_start == NULL) return false;
+
+  // The chaining vector r is kept in a byte array of the CBC object.
+  Node* objRvec = load_field_from_object(cbc_object, "r", "[B");
+  if (objRvec == NULL) return false;
+  Node* r_start = array_element_address(objRvec, intcon(0), T_BYTE);
+
+  Node* src_start  = array_element_address(src,  src_offset,  T_BYTE);
+  Node* dest_start = array_element_address(dest, dest_offset, T_BYTE);
+
+  // Call the stub, passing src_start, dest_start, k_start, r_start and src_len.
+  make_runtime_call(RC_LEAF|RC_NO_FP,
+                    OptoRuntime::cipherBlockChaining_aescrypt_Type(),
+                    stubAddr, stubName, TypePtr::BOTTOM,
+                    src_start, dest_start, k_start, r_start, len);
+
+  return true;
+}
+
+//------------------------------inline_updateCRC32----------------------------
+// static int java.util.zip.CRC32.update(int crc, int b)
+//
+// Calculate the CRC32 of a single byte with the table of the CRC32 stubs:
+//   crc = ~crc;
+//   crc = table[(crc ^ b) & 0xff] ^ (crc >>> 8);
+//   crc = ~crc;
+bool LibraryCallKit::inline_updateCRC32() {
+  assert(UseCRC32Intrinsics, "need CRC32 intrinsics support");
+  address table = StubRoutines::crc_table_addr();
+  if (table == NULL) return false;
+
+  const int nargs = 2;  // crc, b
+
+  // Restore the stack and pop off the arguments.
+  _sp += nargs;
+  Node* b   = pop();
+  Node* crc = pop();
+
+  Node* M1 = intcon(-1);
+  crc = _gvn.transform(new (C, 3) XorINode(crc, M1));
+  Node* result = _gvn.transform(new (C, 3) XorINode(crc, b));
+  result = _gvn.transform(new (C, 3) AndINode(result, intcon(0xFF)));
+
+  Node* base = makecon(TypeRawPtr::make(table));
+  Node* offset = _gvn.transform(new (C, 3) LShiftINode(result, intcon(0x2)));
+  Node* adr = basic_plus_adr(top(), base, ConvI2X(offset));
+  result = make_load(control(), adr, TypeInt::INT, T_INT);
+
+  crc = _gvn.transform(new (C, 3) URShiftINode(crc, intcon(8)));
+  result = _gvn.transform(new (C, 3) XorINode(crc, result));
+  result = _gvn.transform(new (C, 3) XorINode(result, M1));
+  push(result);
+  return true;
+}
+
+//---------------------------inline_updateBytesCRC32--------------------------
+// static int java.util.zip.CRC32.updateBytes(int crc, byte[] b, int off, int len)
+bool LibraryCallKit::inline_updateBytesCRC32() {
+  assert(UseCRC32Intrinsics, "need CRC32 intrinsics support");
+  address stubAddr = StubRoutines::updateBytesCRC32();
+  if (stubAddr == NULL) return false;
+
+  const int nargs = 4;  // crc, b, off, len
+
+  // Restore the stack and pop off the arguments.
+  _sp += nargs;
+  Node* length = pop();
+  Node* offset = pop();
+  Node* src    = pop();
+  Node* crc    = pop();
+
+  // The Java code has checked the array, the offset and the length.
+  assert(_gvn.type(src)->isa_aryptr() != NULL, "args are strange");
+
+  Node* src_start = array_element_address(src, offset, T_BYTE);
+
+  // Call the stub.
+  Node* call = make_runtime_call(RC_LEAF|RC_NO_FP, OptoRuntime::updateBytesCRC32_Type(),
+                                 stubAddr, "updateBytesCRC32", TypePtr::BOTTOM,
+                                 crc, src_start, length);
+  Node* result = _gvn.transform(new (C, 1) ProjNode(call, TypeFunc::Parms));
+  push(result);
+  return true;
+}
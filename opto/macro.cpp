@@ -2194,6 +2194,8 @@ bool PhaseMacroExpand::expand_macro_nodes() {
     }
   }
   // Next, attempt to eliminate allocations
+  NOT_PRODUCT(int eliminated_allocations = 0;)
+  NOT_PRODUCT(int eliminated_arrays = 0;)
   progress = true;
   while (progress) {
     progress = false;
@@ -2204,8 +2206,19 @@ bool PhaseMacroExpand::expand_macro_nodes() {
       switch (n->class_id()) {
       case Node::Class_Allocate:
       case Node::Class_AllocateArray:
+      {
+        NOT_PRODUCT(bool is_array = n->is_AllocateArray();)
         success = eliminate_allocate_node(n->as_Allocate());
+#ifndef PRODUCT
+        if (success) {
+          eliminated_allocations++;
+          if (is_array) {
+            eliminated_arrays++;
+          }
+        }
+#endif
         break;
+      }
       case Node::Class_Lock:
       case Node::Class_Unlock:
         assert(!n->as_AbstractLock()->is_eliminated(), "sanity");
@@ -2217,6 +2230,14 @@ bool PhaseMacroExpand::expand_macro_nodes() {
       progress = progress || success;
     }
   }
+#ifndef PRODUCT
+  if (PrintEliminateAllocations && eliminated_allocations > 0) {
+    tty->print("++++ Eliminated: %d Allocate %d AllocateArray in ",
+               eliminated_allocations - eliminated_arrays, eliminated_arrays);
+    C->method()->print_short_name();
+    tty->cr();
+  }
+#endif
   // Make sure expansion will not cause node limit to be exceeded.
   // Worst case is a macro node gets expanded into about 50 nodes.
   // Allow 50% more for optimization.
@@ -69,7 +69,8 @@ protected:
                                            int caller_bci);
   const char* try_to_inline(ciMethod* callee_method, ciMethod* caller_method, int caller_bci, ciCallProfile& profile, WarmCallInfo* wci_result);
   const char* should_inline(ciMethod* callee_method, ciMethod* caller_method, int caller_bci, ciCallProfile& profile, WarmCallInfo* wci_result) const;
-  const char* should_not_inline(ciMethod* callee_method, ciMethod* caller_method, WarmCallInfo* wci_result) const;
+  const char* should_not_inline(ciMethod* callee_method, ciMethod* caller_method, int caller_bci, ciCallProfile& profile, WarmCallInfo* wci_result) const;
+  bool        inline_within_budget(ciMethod* callee_method, int caller_bci, ciCallProfile& profile, const char* limit) const;
   void        print_inlining(ciMethod *callee_method, int caller_bci, const char *failure_msg) const;
 
   InlineTree *caller_tree()       const { return _caller_tree;  }
@@ -459,6 +460,9 @@ class Parse : public GraphKit {
   // Helper function to setup Ideal Call nodes
   void do_call();
 
+  // Helper function to pass heap copies of objects escaping at a rare call
+  void materialize_rare_escapes(juint args, int nargs);
+
   // Helper function to uncommon-trap or bailout for non-compilable call-sites
   bool can_not_compile_call_site(ciMethod *dest_method, ciInstanceKlass *klass);
 
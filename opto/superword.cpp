@@ -53,6 +53,7 @@ SuperWord::SuperWord(PhaseIdealLoop* phase) :
   _node_info(arena(), 8,  0, SWNodeInfo::initial), // info needed per node
   _align_to_ref(NULL),                    // memory reference to align vectors to
   _disjoint_ptrs(arena(), 8,  0, OrderedPair::initial), // runtime disambiguated pointer pairs
+  _reductions(arena(), 8,  0, NULL),      // reduction chains
   _dg(_arena),                            // dependence graph
   _visited(arena()),                      // visited node set
   _post_visited(arena()),                 // post visited node set
@@ -120,6 +121,14 @@ void SuperWord::transform_loop(IdealLoopTree* lpt) {
 //    integers.  This reverses the promotion to type "int" that javac
 //    did for operations like: char c1,c2,c3;  c1 = c2 + c3.
 //
+// 4a) With SuperWordReductions, the integer reductions carried by the
+//    Phis of the loop (sums, dot products, and, or, xor) are found.  The
+//    chain of operations of an unrolled reduction depends on itself from
+//    one unrolled copy to the next, so its operations are never packed;
+//    their other operands may be, and the chain is then replaced with
+//    a vector accumulator carried by the loop, which is reduced into a
+//    scalar after the loop.
+//
 // 5) One of the memory references is picked to be an aligned vector reference.
 //    The pre-loop trip count is adjusted to align this reference in the
 //    unrolled body.
@@ -148,6 +157,10 @@ void SuperWord::SLP_extract() {
 
   compute_vector_element_type();
 
+  if (SuperWordReductions) {
+    mark_reductions();
+  }
+
   // Attempt vectorization
 
   find_adjacent_refs();
@@ -879,7 +892,7 @@ void SuperWord::filter_packs() {
 bool SuperWord::implemented(Node_List* p) {
   Node* p0 = p->at(0);
   int vopc = VectorNode::opcode(p0->Opcode(), p->size(), velt_type(p0));
-  return vopc > 0 && Matcher::has_match_rule(vopc);
+  return vopc > 0 && Matcher::match_rule_supported(vopc);
 }
 
 //------------------------------profitable---------------------------
@@ -1144,6 +1157,14 @@ void SuperWord::output() {
 
   align_initial_loop_index(align_to_ref());
 
+  // Only keep the reductions whose operands are all vectorized; the
+  // pack map is no longer valid once the packs have been replaced.
+  for (int i = _reductions.length() - 1; i >= 0; i--) {
+    if (!reduction_is_packed(_reductions.at(i))) {
+      _reductions.remove_at(i);
+    }
+  }
+
   // Insert extract (unpack) operations for scalar uses
   for (int i = 0; i < _packset.length(); i++) {
     insert_extracts(_packset.at(i));
@@ -1195,6 +1216,11 @@ void SuperWord::output() {
       _igvn._worklist.push(vn);
     }
   }
+
+  // The operands of the vectorized reductions are now vectors
+  for (int i = 0; i < _reductions.length(); i++) {
+    output_reduction(_reductions.at(i));
+  }
 }
 
 //------------------------------vector_opd---------------------------
@@ -1299,7 +1325,10 @@ void SuperWord::insert_extracts(Node_List* p) {
 // Is use->in(u_idx) a vector use?
 bool SuperWord::is_vector_use(Node* use, int u_idx) {
   Node_List* u_pk = my_pack(use);
-  if (u_pk == NULL) return false;
+  if (u_pk == NULL) {
+    // The operands of a vectorized reduction are used as vectors.
+    return is_reduction_opd(use, u_idx);
+  }
   Node* def = use->in(u_idx);
   Node_List* d_pk = my_pack(def);
   if (d_pk == NULL) {
@@ -1577,6 +1606,217 @@ void SuperWord::compute_vector_element_type() {
 #endif
 }
 
+//------------------------------mark_reductions---------------------------
+// Find the reductions carried by the Phis of the loop.  After unrolling,
+// a reduction is a Phi whose only use starts a chain of the same
+// associative integer operation:  s = ((s op x0) op x1) ... op xn
+// where every link is only used by the next one and the last link is
+// only used by the Phi and after the loop.
+void SuperWord::mark_reductions() {
+  for (DUIterator_Fast imax, i = lp()->fast_outs(imax); i < imax; i++) {
+    Node* phi = lp()->fast_out(i);
+    if (!phi->is_Phi() || phi == iv() || !in_bb(phi) ||
+        phi->bottom_type()->isa_int() == NULL || phi->outcnt() != 1) {
+      continue;
+    }
+    Node* last = phi->in(LoopNode::LoopBackControl);
+    int opc = last->Opcode();
+    if (opc != Op_AddI && opc != Op_AndI && opc != Op_OrI && opc != Op_XorI) {
+      continue;
+    }
+    Node_List* r = new Node_List();
+    r->push(phi);
+    Node* prev = phi;
+    bool is_reduction = true;
+    while (prev != last) {
+      if (prev->outcnt() != 1) {
+        is_reduction = false;
+        break;
+      }
+      Node* n = prev->unique_out();
+      if (n->Opcode() != opc || !in_bb(n) || n->in(1) == n->in(2)) {
+        is_reduction = false;
+        break;
+      }
+      r->push(n);
+      prev = n;
+    }
+    if (!is_reduction || r->size() < 3) {
+      continue;
+    }
+    for (DUIterator_Fast jmax, j = last->fast_outs(jmax); j < jmax; j++) {
+      Node* use = last->fast_out(j);
+      if (use != phi && in_bb(use)) {
+        is_reduction = false;
+        break;
+      }
+    }
+    if (is_reduction) {
+      _reductions.append(r);
+    }
+  }
+
+#ifndef PRODUCT
+  if (TraceSuperWord) {
+    tty->print_cr("\nreductions: %s", _reductions.length() > 0 ? "" : "NONE");
+    for (int m = 0; m < _reductions.length(); m++) {
+      Node_List* r = _reductions.at(m);
+      tty->print("%3d ", m); r->at(0)->dump();
+      tty->print("    ");    r->at(r->size() - 1)->dump();
+    }
+  }
+#endif
+}
+
+//------------------------------reduction_of---------------------------
+// Return the reduction chain containing operation n, or NULL
+Node_List* SuperWord::reduction_of(Node* n) {
+  for (int i = 0; i < _reductions.length(); i++) {
+    Node_List* r = _reductions.at(i);
+    for (uint j = 1; j < r->size(); j++) {
+      if (r->at(j) == n) {
+        return r;
+      }
+    }
+  }
+  return NULL;
+}
+
+//------------------------------reduction_opd_idx---------------------------
+// Index of the operand of reduction operation n which is not its
+// predecessor prev in the chain
+int SuperWord::reduction_opd_idx(Node* n, Node* prev) {
+  assert(n->in(1) == prev || n->in(2) == prev, "must be in the chain");
+  return n->in(1) == prev ? 2 : 1;
+}
+
+//------------------------------reduction_is_packed---------------------------
+// Are all the operands of reduction r in packs of the same size, made
+// of operands of r only, which the reduction can be generated for?
+bool SuperWord::reduction_is_packed(Node_List* r) {
+  int  opc  = r->at(1)->Opcode();
+  uint vlen = 0;
+  for (uint j = 1; j < r->size(); j++) {
+    Node* n   = r->at(j);
+    Node* opd = n->in(reduction_opd_idx(n, r->at(j-1)));
+    Node_List* p = my_pack(opd);
+    if (p == NULL || velt_type(opd) != TypeInt::INT) {
+      return false;
+    }
+    if (vlen == 0) {
+      vlen = p->size();
+      int ropc = ReductionNode::opcode(opc, vlen, TypeInt::INT);
+      int vopc = VectorNode::opcode(opc, vlen, TypeInt::INT);
+      if (ropc == 0 || !Matcher::match_rule_supported(ropc) ||
+          vopc == 0 || !Matcher::match_rule_supported(vopc)) {
+        return false;
+      }
+    } else if (p->size() != vlen) {
+      return false;
+    }
+    for (uint k = 0; k < p->size(); k++) {
+      Node* m = p->at(k);
+      if (m->outcnt() != 1 || reduction_of(m->unique_out()) != r) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//------------------------------is_reduction_opd---------------------------
+// Is use->in(u_idx) the operand of a reduction whose operands are all
+// vectorized?  The reduction then consumes the vector.
+bool SuperWord::is_reduction_opd(Node* use, int u_idx) {
+  Node_List* r = reduction_of(use);
+  if (r == NULL) {
+    return false;
+  }
+  Node* prev = NULL;
+  for (uint j = 1; j < r->size(); j++) {
+    if (r->at(j) == use) {
+      prev = r->at(j-1);
+      break;
+    }
+  }
+  if (u_idx != reduction_opd_idx(use, prev)) {
+    return false;
+  }
+  return reduction_is_packed(r);
+}
+
+//------------------------------output_reduction---------------------------
+// The operands of reduction r have been replaced with vectors.  Combine
+// these vectors with vector operations into a vector accumulator carried
+// by a new Phi of the loop, and reduce the accumulator into the scalar
+// once, after the loop.  The lanes are combined in a different order than
+// the scalar chain did, which is why only associative and commutative
+// integer operations are reduced.
+void SuperWord::output_reduction(Node_List* r) {
+  Compile* C = _phase->C;
+  Node* phi  = r->at(0);
+  Node* last = r->at(r->size() - 1);
+  int   opc  = last->Opcode();
+
+  Node* acc = NULL;
+  uint vlen = 0;
+  Node_List vectors;
+  for (uint j = 1; j < r->size(); j++) {
+    Node* n   = r->at(j);
+    Node* opd = n->in(reduction_opd_idx(n, r->at(j-1)));
+    assert(opd->is_Vector(), "operand must have been vectorized");
+    bool seen = false;
+    for (uint k = 0; k < vectors.size(); k++) {
+      if (vectors.at(k) == opd) {
+        seen = true;
+        break;
+      }
+    }
+    if (seen) continue;
+    vectors.push(opd);
+    if (acc == NULL) {
+      acc  = opd;
+      vlen = ((VectorNode*)opd)->length();
+    } else {
+      acc = VectorNode::make(C, opc, acc, opd, vlen, TypeInt::INT);
+      _phase->_igvn.register_new_node_with_optimizer(acc);
+      _phase->set_ctrl(acc, bb());
+    }
+  }
+
+  // The accumulator starts with the identity of the operation in every
+  // lane.  The Phi carrying it has the type of the vectors themselves,
+  // which is what its inputs compute to, and their register class.
+  Node* identity = _igvn.intcon(opc == Op_AndI ? -1 : 0);
+  Node* vinit = VectorNode::scalar2vector(C, identity, vlen, TypeInt::INT);
+  _phase->_igvn.register_new_node_with_optimizer(vinit);
+  _phase->set_ctrl(vinit, _phase->get_ctrl(identity));
+
+  PhiNode* vphi = new (C, 3) VectorPhiNode(lp(), vinit->bottom_type());
+  vphi->init_req(LoopNode::EntryControl, vinit);
+  Node* vnext = VectorNode::make(C, opc, vphi, acc, vlen, TypeInt::INT);
+  vphi->init_req(LoopNode::LoopBackControl, vnext);
+  _phase->_igvn.register_new_node_with_optimizer(vphi);
+  _phase->set_ctrl(vphi, lp());
+  _phase->_igvn.register_new_node_with_optimizer(vnext);
+  _phase->set_ctrl(vnext, bb());
+
+  // Reduce the accumulator into the value the scalar Phi had on entry,
+  // on the loop exit.
+  Node* init = phi->in(LoopNode::EntryControl);
+  Node* exit = lp()->as_CountedLoop()->loopexit()->proj_out(false);
+  Node* red  = ReductionNode::make(C, opc, init, vnext, vlen, TypeInt::INT);
+  red->init_req(0, exit);
+  _phase->_igvn.register_new_node_with_optimizer(red);
+  _phase->set_ctrl(red, exit);
+
+  // The scalar Phi is only used by the chain, which dies with it, and
+  // the uses after the loop now take the reduction.
+  _igvn.replace_node(phi, init);
+  _igvn.replace_node(last, red);
+  _igvn._worklist.push(red);
+}
+
 //------------------------------memory_alignment---------------------------
 // Alignment within a vector memory reference
 int SuperWord::memory_alignment(MemNode* s, int iv_adjust_in_bytes) {
@@ -1868,6 +2108,7 @@ void SuperWord::init() {
   _dg.init();
   _packset.clear();
   _disjoint_ptrs.clear();
+  _reductions.clear();
   _block.clear();
   _data_entry.clear();
   _mem_slice_head.clear();
@@ -226,6 +226,8 @@ class SuperWord : public ResourceObj {
 
   GrowableArray<OrderedPair> _disjoint_ptrs; // runtime disambiguated pointer pairs
 
+  GrowableArray<Node_List*> _reductions; // Reduction chains: the Phi, then its operations
+
   DepGraph _dg; // Dependence graph
 
   // Scratch pads
@@ -379,6 +381,18 @@ class SuperWord : public ResourceObj {
   void compute_max_depth();
   // Compute necessary vector element type for expressions
   void compute_vector_element_type();
+  // Find the reductions carried by the Phis of the loop
+  void mark_reductions();
+  // Return the reduction chain containing operation n, or NULL
+  Node_List* reduction_of(Node* n);
+  // Index of the operand of reduction operation n which is not the chain
+  int reduction_opd_idx(Node* n, Node* prev);
+  // Are all the operands of reduction r in packs of reduction r?
+  bool reduction_is_packed(Node_List* r);
+  // Is use->in(u_idx) the operand of a reduction which is vectorized?
+  bool is_reduction_opd(Node* use, int u_idx);
+  // Replace vectorized reduction r with a reduction of its vector operands
+  void output_reduction(Node_List* r);
   // Are s1 and s2 in a pack pair and ordered as s1,s2?
   bool in_packset(Node* s1, Node* s2);
   // Is s in pack p?
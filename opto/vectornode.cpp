@@ -23,6 +23,7 @@
 
 #include "precompiled.hpp"
 #include "memory/allocation.inline.hpp"
+#include "opto/compile.hpp"
 #include "opto/connode.hpp"
 #include "opto/vectornode.hpp"
 
@@ -200,6 +201,13 @@ int VectorNode::opcode(int sopc, uint vlen, const Type* opd_t) {
   case Op_SubD:
     assert(bt == T_DOUBLE, "must be");
     return Op_SubVD;
+  case Op_MulI:
+    switch (bt) {
+    case T_CHAR:   return Op_MulVC;
+    case T_SHORT:  return Op_MulVS;
+    case T_INT:    return Op_MulVI;
+    }
+    return 0; // Unimplemented (no packed byte multiply)
   case Op_MulF:
     assert(bt == T_FLOAT, "must be");
     return Op_MulVF;
@@ -368,6 +376,9 @@ VectorNode* VectorNode::make(Compile* C, int sopc, Node* n1, Node* n2, uint vlen
   case Op_SubVF: return new (C, 3) SubVFNode(n1, n2, vlen);
   case Op_SubVD: return new (C, 3) SubVDNode(n1, n2, vlen);
 
+  case Op_MulVC: return new (C, 3) MulVCNode(n1, n2, vlen);
+  case Op_MulVS: return new (C, 3) MulVSNode(n1, n2, vlen);
+  case Op_MulVI: return new (C, 3) MulVINode(n1, n2, vlen);
   case Op_MulVF: return new (C, 3) MulVFNode(n1, n2, vlen);
   case Op_MulVD: return new (C, 3) MulVDNode(n1, n2, vlen);
 
@@ -478,3 +489,39 @@ Node* ExtractNode::make(Compile* C, Node* v, uint position, const Type* opd_t) {
   ShouldNotReachHere();
   return NULL;
 }
+
+//------------------------------VectorPhiNode-------------------------------------
+// The Phi is spilled like the vectors it merges.
+const RegMask &VectorPhiNode::out_RegMask() const {
+  return *(Compile::current()->matcher()->idealreg2spillmask[ideal_reg()]);
+}
+
+// Return the reduction opcode for a scalar opcode, element type and
+// vector length, or 0 if there is none.  Only operations which may be
+// reassociated are reduced: the elements are combined in any order.
+int ReductionNode::opcode(int sopc, uint vlen, const Type* opd_t) {
+  BasicType bt = opd_t->array_element_basic_type();
+  if (bt != T_INT || !(is_power_of_2(vlen) && vlen <= VectorNode::max_vlen(bt)))
+    return 0; // unimplemented
+  switch (sopc) {
+  case Op_AddI: return Op_AddReductionVI;
+  case Op_AndI: return Op_AndReductionVI;
+  case Op_OrI:  return Op_OrReductionVI;
+  case Op_XorI: return Op_XorReductionVI;
+  }
+  return 0;
+}
+
+// Return the reduction of vector n2 into scalar n1 for a scalar operation.
+ReductionNode* ReductionNode::make(Compile* C, int sopc, Node* n1, Node* n2, uint vlen, const Type* opd_t) {
+  int ropc = opcode(sopc, vlen, opd_t);
+
+  switch (ropc) {
+  case Op_AddReductionVI: return new (C, 3) AddReductionVINode(n1, n2);
+  case Op_AndReductionVI: return new (C, 3) AndReductionVINode(n1, n2);
+  case Op_OrReductionVI:  return new (C, 3) OrReductionVINode(n1, n2);
+  case Op_XorReductionVI: return new (C, 3) XorReductionVINode(n1, n2);
+  }
+  ShouldNotReachHere();
+  return NULL;
+}
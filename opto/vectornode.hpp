@@ -24,6 +24,7 @@
 #ifndef SHARE_VM_OPTO_VECTORNODE_HPP
 #define SHARE_VM_OPTO_VECTORNODE_HPP
 
+#include "opto/cfgnode.hpp"
 #include "opto/matcher.hpp"
 #include "opto/memnode.hpp"
 #include "opto/node.hpp"
@@ -218,6 +219,36 @@ class SubVDNode : public VectorNode {
   virtual int Opcode() const;
 };
 
+//------------------------------MulVCNode---------------------------------------
+// Vector multiply char
+class MulVCNode : public VectorNode {
+ protected:
+  virtual BasicType elt_basic_type() const { return T_CHAR; }
+ public:
+  MulVCNode(Node* in1, Node* in2, uint vlen) : VectorNode(in1,in2,vlen) {}
+  virtual int Opcode() const;
+};
+
+//------------------------------MulVSNode---------------------------------------
+// Vector multiply short
+class MulVSNode : public VectorNode {
+ protected:
+  virtual BasicType elt_basic_type() const { return T_SHORT; }
+ public:
+  MulVSNode(Node* in1, Node* in2, uint vlen) : VectorNode(in1,in2,vlen) {}
+  virtual int Opcode() const;
+};
+
+//------------------------------MulVINode---------------------------------------
+// Vector multiply int
+class MulVINode : public VectorNode {
+ protected:
+  virtual BasicType elt_basic_type() const { return T_INT; }
+ public:
+  MulVINode(Node* in1, Node* in2, uint vlen) : VectorNode(in1,in2,vlen) {}
+  virtual int Opcode() const;
+};
+
 //------------------------------MulVFNode---------------------------------------
 // Vector multiply float
 class MulVFNode : public VectorNode {
@@ -1142,4 +1173,65 @@ class ExtractDNode : public ExtractNode {
   virtual uint ideal_reg() const { return Op_RegD; }
 };
 
+//------------------------------VectorPhiNode-------------------------------------
+// Phi of a vector carried around a loop.  It has the type of the vectors it
+// merges, which is the scalar type of the same size, but like them it lives
+// in the vector registers.
+class VectorPhiNode : public PhiNode {
+  virtual uint size_of() const { return sizeof(*this); }
+ public:
+  VectorPhiNode(Node* r, const Type* t) : PhiNode(r, t) {}
+  virtual uint ideal_reg() const { return Matcher::vector_ideal_reg(); }
+  virtual const RegMask &out_RegMask() const;
+};
+
+//========================Reduce_a_Vector_into_a_Scalar===========================
+
+//------------------------------ReductionNode-------------------------------------
+// Combine the scalar in(1) with all the elements of the vector in(2)
+class ReductionNode : public Node {
+ public:
+  ReductionNode(Node* in1, Node* in2) : Node(NULL, in1, in2) {}
+  virtual int Opcode() const;
+  virtual const Type *bottom_type() const { return TypeInt::INT; }
+  virtual uint ideal_reg() const { return Op_RegI; }
+
+  // Reduction opcode from scalar opcode
+  static int opcode(int sopc, uint vlen, const Type* opd_t);
+
+  static ReductionNode* make(Compile* C, int sopc, Node* n1, Node* n2, uint vlen, const Type* opd_t);
+};
+
+//------------------------------AddReductionVINode--------------------------------
+// Add the integers of a vector to a scalar
+class AddReductionVINode : public ReductionNode {
+ public:
+  AddReductionVINode(Node* in1, Node* in2) : ReductionNode(in1, in2) {}
+  virtual int Opcode() const;
+};
+
+//------------------------------AndReductionVINode--------------------------------
+// And the integers of a vector into a scalar
+class AndReductionVINode : public ReductionNode {
+ public:
+  AndReductionVINode(Node* in1, Node* in2) : ReductionNode(in1, in2) {}
+  virtual int Opcode() const;
+};
+
+//------------------------------OrReductionVINode---------------------------------
+// Or the integers of a vector into a scalar
+class OrReductionVINode : public ReductionNode {
+ public:
+  OrReductionVINode(Node* in1, Node* in2) : ReductionNode(in1, in2) {}
+  virtual int Opcode() const;
+};
+
+//------------------------------XorReductionVINode--------------------------------
+// Xor the integers of a vector into a scalar
+class XorReductionVINode : public ReductionNode {
+ public:
+  XorReductionVINode(Node* in1, Node* in2) : ReductionNode(in1, in2) {}
+  virtual int Opcode() const;
+};
+
 #endif // SHARE_VM_OPTO_VECTORNODE_HPP
@@ -3115,6 +3115,12 @@ jint Arguments::parse(const JavaVMInitArgs* args) {
   if (!UseBiasedLocking || EmitSync != 0) {
     UseOptoBiasInlining = false;
   }
+  if (UsePolymorphicInlining && FLAG_IS_DEFAULT(TypeProfileWidth) &&
+      TypeProfileWidth < PolymorphicInlineLimit) {
+    // The receivers of a polymorphic call site are only known if the
+    // profile has a row for each of them.
+    FLAG_SET_DEFAULT(TypeProfileWidth, PolymorphicInlineLimit);
+  }
 #endif
 
   if (PrintAssembly && FLAG_IS_DEFAULT(DebugNonSafepoints)) {
@@ -492,6 +492,10 @@ class CommandLineFlags {
   product(intx, UseSSE, 99,                                                 \
           "Highest supported SSE instructions set on x86/x64")              \
                                                                             \
+  product(intx, UseAVX, 99,                                                 \
+          "Highest supported AVX instructions set on x86/x64; only "        \
+          "the VEX encodings of the 8 byte vector operations use it")       \
+                                                                            \
   product(uintx, LargePageSizeInBytes, 0,                                   \
           "Large page size (0 to let VM choose the page size")              \
                                                                             \
@@ -620,6 +624,18 @@ class CommandLineFlags {
   product(bool, UseSSE42Intrinsics, false,                                  \
           "SSE4.2 versions of intrinsics")                                  \
                                                                             \
+  product(bool, UseAES, false,                                              \
+          "Control whether AES instructions can be used on x86/x64")        \
+                                                                            \
+  product(bool, UseAESIntrinsics, false,                                    \
+          "use intrinsics for AES versions of crypto")                      \
+                                                                            \
+  product(bool, UseCLMUL, false,                                            \
+          "Control whether CLMUL instructions can be used on x86/x64")      \
+                                                                            \
+  product(bool, UseCRC32Intrinsics, false,                                  \
+          "use intrinsics for java.util.zip.CRC32")                         \
+                                                                            \
   product(bool, UseCondCardMark, false,                                     \
           "Check for already marked card before updating card table")       \
                                                                             \
@@ -1163,6 +1179,14 @@ class CommandLineFlags {
   product(bool, LazyBootClassLoader, true,                                  \
           "Enable/disable lazy opening of boot class path entries")         \
                                                                             \
+  product(uintx, ClassFilePrefetchThreads, 0,                               \
+          "Number of threads reading and inflating the class files of "     \
+          "the boot class path ahead of use (0 disables prefetching)")      \
+                                                                            \
+  product(uintx, ClassFilePrefetchDistance, 512,                            \
+          "Number of jar file entries the class file prefetch threads may " \
+          "read past the last prefetched class file used")                  \
+                                                                            \
   diagnostic(bool, UseIncDec, true,                                         \
           "Use INC, DEC instructions on x86")                               \
                                                                             \
@@ -1380,6 +1404,19 @@ class CommandLineFlags {
   product(uintx, ParallelGCThreads, 0,                                      \
           "Number of parallel threads parallel gc will use")                \
                                                                             \
+  product(bool, UseDynamicNumberOfGCThreads, false,                         \
+          "Size the number of GC threads used by each pause and each "      \
+          "concurrent phase from the heap occupancy, the number of "        \
+          "application threads and the recent pause times")                 \
+                                                                            \
+  product(uintx, HeapSizePerGCThread, ScaleForWordSize(64*M),               \
+          "Occupied heap (in bytes) per GC thread with "                    \
+          "UseDynamicNumberOfGCThreads")                                    \
+                                                                            \
+  product(bool, TraceDynamicGCThreads, false,                               \
+          "Trace the number of GC threads chosen with "                     \
+          "UseDynamicNumberOfGCThreads")                                    \
+                                                                            \
   develop(bool, ParallelOldGCSplitALot, false,                              \
           "Provoke splitting (copying data from a young gen space to"       \
           "multiple destination spaces)")                                   \
@@ -1653,12 +1690,21 @@ class CommandLineFlags {
           "When CMS class unloading is enabled, the maximum CMS cycle count"\
           " for which classes may not be unloaded")                         \
                                                                             \
+  product(bool, CMSParallelClassUnloadingEnabled, true,                     \
+          "Whether the klass links and the symbol and string tables are"    \
+          " cleaned up in parallel after CMS class unloading")              \
+                                                                            \
   product(bool, CMSCompactWhenClearAllSoftRefs, true,                       \
           "Compact when asked to collect CMS gen with clear_all_soft_refs") \
                                                                             \
   product(bool, UseCMSCompactAtFullCollection, true,                        \
           "Use mark sweep compact at full collections")                     \
                                                                             \
+  product(bool, CMSParallelFullGC, true,                                    \
+          "Use the parallel GC threads for the marking, forwarding, "       \
+          "pointer adjustment and compaction phases of mark sweep "         \
+          "compact collections")                                            \
+                                                                            \
   product(uintx, CMSFullGCsBeforeCompaction, 0,                             \
           "Number of CMS full collection done before compaction if > 0")    \
                                                                             \
@@ -1853,6 +1899,11 @@ class CommandLineFlags {
   product(bool, ParallelRefProcBalancingEnabled, true,                      \
           "Enable balancing of reference processing queues")                \
                                                                             \
+  product(uintx, ParallelRefProcChunkSize, 256,                             \
+          "Number of discovered references in a unit of work claimed by "   \
+          "the workers of parallel reference processing; 0 disables "       \
+          "chunking")                                                       \
+                                                                            \
   product(intx, CMSTriggerRatio, 80,                                        \
           "Percentage of MinHeapFreeRatio in CMS generation that is "       \
           "allocated before a CMS collection cycle commences")              \
@@ -2406,6 +2457,20 @@ class CommandLineFlags {
   product(intx, CompilationPolicyChoice, 0,                                 \
           "which compilation policy (0/1)")                                 \
                                                                             \
+  product(ccstr, ProfileSnapshotFile, NULL,                                  \
+          "File of method counters read at startup to prime the counters "  \
+          "of the methods which were hot in a previous run")                \
+                                                                            \
+  product(bool, DumpProfileSnapshot, false,                                 \
+          "Write the method counters to ProfileSnapshotFile at exit")       \
+                                                                            \
+  product(intx, ProfileSnapshotPrimePercentage, 90,                         \
+          "Percentage of the compile thresholds to which the counters of "  \
+          "the methods found hot in ProfileSnapshotFile are raised")        \
+                                                                            \
+  diagnostic(bool, PrintProfileSnapshot, false,                             \
+          "Print the methods primed from ProfileSnapshotFile")              \
+                                                                            \
   develop(bool, UseStackBanging, true,                                      \
           "use stack banging for stack overflow checks (required for "      \
           "proper StackOverflow handling; disable only to measure cost "    \
@@ -3278,6 +3343,23 @@ class CommandLineFlags {
   product_pd(uintx, ReservedCodeCacheSize,                                  \
           "Reserved code cache size (in bytes) - maximum code cache size")  \
                                                                             \
+  product(bool, SegmentedCodeCache, false,                                  \
+          "Divide the code cache into separate code heaps for non-method "  \
+          "code, profiled nmethods and non-profiled nmethods")              \
+                                                                            \
+  product(uintx, NonMethodCodeHeapSize, 0,                                  \
+          "Size of the code heap for non-method code (in bytes) when the "  \
+          "code cache is segmented; 0 selects a size ergonomically")        \
+                                                                            \
+  product(uintx, ProfiledCodeHeapSize, 0,                                   \
+          "Size of the code heap for profiled nmethods (in bytes) when "    \
+          "the code cache is segmented; 0 selects a size ergonomically")    \
+                                                                            \
+  product(uintx, NonProfiledCodeHeapSize, 0,                                \
+          "Size of the code heap for non-profiled nmethods (in bytes) "     \
+          "when the code cache is segmented; 0 selects a size "             \
+          "ergonomically")                                                  \
+                                                                            \
   product(uintx, CodeCacheMinimumFreeSpace, 500*K,                          \
           "When less than X space left, we stop compiling.")                \
                                                                             \
@@ -3671,6 +3753,12 @@ class CommandLineFlags {
             "shared spaces, and dumps the shared spaces to a file to be "   \
             "used in future JVM runs.")                                     \
                                                                             \
+  product(ccstr, SharedClassListFile, NULL,                                 \
+          "File listing the application classes to be added to the shared " \
+          "archive by -Xshare:dump; they are loaded from the boot class "   \
+          "path, e.g. -Xbootclasspath/a, and are defined by the boot "      \
+          "loader, not the application class loader")                       \
+                                                                            \
   product(bool, PrintSharedSpaces, false,                                   \
           "Print usage of shared spaces")                                   \
                                                                             \
@@ -3776,6 +3864,19 @@ class CommandLineFlags {
   product(uintx, StringTableSize, 1009,                                     \
           "Number of buckets in the interned String table")                 \
                                                                             \
+  product(bool, ResizeSymbolTables, true,                                   \
+          "Grow the SymbolTable and the interned String table at a "        \
+          "safepoint when their bucket chains get too long")                \
+                                                                            \
+  product(uintx, SymbolTableMaxLoad, 4,                                     \
+          "Average number of entries per bucket above which the "           \
+          "SymbolTable and the interned String table are grown")            \
+                                                                            \
+  product(uintx, IncrementalSymbolTableUnlinkBuckets, 0,                    \
+          "If positive, CMS and G1 do not scrub the SymbolTable in "        \
+          "their remark pauses; this many buckets are scrubbed at "         \
+          "every safepoint instead")                                        \
+                                                                            \
   product(bool, UseVMInterruptibleIO, false,                                \
           "(Unstable, Solaris-specific) Thread interrupt before or with "   \
           "EINTR for I/O operations results in OS_INTRPT. The default value"\
@@ -51,6 +51,7 @@ void stubRoutines_init1();
 jint universe_init();  // dependent on codeCache_init and stubRoutines_init
 void interpreter_init();  // before any methods loaded
 void invocationCounter_init();  // before any methods loaded
+void profileSnapshot_init();  // before any methods linked
 void marksweep_init();
 void accessFlags_init();
 void templateTable_init();
@@ -101,6 +102,7 @@ jint init_globals() {
 
   interpreter_init();  // before any methods loaded
   invocationCounter_init();  // before any methods loaded
+  profileSnapshot_init();  // before any methods linked
   marksweep_init();
   accessFlags_init();
   templateTable_init();
@@ -23,6 +23,7 @@
  */
 
 #include "precompiled.hpp"
+#include "classfile/classFilePrefetcher.hpp"
 #include "classfile/classLoader.hpp"
 #include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionary.hpp"
@@ -52,6 +53,7 @@
 #include "runtime/interfaceSupport.hpp"
 #include "runtime/java.hpp"
 #include "runtime/memprofiler.hpp"
+#include "runtime/profileSnapshot.hpp"
 #include "runtime/sharedRuntime.hpp"
 #include "runtime/statSampler.hpp"
 #include "runtime/task.hpp"
@@ -454,10 +456,20 @@ void before_exit(JavaThread * thread) {
     os::infinite_sleep();
   }
 
+  // Save the method counters for the next run
+  if (DumpProfileSnapshot && ProfileSnapshotFile != NULL) {
+    ProfileSnapshot::write();
+  }
+
   // Terminate watcher thread - must before disenrolling any periodic task
   if (PeriodicTask::num_tasks() > 0)
     WatcherThread::stop();
 
+  // Stop the class file prefetch threads
+  if (ClassFilePrefetcher::is_active()) {
+    ClassFilePrefetcher::stop();
+  }
+
   // Print statistics gathered (profiling ...)
   if (Arguments::has_profile()) {
     FlatProfiler::disengage();
@@ -71,6 +71,7 @@ extern Monitor* Threads_lock;                    // a lock on the Threads table
                                                  // (also used by Safepoints too to block threads creation/destruction)
 extern Monitor* CGC_lock;                        // used for coordination between
                                                  // fore- & background GC threads.
+extern Monitor* ClassFilePrefetch_lock;          // coordinate the class file prefetch threads
 extern Mutex*   STS_init_lock;                   // coordinate initialization of SuspendibleThreadSets.
 extern Monitor* SLT_lock;                        // used in CMS GC for acquiring PLL
 extern Monitor* iCMS_lock;                       // CMS incremental mode start/stop notification
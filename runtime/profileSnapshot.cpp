@@ -0,0 +1,345 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#include "precompiled.hpp"
+#include "classfile/symbolTable.hpp"
+#include "classfile/systemDictionary.hpp"
+#include "memory/resourceArea.hpp"
+#include "oops/oop.inline.hpp"
+#include "runtime/mutexLocker.hpp"
+#include "runtime/os.hpp"
+#include "runtime/profileSnapshot.hpp"
+#include "utilities/ostream.hpp"
+
+// The snapshot is a text file.  After the header line, every line holds
+// the counters of one method:
+//
+//   <class> <class fingerprint> <method> <signature> <method fingerprint>
+//   <invocations> <backedges> <compiled>
+//
+// on a single line, with the fingerprints in hexadecimal.  Lines starting
+// with '#' are ignored.
+
+static const char* snapshot_header = "# HotSpot profile snapshot 1";
+
+// Names longer than this are not saved.
+static const int max_name_length = 1024;
+static const int max_line_length = 3 * max_name_length + 64;
+
+class ProfileSnapshotEntry: public CHeapObj {
+ private:
+  char*                 _class_name;
+  unsigned int          _class_fingerprint;
+  char*                 _name;
+  char*                 _signature;
+  unsigned int          _method_fingerprint;
+  int                   _invocations;
+  int                   _backedges;
+  bool                  _compiled;
+  ProfileSnapshotEntry* _next;
+
+ public:
+  ProfileSnapshotEntry(const char* class_name, unsigned int class_fingerprint,
+                       const char* name, const char* signature,
+                       unsigned int method_fingerprint,
+                       int invocations, int backedges, bool compiled) :
+    _class_name(os::strdup(class_name)), _class_fingerprint(class_fingerprint),
+    _name(os::strdup(name)), _signature(os::strdup(signature)),
+    _method_fingerprint(method_fingerprint),
+    _invocations(invocations), _backedges(backedges), _compiled(compiled),
+    _next(NULL) { }
+
+  const char* class_name() const           { return _class_name; }
+  unsigned int class_fingerprint() const   { return _class_fingerprint; }
+  const char* name() const                 { return _name; }
+  const char* signature() const            { return _signature; }
+  unsigned int method_fingerprint() const  { return _method_fingerprint; }
+  int invocations() const                  { return _invocations; }
+  int backedges() const                    { return _backedges; }
+  bool compiled() const                    { return _compiled; }
+
+  ProfileSnapshotEntry* next() const       { return _next; }
+  void set_next(ProfileSnapshotEntry* e)   { _next = e; }
+};
+
+ProfileSnapshotEntry** ProfileSnapshot::_buckets     = NULL;
+int                    ProfileSnapshot::_entry_count = 0;
+
+static outputStream*   _snapshot_output = NULL;
+
+unsigned int ProfileSnapshot::name_hash(const char* name) {
+  unsigned int h = 0;
+  while (*name != '\0') {
+    h = 31*h + (unsigned int)(unsigned char)*name++;
+  }
+  return h;
+}
+
+// The fingerprints are computed on linked classes, whose methods have
+// been rewritten, both when the snapshot is written and when it is used.
+
+unsigned int ProfileSnapshot::class_fingerprint(instanceKlass* ik) {
+  unsigned int h = ik->access_flags().get_flags() & JVM_RECOGNIZED_CLASS_MODIFIERS;
+  h = 31*h + ik->methods()->length();
+  h = 31*h + ik->fields()->length();
+  h = 31*h + ik->local_interfaces()->length();
+  h = 31*h + ik->constants()->length();
+  if (ik->super() != NULL) {
+    ResourceMark rm;
+    h = 31*h + name_hash(Klass::cast(ik->super())->name()->as_C_string());
+  }
+  return h;
+}
+
+unsigned int ProfileSnapshot::method_fingerprint(methodOop m) {
+  unsigned int h = m->access_flags().get_flags() & JVM_RECOGNIZED_METHOD_MODIFIERS;
+  h = 31*h + m->code_size();
+  h = 31*h + m->max_stack();
+  h = 31*h + m->max_locals();
+  h = 31*h + m->size_of_parameters();
+  h = 31*h + m->exception_table()->length();
+  return h;
+}
+
+void ProfileSnapshot::add_entry(ProfileSnapshotEntry* e) {
+  ProfileSnapshotEntry** b = &_buckets[name_hash(e->class_name()) % bucket_count];
+  e->set_next(*b);
+  *b = e;
+  _entry_count++;
+}
+
+void ProfileSnapshot::read(const char* path) {
+  fileStream fs(path, "r");
+  if (!fs.is_open()) {
+    // There is no snapshot before the first run.
+    return;
+  }
+
+  ResourceMark rm;
+  char* line       = NEW_RESOURCE_ARRAY(char, max_line_length);
+  char* class_name = NEW_RESOURCE_ARRAY(char, max_line_length);
+  char* name       = NEW_RESOURCE_ARRAY(char, max_line_length);
+  char* signature  = NEW_RESOURCE_ARRAY(char, max_line_length);
+
+  if (fs.readln(line, max_line_length) == NULL ||
+      strcmp(line, snapshot_header) != 0) {
+    warning("Ignoring profile snapshot %s: unknown format", path);
+    return;
+  }
+
+  int ignored = 0;
+  while (fs.readln(line, max_line_length) != NULL) {
+    if (*line == '#' || *line == '\0') {
+      continue;
+    }
+    unsigned int class_fp, method_fp;
+    int invocations, backedges, compiled;
+    if (sscanf(line, "%s %x %s %s %x %d %d %d",
+               class_name, &class_fp, name, signature, &method_fp,
+               &invocations, &backedges, &compiled) != 8 ||
+        invocations < 0 || backedges < 0) {
+      ignored++;
+      continue;
+    }
+    add_entry(new ProfileSnapshotEntry(class_name, class_fp, name, signature,
+                                       method_fp, invocations, backedges,
+                                       compiled != 0));
+  }
+
+  if (PrintProfileSnapshot) {
+    tty->print_cr("[Profile snapshot %s: %d methods, %d malformed lines]",
+                  path, _entry_count, ignored);
+  }
+}
+
+void ProfileSnapshot::initialize() {
+  if (ProfileSnapshotFile == NULL) {
+    return;
+  }
+  _buckets = NEW_C_HEAP_ARRAY(ProfileSnapshotEntry*, bucket_count);
+  for (int i = 0; i < bucket_count; i++) {
+    _buckets[i] = NULL;
+  }
+  read(ProfileSnapshotFile);
+}
+
+void ProfileSnapshot::prime_method(methodOop m, ProfileSnapshotEntry* e) {
+  // The thresholds at which the method would be compiled.  With tiered
+  // compilation these lead to a profiling (tier 3) compilation, so that
+  // the profile used by the optimizing compiler is still collected in
+  // this run.  Without it the method is compiled once the sum of its
+  // counters reaches CompileThreshold, and an OSR compilation is
+  // requested once its backedge counter reaches the backward branch
+  // limit, so the sum has to stay below the former and the backedges
+  // below the latter.
+  jlong invocation_limit;
+  jlong backedge_limit;
+  jlong sum_limit;
+  if (TieredCompilation) {
+    invocation_limit = Tier3InvocationThreshold;
+    backedge_limit   = Tier3BackEdgeThreshold;
+    sum_limit        = Tier3CompileThreshold;
+  } else {
+    invocation_limit = CompileThreshold;
+    if (ProfileInterpreter) {
+      backedge_limit = ((jlong)CompileThreshold *
+                        (OnStackReplacePercentage - InterpreterProfilePercentage)) / 100;
+    } else {
+      backedge_limit = ((jlong)CompileThreshold * OnStackReplacePercentage) / 100;
+    }
+    sum_limit        = CompileThreshold;
+  }
+  invocation_limit = (invocation_limit * ProfileSnapshotPrimePercentage) / 100;
+  backedge_limit   = (backedge_limit * ProfileSnapshotPrimePercentage) / 100;
+  sum_limit        = (sum_limit * ProfileSnapshotPrimePercentage) / 100;
+
+  // Counters decay, so the counts of the methods which were compiled in
+  // the previous run may have dropped below the limits since.
+  jlong invocations = MIN2((jlong)e->invocations(), invocation_limit);
+  jlong backedges   = MIN2((jlong)e->backedges(), backedge_limit);
+  if (e->compiled()) {
+    invocations = invocation_limit;
+    if (e->backedges() > 0) {
+      backedges = backedge_limit;
+    }
+  }
+  backedges = MIN2(backedges, MAX2(backedge_limit - 1, (jlong)0));
+  if (invocations + backedges >= sum_limit) {
+    // Keep the ratio of the counts but bring their sum below the limit.
+    jlong target = MAX2(sum_limit - 1, (jlong)0);
+    jlong total  = invocations + backedges;
+    invocations  = (invocations * target) / total;
+    backedges    = (backedges * target) / total;
+  }
+
+  InvocationCounter* ic = m->invocation_counter();
+  if (invocations > ic->count()) {
+    ic->set(ic->state(), (int)invocations);
+  }
+  InvocationCounter* bc = m->backedge_counter();
+  if (backedges > bc->count()) {
+    bc->set(bc->state(), (int)backedges);
+  }
+
+  if (PrintProfileSnapshot) {
+    ResourceMark rm;
+    tty->print_cr("[Profile snapshot: primed %s (%d invocations, %d backedges)]",
+                  m->name_and_sig_as_C_string(), (int)invocations, (int)backedges);
+  }
+}
+
+void ProfileSnapshot::prime_class(instanceKlass* ik) {
+  if (_entry_count == 0) {
+    return;
+  }
+  ResourceMark rm;
+  const char* class_name = ik->name()->as_C_string();
+  ProfileSnapshotEntry* e = _buckets[name_hash(class_name) % bucket_count];
+  bool has_class_fingerprint = false;
+  unsigned int class_fp = 0;
+  for (; e != NULL; e = e->next()) {
+    if (strcmp(e->class_name(), class_name) != 0) {
+      continue;
+    }
+    if (!has_class_fingerprint) {
+      class_fp = class_fingerprint(ik);
+      has_class_fingerprint = true;
+    }
+    if (e->class_fingerprint() != class_fp) {
+      // The class has changed since the snapshot was written.
+      continue;
+    }
+    Symbol* name = SymbolTable::probe(e->name(), (int)strlen(e->name()));
+    Symbol* signature = SymbolTable::probe(e->signature(), (int)strlen(e->signature()));
+    if (name == NULL || signature == NULL) {
+      continue;
+    }
+    methodOop m = ik->find_method(name, signature);
+    if (m == NULL || method_fingerprint(m) != e->method_fingerprint()) {
+      continue;
+    }
+    prime_method(m, e);
+  }
+}
+
+void ProfileSnapshot::write_class(klassOop k) {
+  if (!Klass::cast(k)->oop_is_instance()) {
+    return;
+  }
+  instanceKlass* ik = instanceKlass::cast(k);
+  if (!ik->is_linked()) {
+    return;
+  }
+
+  ResourceMark rm;
+  const char* class_name = ik->name()->as_C_string();
+  if ((int)strlen(class_name) >= max_name_length) {
+    return;
+  }
+  unsigned int class_fp = class_fingerprint(ik);
+  objArrayOop methods = ik->methods();
+  for (int i = 0; i < methods->length(); i++) {
+    methodOop m = methodOop(methods->obj_at(i));
+    int invocations = m->invocation_count();
+    int backedges = m->backedge_count();
+    bool compiled = m->code() != NULL ||
+                    m->highest_comp_level() > CompLevel_none;
+    if (invocations == 0 && backedges == 0 && !compiled) {
+      continue;
+    }
+    const char* name = m->name()->as_C_string();
+    const char* signature = m->signature()->as_C_string();
+    if ((int)strlen(name) >= max_name_length ||
+        (int)strlen(signature) >= max_name_length) {
+      continue;
+    }
+    _snapshot_output->print_cr("%s %x %s %s %x %d %d %d",
+                               class_name, class_fp, name, signature,
+                               method_fingerprint(m),
+                               invocations, backedges, compiled ? 1 : 0);
+  }
+}
+
+void ProfileSnapshot::write() {
+  assert(DumpProfileSnapshot && ProfileSnapshotFile != NULL, "not requested");
+  fileStream fs(ProfileSnapshotFile, "w");
+  if (!fs.is_open()) {
+    warning("Cannot write profile snapshot %s", ProfileSnapshotFile);
+    return;
+  }
+  fs.print_cr("%s", snapshot_header);
+  _snapshot_output = &fs;
+  {
+    // Hold the SystemDictionary_lock so that classes are not added
+    // while the dictionary is walked.
+    MutexLocker sd(SystemDictionary_lock);
+    SystemDictionary::classes_do(&write_class);
+  }
+  _snapshot_output = NULL;
+  fs.flush();
+}
+
+void profileSnapshot_init() {
+  ProfileSnapshot::initialize();
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2011, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+#ifndef SHARE_VM_RUNTIME_PROFILESNAPSHOT_HPP
+#define SHARE_VM_RUNTIME_PROFILESNAPSHOT_HPP
+
+#include "memory/allocation.hpp"
+#include "oops/instanceKlass.hpp"
+#include "oops/methodOop.hpp"
+
+class ProfileSnapshotEntry;
+
+// A snapshot of the invocation and backedge counters of the methods which
+// were executed by a previous run of the VM.
+//
+// With ProfileSnapshotFile set, the snapshot is read at startup and, if
+// DumpProfileSnapshot is on, written back at exit.  When a class is linked
+// (or, for a class from the shared archive, loaded), the counters of its
+// methods which were hot in the snapshot are primed: they are raised to
+// ProfileSnapshotPrimePercentage of the thresholds at which the
+// compilation policy compiles them, and always kept below them, so no
+// method is compiled or OSR compiled before it has run.  Hot methods are then
+// profiled from their first invocations and compiled after a short
+// profiling period, rather than after minutes in the interpreter.  The
+// method data (type profiles, branch profiles) is not saved: it refers to
+// klasses of the previous run and is collected anew.
+//
+// Every entry carries a fingerprint of its class and of its method, so
+// entries of classes or methods which have changed since the snapshot was
+// written are ignored.
+
+class ProfileSnapshot : AllStatic {
+ private:
+  enum {
+    bucket_count = 1024
+  };
+
+  static ProfileSnapshotEntry** _buckets;
+  static int                    _entry_count;
+
+  static unsigned int name_hash(const char* name);
+  static unsigned int class_fingerprint(instanceKlass* ik);
+  static unsigned int method_fingerprint(methodOop m);
+
+  static void add_entry(ProfileSnapshotEntry* e);
+  static void read(const char* path);
+  static void prime_method(methodOop m, ProfileSnapshotEntry* e);
+  static void write_class(klassOop k);
+
+ public:
+  // Read the snapshot.  Called before any method is linked.
+  static void initialize();
+
+  // Prime the counters of the methods of ik from the snapshot.  Called
+  // when ik is linked, or when it is loaded from the shared archive,
+  // before any of its methods can run.
+  static void prime_class(instanceKlass* ik);
+
+  // Write the counters of all the loaded classes to ProfileSnapshotFile.
+  static void write();
+};
+
+#endif // SHARE_VM_RUNTIME_PROFILESNAPSHOT_HPP
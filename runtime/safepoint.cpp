@@ -23,6 +23,7 @@
  */
 
 #include "precompiled.hpp"
+#include "classfile/symbolTable.hpp"
 #include "classfile/systemDictionary.hpp"
 #include "code/codeCache.hpp"
 #include "code/icBuffer.hpp"
@@ -509,6 +510,17 @@ void SafepointSynchronize::do_cleanup_tasks() {
     CompilationPolicy::policy()->do_safepoint_work();
   }
 
+  {
+    TraceTime t5("resizing symbol and string tables", TraceSafepointCleanupTime);
+    SymbolTable::resize_if_needed();
+    StringTable::resize_if_needed();
+  }
+
+  if (SymbolTable::unlinks_incrementally()) {
+    TraceTime t6("unlinking symbols", TraceSafepointCleanupTime);
+    SymbolTable::unlink_incrementally();
+  }
+
   TraceTime t4("sweeping nmethods", TraceSafepointCleanupTime);
   NMethodSweeper::scan_stacks();
 }
@@ -712,6 +712,13 @@ static inline uint64_t cast_uint64_t(size_t x)
   /********************************/                                                                                                 \
                                                                                                                                      \
      static_field(CodeCache,                   _heap,                                         CodeHeap*)                             \
+     static_field(CodeCache,                   _heaps[0],                                     CodeHeap*)                             \
+     static_field(CodeCache,                   _heaps[1],                                     CodeHeap*)                             \
+     static_field(CodeCache,                   _heaps[2],                                     CodeHeap*)                             \
+     static_field(CodeCache,                   _heaps[3],                                     CodeHeap*)                             \
+     static_field(CodeCache,                   _number_of_heaps,                              int)                                   \
+     static_field(CodeCache,                   _low_bound,                                    address)                               \
+     static_field(CodeCache,                   _high_bound,                                   address)                               \
      static_field(CodeCache,                   _scavenge_root_nmethods,                       nmethod*)                              \
                                                                                                                                      \
   /*******************************/                                                                                                  \
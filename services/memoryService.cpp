@@ -64,7 +64,9 @@ GrowableArray<MemoryManager*>* MemoryService::_managers_list =
 
 GCMemoryManager* MemoryService::_minor_gc_manager = NULL;
 GCMemoryManager* MemoryService::_major_gc_manager = NULL;
-MemoryPool*      MemoryService::_code_heap_pool   = NULL;
+GrowableArray<MemoryPool*>* MemoryService::_code_heap_pools =
+  new (ResourceObj::C_HEAP) GrowableArray<MemoryPool*>(init_code_heap_pools_size, true);
+MemoryManager*   MemoryService::_code_cache_manager = NULL;
 
 class GcThreadCountClosure: public ThreadClosure {
  private:
@@ -489,15 +491,19 @@ void MemoryService::add_g1PermGen_memory_pool(G1CollectedHeap* g1h,
 }
 #endif // SERIALGC
 
-void MemoryService::add_code_heap_memory_pool(CodeHeap* heap) {
-  _code_heap_pool = new CodeHeapPool(heap,
-                                     "Code Cache",
-                                     true /* support_usage_threshold */);
-  MemoryManager* mgr = MemoryManager::get_code_cache_memory_manager();
-  mgr->add_pool(_code_heap_pool);
+void MemoryService::add_code_heap_memory_pool(CodeHeap* heap, const char* name) {
+  MemoryPool* code_heap_pool = new CodeHeapPool(heap,
+                                                name,
+                                                true /* support_usage_threshold */);
+  // All the CodeHeaps share the code cache memory manager
+  if (_code_cache_manager == NULL) {
+    _code_cache_manager = MemoryManager::get_code_cache_memory_manager();
+    _managers_list->append(_code_cache_manager);
+  }
+  _code_cache_manager->add_pool(code_heap_pool);
 
-  _pools_list->append(_code_heap_pool);
-  _managers_list->append(mgr);
+  _code_heap_pools->append(code_heap_pool);
+  _pools_list->append(code_heap_pool);
 }
 
 MemoryManager* MemoryService::get_memory_manager(instanceHandle mh) {
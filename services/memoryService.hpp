@@ -57,7 +57,8 @@ class MemoryService : public AllStatic {
 private:
   enum {
     init_pools_list_size = 10,
-    init_managers_list_size = 5
+    init_managers_list_size = 5,
+    init_code_heap_pools_size = 3
   };
 
   // index for minor and major generations
@@ -74,8 +75,10 @@ private:
   static GCMemoryManager*               _major_gc_manager;
   static GCMemoryManager*               _minor_gc_manager;
 
-  // Code heap memory pool
-  static MemoryPool*                    _code_heap_pool;
+  // Code heap memory pools, one per CodeHeap of the code cache, and
+  // their memory manager
+  static GrowableArray<MemoryPool*>*    _code_heap_pools;
+  static MemoryManager*                 _code_cache_manager;
 
   static void add_generation_memory_pool(Generation* gen,
                                          MemoryManager* major_mgr,
@@ -132,7 +135,7 @@ private:
 
 public:
   static void set_universe_heap(CollectedHeap* heap);
-  static void add_code_heap_memory_pool(CodeHeap* heap);
+  static void add_code_heap_memory_pool(CodeHeap* heap, const char* name);
 
   static MemoryPool*    get_memory_pool(instanceHandle pool);
   static MemoryManager* get_memory_manager(instanceHandle mgr);
@@ -154,7 +157,9 @@ public:
 
   static void track_memory_usage();
   static void track_code_cache_memory_usage() {
-    track_memory_pool_usage(_code_heap_pool);
+    for (int i = 0; i < _code_heap_pools->length(); i++) {
+      track_memory_pool_usage(_code_heap_pools->at(i));
+    }
   }
   static void track_memory_pool_usage(MemoryPool* pool);
 
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Compare the AES intrinsics with a pure-Java AES
+ * @run main/othervm -Xbatch -XX:+UseAES -XX:+UseAESIntrinsics TestAESIntrinsics
+ */
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.List;
+import java.util.Random;
+import javax.crypto.Cipher;
+import javax.crypto.spec.IvParameterSpec;
+import javax.crypto.spec.SecretKeySpec;
+
+/*
+ * Encrypts and decrypts with the SunJCE AES, whose AESCrypt and
+ * CipherBlockChaining methods are intrinsified, often enough for them to
+ * be compiled, and compares every result with a straightforward FIPS-197
+ * implementation.  Inputs and outputs start at unaligned offsets, the
+ * lengths are around the block size, and CBC is run with enough blocks to
+ * go through the 4 block loop of the decryption stub and its remainder.
+ */
+public class TestAESIntrinsics {
+  static final int ITERS = 2000;
+
+  // Lengths for the padding modes, and for the modes without padding.
+  static final int[] PAD_LENGTHS   = { 0, 1, 15, 16, 17, 63, 64, 65, 80 };
+  static final int[] NOPAD_LENGTHS = { 0, 16, 32, 48, 64, 80, 112, 128, 144 };
+
+  // Pairs of input and output offsets.
+  static final int[][] OFFSETS = { {0, 0}, {1, 0}, {0, 1}, {3, 7}, {7, 3} };
+
+  public static void main(String[] args) throws Exception {
+    RefAES.selfTest();
+
+    Random r = new Random(20120910);
+    byte[] data = new byte[160];
+    r.nextBytes(data);
+    byte[] ivBytes = new byte[16];
+    r.nextBytes(ivBytes);
+
+    int maxKeyBits = Cipher.getMaxAllowedKeyLength("AES");
+    List<Case> cases = new ArrayList<Case>();
+    for (int keyBits = 128; keyBits <= 256; keyBits += 64) {
+      if (keyBits > maxKeyBits) {
+        System.out.println("Skipping " + keyBits + " bit keys, not allowed by the JCE policy");
+        continue;
+      }
+      byte[] keyBytes = new byte[keyBits / 8];
+      r.nextBytes(keyBytes);
+      for (String mode : new String[] { "ECB", "CBC" }) {
+        for (String padding : new String[] { "NoPadding", "PKCS5Padding" }) {
+          int[] lengths = padding.equals("NoPadding") ? NOPAD_LENGTHS : PAD_LENGTHS;
+          for (int len : lengths) {
+            for (int[] off : OFFSETS) {
+              cases.add(new Case(mode, padding, keyBytes, ivBytes,
+                                 Arrays.copyOf(data, len), off[0], off[1]));
+            }
+          }
+        }
+      }
+    }
+
+    for (int i = 0; i < ITERS; i++) {
+      for (Case c : cases) {
+        c.run();
+      }
+    }
+    System.out.println("PASSED: " + cases.size() + " cases");
+  }
+
+  static final class Case {
+    final String name;
+    final Cipher enc;
+    final Cipher dec;
+    final SecretKeySpec key;
+    final IvParameterSpec iv;
+    final byte[] plain;
+    final byte[] cipher;
+    final int inOff;
+    final int outOff;
+
+    Case(String mode, String padding, byte[] keyBytes, byte[] ivBytes,
+         byte[] plain, int inOff, int outOff) throws Exception {
+      String transformation = "AES/" + mode + "/" + padding;
+      this.name = transformation + " key " + (keyBytes.length * 8) +
+                  " len " + plain.length + " offsets " + inOff + "/" + outOff;
+      this.enc = Cipher.getInstance(transformation, "SunJCE");
+      this.dec = Cipher.getInstance(transformation, "SunJCE");
+      this.key = new SecretKeySpec(keyBytes, "AES");
+      this.iv = mode.equals("CBC") ? new IvParameterSpec(ivBytes) : null;
+      this.plain = plain;
+      this.inOff = inOff;
+      this.outOff = outOff;
+
+      byte[] padded = plain;
+      if (padding.equals("PKCS5Padding")) {
+        int pad = 16 - plain.length % 16;
+        padded = Arrays.copyOf(plain, plain.length + pad);
+        Arrays.fill(padded, plain.length, padded.length, (byte)pad);
+      }
+      this.cipher = new RefAES(keyBytes).encrypt(padded, iv == null ? null : ivBytes);
+    }
+
+    void init(Cipher c, int opmode) throws Exception {
+      if (iv == null) {
+        c.init(opmode, key);
+      } else {
+        c.init(opmode, key, iv);
+      }
+    }
+
+    void run() throws Exception {
+      byte[] in = new byte[inOff + plain.length];
+      System.arraycopy(plain, 0, in, inOff, plain.length);
+      byte[] out = new byte[outOff + cipher.length];
+      init(enc, Cipher.ENCRYPT_MODE);
+      int n = enc.doFinal(in, inOff, plain.length, out, outOff);
+      compare("encrypt", cipher, out, outOff, n);
+
+      in = new byte[inOff + cipher.length];
+      System.arraycopy(cipher, 0, in, inOff, cipher.length);
+      out = new byte[outOff + cipher.length];
+      init(dec, Cipher.DECRYPT_MODE);
+      n = dec.doFinal(in, inOff, cipher.length, out, outOff);
+      compare("decrypt", plain, out, outOff, n);
+
+      // The decryption stub must read each cipher block before it stores
+      // over it.
+      init(dec, Cipher.DECRYPT_MODE);
+      n = dec.doFinal(in, inOff, cipher.length, in, inOff);
+      compare("decrypt in place", plain, in, inOff, n);
+    }
+
+    void compare(String what, byte[] expected, byte[] actual, int off, int n) {
+      if (n != expected.length) {
+        throw new RuntimeException(name + ": " + what + " returned " + n +
+                                   " bytes, expected " + expected.length);
+      }
+      for (int i = 0; i < n; i++) {
+        if (actual[off + i] != expected[i]) {
+          throw new RuntimeException(name + ": " + what + " differs at byte " + i);
+        }
+      }
+    }
+  }
+
+  // AES as specified in FIPS-197, with ECB and CBC on top of it.
+  static final class RefAES {
+    static final int[] SBOX = new int[256];
+    static final int[] INV_SBOX = new int[256];
+    static final int[] MIX = { 2, 3, 1, 1 };
+    static final int[] INV_MIX = { 14, 11, 13, 9 };
+
+    static {
+      // p runs through the powers of 3 in GF(2^8) and q through the
+      // powers of its inverse, so q is the multiplicative inverse of p.
+      int p = 1;
+      int q = 1;
+      do {
+        p ^= xtime(p);
+        q ^= q << 1;
+        q ^= q << 2;
+        q ^= q << 4;
+        q &= 0xff;
+        if ((q & 0x80) != 0) {
+          q ^= 0x09;
+        }
+        int x = q ^ rotl8(q, 1) ^ rotl8(q, 2) ^ rotl8(q, 3) ^ rotl8(q, 4) ^ 0x63;
+        SBOX[p] = x;
+        INV_SBOX[x] = p;
+      } while (p != 1);
+      SBOX[0] = 0x63;
+      INV_SBOX[0x63] = 0;
+    }
+
+    static int xtime(int b) {
+      return ((b << 1) ^ ((b & 0x80) != 0 ? 0x1b : 0)) & 0xff;
+    }
+
+    static int rotl8(int b, int s) {
+      return ((b << s) | (b >>> (8 - s))) & 0xff;
+    }
+
+    static int mul(int a, int b) {
+      int r = 0;
+      while (b != 0) {
+        if ((b & 1) != 0) {
+          r ^= a;
+        }
+        a = xtime(a);
+        b >>>= 1;
+      }
+      return r;
+    }
+
+    static int subWord(int w) {
+      return (SBOX[w >>> 24] << 24) | (SBOX[(w >>> 16) & 0xff] << 16) |
+             (SBOX[(w >>> 8) & 0xff] << 8) | SBOX[w & 0xff];
+    }
+
+    final int rounds;
+    final int[] w;
+
+    RefAES(byte[] key) {
+      int nk = key.length / 4;
+      rounds = nk + 6;
+      w = new int[4 * (rounds + 1)];
+      for (int i = 0; i < nk; i++) {
+        w[i] = ((key[4 * i] & 0xff) << 24) | ((key[4 * i + 1] & 0xff) << 16) |
+               ((key[4 * i + 2] & 0xff) << 8) | (key[4 * i + 3] & 0xff);
+      }
+      int rcon = 1;
+      for (int i = nk; i < w.length; i++) {
+        int t = w[i - 1];
+        if (i % nk == 0) {
+          t = subWord((t << 8) | (t >>> 24)) ^ (rcon << 24);
+          rcon = xtime(rcon);
+        } else if (nk > 6 && i % nk == 4) {
+          t = subWord(t);
+        }
+        w[i] = w[i - nk] ^ t;
+      }
+    }
+
+    // The state is kept column by column, s[row + 4 * column].
+    void addRoundKey(int[] s, int round) {
+      for (int c = 0; c < 4; c++) {
+        int k = w[4 * round + c];
+        s[4 * c]     ^= k >>> 24;
+        s[4 * c + 1] ^= (k >>> 16) & 0xff;
+        s[4 * c + 2] ^= (k >>> 8) & 0xff;
+        s[4 * c + 3] ^= k & 0xff;
+      }
+    }
+
+    static void subBytes(int[] s, int[] box) {
+      for (int i = 0; i < 16; i++) {
+        s[i] = box[s[i]];
+      }
+    }
+
+    static int[] shiftRows(int[] s, boolean inverse) {
+      int[] t = new int[16];
+      for (int r = 0; r < 4; r++) {
+        for (int c = 0; c < 4; c++) {
+          if (inverse) {
+            t[r + 4 * ((c + r) % 4)] = s[r + 4 * c];
+          } else {
+            t[r + 4 * c] = s[r + 4 * ((c + r) % 4)];
+          }
+        }
+      }
+      return t;
+    }
+
+    static void mixColumns(int[] s, int[] m) {
+      for (int c = 0; c < 4; c++) {
+        int[] a = { s[4 * c], s[4 * c + 1], s[4 * c + 2], s[4 * c + 3] };
+        for (int r = 0; r < 4; r++) {
+          int b = 0;
+          for (int j = 0; j < 4; j++) {
+            b ^= mul(m[(j - r + 4) % 4], a[j]);
+          }
+          s[4 * c + r] = b;
+        }
+      }
+    }
+
+    byte[] encryptBlock(byte[] in, int off) {
+      int[] s = new int[16];
+      for (int i = 0; i < 16; i++) {
+        s[i] = in[off + i] & 0xff;
+      }
+      addRoundKey(s, 0);
+      for (int round = 1; round < rounds; round++) {
+        subBytes(s, SBOX);
+        s = shiftRows(s, false);
+        mixColumns(s, MIX);
+        addRoundKey(s, round);
+      }
+      subBytes(s, SBOX);
+      s = shiftRows(s, false);
+      addRoundKey(s, rounds);
+      byte[] out = new byte[16];
+      for (int i = 0; i < 16; i++) {
+        out[i] = (byte)s[i];
+      }
+      return out;
+    }
+
+    byte[] decryptBlock(byte[] in, int off) {
+      int[] s = new int[16];
+      for (int i = 0; i < 16; i++) {
+        s[i] = in[off + i] & 0xff;
+      }
+      addRoundKey(s, rounds);
+      for (int round = rounds - 1; round >= 1; round--) {
+        s = shiftRows(s, true);
+        subBytes(s, INV_SBOX);
+        addRoundKey(s, round);
+        mixColumns(s, INV_MIX);
+      }
+      s = shiftRows(s, true);
+      subBytes(s, INV_SBOX);
+      addRoundKey(s, 0);
+      byte[] out = new byte[16];
+      for (int i = 0; i < 16; i++) {
+        out[i] = (byte)s[i];
+      }
+      return out;
+    }
+
+    // ECB if iv is null, CBC otherwise.  The length must be a multiple
+    // of the block size.
+    byte[] encrypt(byte[] plain, byte[] iv) {
+      byte[] out = new byte[plain.length];
+      byte[] prev = iv;
+      for (int off = 0; off < plain.length; off += 16) {
+        byte[] block = Arrays.copyOfRange(plain, off, off + 16);
+        if (prev != null) {
+          for (int i = 0; i < 16; i++) {
+            block[i] ^= prev[i];
+          }
+        }
+        byte[] c = encryptBlock(block, 0);
+        System.arraycopy(c, 0, out, off, 16);
+        if (prev != null) {
+          prev = c;
+        }
+      }
+      return out;
+    }
+
+    // Known answers from appendix C of FIPS-197.
+    static void selfTest() {
+      byte[] plain = hex("00112233445566778899aabbccddeeff");
+      String[] expected = { "69c4e0d86a7b0430d8cdb78070b4c55a",
+                            "dda97ca4864cdfe06eaf70a0ec0d7191",
+                            "8ea2b7ca516745bfeafc49904b496089" };
+      for (int k = 0; k < 3; k++) {
+        byte[] key = new byte[16 + 8 * k];
+        for (int i = 0; i < key.length; i++) {
+          key[i] = (byte)i;
+        }
+        RefAES aes = new RefAES(key);
+        byte[] c = aes.encryptBlock(plain, 0);
+        if (!Arrays.equals(c, hex(expected[k])) ||
+            !Arrays.equals(aes.decryptBlock(c, 0), plain)) {
+          throw new RuntimeException("reference AES is broken for " + (key.length * 8) + " bit keys");
+        }
+      }
+    }
+
+    static byte[] hex(String s) {
+      byte[] b = new byte[s.length() / 2];
+      for (int i = 0; i < b.length; i++) {
+        b[i] = (byte)Integer.parseInt(s.substring(2 * i, 2 * i + 2), 16);
+      }
+      return b;
+    }
+  }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * @test
+ * @summary Compare the CRC32 intrinsics with a pure-Java CRC32
+ * @run main/othervm -Xbatch -XX:+UseCLMUL -XX:+UseCRC32Intrinsics TestCRC32Intrinsics
+ */
+
+import java.util.Random;
+import java.util.zip.CRC32;
+
+/*
+ * Computes checksums with java.util.zip.CRC32, whose update methods are
+ * intrinsified in the interpreter and by C2, often enough for the callers
+ * to be compiled, and compares them with a table driven CRC32.  The data
+ * starts at unaligned offsets, and the lengths are around the 16 byte
+ * and 64 byte steps of the stub.
+ */
+public class TestCRC32Intrinsics {
+  static final int ITERS = 2000;
+
+  static final int[] LENGTHS = { 0, 1, 15, 16, 17, 63, 64, 65, 127, 128, 129,
+                                 1023, 1024, 1025, 4099 };
+  static final int[] OFFSETS = { 0, 1, 3, 7 };
+
+  static final int[] TABLE = new int[256];
+
+  static {
+    for (int n = 0; n < 256; n++) {
+      int c = n;
+      for (int k = 0; k < 8; k++) {
+        c = (c & 1) != 0 ? 0xedb88320 ^ (c >>> 1) : c >>> 1;
+      }
+      TABLE[n] = c;
+    }
+  }
+
+  static int refUpdate(int crc, byte[] b, int off, int len) {
+    crc = ~crc;
+    for (int i = off; i < off + len; i++) {
+      crc = TABLE[(crc ^ b[i]) & 0xff] ^ (crc >>> 8);
+    }
+    return ~crc;
+  }
+
+  public static void main(String[] args) {
+    byte[] check = "123456789".getBytes();
+    if (refUpdate(0, check, 0, check.length) != 0xcbf43926) {
+      throw new RuntimeException("reference CRC32 is broken");
+    }
+
+    Random r = new Random(20120910);
+    byte[] data = new byte[4099 + 7];
+    r.nextBytes(data);
+
+    // The expected checksums of one update, and of the same data twice.
+    long[][] once = new long[LENGTHS.length][OFFSETS.length];
+    long[][] twice = new long[LENGTHS.length][OFFSETS.length];
+    for (int l = 0; l < LENGTHS.length; l++) {
+      for (int o = 0; o < OFFSETS.length; o++) {
+        int crc = refUpdate(0, data, OFFSETS[o], LENGTHS[l]);
+        once[l][o] = crc & 0xffffffffL;
+        twice[l][o] = refUpdate(crc, data, OFFSETS[o], LENGTHS[l]) & 0xffffffffL;
+      }
+    }
+
+    for (int i = 0; i < ITERS; i++) {
+      for (int l = 0; l < LENGTHS.length; l++) {
+        for (int o = 0; o < OFFSETS.length; o++) {
+          int len = LENGTHS[l];
+          int off = OFFSETS[o];
+          CRC32 crc = new CRC32();
+          crc.update(data, off, len);
+          compare("update(byte[])", len, off, once[l][o], crc.getValue());
+          crc.update(data, off, len);
+          compare("update(byte[]) twice", len, off, twice[l][o], crc.getValue());
+
+          if (len <= 129) {
+            crc.reset();
+            for (int k = off; k < off + len; k++) {
+              crc.update(data[k]);
+            }
+            compare("update(int)", len, off, once[l][o], crc.getValue());
+          }
+        }
+      }
+    }
+    System.out.println("PASSED");
+  }
+
+  static void compare(String what, int len, int off, long expected, long actual) {
+    if (expected != actual) {
+      throw new RuntimeException(what + " len " + len + " offset " + off +
+                                 ": got " + Long.toHexString(actual) +
+                                 ", expected " + Long.toHexString(expected));
+    }
+  }
+}
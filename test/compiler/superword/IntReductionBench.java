@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2012, Oracle and/or its affiliates. All rights reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER.
+ *
+ * This code is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 only, as
+ * published by the Free Software Foundation.
+ *
+ * This code is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+ * version 2 for more details (a copy is included in the LICENSE file that
+ * accompanied this code).
+ *
+ * You should have received a copy of the GNU General Public License version
+ * 2 along with this work; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1301 USA.
+ *
+ * Please contact Oracle, 500 Oracle Parkway, Redwood Shores, CA 94065 USA
+ * or visit www.oracle.com if you need additional information or have any
+ * questions.
+ *
+ */
+
+/*
+ * Microbenchmark of the integer reductions vectorized by SuperWord:
+ * sum, dot product, and, or and xor over int arrays.
+ *
+ * Run it with and without the reductions and compare the times:
+ *
+ *   java -XX:-SuperWordReductions IntReductionBench
+ *   java -XX:+SuperWordReductions IntReductionBench
+ *
+ * Every kernel is checked against a reference loop which accumulates in a
+ * long, which is not reduced, so a wrong reduction fails the run.
+ */
+public class IntReductionBench {
+  static final int ARRLEN = 997;
+  static final int ITERS  = 200000;
+  static final int WARMUP = 20000;
+
+  static int sum(int[] a) {
+    int s = 0;
+    for (int i = 0; i < a.length; i++) {
+      s += a[i];
+    }
+    return s;
+  }
+
+  static int dot(int[] a, int[] b) {
+    int s = 0;
+    for (int i = 0; i < a.length; i++) {
+      s += a[i] * b[i];
+    }
+    return s;
+  }
+
+  static int and(int[] a) {
+    int s = -1;
+    for (int i = 0; i < a.length; i++) {
+      s &= a[i];
+    }
+    return s;
+  }
+
+  static int or(int[] a) {
+    int s = 0;
+    for (int i = 0; i < a.length; i++) {
+      s |= a[i];
+    }
+    return s;
+  }
+
+  static int xor(int[] a) {
+    int s = 0;
+    for (int i = 0; i < a.length; i++) {
+      s ^= a[i];
+    }
+    return s;
+  }
+
+  // The reference results.  The low 32 bits of the long accumulator are
+  // the int result.
+  static int ref(int kernel, int[] a, int[] b) {
+    long s = (kernel == 2) ? -1 : 0;
+    for (int i = 0; i < a.length; i++) {
+      switch (kernel) {
+      case 0: s += a[i];               break;
+      case 1: s += (long)a[i] * b[i];  break;
+      case 2: s &= a[i];               break;
+      case 3: s |= a[i];               break;
+      case 4: s ^= a[i];               break;
+      }
+    }
+    return (int)s;
+  }
+
+  static int run(int kernel, int[] a, int[] b) {
+    switch (kernel) {
+    case 0: return sum(a);
+    case 1: return dot(a, b);
+    case 2: return and(a);
+    case 3: return or(a);
+    case 4: return xor(a);
+    }
+    throw new InternalError();
+  }
+
+  public static void main(String[] args) {
+    String[] names = { "sum", "dot", "and", "or", "xor" };
+    int[] a = new int[ARRLEN];
+    int[] b = new int[ARRLEN];
+    for (int i = 0; i < ARRLEN; i++) {
+      a[i] = (i * 0x9E3779B9) | 0x10001;
+      b[i] = i - ARRLEN / 2;
+    }
+
+    boolean failed = false;
+    for (int k = 0; k < names.length; k++) {
+      int expected = ref(k, a, b);
+      for (int i = 0; i < WARMUP; i++) {
+        if (run(k, a, b) != expected) {
+          System.out.println(names[k] + ": wrong result during warmup");
+          failed = true;
+          break;
+        }
+      }
+      int r = 0;
+      long start = System.nanoTime();
+      for (int i = 0; i < ITERS; i++) {
+        r = run(k, a, b);
+      }
+      long end = System.nanoTime();
+      if (r != expected) {
+        System.out.println(names[k] + ": wrong result " + r + ", expected " + expected);
+        failed = true;
+      }
+      System.out.println(names[k] + ": " + (end - start) / ITERS + " ns/op");
+    }
+    if (failed) {
+      throw new RuntimeException("reduction results are wrong");
+    }
+  }
+}
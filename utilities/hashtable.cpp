@@ -26,6 +26,7 @@
 #include "memory/allocation.inline.hpp"
 #include "memory/resourceArea.hpp"
 #include "oops/oop.inline.hpp"
+#include "runtime/atomic.hpp"
 #include "runtime/safepoint.hpp"
 #include "utilities/dtrace.hpp"
 #include "utilities/hashtable.hpp"
@@ -38,7 +39,8 @@ HS_DTRACE_PROBE_DECL4(hs_private, hashtable__new_entry,
 // This is a generic hashtable, designed to be used for the symbol
 // and string tables.
 //
-// It is implemented as an open hash table with a fixed number of buckets.
+// It is implemented as an open hash table.  The number of buckets is only
+// changed by resize().
 //
 // %note:
 //  - HashtableEntrys are allocated in blocks to reduce the space overhead.
@@ -68,6 +70,18 @@ BasicHashtableEntry* BasicHashtable::new_entry(unsigned int hashValue) {
 }
 
 
+void BasicHashtable::bulk_free_entries(BasicHashtableEntry* first,
+                                       BasicHashtableEntry* last, int n) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  BasicHashtableEntry* old;
+  do {
+    old = _free_list;
+    last->set_next(old);
+  } while (Atomic::cmpxchg_ptr(first, &_free_list, old) != old);
+  Atomic::add(-n, (volatile jint*)&_number_of_entries);
+}
+
+
 template <class T> HashtableEntry<T>* Hashtable<T>::new_entry(unsigned int hashValue, T obj) {
   HashtableEntry<T>* entry;
 
@@ -97,6 +111,49 @@ void BasicHashtable::reverse() {
 }
 
 
+// Relink the entries into a new array of buckets.  The hash values are
+// kept in the entries, so the literals are not looked at.
+
+void BasicHashtable::resize(int new_size) {
+  assert(SafepointSynchronize::is_at_safepoint(), "must be at safepoint");
+  assert(new_size > 0, "invalid table size");
+
+  HashtableBucket* new_buckets = NEW_C_HEAP_ARRAY(HashtableBucket, new_size);
+  for (int index = 0; index < new_size; index++) {
+    new_buckets[index].clear();
+  }
+
+  for (int i = 0; i < _table_size; ++i) {
+    BasicHashtableEntry* p = bucket(i);
+    while (p != NULL) {
+      assert(!p->is_shared(), "shared entries cannot be relinked");
+      BasicHashtableEntry* next = p->next();
+      int index = p->hash() % new_size;
+      p->set_next(*new_buckets[index].entry_addr());
+      *new_buckets[index].entry_addr() = p;
+      p = next;
+    }
+  }
+
+  FREE_C_HEAP_ARRAY(HashtableBucket, _buckets);
+  _buckets = new_buckets;
+  _table_size = new_size;
+}
+
+
+int BasicHashtable::max_chain_length() {
+  int max_length = 0;
+  for (int i = 0; i < _table_size; ++i) {
+    int length = 0;
+    for (BasicHashtableEntry* p = bucket(i); p != NULL; p = p->next()) {
+      ++length;
+    }
+    max_length = MAX2(max_length, length);
+  }
+  return max_length;
+}
+
+
 // Copy the table to the shared space.
 
 void BasicHashtable::copy_table(char** top, char* end) {
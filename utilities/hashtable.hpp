@@ -33,7 +33,8 @@
 // This is a generic hashtable, designed to be used for the symbol
 // and string tables.
 //
-// It is implemented as an open hash table with a fixed number of buckets.
+// It is implemented as an open hash table.  The number of buckets is only
+// changed by resize().
 //
 // %note:
 //  - TableEntrys are allocated in blocks to reduce the space overhead.
@@ -183,7 +184,6 @@ protected:
 
   // Accessor
   int entry_size() const { return _entry_size; }
-  int table_size() { return _table_size; }
 
   // The following method is MT-safe and may be used with caution.
   BasicHashtableEntry* bucket(int i);
@@ -201,7 +201,22 @@ public:
 
   void free_entry(BasicHashtableEntry* entry);
 
+  // Return the n entries chained from first to last to the free list.
+  // MT-safe with respect to other calls of this method, so that the
+  // buckets of a table can be unlinked by several threads at a safepoint.
+  void bulk_free_entries(BasicHashtableEntry* first, BasicHashtableEntry* last,
+                         int n);
+
   int number_of_entries() { return _number_of_entries; }
+  int table_size() { return _table_size; }
+
+  // Move all the entries into a new array of new_size buckets.  Readers
+  // of the table are unlocked, so this is only done at a safepoint, and
+  // never for a table whose entries are shared.
+  void resize(int new_size);
+
+  // Length of the longest bucket chain.
+  int max_chain_length();
 
   void verify() PRODUCT_RETURN;
 };
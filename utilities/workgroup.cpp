@@ -50,6 +50,7 @@ AbstractWorkGang::AbstractWorkGang(const char* name,
   _sequence_number = 0;
   _started_workers = 0;
   _finished_workers = 0;
+  _task_workers = 0;
 }
 
 WorkGang::WorkGang(const char* name,
@@ -127,6 +128,10 @@ GangWorker* AbstractWorkGang::gang_worker(int i) const {
 }
 
 void WorkGang::run_task(AbstractGangTask* task) {
+  run_task(task, (uint) total_workers());
+}
+
+void WorkGang::run_task(AbstractGangTask* task, uint no_of_parallel_workers) {
   // This thread is executed by the VM thread which does not block
   // on ordinary MutexLocker's.
   MutexLockerEx ml(monitor(), Mutex::_no_safepoint_check_flag);
@@ -135,18 +140,22 @@ void WorkGang::run_task(AbstractGangTask* task) {
   }
   // Tell all the workers to run a task.
   assert(task != NULL, "Running a null task");
+  assert(no_of_parallel_workers > 0 &&
+         (int) no_of_parallel_workers <= total_workers(),
+         "Number of workers out of range");
   // Initialize.
   _task = task;
   _sequence_number += 1;
   _started_workers = 0;
   _finished_workers = 0;
+  _task_workers = (int) no_of_parallel_workers;
   // Tell the workers to get to work.
   monitor()->notify_all();
   // Wait for them to be finished
-  while (finished_workers() < total_workers()) {
+  while (finished_workers() < _task_workers) {
     if (TraceWorkGang) {
       tty->print_cr("Waiting in work gang %s: %d/%d finished sequence %d",
-                    name(), finished_workers(), total_workers(),
+                    name(), finished_workers(), _task_workers,
                     _sequence_number);
     }
     monitor()->wait(/* no_safepoint_check */ true);
@@ -154,7 +163,7 @@ void WorkGang::run_task(AbstractGangTask* task) {
   _task = NULL;
   if (TraceWorkGang) {
     tty->print_cr("/nFinished work gang %s: %d/%d sequence %d",
-                  name(), finished_workers(), total_workers(),
+                  name(), finished_workers(), _task_workers,
                   _sequence_number);
   }
 }
@@ -275,10 +284,15 @@ void GangWorker::loop() {
         // Check for new work.
         if ((data.task() != NULL) &&
             (data.sequence_number() != previous_sequence_number)) {
-          gang()->internal_note_start();
-          gang_monitor->notify_all();
-          part = gang()->started_workers() - 1;
-          break;
+          if (gang()->needs_more_workers()) {
+            gang()->internal_note_start();
+            gang_monitor->notify_all();
+            part = gang()->started_workers() - 1;
+            break;
+          }
+          // The task runs on fewer workers than the gang has, and
+          // enough of them have started it.
+          previous_sequence_number = data.sequence_number();
         }
         // Nothing to do.
         gang_monitor->wait(/* no_safepoint_check */ true);
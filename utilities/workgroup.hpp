@@ -154,6 +154,8 @@ protected:
   int _started_workers;
   // The number of finished workers.
   int _finished_workers;
+  // The number of workers which run the current task.
+  int _task_workers;
 public:
   // Accessors for fields
   Monitor* monitor() const {
@@ -183,6 +185,10 @@ public:
   int finished_workers() const {
     return _finished_workers;
   }
+  // True if the current task is still to be started by some worker.
+  bool needs_more_workers() const {
+    return _started_workers < _task_workers;
+  }
   bool are_GC_task_threads() const {
     return _are_GC_task_threads;
   }
@@ -248,8 +254,11 @@ public:
   // Constructor
   WorkGang(const char* name, int workers,
            bool are_GC_task_threads, bool are_ConcurrentGC_threads);
-  // Run a task, returns when the task is done (or terminated).
+  // Run a task on all the workers, returns when the task is done (or
+  // terminated).
   virtual void run_task(AbstractGangTask* task);
+  // Run a task on the first no_of_parallel_workers to start; the other
+  // workers sit it out.  The task must be set up for that many workers.
   void run_task(AbstractGangTask* task, uint no_of_parallel_workers);
   // Allocate a worker and return a pointer to it.
   virtual GangWorker* allocate_worker(int which);
@@ -284,6 +293,11 @@ public:
   AbstractWorkGang* gang() const { return _gang; }
 };
 
+// A gang whose users may run their tasks on fewer workers than it has.
+// active_workers() is the number chosen for the latest pause or phase
+// (see AdaptiveSizePolicy::calc_active_workers()); tasks sized by it are
+// run with run_task(task, active_workers()).  run_task(task) still runs
+// all the workers.
 class FlexibleWorkGang: public WorkGang {
  protected:
   int _active_workers;
@@ -293,11 +307,14 @@ class FlexibleWorkGang: public WorkGang {
                    bool are_GC_task_threads,
                    bool  are_ConcurrentGC_threads) :
     WorkGang(name, workers, are_GC_task_threads, are_ConcurrentGC_threads) {
-    _active_workers = ParallelGCThreads;
+    _active_workers = workers;
   };
   // Accessors for fields
   virtual int active_workers() const { return _active_workers; }
-  void set_active_workers(int v) { _active_workers = v; }
+  void set_active_workers(int v) {
+    assert(v > 0 && v <= total_workers(), "Active workers out of range");
+    _active_workers = v;
+  }
 };
 
 // Work gangs in garbage collectors: 2009-06-10
@@ -35,7 +35,7 @@ class WorkData;
 YieldingFlexibleWorkGang::YieldingFlexibleWorkGang(
   const char* name, int workers, bool are_GC_task_threads) :
   FlexibleWorkGang(name, workers, are_GC_task_threads, false),
-    _yielded_workers(0) {}
+    _active_workers(workers), _yielded_workers(0) {}
 
 GangWorker* YieldingFlexibleWorkGang::allocate_worker(int which) {
   YieldingFlexibleGangWorker* new_member =
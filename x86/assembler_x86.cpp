@@ -270,6 +270,99 @@ void Assembler::emit_arith(int op1, int op2, Register dst, Register src) {
 }
 
 
+// VEX prefix: the 2 byte form is used when neither VEX.X, VEX.B nor
+// VEX.W is needed and the opcode is in the 0x0F map.  VEX.L is left
+// clear: C2 vectors are at most 128 bits wide.
+void Assembler::vex_prefix(bool vex_r, bool vex_b, bool vex_x, bool vex_w,
+                           int nds_enc, VexSimdPrefix pre, VexOpcode opc) {
+  if (vex_b || vex_x || vex_w || (opc == VEX_OPCODE_0F_38) || (opc == VEX_OPCODE_0F_3A)) {
+    emit_byte(VEX_3bytes);
+
+    int byte1 = (vex_r ? VEX_R : 0) | (vex_x ? VEX_X : 0) | (vex_b ? VEX_B : 0);
+    byte1 = (~byte1) & 0xE0;
+    byte1 |= opc;
+    emit_byte(byte1);
+
+    int byte2 = ((~nds_enc) & 0xf) << 3;
+    byte2 |= (vex_w ? VEX_W : 0) | pre;
+    emit_byte(byte2);
+  } else {
+    emit_byte(VEX_2bytes);
+
+    int byte1 = vex_r ? VEX_R : 0;
+    byte1 = (~byte1) & 0x80;
+    byte1 |= ((~nds_enc) & 0xf) << 3;
+    byte1 |= pre;
+    emit_byte(byte1);
+  }
+}
+
+
+int Assembler::vex_prefix_and_encode(int dst_enc, int nds_enc, int src_enc,
+                                     VexSimdPrefix pre, VexOpcode opc,
+                                     bool vex_w) {
+  bool vex_r = (dst_enc >= 8);
+  bool vex_b = (src_enc >= 8);
+  bool vex_x = false;
+  vex_prefix(vex_r, vex_b, vex_x, vex_w, nds_enc, pre, opc);
+  return (((dst_enc & 7) << 3) | (src_enc & 7));
+}
+
+
+void Assembler::emit_simd_arith(int opcode, XMMRegister dst, XMMRegister src,
+                                VexSimdPrefix pre, VexOpcode opc) {
+  // Legacy encodings of the mandatory prefixes, indexed by VexSimdPrefix
+  static const int simd_pre[] = { 0x00, 0x66, 0xF3, 0xF2 };
+  if (pre != VEX_SIMD_NONE) {
+    emit_byte(simd_pre[pre]);
+  }
+  int encode = prefix_and_encode(dst->encoding(), src->encoding());
+  emit_byte(0x0F);
+  if (opc == VEX_OPCODE_0F_38) {
+    emit_byte(0x38);
+  } else {
+    assert(opc == VEX_OPCODE_0F, "unexpected opcode map");
+  }
+  emit_byte(opcode);
+  emit_byte(0xC0 | encode);
+}
+
+
+void Assembler::emit_vex_arith(int opcode, XMMRegister dst, XMMRegister nds, XMMRegister src,
+                               VexSimdPrefix pre, VexOpcode opc) {
+  assert(VM_Version::supports_avx(), "");
+  int encode = vex_prefix_and_encode(dst->encoding(), nds->encoding(), src->encoding(),
+                                     pre, opc, false);
+  emit_byte(opcode);
+  emit_byte(0xC0 | encode);
+}
+
+
+void Assembler::emit_simd_shift(int opcode, XMMRegister xmm_ext, XMMRegister dst, int shift) {
+  // The register xmm_ext supplies the opcode extension in ModRM.reg.
+  assert(isByte(shift), "invalid value");
+  emit_byte(0x66);
+  int encode = prefix_and_encode(xmm_ext->encoding(), dst->encoding());
+  emit_byte(0x0F);
+  emit_byte(opcode);
+  emit_byte(0xC0 | encode);
+  emit_byte(shift & 0xFF);
+}
+
+
+void Assembler::emit_vex_shift(int opcode, XMMRegister xmm_ext, XMMRegister dst, XMMRegister src,
+                               int shift) {
+  // The destination is encoded in VEX.vvvv, the source in ModRM.rm.
+  assert(VM_Version::supports_avx(), "");
+  assert(isByte(shift), "invalid value");
+  int encode = vex_prefix_and_encode(xmm_ext->encoding(), dst->encoding(), src->encoding(),
+                                     VEX_SIMD_66, VEX_OPCODE_0F, false);
+  emit_byte(opcode);
+  emit_byte(0xC0 | encode);
+  emit_byte(shift & 0xFF);
+}
+
+
 void Assembler::emit_operand(Register reg, Register base, Register index,
                              Address::ScaleFactor scale, int disp,
                              RelocationHolder const& rspec,
@@ -954,6 +1047,70 @@ void Assembler::addss(XMMRegister dst, Address src) {
   emit_operand(dst, src);
 }
 
+void Assembler::aesdec(XMMRegister dst, Address src) {
+  assert(VM_Version::supports_aes(), "");
+  InstructionMark im(this);
+  emit_byte(0x66);
+  prefix(src, dst);
+  emit_byte(0x0F);
+  emit_byte(0x38);
+  emit_byte(0xDE);
+  emit_operand(dst, src);
+}
+
+void Assembler::aesdec(XMMRegister dst, XMMRegister src) {
+  assert(VM_Version::supports_aes(), "");
+  emit_simd_arith(0xDE, dst, src, VEX_SIMD_66, VEX_OPCODE_0F_38);
+}
+
+void Assembler::aesdeclast(XMMRegister dst, Address src) {
+  assert(VM_Version::supports_aes(), "");
+  InstructionMark im(this);
+  emit_byte(0x66);
+  prefix(src, dst);
+  emit_byte(0x0F);
+  emit_byte(0x38);
+  emit_byte(0xDF);
+  emit_operand(dst, src);
+}
+
+void Assembler::aesdeclast(XMMRegister dst, XMMRegister src) {
+  assert(VM_Version::supports_aes(), "");
+  emit_simd_arith(0xDF, dst, src, VEX_SIMD_66, VEX_OPCODE_0F_38);
+}
+
+void Assembler::aesenc(XMMRegister dst, Address src) {
+  assert(VM_Version::supports_aes(), "");
+  InstructionMark im(this);
+  emit_byte(0x66);
+  prefix(src, dst);
+  emit_byte(0x0F);
+  emit_byte(0x38);
+  emit_byte(0xDC);
+  emit_operand(dst, src);
+}
+
+void Assembler::aesenc(XMMRegister dst, XMMRegister src) {
+  assert(VM_Version::supports_aes(), "");
+  emit_simd_arith(0xDC, dst, src, VEX_SIMD_66, VEX_OPCODE_0F_38);
+}
+
+void Assembler::aesenclast(XMMRegister dst, Address src) {
+  assert(VM_Version::supports_aes(), "");
+  InstructionMark im(this);
+  emit_byte(0x66);
+  prefix(src, dst);
+  emit_byte(0x0F);
+  emit_byte(0x38);
+  emit_byte(0xDD);
+  emit_operand(dst, src);
+}
+
+void Assembler::aesenclast(XMMRegister dst, XMMRegister src) {
+  assert(VM_Version::supports_aes(), "");
+  emit_simd_arith(0xDD, dst, src, VEX_SIMD_66, VEX_OPCODE_0F_38);
+}
+
 void Assembler::andl(Register dst, int32_t imm32) {
   prefix(dst);
   emit_arith(0x81, 0xE0, dst, imm32);
@@ -2239,6 +2396,18 @@ void Assembler::orl(Register dst, Register src) {
   emit_arith(0x0B, 0xC0, dst, src);
 }
 
+void Assembler::pclmulqdq(XMMRegister dst, XMMRegister src, int mask) {
+  assert(VM_Version::supports_clmul(), "");
+  assert(isByte(mask), "invalid value");
+  emit_byte(0x66);
+  int encode = prefix_and_encode(dst->encoding(), src->encoding());
+  emit_byte(0x0F);
+  emit_byte(0x3A);
+  emit_byte(0x44);
+  emit_byte(0xC0 | encode);
+  emit_byte(mask & 0xFF);
+}
+
 void Assembler::pcmpestri(XMMRegister dst, Address src, int imm8) {
   assert(VM_Version::supports_sse4_2(), "");
 
@@ -2371,6 +2540,23 @@ void Assembler::por(XMMRegister dst, XMMRegister src) {
   emit_byte(0xC0 | encode);
 }
 
+void Assembler::pshufb(XMMRegister dst, XMMRegister src) {
+  assert(VM_Version::supports_ssse3(), "");
+  emit_simd_arith(0x00, dst, src, VEX_SIMD_66, VEX_OPCODE_0F_38);
+}
+
+void Assembler::pshufb(XMMRegister dst, Address src) {
+  assert(VM_Version::supports_ssse3(), "");
+  // The memory operand must be 16 byte aligned.
+  InstructionMark im(this);
+  emit_byte(0x66);
+  prefix(src, dst);
+  emit_byte(0x0F);
+  emit_byte(0x38);
+  emit_byte(0x00);
+  emit_operand(dst, src);
+}
+
 void Assembler::pshufd(XMMRegister dst, XMMRegister src, int mode) {
   assert(isByte(mode), "invalid value");
   NOT_LP64(assert(VM_Version::supports_sse2(), ""));
@@ -2888,6 +3074,12 @@ void Assembler::xchgl(Register dst, Register src) {
   emit_byte(0xc0 | encode);
 }
 
+void Assembler::xgetbv() {
+  emit_byte(0x0F);
+  emit_byte(0x01);
+  emit_byte(0xD0);
+}
+
 void Assembler::xorl(Register dst, int32_t imm32) {
   prefix(dst);
   emit_arith(0x81, 0xF0, dst, imm32);
@@ -2939,6 +3131,209 @@ void Assembler::xorps(XMMRegister dst, Address src) {
   emit_operand(dst, src);
 }
 
+// Packed arithmetic for the vectorizer
+
+void Assembler::addps(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse(), ""));
+  emit_simd_arith(0x58, dst, src, VEX_SIMD_NONE);
+}
+
+void Assembler::subps(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse(), ""));
+  emit_simd_arith(0x5C, dst, src, VEX_SIMD_NONE);
+}
+
+void Assembler::mulps(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse(), ""));
+  emit_simd_arith(0x59, dst, src, VEX_SIMD_NONE);
+}
+
+void Assembler::divps(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse(), ""));
+  emit_simd_arith(0x5E, dst, src, VEX_SIMD_NONE);
+}
+
+void Assembler::vaddps(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0x58, dst, nds, src, VEX_SIMD_NONE);
+}
+
+void Assembler::vsubps(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0x5C, dst, nds, src, VEX_SIMD_NONE);
+}
+
+void Assembler::vmulps(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0x59, dst, nds, src, VEX_SIMD_NONE);
+}
+
+void Assembler::vdivps(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0x5E, dst, nds, src, VEX_SIMD_NONE);
+}
+
+void Assembler::paddb(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xFC, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::paddw(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xFD, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::paddd(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xFE, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::psubb(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xF8, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::psubw(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xF9, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::psubd(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xFA, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::vpaddb(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xFC, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpaddw(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xFD, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpaddd(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xFE, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpsubb(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xF8, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpsubw(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xF9, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpsubd(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xFA, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::pmullw(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xD5, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::pmulld(XMMRegister dst, XMMRegister src) {
+  assert(VM_Version::supports_sse4_1(), "");
+  emit_simd_arith(0x40, dst, src, VEX_SIMD_66, VEX_OPCODE_0F_38);
+}
+
+void Assembler::vpmullw(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xD5, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpmulld(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0x40, dst, nds, src, VEX_SIMD_66, VEX_OPCODE_0F_38);
+}
+
+void Assembler::pand(XMMRegister dst, XMMRegister src) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xDB, dst, src, VEX_SIMD_66);
+}
+
+void Assembler::vpand(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xDB, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpor(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xEB, dst, nds, src, VEX_SIMD_66);
+}
+
+void Assembler::vpxor(XMMRegister dst, XMMRegister nds, XMMRegister src) {
+  emit_vex_arith(0xEF, dst, nds, src, VEX_SIMD_66);
+}
+
+// Shifts by an immediate count: 66 0F 71/72 /6 (left), /2 (logical right)
+
+void Assembler::psllw(XMMRegister dst, int shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_shift(0x71, xmm6, dst, shift);
+}
+
+void Assembler::pslld(XMMRegister dst, int shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_shift(0x72, xmm6, dst, shift);
+}
+
+void Assembler::psrlw(XMMRegister dst, int shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_shift(0x71, xmm2, dst, shift);
+}
+
+void Assembler::psrld(XMMRegister dst, int shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_shift(0x72, xmm2, dst, shift);
+}
+
+void Assembler::vpsllw(XMMRegister dst, XMMRegister src, int shift) {
+  emit_vex_shift(0x71, xmm6, dst, src, shift);
+}
+
+void Assembler::vpslld(XMMRegister dst, XMMRegister src, int shift) {
+  emit_vex_shift(0x72, xmm6, dst, src, shift);
+}
+
+void Assembler::vpsrlw(XMMRegister dst, XMMRegister src, int shift) {
+  emit_vex_shift(0x71, xmm2, dst, src, shift);
+}
+
+void Assembler::vpsrld(XMMRegister dst, XMMRegister src, int shift) {
+  emit_vex_shift(0x72, xmm2, dst, src, shift);
+}
+
+// Shifts by the count in the low quadword of an XMM register
+
+void Assembler::psllw(XMMRegister dst, XMMRegister shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xF1, dst, shift, VEX_SIMD_66);
+}
+
+void Assembler::pslld(XMMRegister dst, XMMRegister shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xF2, dst, shift, VEX_SIMD_66);
+}
+
+void Assembler::psrlw(XMMRegister dst, XMMRegister shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xD1, dst, shift, VEX_SIMD_66);
+}
+
+void Assembler::psrld(XMMRegister dst, XMMRegister shift) {
+  NOT_LP64(assert(VM_Version::supports_sse2(), ""));
+  emit_simd_arith(0xD2, dst, shift, VEX_SIMD_66);
+}
+
+void Assembler::vpsllw(XMMRegister dst, XMMRegister src, XMMRegister shift) {
+  emit_vex_arith(0xF1, dst, src, shift, VEX_SIMD_66);
+}
+
+void Assembler::vpslld(XMMRegister dst, XMMRegister src, XMMRegister shift) {
+  emit_vex_arith(0xF2, dst, src, shift, VEX_SIMD_66);
+}
+
+void Assembler::vpsrlw(XMMRegister dst, XMMRegister src, XMMRegister shift) {
+  emit_vex_arith(0xD1, dst, src, shift, VEX_SIMD_66);
+}
+
+void Assembler::vpsrld(XMMRegister dst, XMMRegister src, XMMRegister shift) {
+  emit_vex_arith(0xD2, dst, src, shift, VEX_SIMD_66);
+}
+
 #ifndef _LP64
 // 32bit only pieces of the assembler
 
@@ -7901,6 +8296,25 @@ void MacroAssembler::xorps(XMMRegister dst, AddressLiteral src) {
   }
 }
 
+void MacroAssembler::movdqu(XMMRegister dst, AddressLiteral src) {
+  if (reachable(src)) {
+    movdqu(dst, as_Address(src));
+  } else {
+    lea(rscratch1, src);
+    movdqu(dst, Address(rscratch1, 0));
+  }
+}
+
+void MacroAssembler::pshufb(XMMRegister dst, AddressLiteral src) {
+  assert(((intptr_t)src.target() & 15) == 0, "SSE mode requires address alignment 16 bytes");
+  if (reachable(src)) {
+    pshufb(dst, as_Address(src));
+  } else {
+    lea(rscratch1, src);
+    pshufb(dst, Address(rscratch1, 0));
+  }
+}
+
 void MacroAssembler::cmov32(Condition cc, Register dst, Address src) {
   if (VM_Version::supports_cmov()) {
     cmovl(cc, dst, src);
@@ -9597,6 +10011,157 @@ void MacroAssembler::generate_fill(BasicType t, bool aligned,
   }
   BIND(L_exit);
 }
+
+// Helper functions for the CRC32 intrinsics.  The tables and the way the
+// CRC is folded follow the reflected bit order of java.util.zip.CRC32
+// (zlib): bit 0 of the first byte is the highest order coefficient.
+
+// Process one byte: crc = table[(crc ^ val) & 0xff] ^ (crc >>> 8).
+void MacroAssembler::update_byte_crc32(Register crc, Register val, Register table) {
+  xorl(val, crc);
+  andl(val, 0xFF);
+  shrl(crc, 8); // unsigned shift
+  xorl(crc, Address(table, val, Address::times_4, 0));
+}
+
+#ifdef _LP64
+// Fold 128-bit data chunk
+void MacroAssembler::fold_128bit_crc32(XMMRegister xcrc, XMMRegister xK, XMMRegister xtmp, Register buf, int offset) {
+  movdqa(xtmp, xcrc);
+  pclmulqdq(xtmp, xK, 0x11); // [127:64] x K[127:64]
+  pclmulqdq(xcrc, xK, 0x00); // [63:0]   x K[63:0]
+  pxor(xcrc, xtmp);
+  movdqu(xtmp, Address(buf, offset));
+  pxor(xcrc, xtmp);
+}
+
+void MacroAssembler::fold_128bit_crc32(XMMRegister xcrc, XMMRegister xK, XMMRegister xtmp, XMMRegister xbuf) {
+  movdqa(xtmp, xcrc);
+  pclmulqdq(xtmp, xK, 0x11); // [127:64] x K[127:64]
+  pclmulqdq(xcrc, xK, 0x00); // [63:0]   x K[63:0]
+  pxor(xcrc, xtmp);
+  pxor(xcrc, xbuf);
+}
+
+// Shift one zero byte into the crc: crc = table[crc & 0xff] ^ (crc >>> 8).
+void MacroAssembler::fold_8bit_crc32(Register crc, Register table, Register tmp) {
+  movl(tmp, crc);
+  andl(tmp, 0xFF);
+  shrl(crc, 8);
+  xorl(crc, Address(table, tmp, Address::times_4, 0));
+}
+
+// Compute the CRC32 of len bytes at buf.  Chunks of 16 bytes are folded
+// with carry-less multiplication, four streams at a time while there
+// are at least 64 bytes left; the final 128 bit remainder and the tail
+// bytes are processed with the table.  Uses rax, xmm0-xmm5 as temps.
+//
+// @param crc   register containing existing CRC (32-bit)
+// @param buf   register pointing to input byte buffer (byte*)
+// @param len   register containing number of bytes
+// @param table register that will contain address of CRC table
+// @param tmp   scratch register
+void MacroAssembler::kernel_crc32(Register crc, Register buf, Register len, Register table, Register tmp) {
+  assert_different_registers(crc, buf, len, table, tmp, rax);
+
+  Label L_tail, L_tail_loop, L_exit, L_fold_single;
+  Label L_fold_512b, L_fold_512b_loop, L_fold_tail_loop, L_fold_128b;
+
+  lea(table, ExternalAddress(StubRoutines::crc_table_addr()));
+  notl(crc); // ~crc
+  cmpl(len, 16);
+  jcc(Assembler::less, L_tail);
+
+  // Fold crc into the first 16 bytes of the buffer.
+  movdqu(xmm1, Address(buf, 0));
+  movdl(xmm0, crc);
+  pxor(xmm1, xmm0);
+  cmpl(len, 64);
+  jcc(Assembler::less, L_fold_single);
+
+  // Fold 512 bits of the buffer on each iteration,
+  // 128 bits per each of 4 parallel streams.
+  movdqu(xmm2, Address(buf, 16));
+  movdqu(xmm3, Address(buf, 32));
+  movdqu(xmm4, Address(buf, 48));
+  addptr(buf, 64);
+  subl(len, 64);
+  movdqu(xmm0, ExternalAddress(StubRoutines::x86::crc_by128_masks_addr() + 16));
+
+  BIND(L_fold_512b_loop);
+  cmpl(len, 64);
+  jcc(Assembler::less, L_fold_512b);
+  fold_128bit_crc32(xmm1, xmm0, xmm5, buf,  0);
+  fold_128bit_crc32(xmm2, xmm0, xmm5, buf, 16);
+  fold_128bit_crc32(xmm3, xmm0, xmm5, buf, 32);
+  fold_128bit_crc32(xmm4, xmm0, xmm5, buf, 48);
+  addptr(buf, 64);
+  subl(len, 64);
+  jmp(L_fold_512b_loop);
+
+  // Fold the 4 streams down into 128 bits.
+  BIND(L_fold_512b);
+  movdqu(xmm0, ExternalAddress(StubRoutines::x86::crc_by128_masks_addr()));
+  fold_128bit_crc32(xmm1, xmm0, xmm5, xmm2);
+  fold_128bit_crc32(xmm1, xmm0, xmm5, xmm3);
+  fold_128bit_crc32(xmm1, xmm0, xmm5, xmm4);
+  jmpb(L_fold_tail_loop);
+
+  BIND(L_fold_single);
+  addptr(buf, 16);
+  subl(len, 16);
+  movdqu(xmm0, ExternalAddress(StubRoutines::x86::crc_by128_masks_addr()));
+
+  // Fold the rest of 128 bits data chunks
+  BIND(L_fold_tail_loop);
+  cmpl(len, 16);
+  jccb(Assembler::less, L_fold_128b);
+  fold_128bit_crc32(xmm1, xmm0, xmm5, buf, 0);
+  addptr(buf, 16);
+  subl(len, 16);
+  jmpb(L_fold_tail_loop);
+
+  // Reduce the 128 bits in xmm1 to the 32 bits of crc: the crc of the
+  // remainder's 16 bytes, starting from 0.
+  BIND(L_fold_128b);
+  movdq(tmp, xmm1);
+  movl(crc, tmp);
+  for (int j = 0; j < 4; j++) {
+    fold_8bit_crc32(crc, table, rax);
+  }
+  shrq(tmp, 32);
+  xorl(crc, tmp);
+  for (int j = 0; j < 4; j++) {
+    fold_8bit_crc32(crc, table, rax);
+  }
+  psrldq(xmm1, 8);
+  movdq(tmp, xmm1);
+  xorl(crc, tmp);
+  for (int j = 0; j < 4; j++) {
+    fold_8bit_crc32(crc, table, rax);
+  }
+  shrq(tmp, 32);
+  xorl(crc, tmp);
+  for (int j = 0; j < 4; j++) {
+    fold_8bit_crc32(crc, table, rax);
+  }
+
+  // Process the remaining bytes one at a time.
+  BIND(L_tail);
+  testl(len, len);
+  jccb(Assembler::lessEqual, L_exit);
+
+  BIND(L_tail_loop);
+  movzbl(rax, Address(buf, 0));
+  update_byte_crc32(crc, rax, table);
+  increment(buf);
+  decrementl(len);
+  jccb(Assembler::greater, L_tail_loop);
+
+  BIND(L_exit);
+  notl(crc); // ~crc
+}
+#endif // _LP64
 #undef BIND
 #undef BLOCK_COMMENT
 
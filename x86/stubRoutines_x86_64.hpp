@@ -32,8 +32,8 @@
 static bool    returns_to_call_stub(address return_pc)   { return return_pc == _call_stub_return_address; }
 
 enum platform_dependent_constants {
-  code_size1 = 19000,          // simply increase if too small (assembler will crash if too small)
-  code_size2 = 22000           // simply increase if too small (assembler will crash if too small)
+  code_size1 = 20000,          // simply increase if too small (assembler will crash if too small)
+  code_size2 = 25000           // simply increase if too small (assembler will crash if too small)
 };
 
 class x86 {
@@ -53,6 +53,12 @@ class x86 {
   static address _double_sign_mask;
   static address _double_sign_flip;
   static address _mxcsr_std;
+  // shuffle mask for fixing up 128-bit words consisting of big-endian 32-bit integers
+  static address _key_shuffle_mask_addr;
+  // fold constants for the CRC32 stub
+  static address _crc_by128_masks_addr;
+  // table for CRC32
+  static juint   _crc_table[];
 
  public:
 
@@ -110,6 +116,21 @@ class x86 {
   {
     return _mxcsr_std;
   }
+
+  static address key_shuffle_mask_addr()
+  {
+    return _key_shuffle_mask_addr;
+  }
+
+  static address crc_by128_masks_addr()
+  {
+    return _crc_by128_masks_addr;
+  }
+
+  static address crc_table_addr()
+  {
+    return (address)_crc_table;
+  }
 };
 
 #endif // CPU_X86_VM_STUBROUTINES_X86_64_HPP